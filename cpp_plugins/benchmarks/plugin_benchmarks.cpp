@@ -0,0 +1,531 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "plugin_manager.h"
+#include "data_types.h"
+#include "vibrate31_plugin.h"
+#include "feature_plugin_base.h"
+#include "decision_plugin_base.h"
+#include "evaluation_plugin_base.h"
+#include "event_plugin_base.h"
+#include "memory_accounting.h"
+#include "synthetic_data.h"
+
+// 版本号由CMake注入，其他方式构建时使用占位值
+#ifndef ALGORITHM_PLUGINS_BENCHMARK_VERSION
+#define ALGORITHM_PLUGINS_BENCHMARK_VERSION "unknown"
+#endif
+
+using namespace AlgorithmPlugins;
+
+/**
+ * 插件框架性能基准
+ *
+ * 默认以JSON输出到标准输出，可用--benchmark_out=<file>同时写入文件，
+ * 用--benchmark_filter=<regex>选择基准。各基准的数据由SyntheticDataGenerator以固定种子生成
+ */
+
+namespace {
+
+template <typename PluginT>
+class BenchmarkPluginFactory : public IPluginFactory {
+public:
+    BenchmarkPluginFactory(const std::string& name, PluginType type) : name_(name), type_(type) {}
+
+    std::shared_ptr<IPlugin> createPlugin() override { return std::make_shared<PluginT>(); }
+    std::string getPluginName() const override { return name_; }
+    PluginType getPluginType() const override { return type_; }
+
+private:
+    std::string name_;
+    PluginType type_;
+};
+
+/**
+ * @brief 只转发输入特征的插件，用于测量插件链自身的调度开销
+ */
+class PassThroughPlugin : public IPlugin {
+public:
+    explicit PassThroughPlugin(const std::string& name) : name_(name) {}
+
+    std::string getName() const override { return name_; }
+    std::string getVersion() const override { return "1.0.0"; }
+    std::string getDescription() const override { return "基准测试转发插件"; }
+    PluginType getType() const override { return PluginType::OTHER; }
+
+    bool initialize(std::shared_ptr<PluginParameter>) override { return true; }
+    bool process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) override {
+        auto features = std::dynamic_pointer_cast<FeatureData>(input);
+        output->setData(name_, features ? static_cast<double>(features->getFeatures().size()) : 0.0);
+        return true;
+    }
+    void cleanup() override {}
+    bool isInitialized() const override { return true; }
+    std::string getLastError() const override { return ""; }
+
+    std::vector<std::string> getRequiredParameters() const override { return {}; }
+    std::vector<std::string> getOptionalParameters() const override { return {}; }
+
+private:
+    std::string name_;
+};
+
+class PassThroughPluginFactory : public IPluginFactory {
+public:
+    explicit PassThroughPluginFactory(const std::string& name) : name_(name) {}
+
+    std::shared_ptr<IPlugin> createPlugin() override { return std::make_shared<PassThroughPlugin>(name_); }
+    std::string getPluginName() const override { return name_; }
+    PluginType getPluginType() const override { return PluginType::OTHER; }
+
+private:
+    std::string name_;
+};
+
+constexpr size_t kPassThroughPlugins = 16;
+
+// 注册被测插件，多个基准线程同时进入时只注册一次
+void registerBenchmarkPlugins() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        auto& manager = PluginManager::getInstance();
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<Vibrate31Plugin>>(
+            "vibrate31", PluginType::FEATURE));
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<CurrentFeaturePlugin>>(
+            "current_feature", PluginType::FEATURE));
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<TemperatureFeaturePlugin>>(
+            "temperature_feature", PluginType::FEATURE));
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<AudioFeaturePlugin>>(
+            "audio_feature", PluginType::FEATURE));
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<Motor97Plugin>>(
+            "motor97", PluginType::DECISION));
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<UniversalClassify1Plugin>>(
+            "universal_classify1", PluginType::DECISION));
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<CompRealtimeHealth34Plugin>>(
+            "comp_realtime_health34", PluginType::EVALUATION));
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<Error18Plugin>>(
+            "error18", PluginType::EVALUATION));
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<ScoreAlarm5Plugin>>(
+            "score_alarm5", PluginType::EVENT));
+        manager.registerPluginFactory(std::make_shared<BenchmarkPluginFactory<StatusAlarm4Plugin>>(
+            "status_alarm4", PluginType::EVENT));
+        for (size_t i = 0; i < kPassThroughPlugins; ++i) {
+            manager.registerPluginFactory(std::make_shared<PassThroughPluginFactory>("bench_pass_" + std::to_string(i)));
+        }
+    });
+}
+
+// 各插件的基准参数，与生产配置的量级一致
+std::shared_ptr<PluginParameterImpl> benchmarkParameters() {
+    auto params = std::make_shared<PluginParameterImpl>();
+    params->setInt("sampling_rate", 1000);
+    params->setInt("duration_limit", 10);
+    params->setDouble("dc_threshold", 500.0);
+    params->setInt("window_size", 10);
+    params->setInt("trend_window", 5);
+    params->setDoubleArray("threshold", {0, 50, 100});
+    params->setDoubleArray("alarm_line", {20, 40, 60, 80, 90, 95});
+    params->setInt("minimum_quantity", 1);
+    params->setInt("tolerable_length", 5);
+    return params;
+}
+
+// 创建并初始化插件，失败时在state中记录原因并返回nullptr
+std::shared_ptr<IPlugin> createBenchmarkPlugin(benchmark::State& state, const std::string& plugin_name) {
+    registerBenchmarkPlugins();
+    auto plugin = PluginManager::getInstance().createPlugin(plugin_name);
+    if (!plugin) {
+        state.SkipWithError(("插件创建失败: " + plugin_name).c_str());
+        return nullptr;
+    }
+    if (!plugin->initialize(benchmarkParameters())) {
+        state.SkipWithError(("插件初始化失败: " + plugin->getLastError()).c_str());
+        return nullptr;
+    }
+    return plugin;
+}
+
+// 逐条循环处理输入，统计处理条数
+void runPlugin(benchmark::State& state, IPlugin& plugin,
+               const std::vector<std::shared_ptr<PluginData>>& inputs) {
+    auto output = std::make_shared<PluginResultImpl>();
+    size_t index = 0;
+    for (auto _ : state) {
+        output->clear();
+        bool success = plugin.process(inputs[index], output);
+        benchmark::DoNotOptimize(success);
+        index = (index + 1 == inputs.size()) ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// 多设备交错的实时读数，range(0)为设备数
+std::vector<std::shared_ptr<PluginData>> realTimeInputs(benchmark::State& state) {
+    SyntheticDataGenerator generator(42 + state.thread_index());
+    return generator.interleavedStream(static_cast<size_t>(state.range(0)), 64);
+}
+
+std::vector<std::shared_ptr<PluginData>> featureInputs(benchmark::State& state) {
+    SyntheticDataGenerator generator(42 + state.thread_index());
+    std::vector<std::shared_ptr<PluginData>> inputs;
+    for (int64_t i = 0; i < state.range(0) * 16; ++i) {
+        inputs.push_back(generator.featureData("device_" + std::to_string(i % state.range(0)), 8));
+    }
+    return inputs;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// 振动特征提取：range(0)为波形时长（秒），采样率1000Hz
+// ---------------------------------------------------------------------------
+
+void BM_Vibrate31(benchmark::State& state) {
+    auto plugin = createBenchmarkPlugin(state, "vibrate31");
+    if (!plugin) {
+        return;
+    }
+    SyntheticDataGenerator generator(42 + state.thread_index());
+    std::vector<std::shared_ptr<PluginData>> inputs = {
+        generator.batchData("vibration_" + std::to_string(state.thread_index()),
+                            static_cast<size_t>(state.range(0)) * 1000)
+    };
+    runPlugin(state, *plugin, inputs);
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 1000 * static_cast<int64_t>(sizeof(double)));
+}
+BENCHMARK(BM_Vibrate31)->Arg(60)->Arg(300)->Arg(900)->ThreadRange(1, 4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// ---------------------------------------------------------------------------
+// 各类插件的单条处理：range(0)为交错的设备数，每个线程使用独立实例
+// ---------------------------------------------------------------------------
+
+template <const char* PluginName, bool FeatureInput>
+void BM_PluginProcess(benchmark::State& state) {
+    auto plugin = createBenchmarkPlugin(state, PluginName);
+    if (!plugin) {
+        return;
+    }
+    auto inputs = FeatureInput ? featureInputs(state) : realTimeInputs(state);
+    runPlugin(state, *plugin, inputs);
+}
+
+namespace {
+constexpr char kCurrentFeature[] = "current_feature";
+constexpr char kTemperatureFeature[] = "temperature_feature";
+constexpr char kAudioFeature[] = "audio_feature";
+constexpr char kMotor97[] = "motor97";
+constexpr char kUniversalClassify1[] = "universal_classify1";
+constexpr char kCompRealtimeHealth34[] = "comp_realtime_health34";
+constexpr char kError18[] = "error18";
+constexpr char kScoreAlarm5[] = "score_alarm5";
+constexpr char kStatusAlarm4[] = "status_alarm4";
+
+void pluginArgs(benchmark::internal::Benchmark* b) {
+    b->Arg(1)->Arg(16)->Arg(256)->ThreadRange(1, 8)->UseRealTime();
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_PluginProcess, kCurrentFeature, false)->Apply(pluginArgs);
+BENCHMARK_TEMPLATE(BM_PluginProcess, kTemperatureFeature, false)->Apply(pluginArgs);
+BENCHMARK_TEMPLATE(BM_PluginProcess, kAudioFeature, false)->Apply(pluginArgs);
+BENCHMARK_TEMPLATE(BM_PluginProcess, kMotor97, true)->Apply(pluginArgs);
+BENCHMARK_TEMPLATE(BM_PluginProcess, kUniversalClassify1, true)->Apply(pluginArgs);
+BENCHMARK_TEMPLATE(BM_PluginProcess, kCompRealtimeHealth34, true)->Apply(pluginArgs);
+BENCHMARK_TEMPLATE(BM_PluginProcess, kError18, true)->Apply(pluginArgs);
+BENCHMARK_TEMPLATE(BM_PluginProcess, kScoreAlarm5, true)->Apply(pluginArgs);
+BENCHMARK_TEMPLATE(BM_PluginProcess, kStatusAlarm4, true)->Apply(pluginArgs);
+
+// ---------------------------------------------------------------------------
+// 插件链：所有线程共用一个链管理器，各线程的设备互不重叠
+// ---------------------------------------------------------------------------
+
+namespace {
+
+PluginChainManager& benchmarkChainManager() {
+    static PluginChainManager chain_manager;
+    static std::once_flag once;
+    std::call_once(once, [] {
+        registerBenchmarkPlugins();
+
+        // 串行转发链，长度1/4/16
+        for (size_t length : {1, 4, 16}) {
+            PluginChainManager::ChainConfig config;
+            config.chain_name = "bench_serial_" + std::to_string(length);
+            for (size_t i = 0; i < length; ++i) {
+                config.plugin_names.push_back("bench_pass_" + std::to_string(i));
+            }
+            chain_manager.createChain(config);
+        }
+
+        // 菱形DAG：一个源节点分出4个并行分支后汇合
+        PluginChainManager::ChainConfig dag;
+        dag.chain_name = "bench_diamond";
+        for (size_t i = 0; i < 6; ++i) {
+            dag.plugin_names.push_back("bench_pass_" + std::to_string(i));
+        }
+        for (size_t i = 1; i <= 4; ++i) {
+            dag.data_mappings["bench_pass_0->bench_pass_" + std::to_string(i)] = "*";
+            dag.data_mappings["bench_pass_" + std::to_string(i) + "->bench_pass_5"] = "*";
+        }
+        chain_manager.createChain(dag);
+
+        // 实时监测链：特征 -> 状态识别 -> 健康度 -> 报警
+        PluginChainManager::ChainConfig realtime;
+        realtime.chain_name = "bench_realtime";
+        realtime.plugin_names = {"current_feature", "motor97", "comp_realtime_health34", "score_alarm5"};
+        auto params = benchmarkParameters();
+        realtime.plugin_params = {params, params, params, params};
+        chain_manager.createChain(realtime);
+
+        // 同一实时监测链开启实例分片，设备数多时实例数固定为分片数
+        realtime.chain_name = "bench_realtime_sharded";
+        realtime.instance_shards = 8;
+        chain_manager.createChain(realtime);
+    });
+    return chain_manager;
+}
+
+void runChain(benchmark::State& state, const std::string& chain_name,
+              const std::vector<std::shared_ptr<PluginData>>& inputs) {
+    auto& chain_manager = benchmarkChainManager();
+    if (!chain_manager.isChainAvailable(chain_name)) {
+        state.SkipWithError(("插件链创建失败: " + chain_name).c_str());
+        return;
+    }
+
+    auto output = std::make_shared<PluginResultImpl>();
+    size_t index = 0;
+    for (auto _ : state) {
+        output->clear();
+        bool success = chain_manager.executeChain(chain_name, inputs[index], output);
+        benchmark::DoNotOptimize(success);
+        index = (index + 1 == inputs.size()) ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// 每个线程独立的设备集合，range(1)为设备数
+std::vector<std::shared_ptr<PluginData>> chainFeatureInputs(benchmark::State& state, int64_t devices) {
+    SyntheticDataGenerator generator(42 + state.thread_index());
+    std::vector<std::shared_ptr<PluginData>> inputs;
+    for (int64_t i = 0; i < devices * 4; ++i) {
+        inputs.push_back(generator.featureData(
+            "chain_" + std::to_string(state.thread_index()) + "_" + std::to_string(i % devices), 8));
+    }
+    return inputs;
+}
+
+} // namespace
+
+// range(0)为链长度，range(1)为设备数
+void BM_ExecuteChainSerial(benchmark::State& state) {
+    runChain(state, "bench_serial_" + std::to_string(state.range(0)), chainFeatureInputs(state, state.range(1)));
+}
+BENCHMARK(BM_ExecuteChainSerial)
+    ->ArgsProduct({{1, 4, 16}, {1, 64}})
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+void BM_ExecuteChainDag(benchmark::State& state) {
+    runChain(state, "bench_diamond", chainFeatureInputs(state, state.range(0)));
+}
+BENCHMARK(BM_ExecuteChainDag)->Arg(1)->Arg(64)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_ExecuteChainRealtime(benchmark::State& state) {
+    SyntheticDataGenerator generator(42 + state.thread_index());
+    // 按线程区分设备，避免不同线程争用同一设备的实例集合
+    auto inputs = generator.interleavedStream(static_cast<size_t>(state.range(0)), 16,
+                                              "realtime_" + std::to_string(state.thread_index()) + "_");
+    runChain(state, "bench_realtime", inputs);
+}
+BENCHMARK(BM_ExecuteChainRealtime)->Arg(1)->Arg(16)->Arg(256)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_ExecuteChainRealtimeSharded(benchmark::State& state) {
+    SyntheticDataGenerator generator(42 + state.thread_index());
+    auto inputs = generator.interleavedStream(static_cast<size_t>(state.range(0)), 16,
+                                              "realtime_" + std::to_string(state.thread_index()) + "_");
+    runChain(state, "bench_realtime_sharded", inputs);
+}
+BENCHMARK(BM_ExecuteChainRealtimeSharded)->Arg(1)->Arg(16)->Arg(256)->ThreadRange(1, 8)->UseRealTime();
+
+// 批量执行：range(0)为每批条数
+void BM_ExecuteChainBatch(benchmark::State& state) {
+    auto& chain_manager = benchmarkChainManager();
+    auto inputs = chainFeatureInputs(state, 16);
+    inputs.resize(static_cast<size_t>(state.range(0)), inputs.front());
+
+    std::vector<std::shared_ptr<PluginResult>> outputs;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        outputs.push_back(std::make_shared<PluginResultImpl>());
+    }
+    std::vector<bool> succeeded;
+    for (auto _ : state) {
+        bool success = chain_manager.executeChainBatch("bench_serial_4", inputs, outputs, succeeded);
+        benchmark::DoNotOptimize(success);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ExecuteChainBatch)->Arg(1)->Arg(16)->Arg(256)->ThreadRange(1, 4)->UseRealTime();
+
+// ---------------------------------------------------------------------------
+// 数据层序列化
+// ---------------------------------------------------------------------------
+
+void BM_SerializeBatchData(benchmark::State& state) {
+    SyntheticDataGenerator generator;
+    auto data = generator.batchData("serialize", static_cast<size_t>(state.range(0)));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string text = data->serialize();
+        bytes += text.size();
+        benchmark::DoNotOptimize(text);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_SerializeBatchData)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+void BM_DeserializeBatchData(benchmark::State& state) {
+    SyntheticDataGenerator generator;
+    std::string text = generator.batchData("serialize", static_cast<size_t>(state.range(0)))->serialize();
+    BatchData data("", std::chrono::system_clock::now());
+    for (auto _ : state) {
+        bool success = data.deserialize(text);
+        benchmark::DoNotOptimize(success);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_DeserializeBatchData)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+void BM_SerializeRealTimeData(benchmark::State& state) {
+    SyntheticDataGenerator generator;
+    auto data = generator.realTimeData("serialize", 0);
+    for (auto _ : state) {
+        std::string text = data->serialize();
+        benchmark::DoNotOptimize(text);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SerializeRealTimeData);
+
+void BM_DeserializeRealTimeData(benchmark::State& state) {
+    SyntheticDataGenerator generator;
+    std::string text = generator.realTimeData("serialize", 0)->serialize();
+    RealTimeData data("", std::chrono::system_clock::now());
+    for (auto _ : state) {
+        bool success = data.deserialize(text);
+        benchmark::DoNotOptimize(success);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeserializeRealTimeData);
+
+// range(0)为特征数
+void BM_SerializeFeatureData(benchmark::State& state) {
+    SyntheticDataGenerator generator;
+    auto data = generator.featureData("serialize", static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::string text = data->serialize();
+        benchmark::DoNotOptimize(text);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SerializeFeatureData)->Arg(8)->Arg(64)->Arg(512);
+
+void BM_DeserializeFeatureData(benchmark::State& state) {
+    SyntheticDataGenerator generator;
+    std::string text = generator.featureData("serialize", static_cast<size_t>(state.range(0)))->serialize();
+    FeatureData data("", std::chrono::system_clock::now());
+    for (auto _ : state) {
+        bool success = data.deserialize(text);
+        benchmark::DoNotOptimize(success);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeserializeFeatureData)->Arg(8)->Arg(64)->Arg(512);
+
+void BM_RoundTripPluginResult(benchmark::State& state) {
+    PluginResultImpl result;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        result.setData("value_" + std::to_string(i), static_cast<double>(i));
+    }
+    PluginResultImpl parsed;
+    for (auto _ : state) {
+        std::string serialized = result.serialize();
+        bool success = parsed.deserialize(serialized);
+        benchmark::DoNotOptimize(success);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RoundTripPluginResult)->Arg(8)->Arg(64)->Arg(512);
+
+// ---------------------------------------------------------------------------
+// 插件管理器查询
+// ---------------------------------------------------------------------------
+
+void BM_PluginManagerCreatePlugin(benchmark::State& state) {
+    registerBenchmarkPlugins();
+    auto& manager = PluginManager::getInstance();
+    for (auto _ : state) {
+        auto plugin = manager.createPlugin("bench_pass_7");
+        benchmark::DoNotOptimize(plugin);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PluginManagerCreatePlugin)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_PluginManagerIsAvailable(benchmark::State& state) {
+    registerBenchmarkPlugins();
+    auto& manager = PluginManager::getInstance();
+    const std::vector<std::string> names = {"vibrate31", "motor97", "bench_pass_3", "missing_plugin"};
+    size_t index = 0;
+    for (auto _ : state) {
+        bool available = manager.isPluginAvailable(names[index]);
+        benchmark::DoNotOptimize(available);
+        index = (index + 1) & 3;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PluginManagerIsAvailable)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_PluginManagerByType(benchmark::State& state) {
+    registerBenchmarkPlugins();
+    auto& manager = PluginManager::getInstance();
+    for (auto _ : state) {
+        auto plugins = manager.getPluginsByType(PluginType::FEATURE);
+        benchmark::DoNotOptimize(plugins);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PluginManagerByType)->ThreadRange(1, 8)->UseRealTime();
+
+// 默认输出JSON，命令行指定--benchmark_format时以命令行为准
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    bool has_format = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--benchmark_format", 18) == 0) {
+            has_format = true;
+        }
+    }
+    char json_format[] = "--benchmark_format=json";
+    if (!has_format) {
+        args.push_back(json_format);
+    }
+    int arg_count = static_cast<int>(args.size());
+
+    benchmark::Initialize(&arg_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(arg_count, args.data())) {
+        return 1;
+    }
+    benchmark::AddCustomContext("algorithm_plugins_version", ALGORITHM_PLUGINS_BENCHMARK_VERSION);
+    benchmark::AddCustomContext("allocation_tracking",
+                                MemoryAccount::isAllocationTrackingEnabled() ? "enabled" : "disabled");
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
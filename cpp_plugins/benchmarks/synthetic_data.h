@@ -0,0 +1,138 @@
+#pragma once
+
+#include "data_types.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 基准测试用合成数据生成器
+ *
+ * 给定种子时输出可复现，用于比较不同版本的性能。
+ * 振动波形按启停工况交替生成：运行段含转频及其谐波、轴承特征频率和噪声，停机段只有底噪
+ */
+class SyntheticDataGenerator {
+public:
+    explicit SyntheticDataGenerator(uint64_t seed = 42) : random_engine_(seed) {}
+
+    // 振动波形及对应转速，run_ratio为运行时长占比，每段约segment_seconds秒
+    void vibration(size_t samples, int sampling_rate, double run_ratio, double segment_seconds,
+                   std::vector<double>& wave_data, std::vector<double>& speed_data) {
+        const double kPi = 3.14159265358979323846;
+        std::normal_distribution<double> noise(0.0, 0.05);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        wave_data.resize(samples);
+        speed_data.resize(samples);
+
+        const size_t segment_samples = std::max<size_t>(1, static_cast<size_t>(segment_seconds * sampling_rate));
+        bool running = unit(random_engine_) < run_ratio;
+        double rpm = 0.0;
+        double phase = 0.0;
+        for (size_t begin = 0; begin < samples; begin += segment_samples) {
+            size_t end = std::min(samples, begin + segment_samples);
+            double target_rpm = running ? 1450.0 + 60.0 * unit(random_engine_) : 0.0;
+            double amplitude = running ? 0.8 + 0.4 * unit(random_engine_) : 0.0;
+
+            for (size_t i = begin; i < end; ++i) {
+                // 转速在启停时按一阶惯性变化
+                rpm += (target_rpm - rpm) * 0.002;
+                double rotation_hz = rpm / 60.0;
+                phase += 2.0 * kPi * rotation_hz / sampling_rate;
+
+                double value = noise(random_engine_);
+                if (rpm > 1.0) {
+                    double load = rpm / 1500.0;
+                    value += amplitude * load * (std::sin(phase) + 0.3 * std::sin(2.0 * phase) +
+                                                 0.1 * std::sin(3.0 * phase) + 0.05 * std::sin(7.2 * phase));
+                }
+                wave_data[i] = value;
+                speed_data[i] = rpm;
+            }
+            running = unit(random_engine_) < run_ratio;
+        }
+    }
+
+    std::shared_ptr<BatchData> batchData(const std::string& device_id, size_t samples, int sampling_rate = 1000) {
+        std::vector<double> wave_data;
+        std::vector<double> speed_data;
+        vibration(samples, sampling_rate, 0.7, 30.0, wave_data, speed_data);
+
+        auto data = std::make_shared<BatchData>(device_id, std::chrono::system_clock::now());
+        data->setWaveData(wave_data);
+        data->setSpeedData(speed_data);
+        data->setSamplingRate(sampling_rate);
+        data->setStatus(1);
+        return data;
+    }
+
+    // 实时特征读数，各特征在基线附近随机游走，第index条读数的时间戳按period递增
+    std::shared_ptr<RealTimeData> realTimeData(const std::string& device_id, size_t index,
+                                               std::chrono::milliseconds period = std::chrono::milliseconds(1000)) {
+        std::normal_distribution<double> step(0.0, 1.0);
+        drift_ = std::max(-20.0, std::min(20.0, drift_ + step(random_engine_)));
+
+        auto data = std::make_shared<RealTimeData>(device_id, epoch_ + period * static_cast<int64_t>(index));
+        data->setMeanHF(100.0 + drift_ + step(random_engine_));
+        data->setMeanLF(50.0 + 0.5 * drift_ + step(random_engine_));
+        data->setMean(75.0 + 0.7 * drift_ + step(random_engine_));
+        data->setStd(15.0 + 0.1 * std::abs(drift_));
+        data->setTemperature(45.0 + 0.2 * drift_);
+        data->setSpeed(1500.0 + 5.0 * step(random_engine_));
+        data->setCustomFeature("current_rms", 12.0 + 0.1 * drift_);
+        data->setCustomFeature("overall_health", 80.0 - std::abs(drift_));
+        return data;
+    }
+
+    std::shared_ptr<FeatureData> featureData(const std::string& device_id, size_t feature_count) {
+        std::uniform_real_distribution<double> value(0.0, 100.0);
+        auto data = std::make_shared<FeatureData>(device_id, std::chrono::system_clock::now());
+        for (size_t i = 0; i < feature_count; ++i) {
+            data->setFeature("feature_" + std::to_string(i), value(random_engine_));
+        }
+        data->setFeature("mean_hf", value(random_engine_));
+        data->setFeature("current_rms", value(random_engine_) / 8.0);
+        data->setFeature("overall_health", value(random_engine_));
+        data->setFeature("status", 1.0);
+        return data;
+    }
+
+    // 多设备交错的实时读数流：每轮每台设备一条，轮内设备顺序随机，模拟网关汇聚后的到达顺序。
+    // 设备名为device_prefix加序号
+    std::vector<std::shared_ptr<PluginData>> interleavedStream(size_t device_count, size_t readings_per_device,
+                                                               const std::string& device_prefix = "device_") {
+        std::vector<std::string> device_ids;
+        for (size_t d = 0; d < device_count; ++d) {
+            device_ids.push_back(device_prefix + std::to_string(d));
+        }
+
+        std::vector<std::shared_ptr<PluginData>> stream;
+        stream.reserve(device_count * readings_per_device);
+        std::vector<size_t> order(device_count);
+        for (size_t round = 0; round < readings_per_device; ++round) {
+            for (size_t d = 0; d < device_count; ++d) {
+                order[d] = d;
+            }
+            std::shuffle(order.begin(), order.end(), random_engine_);
+            for (size_t d : order) {
+                stream.push_back(realTimeData(device_ids[d], round));
+            }
+        }
+        return stream;
+    }
+
+private:
+    std::mt19937_64 random_engine_;
+    double drift_ = 0.0;
+    const std::chrono::system_clock::time_point epoch_ =
+        std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+};
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "plugin_base.h"
+#include "task_scheduler.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace AlgorithmPlugins {
+
+class PluginChainManager;
+
+/**
+ * @brief 插件链异步执行器
+ *
+ * 请求进入有界队列后立即返回，由共享TaskScheduler上最多worker_count个排空任务取出执行，
+ * 执行器自身不创建线程，结果通过future或完成回调返回。队列满时按配置拒绝或阻塞提交方，
+ * 在调度器工作线程中提交时应使用REJECT策略，避免阻塞排空任务所需的线程。
+ * 请求按排序键（插件链请求为设备ID）分队列，同一键的请求按提交顺序逐个执行并完成，
+ * 任一时刻最多一个排空任务处理同一键；不同键的请求并发执行，各键轮流取出一个请求
+ */
+class AsyncChainExecutor {
+public:
+    // 队列满时的处理策略
+    enum class OverflowPolicy {
+        REJECT,     // 立即拒绝
+        BLOCK       // 阻塞直到有空位
+    };
+
+    struct Options {
+        size_t worker_count = 0;        // 最大并发执行数，0表示使用调度器线程数
+        size_t queue_capacity = 1024;   // 队列容量
+        OverflowPolicy overflow_policy = OverflowPolicy::BLOCK;
+        TaskScheduler* scheduler = nullptr;  // 执行请求的调度器，为空时使用进程共享的调度器
+    };
+
+    // 完成回调，在调度器工作线程中调用
+    using Completion = std::function<void(bool success, std::shared_ptr<PluginResult> output_result)>;
+
+    explicit AsyncChainExecutor(PluginChainManager& chain_manager);
+    AsyncChainExecutor(PluginChainManager& chain_manager, const Options& options);
+    ~AsyncChainExecutor();
+
+    // 禁用拷贝构造和赋值
+    AsyncChainExecutor(const AsyncChainExecutor&) = delete;
+    AsyncChainExecutor& operator=(const AsyncChainExecutor&) = delete;
+
+    // 提交插件链执行请求，被拒绝或执行器已停止时返回false
+    bool submit(const std::string& chain_name,
+               std::shared_ptr<PluginData> input_data,
+               std::shared_ptr<PluginResult> output_result,
+               std::future<bool>& result);
+    bool submit(const std::string& chain_name,
+               std::shared_ptr<PluginData> input_data,
+               std::shared_ptr<PluginResult> output_result,
+               Completion on_complete);
+
+    // 提交任意任务，与插件链请求共用队列和并发上限。
+    // ordering_key非空时与同一键的请求按提交顺序执行，为空时不保证顺序
+    bool submitTask(std::function<void()> task);
+    bool submitTask(const std::string& ordering_key, std::function<void()> task);
+
+    // 停止接收新请求，等待已入队的请求执行完毕
+    void shutdown();
+
+    // 状态查询
+    size_t getQueueDepth() const { return queued_count_.load(); }
+    size_t getQueueCapacity() const { return queue_capacity_; }
+    size_t getWorkerCount() const { return max_concurrency_; }
+    uint64_t getRejectedCount() const { return rejected_count_.load(); }
+    uint64_t getCompletedCount() const { return completed_count_.load(); }
+
+private:
+    PluginChainManager& chain_manager_;
+    TaskScheduler& scheduler_;
+    OverflowPolicy overflow_policy_;
+    size_t queue_capacity_;
+    size_t max_concurrency_;
+    std::atomic<uint64_t> rejected_count_{0};
+    std::atomic<uint64_t> completed_count_{0};
+    std::once_flag shutdown_once_;
+
+    // 待取出的工作项：有序请求只记录键，请求本身在键队列中；无序任务直接携带
+    struct ReadyItem {
+        std::string key;
+        std::function<void()> task;
+    };
+
+    // 以下成员由queue_mutex_保护，queued_count_仅在持锁时修改
+    std::mutex queue_mutex_;
+    std::condition_variable not_full_;      // 有空位或关闭时通知阻塞的提交方
+    std::condition_variable idle_;          // 排空任务全部退出时通知shutdown
+    std::unordered_map<std::string, std::deque<std::function<void()>>> key_queues_;  // 存在即表示该键已在就绪队列或正被执行
+    std::deque<ReadyItem> ready_;
+    std::atomic<size_t> queued_count_{0};
+    size_t active_drainers_ = 0;
+    bool closed_ = false;
+
+    bool enqueue(const std::string& ordering_key, std::function<void()> task);
+    void drainQueue();
+};
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 64位内容哈希计算器
+ *
+ * 按XXH64算法流式计算，每32字节只需四次乘法，适合对振动波形等大块数据求指纹。
+ * 字符串和容器按长度前缀写入，不同字段组合不会因拼接产生相同的字节序列
+ */
+class ContentHasher {
+public:
+    explicit ContentHasher(uint64_t seed = 0);
+
+    // 写入原始字节
+    void update(const void* data, size_t length);
+
+    // 写入基本类型和容器
+    void update(uint64_t value);
+    void update(int value);
+    void update(double value);
+    void update(const std::string& value);
+    void update(const std::vector<double>& values);
+    void update(const std::map<std::string, double>& values);
+    void update(const std::map<std::string, std::string>& values);
+
+    // 获取当前哈希值，不影响继续写入
+    uint64_t digest() const;
+
+    // 计算一段字节的哈希值
+    static uint64_t hash(const void* data, size_t length, uint64_t seed = 0);
+
+private:
+    uint64_t seed_;
+    uint64_t accumulators_[4];
+    uint64_t total_length_ = 0;
+    unsigned char buffer_[32];
+    size_t buffer_size_ = 0;
+
+    void reset();
+};
+
+} // namespace AlgorithmPlugins
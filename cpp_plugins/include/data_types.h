@@ -56,6 +56,9 @@ public:
         auto it = custom_features_.find(key);
         return (it != custom_features_.end()) ? it->second : 0.0;
     }
+    const std::map<std::string, double>& getCustomFeatures() const {
+        return custom_features_;
+    }
     
     // 扩展数据
     void setExtendData(const std::string& key, const std::string& value) {
@@ -65,6 +68,9 @@ public:
         auto it = extend_data_.find(key);
         return (it != extend_data_.end()) ? it->second : "";
     }
+    const std::map<std::string, std::string>& getExtendDataMap() const {
+        return extend_data_;
+    }
     
     // PluginData接口实现
     DataType getType() const override { return DataType::REAL_TIME; }
@@ -72,6 +78,7 @@ public:
     std::string getDeviceId() const override { return device_id_; }
     std::string serialize() const override;
     bool deserialize(const std::string& data) override;
+    bool getContentHash(uint64_t& hash) const override;
 
 private:
     std::string device_id_;
@@ -136,6 +143,7 @@ public:
     std::string getDeviceId() const override { return device_id_; }
     std::string serialize() const override;
     bool deserialize(const std::string& data) override;
+    bool getContentHash(uint64_t& hash) const override;
 
 private:
     std::string device_id_;
@@ -176,12 +184,20 @@ public:
         return features_;
     }
     
+    // 复用对象时重置设备、时间戳并清空特征
+    void reset(const std::string& deviceId, std::chrono::system_clock::time_point timestamp) {
+        device_id_ = deviceId;
+        timestamp_ = timestamp;
+        features_.clear();
+    }
+    
     // PluginData接口实现
     DataType getType() const override { return DataType::FEATURE_DATA; }
     std::chrono::system_clock::time_point getTimestamp() const override { return timestamp_; }
     std::string getDeviceId() const override { return device_id_; }
     std::string serialize() const override;
     bool deserialize(const std::string& data) override;
+    bool getContentHash(uint64_t& hash) const override;
 
 private:
     std::string device_id_;
@@ -213,6 +229,9 @@ public:
         auto it = status_mapping_.find(status);
         return (it != status_mapping_.end()) ? it->second : "Unknown";
     }
+    const std::map<int, std::string>& getStatusMapping() const {
+        return status_mapping_;
+    }
     
     // PluginData接口实现
     DataType getType() const override { return DataType::STATUS_DATA; }
@@ -220,6 +239,7 @@ public:
     std::string getDeviceId() const override { return device_id_; }
     std::string serialize() const override;
     bool deserialize(const std::string& data) override;
+    bool getContentHash(uint64_t& hash) const override;
 
 private:
     std::string device_id_;
@@ -253,6 +273,17 @@ public:
     std::vector<std::string> getStringArray(const std::string& key) const;
     std::vector<double> getDoubleArray(const std::string& key) const;
     std::vector<int> getIntArray(const std::string& key) const;
+    
+    // 结果键值遍历，用于插件链中在节点间传递和合并结果
+    const std::map<std::string, std::string>& getAllStringData() const { return string_data_; }
+    const std::map<std::string, double>& getAllDoubleData() const { return double_data_; }
+    const std::map<std::string, int>& getAllIntData() const { return int_data_; }
+    
+    // 将全部结果写入目标结果对象，同名键被覆盖
+    void copyTo(PluginResult& target) const;
+    
+    // 清空全部结果，用于复用结果对象
+    void clear();
 
 private:
     std::map<std::string, std::string> string_data_;
@@ -2,6 +2,7 @@
 
 #include "plugin_base.h"
 #include "data_types.h"
+#include "device_state_store.h"
 #include <memory>
 #include <deque>
 
@@ -21,11 +22,25 @@ public:
     void cleanup() override;
     bool isInitialized() const override { return initialized_; }
     std::string getLastError() const override { return last_error_; }
+    bool process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) override;
+    bool processBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                      const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                      std::vector<bool>& succeeded) override;
+    
+    // 状态快照，保存各设备的状态历史，子类追加各自的设备状态
+    bool isStateful() const override { return true; }
+    bool saveState(StateWriter& writer, bool incremental) override;
+    bool loadState(StateReader& reader) override;
     
     // 状态识别核心接口
     virtual bool classifyStatus(std::shared_ptr<PluginData> input, 
                                std::shared_ptr<PluginResult> output) = 0;
     
+    // 批量状态识别，默认逐条调用classifyStatus，子类可重写为批量实现
+    virtual bool classifyStatusBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                     const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                     std::vector<bool>& succeeded);
+    
     // 获取支持的数据类型
     virtual std::vector<DataType> getSupportedInputTypes() const = 0;
     virtual DataType getOutputType() const = 0;
@@ -44,8 +59,13 @@ protected:
     // 参数验证
     virtual bool validateParameters() = 0;
     
-    // 状态历史管理
-    std::deque<int> status_history_;
+    // 切换当前设备，处理每条数据前调用，子类重写以同时切换各自的设备状态
+    virtual void selectDevice(DeviceHandle device);
+    void selectInputDevice(const PluginData& input);
+    
+    // 状态历史管理，各设备分别保存，status_history_指向当前设备的历史
+    DeviceStateStore<std::deque<int>> status_histories_;
+    std::deque<int>* status_history_;
     size_t max_history_size_ = 10;
     
     void addStatusToHistory(int status);
@@ -73,6 +93,15 @@ public:
     bool classifyStatus(std::shared_ptr<PluginData> input, 
                        std::shared_ptr<PluginResult> output) override;
     
+    // 批量状态识别，特征阈值判断按特征列批量计算，状态过渡按时间顺序逐条处理
+    bool classifyStatusBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                             const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                             std::vector<bool>& succeeded) override;
+    
+    // 状态快照，追加各设备的过渡状态
+    bool saveState(StateWriter& writer, bool incremental) override;
+    bool loadState(StateReader& reader) override;
+    
 protected:
     // 特征选择
     virtual std::vector<std::string> getSelectFeatures() const = 0;
@@ -92,6 +121,20 @@ protected:
     // 时序过渡处理
     virtual bool handleTimeSeriesTransition(int current_status, int previous_status) = 0;
     
+    // 特征状态计算
+    virtual int calculateFeatureStatus(double feature_value, const std::vector<double>& threshold);
+    
+    // 综合状态计算
+    virtual int calculateOverallStatus(const std::vector<int>& feature_statuses);
+    
+    // 置信度计算
+    double calculateConfidence(const std::vector<int>& feature_statuses);
+    
+    // 由各特征状态更新综合状态并写入结果，classifyStatus与批量接口共用
+    bool updateStatus(const std::vector<int>& feature_statuses,
+                      const std::map<int, std::string>& status_mapping,
+                      std::shared_ptr<PluginResult> output);
+    
     // 参数
     int offline_length_ = 3600;  // 离线重置时长（秒）
     int transition_status_ = 2;   // 过渡状态值
@@ -101,13 +144,21 @@ protected:
     int run_feature_num_ = 1;     // 运转特征数量
     int veto_index_ = -1;          // 一票否决权索引
     
-    // 状态历史
-    std::chrono::system_clock::time_point prev_time_;
-    std::chrono::system_clock::time_point time_point_[2]; // 关机、开机时间点
-    int transition_counter_ = 0;
-    int close_counter_ = 0;
-    int time_series_counter_ = 0;
-    int prev_status_ = -1;
+    // 单个设备的状态识别历史
+    struct ClassifyState {
+        std::chrono::system_clock::time_point prev_time;
+        std::chrono::system_clock::time_point time_point[2]; // 关机、开机时间点
+        int transition_counter = 0;
+        int close_counter = 0;
+        int time_series_counter = 0;
+        int prev_status = -1;
+    };
+    
+    // 各设备的状态识别历史，state_指向当前设备
+    DeviceStateStore<ClassifyState> classify_states_;
+    ClassifyState* state_;
+    
+    void selectDevice(DeviceHandle device) override;
     
     // 离线检测
     void offlineCheck(std::chrono::system_clock::time_point current_time);
@@ -192,6 +243,10 @@ public:
     std::map<int, std::string> getStatusMapping() const override {
         return status_mapping_;
     }
+    
+    // 状态快照，追加各设备的滑动窗口
+    bool saveState(StateWriter& writer, bool incremental) override;
+    bool loadState(StateReader& reader) override;
 
 protected:
     bool validateParameters() override;
@@ -208,8 +263,12 @@ private:
     std::vector<std::vector<int>> window_widths_;
     std::map<int, std::string> status_mapping_;
     
-    // 滑动窗口数据
-    std::vector<std::vector<std::deque<double>>> sliding_windows_;
+    // 滑动窗口数据，各设备分别保存，sliding_windows_指向当前设备的窗口
+    using SlidingWindows = std::vector<std::vector<std::deque<double>>>;
+    DeviceStateStore<SlidingWindows> window_states_;
+    SlidingWindows* sliding_windows_;
+    
+    void selectDevice(DeviceHandle device) override;
     
     // 统计量计算
     std::vector<double> extractStatistic(const std::map<std::string, double>& features);
@@ -221,6 +280,7 @@ private:
     int calculateOverallStatus(const std::vector<int>& feature_statuses);
     
     // 滑动窗口管理
+    void initializeSlidingWindows();
     void updateSlidingWindows(const std::vector<double>& stat_features);
     void clearSlidingWindows();
 };
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+// 设备句柄，由DeviceRegistry按注册顺序分配的稠密编号
+using DeviceHandle = uint32_t;
+
+/**
+ * @brief 设备注册表
+ *
+ * 为设备ID分配进程内唯一的稠密句柄，各插件以句柄为下标访问设备状态。
+ * 句柄分配后不再回收，空设备ID固定对应句柄0
+ */
+class DeviceRegistry {
+public:
+    static DeviceRegistry& getInstance();
+
+    // 获取设备句柄，设备首次出现时分配新句柄
+    DeviceHandle getHandle(const std::string& device_id);
+
+    // 查找已分配的句柄，不分配新句柄
+    bool findHandle(const std::string& device_id, DeviceHandle& handle) const;
+
+    // 获取句柄对应的设备ID，句柄无效时返回空字符串
+    std::string getDeviceId(DeviceHandle handle) const;
+
+    // 已分配的句柄数量
+    size_t size() const;
+
+private:
+    DeviceRegistry();
+
+    std::unordered_map<std::string, DeviceHandle> handles_;
+    std::vector<std::string> device_ids_;
+    mutable std::shared_mutex mutex_;
+};
+
+/**
+ * @brief 按设备划分的插件状态存储
+ *
+ * 以设备句柄为下标的稠密数组，按固定大小分块分配，状态对象地址在存储生命周期内保持不变。
+ * 槽位在首次访问时创建，一个插件实例可交替处理大量设备的数据而不混淆各设备的历史状态。
+ * 每次get()将槽位标记为已修改，供增量检查点只保存有变化的设备。
+ * 与插件实例一样不做加锁保护，由调用方保证同一时刻只有一个线程访问
+ */
+template <typename State>
+class DeviceStateStore {
+public:
+    DeviceStateStore() = default;
+
+    // 禁用拷贝构造和赋值，插件持有指向槽位的指针
+    DeviceStateStore(const DeviceStateStore&) = delete;
+    DeviceStateStore& operator=(const DeviceStateStore&) = delete;
+
+    // 获取设备状态，首次访问时创建默认状态，槽位标记为已修改
+    State& get(DeviceHandle device) {
+        const size_t chunk_index = device / kChunkSize;
+        if (chunk_index >= chunks_.size()) {
+            chunks_.resize(chunk_index + 1);
+        }
+
+        auto& chunk = chunks_[chunk_index];
+        if (!chunk) {
+            chunk = std::make_unique<Chunk>();
+        }
+
+        const size_t slot = device % kChunkSize;
+        if (!chunk->created[slot]) {
+            chunk->created[slot] = true;
+            ++size_;
+        }
+        chunk->dirty[slot] = true;
+        return chunk->states[slot];
+    }
+
+    // 查找设备状态，未创建时返回nullptr
+    State* find(DeviceHandle device) {
+        const size_t chunk_index = device / kChunkSize;
+        if (chunk_index >= chunks_.size() || !chunks_[chunk_index]) {
+            return nullptr;
+        }
+        const size_t slot = device % kChunkSize;
+        return chunks_[chunk_index]->created[slot] ? &chunks_[chunk_index]->states[slot] : nullptr;
+    }
+
+    // 将设备状态恢复为默认值，槽位保持已创建
+    void reset(DeviceHandle device) {
+        if (State* state = find(device)) {
+            *state = State();
+        }
+    }
+
+    // 将全部已创建的设备状态恢复为默认值，已获取的状态指针仍然有效
+    void resetAll() {
+        forEach([](DeviceHandle, State& state) { state = State(); });
+    }
+
+    // 已创建的设备状态数量
+    size_t size() const { return size_; }
+
+    // 按句柄顺序遍历已创建的设备状态
+    template <typename Func>
+    void forEach(Func&& func) {
+        for (size_t chunk_index = 0; chunk_index < chunks_.size(); ++chunk_index) {
+            auto& chunk = chunks_[chunk_index];
+            if (!chunk) {
+                continue;
+            }
+            for (size_t slot = 0; slot < kChunkSize; ++slot) {
+                if (chunk->created[slot]) {
+                    func(static_cast<DeviceHandle>(chunk_index * kChunkSize + slot), chunk->states[slot]);
+                }
+            }
+        }
+    }
+
+    // 按句柄顺序遍历上次clearDirty()之后访问过的设备状态
+    template <typename Func>
+    void forEachDirty(Func&& func) {
+        for (size_t chunk_index = 0; chunk_index < chunks_.size(); ++chunk_index) {
+            auto& chunk = chunks_[chunk_index];
+            if (!chunk) {
+                continue;
+            }
+            for (size_t slot = 0; slot < kChunkSize; ++slot) {
+                if (chunk->created[slot] && chunk->dirty[slot]) {
+                    func(static_cast<DeviceHandle>(chunk_index * kChunkSize + slot), chunk->states[slot]);
+                }
+            }
+        }
+    }
+
+    // 清除全部修改标记
+    void clearDirty() {
+        for (auto& chunk : chunks_) {
+            if (chunk) {
+                std::fill(std::begin(chunk->dirty), std::end(chunk->dirty), false);
+            }
+        }
+    }
+
+private:
+    // 每块包含的设备数，相邻句柄的状态连续存放
+    static constexpr size_t kChunkSize = 64;
+
+    struct Chunk {
+        State states[kChunkSize];
+        bool created[kChunkSize] = {};
+        bool dirty[kChunkSize] = {};
+    };
+
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    size_t size_ = 0;
+};
+
+} // namespace AlgorithmPlugins
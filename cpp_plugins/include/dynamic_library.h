@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 动态库句柄封装
+ *
+ * 负责插件共享库的打开、符号查找和卸载，析构时自动关闭句柄。
+ * 通过shared_ptr持有，库在最后一个引用释放后才会被卸载
+ */
+class DynamicLibrary {
+public:
+    // 库文件标识，用于判断同一路径上的文件是否已被替换
+    struct FileStamp {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        int64_t mtime_ns = 0;
+        uint64_t size = 0;
+
+        bool operator==(const FileStamp& other) const {
+            return device == other.device && inode == other.inode &&
+                   mtime_ns == other.mtime_ns && size == other.size;
+        }
+        bool operator!=(const FileStamp& other) const { return !(*this == other); }
+    };
+
+    ~DynamicLibrary();
+
+    // 禁用拷贝构造和赋值
+    DynamicLibrary(const DynamicLibrary&) = delete;
+    DynamicLibrary& operator=(const DynamicLibrary&) = delete;
+
+    // 打开动态库，lazy_binding对应RTLD_LAZY，失败时返回nullptr并设置error
+    static std::shared_ptr<DynamicLibrary> open(const std::string& file_path,
+                                                bool lazy_binding,
+                                                std::string& error);
+
+    // 从临时副本打开动态库，getPath仍返回file_path。
+    // dlopen按路径复用已加载的映像，原路径上的文件被替换后需从副本加载才能得到新代码
+    static std::shared_ptr<DynamicLibrary> openCopy(const std::string& file_path,
+                                                    bool lazy_binding,
+                                                    std::string& error);
+
+    // 查找导出符号，不存在时返回nullptr
+    void* getSymbol(const std::string& symbol_name) const;
+
+    // 获取库文件路径
+    const std::string& getPath() const { return path_; }
+
+    // 获取打开时库文件的标识
+    const FileStamp& getFileStamp() const { return stamp_; }
+
+    // 读取文件标识，文件不存在时返回false
+    static bool statFile(const std::string& file_path, FileStamp& stamp);
+
+    // 检查文件是否为当前平台的共享库（Linux下校验ELF头）
+    static bool isSharedLibrary(const std::string& file_path);
+
+    // 检查文件扩展名是否为共享库
+    static bool hasSharedLibraryExtension(const std::string& file_path);
+
+private:
+    DynamicLibrary(void* handle, const std::string& path, const FileStamp& stamp);
+
+    // 打开load_path处的库文件，记录为path
+    static std::shared_ptr<DynamicLibrary> openAs(const std::string& load_path,
+                                                  const std::string& path,
+                                                  const FileStamp& stamp,
+                                                  bool lazy_binding,
+                                                  std::string& error);
+
+    void* handle_ = nullptr;
+    std::string path_;
+    FileStamp stamp_;
+};
+
+} // namespace AlgorithmPlugins
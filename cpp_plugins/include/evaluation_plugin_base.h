@@ -2,6 +2,12 @@
 
 #include "plugin_base.h"
 #include "data_types.h"
+#include "device_state_store.h"
+#include "health_formula.h"
+#include "long_term_smoothing.h"
+#include "ring_buffer.h"
+#include "streaming_statistics.h"
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <map>
@@ -22,11 +28,20 @@ public:
     void cleanup() override;
     bool isInitialized() const override { return initialized_; }
     std::string getLastError() const override { return last_error_; }
+    bool process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) override;
+    bool processBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                      const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                      std::vector<bool>& succeeded) override;
     
     // 健康评估核心接口
     virtual bool evaluateHealth(std::shared_ptr<PluginData> input, 
                                std::shared_ptr<PluginResult> output) = 0;
     
+    // 批量健康评估，默认逐条调用evaluateHealth，子类可重写为批量实现
+    virtual bool evaluateHealthBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                     const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                     std::vector<bool>& succeeded);
+    
     // 获取支持的数据类型
     virtual std::vector<DataType> getSupportedInputTypes() const = 0;
     virtual DataType getOutputType() const = 0;
@@ -72,6 +87,16 @@ public:
     bool evaluateHealth(std::shared_ptr<PluginData> input, 
                        std::shared_ptr<PluginResult> output) override;
     
+    // 批量健康评估，特征统计与健康度配置在整批内只获取一次
+    bool evaluateHealthBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                             const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                             std::vector<bool>& succeeded) override;
+    
+    // 状态快照，保存各设备的特征缓存、预热进度和运行状态
+    bool isStateful() const override { return true; }
+    bool saveState(StateWriter& writer, bool incremental) override;
+    bool loadState(StateReader& reader) override;
+    
 protected:
     // 特征统计分析
     struct FeatureStat {
@@ -84,6 +109,7 @@ protected:
         std::map<std::string, std::string> clean_formula; // 清洗方法
         std::map<std::string, std::string> move_smooth_param; // 移动平滑参数
         std::map<std::string, std::string> long_smooth; // 长期平滑参数
+        LongSmoothSpec long_smooth_spec;  // 由long_smooth解析，初始化时确定
     };
     
     // 健康度配置
@@ -100,28 +126,51 @@ protected:
     // 健康度配置
     virtual std::vector<HealthConfig> getHealthConfigs() const = 0;
     
+    // 单个特征的历史数据，数值与写入时间一一对应，按写入顺序排列；
+    // statistics随历史数据增量更新，不需要清洗和平滑时可直接读取统计量；
+    // long_term为长期平滑状态，只做长期平滑的特征不保留原始数据
+    struct FeatureHistory {
+        RingBuffer<double> values;
+        RingBuffer<std::chrono::system_clock::time_point> times;
+        WindowStatistics statistics;
+        LongTermSmoother long_term;
+    };
+    
     // 核心计算方法
     virtual std::map<std::string, double> calculateFeatureHealth(const FeatureStat& stat,
-                                                                 const std::vector<double>& data) = 0;
+                                                                 const FeatureHistory& history) = 0;
     
     virtual std::map<std::string, double> calculateOverallHealth(const std::vector<HealthConfig>& configs,
                                                                 const std::map<std::string, double>& feature_scores) = 0;
     
-    // 数据缓存管理
-    std::map<std::string, std::vector<double>> feature_cache_;
-    std::map<std::string, std::vector<std::chrono::system_clock::time_point>> time_cache_;
-    std::map<std::string, double> last_health_scores_;
+    // 对一批数据的特征分数计算健康度，默认逐条调用calculateOverallHealth，子类可重写为向量化实现
+    virtual std::vector<std::map<std::string, double>> calculateOverallHealthBatch(
+        const std::vector<HealthConfig>& configs,
+        const std::vector<std::map<std::string, double>>& feature_scores);
+    
+    // 单个设备的数据缓存与状态
+    struct HealthState {
+        std::map<std::string, FeatureHistory> feature_history; // 按分析特征名称
+        std::map<std::string, double> last_health_scores;
+        int current_status = -1;
+        int close_count = 0;
+        int run_count = 0;
+        std::chrono::system_clock::time_point prev_time;
+    };
+    
+    // 各设备的数据缓存与状态，state_指向当前设备
+    DeviceStateStore<HealthState> health_states_;
+    HealthState* state_;
+    
+    // 切换当前设备，处理每条数据前调用
+    void selectDevice(DeviceHandle device);
     
     // 参数
     int offline_length_ = 86400 * 15;  // 离线重置时长（15天）
     int minimum_quantity_ = 30;         // 最小数据量
     int close_width_ = 1;               // 非关注状态持续时长
-    
-    // 状态管理
-    int current_status_ = -1;
-    int close_count_ = 0;
-    int run_count_ = 0;
-    std::chrono::system_clock::time_point prev_time_;
+    int history_capacity_ = 86400;      // 每个特征保留的最大数据条数
+    int history_window_ = 86400 * 15;   // 历史数据保留时长（秒），早于此的数据被淘汰
     
     // 离线检测
     void offlineCheck(std::chrono::system_clock::time_point current_time);
@@ -129,6 +178,36 @@ protected:
     // 状态检查和数据缓存
     bool statusCheckAndCacheData(std::shared_ptr<PluginData> input_data,
                                 std::chrono::system_clock::time_point current_time);
+    bool statusCheckAndCacheData(std::shared_ptr<PluginData> input_data,
+                                std::chrono::system_clock::time_point current_time,
+                                const std::vector<FeatureStat>& feature_stats);
+    
+    // 切换到数据所属设备并缓存数据，处于关注状态时计算各特征分数；返回false表示沿用上次结果
+    bool computeFeatureScores(std::shared_ptr<PluginData> input,
+                              const std::vector<FeatureStat>& feature_stats,
+                              std::map<std::string, double>& stat_scores);
+    
+    // 使用给定配置评估单条数据
+    bool evaluateWithConfigs(std::shared_ptr<PluginData> input,
+                            std::shared_ptr<PluginResult> output,
+                            const std::vector<FeatureStat>& feature_stats,
+                            const std::vector<HealthConfig>& health_configs);
+    
+    // 同一分析特征的所有统计共用一份历史，缓存参数按这些统计汇总：
+    // 任一统计需要窗口数据即保留原始数据，任一统计使用中位数即维护中位数
+    struct HistorySettings {
+        size_t capacity = 0;
+        bool track_median = false;
+        const LongSmoothSpec* long_smooth = nullptr;
+    };
+    HistorySettings historySettings(const std::vector<FeatureStat>& feature_stats, const std::string& feature) const;
+    
+    // 共用历史的统计须使用相同的长期平滑参数，不一致时设置错误并返回false
+    bool validateFeatureStats(const std::vector<FeatureStat>& feature_stats);
+    
+    // 追加一条特征数据并淘汰超出保留时长的历史，同步更新增量统计量
+    void appendHistory(FeatureHistory& history, const HistorySettings& settings, double value,
+                       std::chrono::system_clock::time_point time);
     
     // 重置缓存
     void resetCache(bool all_cache = true);
@@ -152,7 +231,8 @@ public:
         return {"feature_stats", "healths"};
     }
     std::vector<std::string> getOptionalParameters() const override {
-        return {"offline_length", "minimum_quantity", "close_width"};
+        return {"offline_length", "minimum_quantity", "close_width", "history_capacity", "history_window",
+                "health_formulas"};
     }
     
     std::vector<std::string> getHealthDefinitions() const override;
@@ -163,22 +243,35 @@ protected:
     std::vector<FeatureStat> getFeatureStats() const override;
     std::vector<HealthConfig> getHealthConfigs() const override;
     std::map<std::string, double> calculateFeatureHealth(const FeatureStat& stat,
-                                                        const std::vector<double>& data) override;
+                                                        const FeatureHistory& history) override;
     std::map<std::string, double> calculateOverallHealth(const std::vector<HealthConfig>& configs,
                                                         const std::map<std::string, double>& feature_scores) override;
+    std::vector<std::map<std::string, double>> calculateOverallHealthBatch(
+        const std::vector<HealthConfig>& configs,
+        const std::vector<std::map<std::string, double>>& feature_scores) override;
     
 private:
     std::vector<FeatureStat> feature_stats_;
     std::vector<HealthConfig> health_configs_;
+    
+    // 非weighted_average的健康度公式在初始化时编译，按健康度名称索引；各公式共用一张变量表
+    FormulaSymbols formula_symbols_;
+    std::map<std::string, HealthFormula> health_formulas_;
+    std::vector<double> formula_slots_;  // 单点求值的槽位缓冲区
+    
+    // 解析health_formulas参数（格式为"名称=表达式;名称=表达式"）并编译全部公式
+    bool compileHealthFormulas(const std::string& formulas_str);
+    
+    // 按特征分数对公式单点求值，缺失的特征为NaN，结果无效时返回默认分数
+    double evaluateFormula(const HealthFormula& formula, const std::map<std::string, double>& feature_scores);
     std::vector<std::string> health_definitions_;
     std::vector<int> default_scores_;
     
     // 统计量计算
     double calculateStatistic(const std::vector<double>& data, const std::string& method);
     
-    // 数据清洗
-    std::vector<double> cleanData(const std::vector<double>& data, 
-                                 const std::map<std::string, std::string>& clean_formula);
+    // 数据清洗，原地修改
+    void cleanData(std::vector<double>& data, const std::map<std::string, std::string>& clean_formula);
     
     // 平滑处理
     std::vector<double> smoothData(const std::vector<double>& data,
@@ -186,6 +279,9 @@ private:
     
     // 分数转换
     double convertToScore(double value, const std::vector<double>& thresholds, double upper_limit);
+    
+    // 加入各统计方法分数的平均值作为result_key的综合分数
+    void addAverageScore(const std::string& result_key, std::map<std::string, double>& scores);
 };
 
 /**
@@ -208,6 +304,11 @@ public:
     bool evaluateHealth(std::shared_ptr<PluginData> input, 
                        std::shared_ptr<PluginResult> output) override;
     
+    // 状态快照，保存各设备的长期平滑状态
+    bool isStateful() const override { return true; }
+    bool saveState(StateWriter& writer, bool incremental) override;
+    bool loadState(StateReader& reader) override;
+    
 protected:
     // 错误检测配置
     struct ErrorConfig {
@@ -215,6 +316,7 @@ protected:
         std::vector<double> thresholds;  // 阈值
         double upper_limit;              // 上限
         std::map<std::string, std::string> smooth_param; // 平滑参数
+        LongSmoothSpec long_smooth;      // 长期平滑参数
         int error_width;                 // 错误宽度
     };
     
@@ -233,6 +335,10 @@ protected:
     std::map<std::string, std::vector<double>> feature_cache_;
     std::map<std::string, double> last_scores_;
     
+    // 各设备按特征名称的长期平滑状态
+    using LongTermStates = std::map<std::string, LongTermSmoother>;
+    DeviceStateStore<LongTermStates> long_term_states_;
+    
     // 平滑处理
     std::vector<double> smoothData(const std::vector<double>& data,
                                  const std::map<std::string, std::string>& smooth_param);
@@ -273,6 +379,7 @@ private:
     std::vector<double> upper_limits_;
     std::map<std::string, std::string> move_smooth_param_;
     std::map<std::string, std::string> long_smooth_;
+    LongSmoothSpec long_smooth_spec_;
     
     std::vector<std::string> health_definitions_;
     std::vector<int> default_scores_;
@@ -2,6 +2,7 @@
 
 #include "plugin_base.h"
 #include "data_types.h"
+#include "device_state_store.h"
 #include <memory>
 #include <vector>
 #include <map>
@@ -38,6 +39,7 @@ public:
     void cleanup() override;
     bool isInitialized() const override { return initialized_; }
     std::string getLastError() const override { return last_error_; }
+    bool process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) override;
     
     // 事件处理核心接口
     virtual bool processEvent(std::shared_ptr<PluginData> input, 
@@ -93,6 +95,11 @@ public:
                      std::shared_ptr<PluginResult> output) override;
     
     EventType getEventType() const override { return EventType::SCORE_ALARM; }
+    
+    // 状态快照，保存各设备的报警计数和上次报警时间
+    bool isStateful() const override { return true; }
+    bool saveState(StateWriter& writer, bool incremental) override;
+    bool loadState(StateReader& reader) override;
 
 protected:
     // 健康度定义
@@ -108,10 +115,16 @@ protected:
     int tolerable_length_ = 5;      // 可容忍时长
     int alarm_interval_ = 180;       // 报警间隔（秒）
     
-    // 报警状态管理
-    std::map<std::string, std::chrono::system_clock::time_point> last_alarm_time_;
-    std::map<std::string, int> alarm_count_;
-    std::map<std::string, int> tolerable_count_;
+    // 单个设备的报警状态
+    struct AlarmState {
+        std::map<std::string, std::chrono::system_clock::time_point> last_alarm_time;
+        std::map<std::string, int> alarm_count;
+        std::map<std::string, int> tolerable_count;
+    };
+    
+    // 各设备的报警状态，state_指向当前设备
+    DeviceStateStore<AlarmState> alarm_states_;
+    AlarmState* state_;
     
     // 检查是否应该触发报警
     bool shouldTriggerAlarm(const std::string& health_name, double score);
@@ -178,6 +191,11 @@ public:
                      std::shared_ptr<PluginResult> output) override;
     
     EventType getEventType() const override { return EventType::STATUS_ALARM; }
+    
+    // 状态快照，保存各设备的报警计数和上次报警时间
+    bool isStateful() const override { return true; }
+    bool saveState(StateWriter& writer, bool incremental) override;
+    bool loadState(StateReader& reader) override;
 
 protected:
     // 状态报警配置
@@ -190,9 +208,17 @@ protected:
     // 参数
     bool alarm_enabled_ = true;
     
-    // 报警状态管理
-    std::map<int, std::chrono::system_clock::time_point> last_alarm_time_;
-    std::map<int, int> alarm_count_;
+    // 单个设备的状态报警记录
+    struct StatusAlarmState {
+        std::map<int, std::chrono::system_clock::time_point> last_alarm_time;
+        std::map<int, int> alarm_count;
+    };
+    
+    // 各设备的状态报警记录，state_指向当前设备
+    DeviceStateStore<StatusAlarmState> alarm_states_;
+    StatusAlarmState* state_;
+    
+    // 报警规则
     std::map<int, int> max_alarm_num_;
     std::map<int, int> recovery_reset_time_;
     std::map<int, int> force_reset_time_;
@@ -20,11 +20,20 @@ public:
     void cleanup() override;
     bool isInitialized() const override { return initialized_; }
     std::string getLastError() const override { return last_error_; }
+    bool process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) override;
+    bool processBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                      const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                      std::vector<bool>& succeeded) override;
     
     // 特征提取核心接口
     virtual bool extractFeatures(std::shared_ptr<PluginData> input, 
                                  std::shared_ptr<PluginResult> output) = 0;
     
+    // 批量特征提取，默认逐条调用extractFeatures，子类可重写为批量实现
+    virtual bool extractFeaturesBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                      const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                      std::vector<bool>& succeeded);
+    
     // 获取支持的数据类型
     virtual std::vector<DataType> getSupportedInputTypes() const = 0;
     virtual DataType getOutputType() const = 0;
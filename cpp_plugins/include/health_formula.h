@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 公式变量表
+ *
+ * 把公式中引用的特征名称映射为稠密槽位，同一插件的多个公式共用一张表，
+ * 求值时按槽位一次性取出各特征的值
+ */
+class FormulaSymbols {
+public:
+    // 获取名称对应的槽位，首次出现时分配
+    size_t slot(const std::string& name);
+
+    bool find(const std::string& name, size_t& slot) const;
+
+    const std::vector<std::string>& names() const { return names_; }
+    size_t size() const { return names_.size(); }
+
+private:
+    std::unordered_map<std::string, size_t> slots_;
+    std::vector<std::string> names_;
+};
+
+/**
+ * @brief 编译后的健康度公式
+ *
+ * 支持数值、特征名称、+ - * / ^、一元负号、括号，以及函数min、max、avg（任意个参数）、
+ * abs、sqrt和clamp(x, lo, hi)。特征名称由字母、数字、下划线和点组成。
+ * 编译时做常量折叠并把特征名称解析为槽位，生成栈式字节码；求值时不再做名称查找和内存分配。
+ * 缺失的特征以NaN表示，参与运算后结果为NaN，由调用方决定默认值
+ */
+class HealthFormula {
+public:
+    // 表达式嵌套的上限，求值栈按此大小在栈上分配
+    static constexpr size_t kMaxStackDepth = 64;
+
+    // 编译表达式，变量槽位登记到symbols；失败时error给出原因和位置
+    bool compile(const std::string& expression, FormulaSymbols& symbols, std::string& error);
+
+    // 单点求值，slots按FormulaSymbols的槽位排列
+    double evaluate(const double* slots) const;
+
+    // 列式批量求值：第s个变量的第i个值位于slots[s * count + i]，results写入count个结果。
+    // 每条指令对整列执行一次，适合对多台设备或多个时间点同时评分
+    void evaluateBatch(const double* slots, size_t count, double* results) const;
+
+    // 引用的变量槽位（去重，按首次出现顺序）
+    const std::vector<size_t>& getReferencedSlots() const { return referenced_slots_; }
+
+    bool isCompiled() const { return !code_.empty(); }
+    bool isConstant() const;
+    size_t getInstructionCount() const { return code_.size(); }
+
+private:
+    enum class OpCode : uint8_t {
+        CONST,  // 压入常量，operand为常量下标
+        LOAD,   // 压入变量，operand为槽位
+        ADD,
+        SUB,
+        MUL,
+        DIV,
+        POW,
+        NEG,
+        ABS,
+        SQRT,
+        MIN,    // operand为参数个数
+        MAX,
+        AVG,
+        CLAMP
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint32_t operand;
+    };
+
+    struct Node;
+    class Parser;
+
+    std::vector<Instruction> code_;
+    std::vector<double> constants_;
+    std::vector<size_t> referenced_slots_;
+    size_t stack_depth_ = 0;
+
+    void emit(const Node& node, size_t depth);
+
+    // 对count个操作数执行op，常量折叠和单点求值共用
+    static double applyScalar(OpCode op, const double* args, size_t count);
+};
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 对数分桶的延迟直方图
+ *
+ * 按2的幂划分区间，每个区间再等分为32个子桶，相对误差不超过1/32。
+ * 记录为常数时间的无锁原子递增，可在一个线程记录的同时由其他线程读取或合并
+ */
+class LatencyHistogram {
+public:
+    // 每个2的幂区间的子桶数
+    static constexpr size_t kSubBucketBits = 5;
+    static constexpr size_t kSubBucketCount = size_t(1) << kSubBucketBits;
+
+    // 可记录的最大值位数，更大的值计入最后一个桶（以纳秒计约18分钟）
+    static constexpr size_t kMaxValueBits = 40;
+    static constexpr uint64_t kMaxValue = (uint64_t(1) << kMaxValueBits) - 1;
+
+    static constexpr size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+    LatencyHistogram();
+
+    // 拷贝得到当前计数的快照
+    LatencyHistogram(const LatencyHistogram& other);
+    LatencyHistogram& operator=(const LatencyHistogram& other);
+
+    void record(uint64_t value);
+
+    // 累加另一个直方图的计数
+    void merge(const LatencyHistogram& other);
+
+    void reset();
+
+    uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+
+    // 分位数（0~1），返回所在桶的上界，没有数据时返回0
+    uint64_t getPercentile(double quantile) const;
+
+    // 不超过各上限的累计计数，bounds须升序；跨越上限的桶不计入，一次遍历完成
+    void getCumulativeCounts(const std::vector<uint64_t>& bounds, std::vector<uint64_t>& counts) const;
+
+    // 值对应的桶下标及桶的取值范围
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketLowerBound(size_t index);
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+    std::atomic<uint64_t> count_{0};
+};
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 有界无锁多生产者多消费者队列
+ *
+ * 基于按序号标记的环形缓冲区（Vyukov算法），入队和出队各只需一次CAS，
+ * 队列满或空时立即返回false，由调用方决定等待方式。容量向上取整为2的幂
+ */
+template <typename T>
+class LockFreeQueue {
+public:
+    explicit LockFreeQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 禁用拷贝构造和赋值
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    // 队列已满时返回false，item保持不变
+    bool tryPush(T& item) {
+        size_t position = enqueue_position_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[position & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                            std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = enqueue_position_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(item);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 队列为空时返回false
+    bool tryPop(T& item) {
+        size_t position = dequeue_position_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[position & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (diff == 0) {
+                if (dequeue_position_.compare_exchange_weak(position, position + 1,
+                                                            std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = dequeue_position_.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = std::move(cell->data);
+        cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似元素数量，并发修改时仅供监控使用
+    size_t size() const {
+        size_t enqueued = enqueue_position_.load(std::memory_order_relaxed);
+        size_t dequeued = dequeue_position_.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    // 入队与出队位置分处不同缓存行，避免生产者和消费者互相干扰
+    static constexpr size_t kCacheLineSize = 64;
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(kCacheLineSize) std::atomic<size_t> enqueue_position_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> dequeue_position_{0};
+};
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+class StateWriter;
+class StateReader;
+
+/**
+ * @brief 长期平滑函数
+ */
+enum class LongSmoothFunction {
+    NONE,           // 不平滑
+    EWMA,           // 指数加权移动平均
+    HOLT,           // Holt线性趋势（水平加趋势的双指数平滑）
+    DECAYED_MIN,    // 衰减最小值：新低立即跟随，之后按速率回升到当前值
+    DECAYED_MAX     // 衰减最大值：新高立即跟随，之后按速率回落到当前值
+};
+
+/**
+ * @brief 长期平滑参数
+ *
+ * 由long_smooth参数表解析：func为ewma、holt、decayed_min或decayed_max。
+ * half_life给出以秒为单位的半衰期，按相邻数据的时间间隔衰减，采样不均匀时仍保持同样的时间尺度；
+ * 未给出时按数据条数衰减，平滑系数取alpha，或由win_length取2/(win_length+1)。
+ * half_life和alpha可用逗号分隔多个值，同时维护多个速率的结果。
+ * holt的趋势半衰期为trend_half_life（或趋势系数beta），缺省与水平相同；
+ * horizon为结果向前外推的时长（秒或数据条数）
+ */
+struct LongSmoothSpec {
+    LongSmoothFunction function = LongSmoothFunction::NONE;
+    std::vector<double> rates;      // 按时间衰减时为半衰期（秒），否则为平滑系数
+    bool time_based = false;
+    double trend_rate = 0.0;        // 趋势的半衰期或平滑系数，0表示与水平相同
+    double horizon = 0.0;
+
+    static LongSmoothSpec parse(const std::map<std::string, std::string>& params);
+
+    bool enabled() const { return function != LongSmoothFunction::NONE && !rates.empty(); }
+
+    // 第rate个速率在经过elapsed（秒或数据条数）后新数据的权重
+    double coefficient(size_t rate, double elapsed) const;
+    double trendCoefficient(size_t rate, double elapsed) const;
+};
+
+/**
+ * @brief 长期平滑状态
+ *
+ * 每个速率只保存当前的水平（及holt的趋势），状态大小与平滑时长无关，不需要保留原始数据。
+ * 参数由调用方保存并在每次调用时传入，同一状态须始终使用同一组参数；速率个数或函数变化时重新开始
+ */
+class LongTermSmoother {
+public:
+    void update(const LongSmoothSpec& spec, double value, std::chrono::system_clock::time_point time);
+    void clear();
+
+    uint64_t count() const { return count_; }
+
+    // 第rate个速率的平滑结果，没有数据时为0；holt为向前外推horizon后的值
+    double value(const LongSmoothSpec& spec, size_t rate = 0) const;
+
+    void save(StateWriter& writer) const;
+    bool load(StateReader& reader);
+
+private:
+    std::vector<double> levels_;
+    std::vector<double> trends_;
+    uint64_t count_ = 0;
+    std::chrono::system_clock::time_point last_time_;
+};
+
+} // namespace AlgorithmPlugins
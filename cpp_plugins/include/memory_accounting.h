@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 一个内存账户的分配统计快照
+ */
+struct MemoryUsage {
+    uint64_t bytes_allocated = 0;    // 累计分配字节数
+    uint64_t bytes_freed = 0;        // 累计释放字节数
+    uint64_t allocation_count = 0;   // 分配次数
+    uint64_t free_count = 0;         // 释放次数
+    uint64_t peak_live_bytes = 0;    // 账户内存活字节数的峰值
+
+    // 分配后未释放的字节数，执行结束后仍为正说明插件保留或泄漏了内存
+    int64_t retainedBytes() const {
+        return static_cast<int64_t>(bytes_allocated) - static_cast<int64_t>(bytes_freed);
+    }
+};
+
+/**
+ * @brief 内存账户
+ *
+ * 由执行器在插件调用或一次请求期间通过MemoryAccountScope安装为当前线程的账户，
+ * 期间经全局operator new/delete的分配和释放记入该账户及其所有上级账户。
+ * 可被多个线程同时记录（DAG并行分支），账户的生命周期须覆盖所有安装它的作用域。
+ * 释放记入释放时所在线程的当前账户，跨线程移交的内存在原账户中表现为保留
+ */
+class MemoryAccount {
+public:
+    // parent为上级账户，下级账户的记录同时计入上级
+    explicit MemoryAccount(MemoryAccount* parent = nullptr) : parent_(parent) {}
+
+    // 禁用拷贝构造和赋值
+    MemoryAccount(const MemoryAccount&) = delete;
+    MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+    void recordAllocation(size_t bytes);
+    void recordDeallocation(size_t bytes);
+
+    MemoryUsage getUsage() const;
+    MemoryAccount* getParent() const { return parent_; }
+
+    // 当前线程的账户，未安装时为nullptr
+    static MemoryAccount* current();
+
+    // 是否编译了分配钩子，未编译时账户不会收到任何记录。
+    // 静态库由ENABLE_ALLOCATION_TRACKING控制，共享库由ENABLE_SHARED_ALLOCATION_TRACKING控制，默认均关闭
+    static bool isAllocationTrackingEnabled();
+
+private:
+    friend class MemoryAccountScope;
+
+    MemoryAccount* const parent_;
+    std::atomic<uint64_t> bytes_allocated_{0};
+    std::atomic<uint64_t> bytes_freed_{0};
+    std::atomic<uint64_t> allocation_count_{0};
+    std::atomic<uint64_t> free_count_{0};
+    std::atomic<int64_t> live_bytes_{0};
+    std::atomic<uint64_t> peak_live_bytes_{0};
+
+    static void setCurrent(MemoryAccount* account);
+};
+
+/**
+ * @brief 在当前线程安装内存账户，析构时恢复之前的账户
+ *
+ * 任务提交到其他线程时复制MemoryAccount::current()，并在任务内安装；传入nullptr暂停记录
+ */
+class MemoryAccountScope {
+public:
+    explicit MemoryAccountScope(MemoryAccount* account) : saved_(MemoryAccount::current()) {
+        MemoryAccount::setCurrent(account);
+    }
+
+    ~MemoryAccountScope() {
+        MemoryAccount::setCurrent(saved_);
+    }
+
+    MemoryAccountScope(const MemoryAccountScope&) = delete;
+    MemoryAccountScope& operator=(const MemoryAccountScope&) = delete;
+
+private:
+    MemoryAccount* saved_;
+};
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "plugin_manager.h"
+#include "async_chain_executor.h"
+#include "pipelined_chain_executor.h"
+#include "result_cache.h"
+#include "task_scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief OpenMetrics指标导出器
+ *
+ * 将插件执行统计与延迟直方图、链节点延迟、执行器队列深度、调度器占用和进程内存
+ * 渲染为OpenMetrics文本格式，可定期写入文件或由本地HTTP端口供Prometheus抓取。
+ * 导出器只持有各数据源的指针，数据源的生命周期须长于导出器或在销毁前移除
+ */
+class OpenMetricsExporter {
+public:
+    // prefix为指标名前缀
+    explicit OpenMetricsExporter(const std::string& prefix = "algorithm_plugins");
+    ~OpenMetricsExporter();
+
+    // 禁用拷贝构造和赋值
+    OpenMetricsExporter(const OpenMetricsExporter&) = delete;
+    OpenMetricsExporter& operator=(const OpenMetricsExporter&) = delete;
+
+    // 数据源注册，name作为指标标签区分同类数据源，传入nullptr移除
+    void setMonitor(const PluginMonitorManager* monitor);
+    void setScheduler(const TaskScheduler* scheduler);
+    void setAsyncExecutor(const std::string& name, const AsyncChainExecutor* executor);
+    void setPipeline(const std::string& name, const PipelinedChainExecutor* pipeline);
+    void setResultCache(const std::string& name, const ResultCache* cache);
+
+    // 渲染当前全部指标
+    std::string render() const;
+
+    // 原子地写入文件（先写临时文件再重命名）
+    bool writeToFile(const std::string& file_path) const;
+
+    // 按间隔在后台线程写入文件
+    bool startFileExport(const std::string& file_path, std::chrono::milliseconds interval);
+
+    // 在本地地址启动HTTP监听，GET /metrics返回指标；port为0时由系统分配端口
+    bool startHttpServer(uint16_t port, const std::string& address = "127.0.0.1");
+    uint16_t getHttpPort() const { return http_port_.load(); }
+
+    // 停止后台文件导出和HTTP监听
+    void stop();
+
+    std::string getLastError() const;
+
+private:
+    std::string prefix_;
+
+    // 数据源
+    mutable std::mutex sources_mutex_;
+    const PluginMonitorManager* monitor_ = nullptr;
+    const TaskScheduler* scheduler_ = nullptr;
+    std::map<std::string, const AsyncChainExecutor*> async_executors_;
+    std::map<std::string, const PipelinedChainExecutor*> pipelines_;
+    std::map<std::string, const ResultCache*> result_caches_;
+
+    // 后台线程
+    std::mutex stop_mutex_;
+    std::condition_variable stop_signal_;
+    std::atomic<bool> stopping_{false};
+    std::thread file_thread_;
+    std::thread http_thread_;
+    int listen_socket_ = -1;
+    std::atomic<uint16_t> http_port_{0};
+
+    mutable std::mutex error_mutex_;
+    mutable std::string last_error_;
+
+    void setError(const std::string& error) const;
+    void fileExportLoop(std::string file_path, std::chrono::milliseconds interval);
+    void httpServerLoop();
+    void handleHttpConnection(int client_socket) const;
+};
+
+} // namespace AlgorithmPlugins
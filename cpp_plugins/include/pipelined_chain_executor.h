@@ -0,0 +1,119 @@
+#pragma once
+
+#include "plugin_base.h"
+#include "plugin_manager.h"
+#include "lock_free_queue.h"
+#include "trace_span.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 插件链流水线执行器
+ *
+ * 串行链的每个插件作为一级流水线，各级拥有独立的无锁队列和工作线程，
+ * 第k条数据进入下一级后本级即可处理第k+1条数据。每级只有一个工作线程且队列先进先出，
+ * 同一设备的数据按提交顺序经过各级并按序完成；某级失败的数据跳过后续插件，但仍按序完成。
+ * 每级只持有一个插件实例，由本级工作线程独占，插件热替换后在下一条数据到达时重建实例。
+ * 流水线实例与PluginChainManager的实例互相独立，因此不支持有状态插件，启动时拒绝；
+ * 也不使用纯插件结果缓存。设置监控后各级执行时间按"链/插件"记录，提交时的追踪上下文随数据传递到各级
+ */
+class PipelinedChainExecutor {
+public:
+    // 完成回调，在最后一级的工作线程中调用
+    using Completion = std::function<void(bool success, std::shared_ptr<PluginResult> output_result)>;
+
+    // queue_capacity为每级队列容量
+    explicit PipelinedChainExecutor(size_t queue_capacity = 256);
+    ~PipelinedChainExecutor();
+
+    // 禁用拷贝构造和赋值
+    PipelinedChainExecutor(const PipelinedChainExecutor&) = delete;
+    PipelinedChainExecutor& operator=(const PipelinedChainExecutor&) = delete;
+
+    // 按链配置启动流水线，仅支持未配置数据映射、不含有状态插件的串行链
+    bool start(const PluginChainManager::ChainConfig& config);
+    
+    // 各级执行时间监控，nullptr关闭。monitor的生命周期须长于本执行器
+    void setMonitor(PluginMonitorManager* monitor) { monitor_ = monitor; }
+
+    // 提交数据，流水线未运行或第一级队列已满时返回false
+    bool submit(std::shared_ptr<PluginData> input_data,
+               std::shared_ptr<PluginResult> output_result,
+               Completion on_complete);
+    bool submit(std::shared_ptr<PluginData> input_data,
+               std::shared_ptr<PluginResult> output_result,
+               std::future<bool>& result);
+
+    // 停止接收新数据，等待已提交的数据全部完成后停止各级工作线程
+    void stop();
+
+    // 状态查询
+    bool isRunning() const { return accepting_.load(); }
+    size_t getStageCount() const { return stages_.size(); }
+    size_t getQueueDepth(size_t stage_index) const;
+    size_t getInFlightCount() const { return in_flight_.load(); }
+    std::string getLastError() const { return last_error_; }
+
+private:
+    // 流水线中流转的单条数据
+    struct PipelineItem {
+        std::shared_ptr<PluginData> input_data;
+        std::shared_ptr<PluginResult> output_result;
+        Completion on_complete;
+        TraceContext trace_context;
+        bool failed = false;
+    };
+
+    // 一级流水线
+    struct Stage {
+        explicit Stage(size_t queue_capacity) : queue(queue_capacity) {}
+
+        std::string plugin_name;
+        std::string stage_key;
+        std::shared_ptr<PluginParameter> params;
+        LockFreeQueue<std::unique_ptr<PipelineItem>> queue;
+        std::thread worker;
+
+        // 队列为空时工作线程在此等待
+        std::mutex wait_mutex;
+        std::condition_variable ready;
+        std::atomic<bool> waiting{false};
+
+        // 以下状态在启动后仅由本级工作线程访问
+        std::shared_ptr<IPlugin> plugin;
+        uint64_t registry_generation = 0;
+        uint64_t plugin_generation = 0;
+    };
+
+    size_t queue_capacity_;
+    PluginChainManager::ChainConfig config_;
+    std::vector<std::unique_ptr<Stage>> stages_;
+    std::string last_error_;
+    std::atomic<PluginMonitorManager*> monitor_{nullptr};
+
+    std::atomic<bool> accepting_{false};
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> in_flight_{0};
+    std::mutex drain_mutex_;
+    std::condition_variable drained_;
+
+    void setError(const std::string& error) { last_error_ = error; }
+
+    void stageLoop(size_t stage_index);
+    void pushToStage(size_t stage_index, std::unique_ptr<PipelineItem> item);
+    void wakeStage(Stage& stage);
+    void releaseInFlight();
+    bool executeStage(Stage& stage, PipelineItem& item);
+    std::shared_ptr<IPlugin> acquirePlugin(Stage& stage);
+};
+
+} // namespace AlgorithmPlugins
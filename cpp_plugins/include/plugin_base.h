@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 
 namespace AlgorithmPlugins {
@@ -13,6 +14,8 @@ namespace AlgorithmPlugins {
 class PluginData;
 class PluginResult;
 class PluginParameter;
+class StateWriter;
+class StateReader;
 
 /**
  * @brief 插件数据类型枚举
@@ -55,6 +58,9 @@ public:
     // 序列化/反序列化
     virtual std::string serialize() const = 0;
     virtual bool deserialize(const std::string& data) = 0;
+    
+    // 数据内容的64位哈希，不含设备ID和时间戳，用于纯插件的结果缓存；不支持时返回false
+    virtual bool getContentHash(uint64_t& hash) const { (void)hash; return false; }
 };
 
 /**
@@ -128,6 +134,22 @@ public:
     virtual bool process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) = 0;
     virtual void cleanup() = 0;
     
+    // 批量处理，outputs与inputs一一对应并按顺序处理，succeeded记录每条数据是否成功，全部成功时返回true
+    // 默认逐条调用process，各类插件基类重写为批量实现
+    virtual bool processBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                              const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                              std::vector<bool>& succeeded);
+    
+    // 是否为纯插件：结果只取决于参数和输入内容，与设备、时间戳和历史数据无关。
+    // 插件链对纯插件的结果按内容缓存，重复数据不再重新计算
+    virtual bool isPure() const { return false; }
+    
+    // 状态快照：有跨调用历史状态的插件重写，插件链据此写入和恢复检查点。
+    // incremental为true时只需写入上次快照后有变化的设备；loadState在initialize之后调用
+    virtual bool isStateful() const { return false; }
+    virtual bool saveState(StateWriter& writer, bool incremental) { (void)writer; (void)incremental; return false; }
+    virtual bool loadState(StateReader& reader) { (void)reader; return false; }
+    
     // 插件状态查询
     virtual bool isInitialized() const = 0;
     virtual std::string getLastError() const = 0;
@@ -178,15 +200,43 @@ public:
     virtual PluginType getPluginType() const = 0;
 };
 
+/**
+ * @brief 插件ABI版本
+ *
+ * IPlugin/IPluginFactory及数据类型发生二进制不兼容变更时递增，
+ * 动态加载时ABI版本不一致的插件库会被拒绝
+ */
+#define ALGORITHM_PLUGIN_ABI_VERSION 4
+
+/**
+ * @brief 插件库导出符号修饰
+ *
+ * Linux下插件库以-fvisibility=hidden编译，仅导出入口函数
+ */
+#if defined(_WIN32)
+    #define ALGORITHM_PLUGIN_EXPORT __declspec(dllexport)
+#else
+    #define ALGORITHM_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+// 插件库入口符号名
+#define ALGORITHM_PLUGIN_FACTORY_SYMBOL "createPluginFactory"
+#define ALGORITHM_PLUGIN_ABI_SYMBOL "getPluginAbiVersion"
+
 /**
  * @brief 插件注册宏
+ *
+ * 每个插件库导出工厂入口和ABI版本查询入口，由PluginManager::loadPluginFromFile加载
  */
 #define REGISTER_PLUGIN(PluginClass, PluginName, PluginType) \
     static PluginClass##Factory g_##PluginClass##Factory; \
     extern "C" { \
-        __declspec(dllexport) IPluginFactory* createPluginFactory() { \
+        ALGORITHM_PLUGIN_EXPORT ::AlgorithmPlugins::IPluginFactory* createPluginFactory() { \
             return &g_##PluginClass##Factory; \
         } \
+        ALGORITHM_PLUGIN_EXPORT int getPluginAbiVersion() { \
+            return ALGORITHM_PLUGIN_ABI_VERSION; \
+        } \
     }
 
 } // namespace AlgorithmPlugins
@@ -1,14 +1,30 @@
 #pragma once
 
 #include "plugin_base.h"
+#include "dynamic_library.h"
+#include "latency_histogram.h"
+#include "memory_accounting.h"
+#include "result_cache.h"
+#include "state_checkpoint.h"
+#include "task_scheduler.h"
+#include "ticket_lock.h"
 #include <memory>
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <functional>
+#include <chrono>
 
 namespace AlgorithmPlugins {
 
+class PluginResultImpl;
+class FeatureData;
+class PluginMonitorManager;
+
 /**
  * @brief 插件管理器类
  * 
@@ -44,9 +60,26 @@ public:
     std::vector<std::string> getRequiredParameters(const std::string& plugin_name) const;
     std::vector<std::string> getOptionalParameters(const std::string& plugin_name) const;
     
-    // 插件加载
-    bool loadPluginFromFile(const std::string& file_path);
-    bool loadPluginsFromDirectory(const std::string& directory_path);
+    // 插件加载（共享库，默认RTLD_LAZY延迟绑定）。路径按符号链接解析后去重；
+    // 插件名称已被注册时拒绝加载并记录错误，替换已注册插件须使用swapPluginLibrary
+    bool loadPluginFromFile(const std::string& file_path, bool lazy_binding = true);
+    bool loadPluginsFromDirectory(const std::string& directory_path, bool lazy_binding = true);
+    
+    // 插件热替换：加载同名插件的新版本库，新请求使用新工厂，
+    // 旧版本实例执行完毕、引用归零后旧库自动卸载。
+    // file_path与当前库路径相同时，仅在文件已被替换（inode/mtime/大小变化）时从副本重新加载，否则失败
+    bool swapPluginLibrary(const std::string& plugin_name,
+                           const std::string& file_path,
+                           bool lazy_binding = true);
+    
+    // 插件库查询
+    std::vector<std::string> getLoadedLibraries() const;
+    std::vector<std::string> getDrainingLibraries() const;
+    std::map<std::string, std::string> getLoadErrors() const;
+    
+    // 插件注册版本号，任何插件注册、替换或卸载时递增
+    uint64_t getRegistryGeneration() const { return registry_generation_.load(std::memory_order_acquire); }
+    uint64_t getPluginGeneration(const std::string& plugin_name) const;
     
     // 插件卸载
     bool unregisterPlugin(const std::string& plugin_name);
@@ -62,11 +95,37 @@ private:
     // 插件工厂映射
     std::map<std::string, std::shared_ptr<IPluginFactory>> plugin_factories_;
     
+    // 已加载的插件库（按文件路径）及插件名到所属库的映射
+    std::map<std::string, std::shared_ptr<DynamicLibrary>> loaded_libraries_;
+    std::map<std::string, std::shared_ptr<DynamicLibrary>> plugin_libraries_;
+    std::map<std::string, std::string> load_errors_;
+    
+    // 已被替换、等待实例释放的旧版本库
+    std::vector<std::pair<std::string, std::weak_ptr<DynamicLibrary>>> draining_libraries_;
+    
+    // 注册版本号
+    std::map<std::string, uint64_t> plugin_generations_;
+    std::atomic<uint64_t> registry_generation_{0};
+    
     // 线程安全
     mutable std::mutex mutex_;
     
+    // 单个插件库的加载结果
+    struct LibraryLoadResult {
+        std::string file_path;
+        std::shared_ptr<DynamicLibrary> library;
+        std::shared_ptr<IPluginFactory> factory;
+        std::string error;
+    };
+    
     // 内部方法
     std::shared_ptr<IPluginFactory> getPluginFactory(const std::string& plugin_name) const;
+    static LibraryLoadResult openPluginLibrary(const std::string& file_path, bool lazy_binding,
+                                               bool load_from_copy = false);
+    // replace为false时拒绝注册与已有插件同名的库
+    bool registerLoadedLibrary(const LibraryLoadResult& result, bool replace);
+    void bumpPluginGeneration(const std::string& plugin_name);
+    void releasePluginLibrary(const std::string& plugin_name);
 };
 
 /**
@@ -80,11 +139,18 @@ public:
     ~PluginChainManager();
     
     // 插件链配置
+    // data_mappings为空时按plugin_names顺序串行执行；否则以"源插件->目标插件"为边
+    // 构成DAG，无依赖关系的插件并行执行，目标插件的输入为各源插件结果合并成的特征数据，
+    // 映射值为传递的结果键（逗号分隔），为空或"*"时传递全部数值结果
     struct ChainConfig {
         std::string chain_name;
         std::vector<std::string> plugin_names;
         std::vector<std::shared_ptr<PluginParameter>> plugin_params;
         std::map<std::string, std::string> data_mappings; // 数据映射关系
+        // 插件实例分片数，默认0表示每个设备独占一套实例，实例数随设备数增长。
+        // 分片需显式开启（通常取执行线程数）：分片内的设备共用插件实例，
+        // 只适用于历史状态全部经DeviceStateStore按设备隔离的插件，实例成员中保存设备历史的插件会串数据
+        size_t instance_shards = 0;
     };
     
     // 插件链管理
@@ -101,10 +167,46 @@ public:
                      std::shared_ptr<PluginData> input_data,
                      std::shared_ptr<PluginResult> output_result);
     
+    // 批量执行插件链，outputs与inputs一一对应，succeeded记录每条数据是否成功，全部成功时返回true
+    // 同一实例集合的数据按输入顺序成组执行，串行链的每个插件对整组调用一次processBatch
+    bool executeChainBatch(const std::string& chain_name,
+                          const std::vector<std::shared_ptr<PluginData>>& inputs,
+                          const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                          std::vector<bool>& succeeded);
+    
     // 插件链查询
     std::vector<std::string> getAvailableChains() const;
     std::vector<std::string> getChainPlugins(const std::string& chain_name) const;
     bool isChainAvailable(const std::string& chain_name) const;
+    size_t getChainInstanceSetCount(const std::string& chain_name) const;
+    bool getChainConfig(const std::string& chain_name, ChainConfig& config) const;
+    
+    // 回收超过max_idle未执行的实例集合，返回回收数量；正在执行的集合不回收。
+    // 被回收设备的有状态插件历史随实例丢弃，设备再次出现时重新创建实例；
+    // 回收后下次检查点写入全量，不再包含已回收的设备。由调用方定期调用以限制设备流动带来的内存增长
+    size_t releaseIdleInstanceSets(std::chrono::steady_clock::duration max_idle);
+    
+    // 纯插件结果缓存，各插件链共享，可调整容量或查询命中统计
+    ResultCache& getResultCache() { return result_cache_; }
+    
+    // 链节点执行时间监控，设置后每个节点的执行时间按"链/插件"记录到monitor，nullptr关闭。
+    // monitor的生命周期须长于本管理器
+    void setMonitor(PluginMonitorManager* monitor) { monitor_ = monitor; }
+    
+    // 状态检查点：保存各链各实例集合中有状态插件的设备状态，由调用方定期调用。
+    // incremental为true时只写入上次检查点后有变化的设备，尚无全量检查点或插件实例被替换时自动写入全量检查点
+    bool writeCheckpoint(const std::string& directory, bool incremental = true);
+    
+    // 恢复检查点，应在创建插件链之后、执行之前调用；检查点中已不在链内的插件状态被忽略
+    bool restoreCheckpoint(const std::string& directory);
+    
+    // 最近一次写入或恢复的检查点序号，0表示尚无检查点
+    uint64_t getCheckpointSequence() const;
+    std::string getLastCheckpointError() const;
+    
+    // 数据对应的插件实例集合键，按设备或设备分片划分
+    static std::string instanceSetKey(const ChainConfig& config,
+                                      const std::shared_ptr<PluginData>& input_data);
     
     // 数据流管理
     bool setDataMapping(const std::string& chain_name,
@@ -113,27 +215,127 @@ public:
                        const std::string& data_key);
     
 private:
+    // 插件链DAG的数据边
+    struct ChainEdge {
+        size_t source;                  // 源节点下标
+        std::vector<std::string> keys;  // 传递的结果键，为空时传递全部数值结果
+    };
+    
+    // 插件链DAG，节点下标对应plugin_names
+    struct ChainGraph {
+        std::vector<std::vector<size_t>> successors;
+        std::vector<std::vector<ChainEdge>> predecessors;
+        std::vector<size_t> topo_order;
+        std::vector<size_t> roots;           // 无前驱的节点
+        bool has_parallel_branches = false;  // 是否可能同时有多个节点就绪
+    };
+    
+    // 由链配置编译出的不可变执行计划，配置修改时重新编译并整体替换
+    struct ExecutionPlan {
+        std::shared_ptr<const ChainConfig> config;
+        ChainGraph graph;
+        bool use_graph = false;   // 配置了数据映射时按DAG执行
+        bool valid = true;        // 存在环路或映射了链外插件时无法执行
+    };
+    
+    // 一个设备（或分片）独占的插件实例集合及执行缓冲区
+    struct ChainInstanceSet {
+        TicketLock execution_lock;                       // 同一设备的执行按到达顺序串行
+        std::chrono::steady_clock::time_point last_used; // 最近一次取用时间，由instance_sets_mutex保护
+        std::shared_ptr<const ExecutionPlan> plan;       // 实例对应的执行计划
+        std::map<std::string, std::shared_ptr<IPlugin>> instances;
+        std::map<std::string, uint64_t> generations;     // 实例创建时的插件注册版本号
+        uint64_t registry_generation = 0;
+        
+        // 按计划节点下标解析的插件实例和复用的结果、汇合输入缓冲区
+        std::vector<std::shared_ptr<IPlugin>> node_plugins;
+        std::vector<uint64_t> node_cache_seeds;          // 纯插件节点的缓存键种子，非纯插件为0
+        std::vector<std::string> node_stage_keys;        // 节点执行时间的监控键
+        std::vector<std::shared_ptr<PluginResultImpl>> node_results;
+        std::vector<std::shared_ptr<FeatureData>> join_inputs;
+        std::vector<size_t> remaining_inputs;
+        
+        // 上次写入或恢复检查点时的有状态插件实例，实例被替换后需写入全量检查点
+        std::map<std::string, std::weak_ptr<IPlugin>> checkpoint_instances;
+    };
+    
+    // 插件链运行时状态
+    struct ChainRuntime {
+        std::shared_ptr<const ExecutionPlan> plan;       // 当前执行计划
+        std::mutex instance_sets_mutex;
+        std::map<std::string, std::shared_ptr<ChainInstanceSet>> instance_sets;
+        std::shared_ptr<ChainInstanceSet> initial_set;   // 创建链时验证用的实例，交给第一个设备使用
+    };
+    
     // 插件链映射
-    std::map<std::string, ChainConfig> plugin_chains_;
+    std::map<std::string, std::shared_ptr<ChainRuntime>> plugin_chains_;
     
-    // 插件实例缓存
-    std::map<std::string, std::map<std::string, std::shared_ptr<IPlugin>>> plugin_instances_;
+    // 线程安全，仅在查找和修改链配置时持有，执行期间只持有设备实例集合的票据锁
+    mutable std::shared_mutex mutex_;
     
-    // 线程安全
-    mutable std::mutex mutex_;
+    ResultCache result_cache_;
+    std::atomic<PluginMonitorManager*> monitor_{nullptr};
+    
+    // 检查点状态，写入与恢复互斥
+    mutable std::mutex checkpoint_mutex_;
+    std::string checkpoint_directory_;     // 已有全量检查点的目录，为空时下次写入全量检查点
+    uint64_t checkpoint_sequence_ = 0;
+    std::string checkpoint_error_;
     
     // 内部方法
-    bool initializeChainPlugins(const std::string& chain_name);
-    bool executePluginInChain(const std::string& chain_name,
-                            const std::string& plugin_name,
-                            std::shared_ptr<PluginData> input_data,
-                            std::shared_ptr<PluginResult> output_result);
-    
-    // 数据转换
-    std::shared_ptr<PluginData> convertDataForPlugin(std::shared_ptr<PluginData> input_data,
-                                                    std::shared_ptr<IPlugin> target_plugin);
-    std::shared_ptr<PluginResult> convertResultForPlugin(std::shared_ptr<PluginResult> input_result,
-                                                        std::shared_ptr<IPlugin> source_plugin);
+    static std::shared_ptr<const ExecutionPlan> compileChain(std::shared_ptr<const ChainConfig> config);
+    bool updateChainConfig(const std::string& chain_name,
+                          const std::function<bool(ChainConfig&)>& update);
+    std::shared_ptr<ChainRuntime> findChainRuntime(const std::string& chain_name,
+                                                  std::shared_ptr<const ExecutionPlan>& plan) const;
+    std::shared_ptr<ChainInstanceSet> acquireInstanceSet(ChainRuntime& runtime,
+                                                        const std::string& set_key);
+    bool refreshInstanceSet(ChainInstanceSet& instance_set,
+                           const std::shared_ptr<const ExecutionPlan>& plan);
+    
+    // 收集有状态插件的检查点数据段，incremental时遇到被替换的插件实例返回false并置replaced
+    bool collectCheckpointSections(bool incremental, std::vector<StateCheckpoint::Section>& sections,
+                                  bool& replaced);
+    static bool executePluginInChain(IPlugin& plugin,
+                                    const std::shared_ptr<PluginData>& input_data,
+                                    const std::shared_ptr<PluginResult>& output_result);
+    static void executePluginBatchInChain(IPlugin& plugin,
+                                         const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                         const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                         std::vector<bool>& succeeded);
+    
+    // 按节点执行插件，设置了监控时记录节点执行时间
+    bool executeNodeInChain(ChainInstanceSet& instance_set, size_t node,
+                           const std::shared_ptr<PluginData>& input_data,
+                           const std::shared_ptr<PluginResult>& output_result);
+    void executeNodeBatchInChain(ChainInstanceSet& instance_set, size_t node,
+                                const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                std::vector<bool>& succeeded);
+    
+    // 纯插件节点先查找结果缓存
+    static uint64_t pluginCacheSeed(const IPlugin& plugin,
+                                    const std::string& plugin_name,
+                                    uint64_t generation,
+                                    const std::shared_ptr<PluginParameter>& params);
+    bool executeNodeCached(ChainInstanceSet& instance_set, size_t node,
+                          const std::shared_ptr<PluginData>& input_data,
+                          const std::shared_ptr<PluginResult>& output_result);
+    void executeNodeBatchCached(ChainInstanceSet& instance_set, size_t node,
+                               const std::vector<std::shared_ptr<PluginData>>& inputs,
+                               const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                               std::vector<bool>& succeeded);
+    
+    // DAG构建与执行
+    static bool buildChainGraph(const ChainConfig& config, ChainGraph& graph);
+    bool executeChainGraph(const ExecutionPlan& plan,
+                          ChainInstanceSet& instance_set,
+                          const std::shared_ptr<PluginData>& input_data,
+                          const std::shared_ptr<PluginResult>& output_result);
+    static void buildJoinInput(FeatureData& join_input,
+                              const std::shared_ptr<PluginData>& chain_input,
+                              const std::vector<ChainEdge>& predecessors,
+                              const std::vector<std::shared_ptr<PluginResultImpl>>& node_results);
 };
 
 /**
@@ -187,7 +389,8 @@ private:
 /**
  * @brief 插件监控管理器
  * 
- * 负责监控插件的执行状态和性能
+ * 负责监控插件的执行状态和性能。
+ * 每个线程对每个插件写入独立的统计分片，记录路径无锁且为常数时间，查询时合并各分片
  */
 class PluginMonitorManager {
 public:
@@ -203,6 +406,17 @@ public:
         double avg_execution_time_ms = 0.0;
         double max_execution_time_ms = 0.0;
         double min_execution_time_ms = 0.0;
+        double p50_execution_time_ms = 0.0;
+        double p90_execution_time_ms = 0.0;
+        double p99_execution_time_ms = 0.0;
+        double p999_execution_time_ms = 0.0;
+        
+        // 内存统计，需由执行器通过recordMemoryUsage记录
+        uint64_t memory_samples = 0;          // 记录了内存统计的执行次数
+        uint64_t bytes_allocated = 0;         // 累计分配字节数
+        uint64_t allocation_count = 0;        // 累计分配次数
+        uint64_t peak_memory_bytes = 0;       // 单次执行存活字节数的最高水位
+        int64_t retained_bytes = 0;           // 各次执行结束时未释放字节数之和，持续增长说明存在泄漏
         std::chrono::system_clock::time_point last_execution_time;
         std::string last_error_message;
     };
@@ -225,20 +439,99 @@ public:
     double getSuccessRate(const std::string& plugin_name) const;
     uint64_t getExecutionCount(const std::string& plugin_name) const;
     
+    // 执行时间分布，直方图以纳秒计；分位数quantile取0~1，返回毫秒
+    LatencyHistogram getLatencyHistogram(const std::string& plugin_name) const;
+    double getExecutionTimePercentile(const std::string& plugin_name, double quantile) const;
+    
+    // 插件当前的统计分片数：每个记录过的存活线程一个，已退出线程归并为一个
+    size_t getShardCount(const std::string& plugin_name) const;
+    
+    // 插件链节点执行时间，由PluginChainManager记录，无需startMonitoring
+    static std::string stageKey(const std::string& chain_name, const std::string& plugin_name);
+    void recordStageExecution(const std::string& stage_key, bool success, double execution_time_ms);
+    PluginMetrics getStageMetrics(const std::string& chain_name, const std::string& plugin_name) const;
+    
+    // 一次执行的内存统计，插件须已startMonitoring；链节点由PluginChainManager记录
+    void recordMemoryUsage(const std::string& plugin_name, const MemoryUsage& usage);
+    void recordStageMemoryUsage(const std::string& stage_key, const MemoryUsage& usage);
+    
+    // 导出用的合并统计快照，latency_counts为按给定上限（纳秒，升序）累计的直方图计数
+    struct MetricsSnapshot {
+        std::string chain_name;               // 链节点所属插件链，插件统计为空
+        PluginMetrics metrics;
+        std::vector<uint64_t> latency_counts;
+    };
+    
+    // 一次取得各插件和各链节点的合并统计，每个条目只合并一次。
+    // 内部锁只在收集分片指针时持有，分片合并在锁外完成，不阻塞记录路径创建分片
+    void snapshotMetrics(const std::vector<uint64_t>& latency_bounds,
+                         std::vector<MetricsSnapshot>& plugins,
+                         std::vector<MetricsSnapshot>& stages) const;
+    
     // 监控配置
     void setMonitoringEnabled(bool enabled) { monitoring_enabled_ = enabled; }
     bool isMonitoringEnabled() const { return monitoring_enabled_; }
     
 private:
-    // 监控数据
-    std::map<std::string, PluginMetrics> plugin_metrics_;
-    std::set<std::string> monitored_plugins_;
+    struct PluginEntry;
+    struct ThreadCache;
+    struct ThreadCacheSet;
+    
+    // 单个线程对单个插件的统计分片，只由所属线程写入
+    struct MetricsShard {
+        PluginEntry* entry = nullptr;
+        std::atomic<uint64_t> execution_count{0};
+        std::atomic<uint64_t> success_count{0};
+        std::atomic<uint64_t> error_count{0};
+        std::atomic<uint64_t> total_time_ns{0};
+        std::atomic<uint64_t> min_time_ns{UINT64_MAX};
+        std::atomic<uint64_t> max_time_ns{0};
+        std::atomic<int64_t> last_execution_ns{0};
+        std::atomic<uint64_t> memory_samples{0};
+        std::atomic<uint64_t> bytes_allocated{0};
+        std::atomic<uint64_t> allocation_count{0};
+        std::atomic<uint64_t> peak_memory_bytes{0};
+        std::atomic<int64_t> retained_bytes{0};
+        LatencyHistogram latency;
+    };
+    
+    // 插件的监控条目，创建后不删除，停止监控只清除monitored标记。
+    // 线程退出时其分片并入retired后移出shards，查询方持有的旧分片由shared_ptr保活
+    struct PluginEntry {
+        std::string plugin_name;
+        std::atomic<bool> monitored{false};
+        std::vector<std::shared_ptr<MetricsShard>> shards;  // 由mutex_保护
+        MetricsShard* retired = nullptr;                     // 已退出线程的汇总分片，也在shards中
+        mutable std::mutex error_mutex;
+        std::string last_error_message;
+    };
+    
+    std::map<std::string, std::unique_ptr<PluginEntry>> plugins_;
+    std::map<std::string, std::unique_ptr<PluginEntry>> stages_;  // 按stageKey索引
     
     // 监控状态
-    bool monitoring_enabled_ = true;
+    std::atomic<bool> monitoring_enabled_{true};
     
-    // 线程安全
+    // 线程本地分片缓存按管理器编号区分，新增监控条目时递增版本使缓存失效
+    const uint64_t instance_id_;
+    std::atomic<uint64_t> entries_version_{0};
+    
+    // 线程安全，仅在创建条目、分片和查询时持有
     mutable std::mutex mutex_;
+    
+    // 当前线程对插件（或链节点）的统计分片，插件未被监控时返回nullptr，链节点首次记录时创建条目
+    MetricsShard* findShard(const std::string& key, bool stage);
+    static void recordToShard(MetricsShard& shard, bool success, double execution_time_ms,
+                              const std::string* error_message);
+    static void recordMemoryToShard(MetricsShard& shard, const MemoryUsage& usage);
+    
+    // 线程退出时将其各分片并入所属条目的retired分片
+    void releaseThreadCache(const ThreadCache& cache);
+    static void foldShard(MetricsShard& into, const MetricsShard& from);
+    
+    static PluginMetrics mergeShards(const PluginEntry& entry,
+                                     const std::vector<std::shared_ptr<MetricsShard>>& shards,
+                                     LatencyHistogram& latency);
 };
 
 } // namespace AlgorithmPlugins
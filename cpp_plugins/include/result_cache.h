@@ -0,0 +1,64 @@
+#pragma once
+
+#include "data_types.h"
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 纯插件结果缓存
+ *
+ * 以插件名、插件版本号、参数和输入内容的哈希值为键缓存插件结果，容量满时淘汰最久未使用的条目。
+ * 缓存的结果对象不可修改，命中时由调用方复制到自己的输出中
+ */
+class ResultCache {
+public:
+    // capacity为最大条目数，0表示禁用缓存
+    explicit ResultCache(size_t capacity = 1024);
+
+    // 禁用拷贝构造和赋值
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // 查找结果，命中时将条目移到最近使用位置，未命中返回nullptr
+    std::shared_ptr<const PluginResultImpl> find(uint64_t key);
+
+    // 插入结果，已存在时替换
+    void insert(uint64_t key, std::shared_ptr<const PluginResultImpl> result);
+
+    // 容量管理，缩小容量时立即淘汰多余条目
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const { return capacity_.load(); }
+    bool isEnabled() const { return capacity_.load() > 0; }
+    size_t size() const;
+    void clear();
+
+    // 命中统计
+    uint64_t getHitCount() const { return hits_.load(); }
+    uint64_t getMissCount() const { return misses_.load(); }
+    uint64_t getEvictionCount() const { return evictions_.load(); }
+    double getHitRate() const;
+    void resetStatistics();
+
+private:
+    using Entry = std::pair<uint64_t, std::shared_ptr<const PluginResultImpl>>;
+
+    std::atomic<size_t> capacity_;
+    std::list<Entry> entries_;   // 表头为最近使用的条目
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+
+    mutable std::mutex mutex_;
+
+    void evictLocked(size_t capacity);
+};
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 定容环形缓冲区
+ *
+ * 存储在设置容量时一次分配，之后追加和从头部移除都是常数时间且不再分配内存；
+ * 写满后追加会覆盖最早的元素。元素按写入顺序排列，物理上最多分为两段连续内存，
+ * 统计代码可通过spans()直接遍历而无需先复制到连续数组。
+ * 与DeviceStateStore一样不做加锁保护
+ */
+template <typename T>
+class RingBuffer {
+public:
+    // 一段连续内存的只读视图
+    struct Span {
+        const T* data = nullptr;
+        size_t size = 0;
+
+        const T* begin() const { return data; }
+        const T* end() const { return data + size; }
+    };
+
+    RingBuffer() = default;
+    explicit RingBuffer(size_t capacity) { setCapacity(capacity); }
+
+    // 修改容量，容量变小时保留最新的元素
+    void setCapacity(size_t capacity) {
+        if (capacity == buffer_.size()) {
+            return;
+        }
+        std::vector<T> buffer(capacity);
+        const size_t keep = std::min(size_, capacity);
+        for (size_t i = 0; i < keep; ++i) {
+            buffer[i] = std::move((*this)[size_ - keep + i]);
+        }
+        buffer_ = std::move(buffer);
+        head_ = 0;
+        size_ = keep;
+    }
+
+    size_t capacity() const { return buffer_.size(); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == buffer_.size(); }
+
+    // 追加到尾部，已满时覆盖最早的元素；容量为0时丢弃
+    void push_back(const T& value) {
+        if (buffer_.empty()) {
+            return;
+        }
+        if (size_ < buffer_.size()) {
+            buffer_[physical(size_)] = value;
+            ++size_;
+        } else {
+            buffer_[head_] = value;
+            head_ = physical(1);
+        }
+    }
+
+    // 从头部移除count个元素
+    void pop_front(size_t count = 1) {
+        count = std::min(count, size_);
+        head_ = size_ == count ? 0 : physical(count);
+        size_ -= count;
+    }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // 按写入顺序访问，下标0为最早的元素
+    const T& operator[](size_t index) const { return buffer_[physical(index)]; }
+    T& operator[](size_t index) { return buffer_[physical(index)]; }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    // 按写入顺序的两段连续内存，未回绕时第二段为空
+    std::pair<Span, Span> spans() const {
+        const size_t first_size = std::min(size_, buffer_.size() - head_);
+        Span first{buffer_.data() + head_, first_size};
+        Span second{buffer_.data(), size_ - first_size};
+        return {first, second};
+    }
+
+    // 按写入顺序复制到数组
+    void copyTo(std::vector<T>& out) const {
+        auto [first, second] = spans();
+        out.assign(first.begin(), first.end());
+        out.insert(out.end(), second.begin(), second.end());
+    }
+
+private:
+    std::vector<T> buffer_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+
+    size_t physical(size_t index) const {
+        size_t position = head_ + index;
+        return position >= buffer_.size() ? position - buffer_.size() : position;
+    }
+};
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 平滑函数
+ */
+enum class SmoothingFunction {
+    NONE,       // 不平滑
+    MEAN,       // 滑动均值
+    MIN,        // 滑动最小值
+    MAX,        // 滑动最大值
+    MEDIAN,     // 滑动中位数
+    EWMA        // 指数加权移动平均
+};
+
+/**
+ * @brief 平滑参数
+ *
+ * 由move_smooth_param、long_smooth等参数表解析：func为mean、min、max、median或ewma，
+ * win_length为窗口长度；ewma可用alpha直接给出平滑系数，否则取2/(win_length+1)
+ */
+struct SmoothingSpec {
+    SmoothingFunction function = SmoothingFunction::NONE;
+    int win_length = 0;
+    double alpha = 0.0;
+
+    static SmoothingSpec parse(const std::map<std::string, std::string>& params);
+
+    // 参数是否会改变数据
+    bool enabled() const;
+};
+
+/**
+ * @brief 平滑核
+ *
+ * 窗口类函数以当前点为中心、前后各win_length/2个点为窗口，两端不足半个窗口的点保持原值，
+ * 数据不长于窗口时不平滑；ewma从第一个点开始递推。
+ * 均值用滑动和、最小/最大值用单调队列，均为O(n)；中位数为O(n log w)。
+ * 每次调用只分配与窗口或数据等长的辅助空间，逐点计算时不再分配内存
+ */
+class SmoothingKernel {
+public:
+    static void apply(const SmoothingSpec& spec, const std::vector<double>& input, std::vector<double>& output);
+
+private:
+    static void slidingMean(const std::vector<double>& input, size_t half, std::vector<double>& output);
+    static void slidingExtremum(const std::vector<double>& input, size_t half, bool maximum,
+                                std::vector<double>& output);
+    static void slidingMedian(const std::vector<double>& input, size_t half, std::vector<double>& output);
+    static void ewma(const std::vector<double>& input, double alpha, std::vector<double>& output);
+};
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "device_state_store.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 插件状态二进制编码器
+ *
+ * 以小端定长格式追加写入，字符串和容器带长度前缀
+ */
+class StateWriter {
+public:
+    void writeU32(uint32_t value);
+    void writeU64(uint64_t value);
+    void writeI32(int value) { writeU32(static_cast<uint32_t>(value)); }
+    void writeDouble(double value);
+    void writeString(const std::string& value);
+    void writeTimePoint(std::chrono::system_clock::time_point value);
+    void writeDoubleArray(const std::vector<double>& values);
+    void writeDoubleMap(const std::map<std::string, double>& values);
+
+    const std::string& data() const { return buffer_; }
+    size_t size() const { return buffer_.size(); }
+
+private:
+    std::string buffer_;
+
+    void writeBytes(const void* data, size_t length);
+};
+
+/**
+ * @brief 插件状态二进制解码器
+ *
+ * 直接读取外部缓冲区（如映射的检查点文件），越界时进入失败状态，之后的读取均返回false
+ */
+class StateReader {
+public:
+    StateReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    bool readU32(uint32_t& value);
+    bool readU64(uint64_t& value);
+    bool readI32(int& value);
+    bool readDouble(double& value);
+    bool readString(std::string& value);
+    bool readTimePoint(std::chrono::system_clock::time_point& value);
+    bool readDoubleArray(std::vector<double>& values);
+    bool readDoubleMap(std::map<std::string, double>& values);
+
+    bool failed() const { return failed_; }
+    bool atEnd() const { return position_ == size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t position_ = 0;
+    bool failed_ = false;
+
+    bool readBytes(void* data, size_t length);
+    bool readCount(uint64_t& count, size_t min_element_size);
+};
+
+/**
+ * @brief 设备状态快照辅助函数
+ *
+ * 以设备ID（而非进程内句柄）标识设备，incremental为true时只写入上次快照后访问过的设备。
+ * 写入后清除脏标记；读取时设备状态先恢复为默认值再由read_state填充
+ */
+template <typename State, typename WriteFunc>
+void writeDeviceStates(StateWriter& writer, DeviceStateStore<State>& store,
+                       bool incremental, WriteFunc&& write_state) {
+    std::vector<DeviceHandle> devices;
+    auto collect = [&devices](DeviceHandle device, State&) { devices.push_back(device); };
+    if (incremental) {
+        store.forEachDirty(collect);
+    } else {
+        store.forEach(collect);
+    }
+
+    auto& registry = DeviceRegistry::getInstance();
+    writer.writeU64(devices.size());
+    for (DeviceHandle device : devices) {
+        writer.writeString(registry.getDeviceId(device));
+        write_state(writer, *store.find(device));
+    }
+    store.clearDirty();
+}
+
+template <typename State, typename ReadFunc>
+bool readDeviceStates(StateReader& reader, DeviceStateStore<State>& store, ReadFunc&& read_state) {
+    uint64_t count = 0;
+    if (!reader.readU64(count)) {
+        return false;
+    }
+
+    auto& registry = DeviceRegistry::getInstance();
+    std::string device_id;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!reader.readString(device_id)) {
+            return false;
+        }
+        State& state = store.get(registry.getHandle(device_id));
+        state = State();
+        if (!read_state(reader, state)) {
+            return false;
+        }
+    }
+
+    // 恢复的状态已在检查点中，不计入下次增量
+    store.clearDirty();
+    return true;
+}
+
+/**
+ * @brief 状态检查点文件
+ *
+ * 目录中保存一个全量检查点和其后的若干增量检查点，恢复时按序号依次应用。
+ * 文件先写入临时文件并同步到磁盘，再原子重命名，进程崩溃不会留下不完整的检查点；
+ * 每个段带CRC32校验，读取时映射整个文件并先完成全部校验再应用，损坏的文件不会被部分应用
+ */
+class StateCheckpoint {
+public:
+    // 检查点中的一段数据，key标识状态所属对象
+    struct Section {
+        std::string key;
+        std::string payload;
+    };
+
+    // 段回调，返回false时停止应用并视为恢复失败
+    using SectionHandler = std::function<bool(const std::string& key, StateReader& reader)>;
+
+    // 写入检查点，写入全量检查点后删除目录中的全部增量检查点
+    static bool write(const std::string& directory, uint64_t sequence, bool incremental,
+                      const std::vector<Section>& sections, std::string& error);
+
+    // 恢复检查点，依次应用全量检查点和序号更大的增量检查点，遇到损坏的增量检查点时停止，
+    // last_sequence返回最后应用的检查点序号。目录中没有检查点时返回true且last_sequence为0
+    static bool restore(const std::string& directory, const SectionHandler& handler,
+                        uint64_t& last_sequence, std::string& error);
+
+    // CRC32（IEEE 802.3）
+    static uint32_t crc32(const void* data, size_t length, uint32_t crc = 0);
+
+private:
+    static bool writeFile(const std::string& path, uint64_t sequence, bool incremental,
+                          const std::vector<Section>& sections, std::string& error);
+    static bool readFile(const std::string& path, const SectionHandler& handler,
+                         uint64_t& sequence, std::string& error);
+};
+
+} // namespace AlgorithmPlugins
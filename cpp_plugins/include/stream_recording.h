@@ -0,0 +1,52 @@
+#pragma once
+
+#include "data_types.h"
+#include "state_checkpoint.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 录制数据流的文件格式
+ */
+enum class RecordingFormat {
+    JSON_LINES,     // 每行一条PluginData::serialize()的输出
+    BINARY          // 文件头加长度前缀的二进制记录
+};
+
+/**
+ * @brief 设备数据流录制文件的读写
+ *
+ * JSON行格式便于从现有日志中截取，按"type"字段分发给对应数据类型的deserialize，
+ * 时间戳取自"timestamp"字段（毫秒）；二进制格式以StateWriter编码，保留完整精度，
+ * 读取时不做文本解析，适合大规模回放。读取时按文件头自动识别格式
+ */
+class StreamRecording {
+public:
+    // 读取录制文件，记录按文件中的顺序返回
+    static bool read(const std::string& path, std::vector<std::shared_ptr<PluginData>>& records,
+                     std::string& error);
+
+    static bool write(const std::string& path, const std::vector<std::shared_ptr<PluginData>>& records,
+                      RecordingFormat format, std::string& error);
+
+    // 解析一行JSON记录，无法识别的类型或格式错误时返回nullptr
+    static std::shared_ptr<PluginData> parseJsonLine(const std::string& line);
+
+    // 单条记录的二进制编解码（含设备ID和时间戳）
+    static void encodeRecord(StateWriter& writer, const PluginData& data);
+    static std::shared_ptr<PluginData> decodeRecord(StateReader& reader);
+
+    // 复制记录并替换设备ID，用于把一台设备的录制数据扩展为多台模拟设备
+    static std::shared_ptr<PluginData> withDeviceId(const PluginData& data, const std::string& device_id);
+
+private:
+    static void encodePayload(StateWriter& writer, const PluginData& data);
+    static std::shared_ptr<PluginData> decodePayload(StateReader& reader, DataType type,
+                                                     const std::string& device_id,
+                                                     std::chrono::system_clock::time_point timestamp);
+};
+
+} // namespace AlgorithmPlugins
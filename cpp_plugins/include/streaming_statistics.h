@@ -0,0 +1,153 @@
+#pragma once
+
+#include "ring_buffer.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 可增删的滑动矩统计（Welford算法）
+ *
+ * 加入和移除都是O(1)，移除的值须是之前加入过的
+ */
+class RunningMoments {
+public:
+    void add(double value);
+    void remove(double value);
+    void clear();
+
+    size_t count() const { return count_; }
+    double mean() const { return mean_; }
+
+    // 样本方差（除以n-1），少于两个数据时为0
+    double sampleVariance() const;
+    double sampleStd() const;
+
+private:
+    size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+/**
+ * @brief 先进先出窗口的极值（单调队列）
+ *
+ * Better为std::greater<double>时维护最大值，std::less<double>时维护最小值。
+ * 队列中只保留之后不会被更优值遮盖的元素，push和popFront均摊O(1)
+ */
+template <typename Better>
+class SlidingExtremum {
+public:
+    void push(double value) {
+        while (!candidates_.empty() && !better_(candidates_.back().second, value)) {
+            candidates_.pop_back();
+        }
+        candidates_.emplace_back(next_sequence_++, value);
+    }
+
+    // 移除窗口中最早的元素
+    void popFront() {
+        if (!candidates_.empty() && candidates_.front().first == oldest_sequence_) {
+            candidates_.pop_front();
+        }
+        ++oldest_sequence_;
+    }
+
+    void clear() {
+        candidates_.clear();
+        next_sequence_ = 0;
+        oldest_sequence_ = 0;
+    }
+
+    bool empty() const { return candidates_.empty(); }
+    double value() const { return candidates_.front().second; }
+
+private:
+    std::deque<std::pair<uint64_t, double>> candidates_;
+    uint64_t next_sequence_ = 0;
+    uint64_t oldest_sequence_ = 0;
+    Better better_;
+};
+
+using SlidingMax = SlidingExtremum<std::greater<double>>;
+using SlidingMin = SlidingExtremum<std::less<double>>;
+
+/**
+ * @brief 可增删的中位数（双有序集合）
+ *
+ * lower_保存较小的一半，upper_保存较大的一半，lower_的元素数等于或比upper_多一个。
+ * 加入和移除为O(log n)，中位数为O(1)
+ */
+class SlidingMedian {
+public:
+    void add(double value);
+    void remove(double value);
+    void clear();
+
+    // 以new_value替换一个old_value，复用原集合节点，固定窗口滑动时不分配内存
+    void replace(double old_value, double new_value);
+
+    size_t size() const { return lower_.size() + upper_.size(); }
+
+    // 偶数个数据时为中间两个数的平均值，没有数据时为0
+    double median() const;
+
+private:
+    std::multiset<double> lower_;
+    std::multiset<double> upper_;
+
+    void rebalance();
+};
+
+/**
+ * @brief 跟随先进先出窗口的增量统计量
+ *
+ * 与RingBuffer中的历史数据同步更新：追加数据时push，从头部淘汰时以被淘汰的值调用popFront。
+ * 每条数据的更新代价与窗口长度无关（中位数为O(log n)），统计量可随时读取。
+ * 中位数占用每个数据一个集合节点，只在需要时开启
+ */
+class WindowStatistics {
+public:
+    void push(double value);
+    void popFront(double value);
+    void clear();
+
+    // 按窗口中现有数据重建全部统计量
+    void rebuild(const RingBuffer<double>& values);
+
+    void setTrackMedian(bool track) { track_median_ = track; }
+    bool tracksMedian() const { return track_median_; }
+
+    size_t size() const { return moments_.count(); }
+
+    // 是否可增量提供该统计方法
+    bool supports(const std::string& method) const;
+
+    // 读取统计量，method为mean、std、max、min或median，没有数据或不支持时返回0
+    double get(const std::string& method) const;
+
+private:
+    RunningMoments moments_;
+    SlidingMax max_;
+    SlidingMin min_;
+    SlidingMedian median_;
+    bool track_median_ = false;
+};
+
+/**
+ * @brief 将[first, last)原地截断到分位数区间
+ *
+ * 下界为升序第floor(n*lower_fraction)个值，上界为第floor(n*upper_fraction)个值，
+ * 与整体排序后取对应位置的结果一致。用两次选择算法求界，O(n)，需要一份同样大小的临时缓冲区
+ */
+void clampToPercentiles(std::vector<double>::iterator first, std::vector<double>::iterator last,
+                        double lower_fraction, double upper_fraction);
+
+} // namespace AlgorithmPlugins
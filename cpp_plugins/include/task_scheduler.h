@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+// 任务优先级，高优先级任务先于低优先级任务被取出
+enum class TaskPriority {
+    HIGH = 0,
+    NORMAL = 1,
+    LOW = 2
+};
+
+/**
+ * @brief 工作窃取任务调度器
+ *
+ * 每个工作线程持有按优先级划分的本地双端队列，本线程提交的任务从队尾压入和取出，
+ * 空闲线程从其他线程队首窃取；外部线程提交的任务进入共享注入队列。
+ * 插件链、特征计算和批量内核共用同一个调度器，避免多个子系统各自创建线程导致超额订阅
+ */
+class TaskScheduler {
+public:
+    // thread_count为0时使用硬件并发数
+    explicit TaskScheduler(size_t thread_count = 0);
+    ~TaskScheduler();
+
+    // 禁用拷贝构造和赋值
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // 进程共享的调度器
+    static TaskScheduler& getInstance();
+
+    // 提交任务，任务抛出的异常被忽略
+    void submit(std::function<void()> task, TaskPriority priority = TaskPriority::NORMAL);
+
+    // 取出任意一个待执行任务在当前线程执行，没有任务时返回false。
+    // 会执行无关任务，调用方不得持有任务可能获取的锁
+    bool runPendingTask();
+
+    // 获取工作线程数
+    size_t getThreadCount() const { return workers_.size(); }
+    
+    // 正在执行任务的工作线程数和待执行任务数
+    size_t getActiveCount() const { return active_.load(std::memory_order_relaxed); }
+    size_t getPendingCount() const { return pending_.load(std::memory_order_relaxed); }
+
+    // 当前线程是否为本调度器的工作线程
+    bool isWorkerThread() const;
+
+private:
+    static constexpr size_t kPriorityCount = 3;
+
+    // 单个任务队列，本地队列由所属线程从队尾操作，其他线程从队首窃取
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // 工作线程的本地队列
+    struct WorkerQueues {
+        TaskQueue queues[kPriorityCount];
+    };
+
+    std::vector<std::unique_ptr<WorkerQueues>> worker_queues_;
+    TaskQueue injection_queues_[kPriorityCount];
+    std::vector<std::thread> workers_;
+
+    // 正在执行任务的工作线程数
+    std::atomic<size_t> active_{0};
+
+    // 待执行任务数，工作线程空闲时在此等待
+    std::atomic<size_t> pending_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+
+    bool takeTask(size_t worker_index, std::function<void()>& task);
+    void workerLoop(size_t worker_index);
+};
+
+/**
+ * @brief 任务组
+ *
+ * 跟踪一组任务的完成情况，wait()期间当前线程只协助执行本组尚未开始的任务，
+ * 因此可在任务内部嵌套创建任务组而不会耗尽工作线程，也不会在持有设备锁等待时
+ * 执行无关任务（如异步执行器的排空任务）而重入同一把锁。
+ * 任务抛出的第一个异常在wait()中重新抛出
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::getInstance(),
+                       TaskPriority priority = TaskPriority::NORMAL);
+    ~TaskGroup();
+
+    // 禁用拷贝构造和赋值
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // 提交属于本组的任务
+    void run(std::function<void()> task);
+
+    // 等待本组全部任务完成
+    void wait();
+
+private:
+    TaskScheduler& scheduler_;
+    TaskPriority priority_;
+
+    // 状态与等待者共享，保证最后一个任务结束后仍可安全通知
+    struct State {
+        std::atomic<size_t> pending{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+        // 尚未开始的任务，调度器中的占位任务和wait()都从这里取任务执行
+        std::deque<std::function<void()>> queued;
+    };
+    std::shared_ptr<State> state_;
+
+    // 取出并执行本组一个尚未开始的任务，没有任务时返回false
+    static bool runQueuedTask(const std::shared_ptr<State>& state);
+};
+
+// 将[begin, end)按grain_size切分为多个任务并行执行，func接收子区间[chunk_begin, chunk_end)
+void parallelFor(size_t begin, size_t end, size_t grain_size,
+                 const std::function<void(size_t, size_t)>& func,
+                 TaskPriority priority = TaskPriority::NORMAL);
+
+} // namespace AlgorithmPlugins
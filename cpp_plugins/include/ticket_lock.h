@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 公平的票据锁
+ *
+ * 按调用lock()的先后顺序获得锁，保证同一设备的请求按到达顺序执行。
+ * 满足BasicLockable，可配合std::lock_guard使用
+ */
+class TicketLock {
+public:
+    TicketLock() = default;
+    
+    // 禁用拷贝构造和赋值
+    TicketLock(const TicketLock&) = delete;
+    TicketLock& operator=(const TicketLock&) = delete;
+    
+    void lock() {
+        std::unique_lock<std::mutex> guard(mutex_);
+        uint64_t ticket = next_ticket_++;
+        turn_.wait(guard, [this, ticket] { return now_serving_ == ticket; });
+    }
+    
+    void unlock() {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            ++now_serving_;
+        }
+        turn_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable turn_;
+    uint64_t next_ticket_ = 0;
+    uint64_t now_serving_ = 0;
+};
+
+} // namespace AlgorithmPlugins
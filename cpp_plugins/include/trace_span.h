@@ -0,0 +1,212 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace AlgorithmPlugins {
+
+/**
+ * @brief 追踪事件
+ *
+ * name和category须为静态字符串，label保存插件名、链名等运行时信息
+ */
+struct TraceEvent {
+    const char* name = nullptr;
+    const char* category = nullptr;
+    std::string label;
+    uint64_t start_ns = 0;
+    uint64_t duration_ns = 0;
+    uint64_t request_id = 0;
+    uint32_t depth = 0;
+};
+
+/**
+ * @brief 线程的追踪上下文
+ *
+ * request_id为0表示当前请求未被采样，此时追踪区间不做任何记录。
+ * 任务提交到其他线程时复制上下文，并在任务内用TraceContextScope安装
+ */
+struct TraceContext {
+    uint64_t request_id = 0;
+    uint32_t depth = 0;
+};
+
+/**
+ * @brief 追踪区间收集器
+ *
+ * 每个线程写入自己的环形缓冲区，缓冲区满时覆盖最早的事件。
+ * 按间隔采样请求，只有被采样请求内的区间会被记录，可导出为Chrome trace / Perfetto JSON
+ */
+class Tracer {
+public:
+    static Tracer& getInstance();
+
+    // 禁用拷贝构造和赋值
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    // 运行时开关，关闭时开始请求只需一次原子读取
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // 每interval个请求采样一个，1表示全部采样
+    void setSampleInterval(uint32_t interval);
+    uint32_t getSampleInterval() const { return sample_interval_.load(std::memory_order_relaxed); }
+
+    // 每个线程缓冲区的事件数，只影响之后创建的缓冲区
+    void setBufferCapacity(size_t capacity);
+
+    // 导出Chrome trace JSON
+    std::string renderChromeTrace() const;
+    bool exportChromeTrace(const std::string& file_path) const;
+
+    // 清空已记录的事件，并释放已退出线程的缓冲区
+    void clear();
+
+    size_t getEventCount() const;
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 当前线程的上下文
+    static TraceContext& currentContext();
+
+    // 为新请求分配编号，未被采样时返回0
+    uint64_t sampleRequest();
+
+    // 记录一个已结束的区间
+    void record(const char* name, const char* category, const std::string& label,
+                uint64_t start_ns, uint64_t duration_ns, uint64_t request_id, uint32_t depth);
+
+    // 相对追踪器创建时刻的单调时间
+    uint64_t nowNs() const;
+
+private:
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<TraceEvent> events;
+        size_t next = 0;
+        size_t size = 0;
+        uint32_t thread_index = 0;
+    };
+
+    Tracer();
+
+    ThreadBuffer& threadBuffer();
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint32_t> sample_interval_{1};
+    std::atomic<uint64_t> request_counter_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<size_t> buffer_capacity_{16384};
+    const uint64_t epoch_ns_;
+
+    mutable std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    uint32_t next_thread_index_ = 0;
+};
+
+/**
+ * @brief 请求作用域
+ *
+ * 在请求入口处决定是否采样，已处于被采样请求内时沿用外层请求
+ */
+class TraceRequestScope {
+public:
+    TraceRequestScope();
+    ~TraceRequestScope();
+
+    TraceRequestScope(const TraceRequestScope&) = delete;
+    TraceRequestScope& operator=(const TraceRequestScope&) = delete;
+
+private:
+    TraceContext saved_;
+};
+
+/**
+ * @brief 在当前线程安装复制来的上下文，析构时恢复
+ */
+class TraceContextScope {
+public:
+    explicit TraceContextScope(const TraceContext& context);
+    ~TraceContextScope();
+
+    TraceContextScope(const TraceContextScope&) = delete;
+    TraceContextScope& operator=(const TraceContextScope&) = delete;
+
+private:
+    TraceContext saved_;
+};
+
+/**
+ * @brief 追踪区间，构造时开始、析构时结束
+ *
+ * 当前请求未被采样时只读取一次线程局部变量，label只在被采样时复制
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category) {
+        TraceContext& context = Tracer::currentContext();
+        if (context.request_id != 0) {
+            begin(name, category, nullptr, context);
+        }
+    }
+
+    TraceSpan(const char* name, const char* category, const std::string& label) {
+        TraceContext& context = Tracer::currentContext();
+        if (context.request_id != 0) {
+            begin(name, category, &label, context);
+        }
+    }
+
+    ~TraceSpan() {
+        if (name_) {
+            end();
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_ = nullptr;
+    const char* category_ = nullptr;
+    std::string label_;
+    uint64_t start_ns_ = 0;
+    uint64_t request_id_ = 0;
+    uint32_t depth_ = 0;
+
+    void begin(const char* name, const char* category, const std::string* label, TraceContext& context);
+    void end();
+};
+
+} // namespace AlgorithmPlugins
+
+/**
+ * @brief 追踪埋点宏
+ *
+ * 未定义ALGORITHM_PLUGINS_TRACING时展开为空，埋点在编译期移除
+ */
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if defined(ALGORITHM_PLUGINS_TRACING)
+#define TRACE_REQUEST() \
+    ::AlgorithmPlugins::TraceRequestScope TRACE_CONCAT(trace_request_, __LINE__)
+#define TRACE_SPAN(name, category) \
+    ::AlgorithmPlugins::TraceSpan TRACE_CONCAT(trace_span_, __LINE__)(name, category)
+#define TRACE_SPAN_LABEL(name, category, label) \
+    ::AlgorithmPlugins::TraceSpan TRACE_CONCAT(trace_span_, __LINE__)(name, category, label)
+#define TRACE_CURRENT_CONTEXT() ::AlgorithmPlugins::Tracer::currentContext()
+#define TRACE_CONTEXT_SCOPE(context) \
+    ::AlgorithmPlugins::TraceContextScope TRACE_CONCAT(trace_context_, __LINE__)(context)
+#else
+#define TRACE_REQUEST() do {} while (0)
+#define TRACE_SPAN(name, category) do {} while (0)
+#define TRACE_SPAN_LABEL(name, category, label) do {} while (0)
+#define TRACE_CURRENT_CONTEXT() ::AlgorithmPlugins::TraceContext{}
+#define TRACE_CONTEXT_SCOPE(context) do { (void)(context); } while (0)
+#endif
@@ -21,6 +21,9 @@ public:
     std::string getVersion() const override;
     std::string getDescription() const override;
     
+    // 特征只取决于波形、转速和参数，重复的振动批次直接使用缓存结果
+    bool isPure() const override { return true; }
+    
     std::vector<std::string> getRequiredParameters() const override;
     std::vector<std::string> getOptionalParameters() const override;
     std::vector<std::string> getFeatureNames() const override;
@@ -37,10 +40,12 @@ protected:
 
 private:
     // 核心计算方法
+    // 各工况段并行计算，错误信息写入error而不修改插件状态
     bool computeSegmentFeatures(const std::vector<double>& segment_wave,
                                const std::vector<double>& speed_data,
                                int status,
-                               std::map<std::string, double>& features);
+                               std::map<std::string, double>& features,
+                               std::string& error);
     
     bool mergeSegmentFeatures(const std::vector<std::map<std::string, double>>& segment_features,
                              std::map<std::string, double>& merged_features);
@@ -58,6 +63,12 @@ private:
                         std::vector<double>& frequencies,
                         std::vector<double>& amplitudes);
     
+    // 幅度谱计算内核，按频点并行
+    static void computeAmplitudeSpectrum(const std::vector<double>& wave_data,
+                                         int sampling_rate,
+                                         std::vector<double>& frequencies,
+                                         std::vector<double>& amplitudes);
+    
     double findPeakFrequency(const std::vector<double>& frequencies,
                            const std::vector<double>& amplitudes);
     double findPeakPower(const std::vector<double>& amplitudes);
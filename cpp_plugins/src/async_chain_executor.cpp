@@ -0,0 +1,182 @@
+#include "async_chain_executor.h"
+#include "plugin_manager.h"
+#include <algorithm>
+#include <thread>
+
+namespace AlgorithmPlugins {
+
+AsyncChainExecutor::AsyncChainExecutor(PluginChainManager& chain_manager)
+    : AsyncChainExecutor(chain_manager, Options()) {
+}
+
+AsyncChainExecutor::AsyncChainExecutor(PluginChainManager& chain_manager, const Options& options)
+    : chain_manager_(chain_manager),
+      scheduler_(options.scheduler ? *options.scheduler : TaskScheduler::getInstance()),
+      overflow_policy_(options.overflow_policy),
+      queue_capacity_(std::max<size_t>(1, options.queue_capacity)),
+      max_concurrency_(options.worker_count) {
+    if (max_concurrency_ == 0) {
+        max_concurrency_ = std::max<size_t>(1, scheduler_.getThreadCount());
+    }
+}
+
+AsyncChainExecutor::~AsyncChainExecutor() {
+    shutdown();
+}
+
+bool AsyncChainExecutor::submit(const std::string& chain_name,
+                                std::shared_ptr<PluginData> input_data,
+                                std::shared_ptr<PluginResult> output_result,
+                                std::future<bool>& result) {
+    // std::function要求可拷贝，promise通过shared_ptr持有
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future();
+
+    bool accepted = submit(chain_name, std::move(input_data), std::move(output_result),
+                           [promise](bool success, std::shared_ptr<PluginResult>) {
+                               promise->set_value(success);
+                           });
+    if (accepted) {
+        result = std::move(future);
+    }
+
+    return accepted;
+}
+
+bool AsyncChainExecutor::submit(const std::string& chain_name,
+                                std::shared_ptr<PluginData> input_data,
+                                std::shared_ptr<PluginResult> output_result,
+                                Completion on_complete) {
+    // 同一设备的请求按提交顺序执行
+    std::string ordering_key = input_data ? input_data->getDeviceId() : std::string();
+    return enqueue(ordering_key, [this, chain_name, input_data = std::move(input_data),
+                    output_result = std::move(output_result),
+                    on_complete = std::move(on_complete)]() {
+        bool success = false;
+        try {
+            success = chain_manager_.executeChain(chain_name, input_data, output_result);
+        } catch (const std::exception&) {
+            success = false;
+        }
+
+        if (on_complete) {
+            on_complete(success, output_result);
+        }
+    });
+}
+
+bool AsyncChainExecutor::submitTask(std::function<void()> task) {
+    return submitTask(std::string(), std::move(task));
+}
+
+bool AsyncChainExecutor::submitTask(const std::string& ordering_key, std::function<void()> task) {
+    if (!task) {
+        return false;
+    }
+    return enqueue(ordering_key, std::move(task));
+}
+
+void AsyncChainExecutor::shutdown() {
+    std::call_once(shutdown_once_, [this] {
+        // 关闭后排空任务取完剩余请求再退出，排空任务引用this，须全部退出后才能返回
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        
+        while (active_drainers_ != 0 || queued_count_.load() != 0) {
+            if (scheduler_.isWorkerThread()) {
+                // 在调度器线程中关闭时协助执行，避免排空任务得不到线程
+                lock.unlock();
+                if (!scheduler_.runPendingTask()) {
+                    std::this_thread::yield();
+                }
+                lock.lock();
+            } else {
+                idle_.wait(lock);
+            }
+        }
+    });
+}
+
+bool AsyncChainExecutor::enqueue(const std::string& ordering_key, std::function<void()> task) {
+    bool start_drainer = false;
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (overflow_policy_ == OverflowPolicy::BLOCK) {
+            not_full_.wait(lock, [this] { return closed_ || queued_count_.load() < queue_capacity_; });
+        }
+        if (closed_ || queued_count_.load() >= queue_capacity_) {
+            rejected_count_++;
+            return false;
+        }
+        queued_count_.fetch_add(1);
+        
+        // 有序请求进入键队列，键第一次出现时才加入就绪队列，之后由处理该键的排空任务续排
+        bool became_ready = true;
+        if (ordering_key.empty()) {
+            ready_.push_back({std::string(), std::move(task)});
+        } else {
+            auto [it, inserted] = key_queues_.try_emplace(ordering_key);
+            it->second.push_back(std::move(task));
+            became_ready = inserted;
+            if (inserted) {
+                ready_.push_back({ordering_key, nullptr});
+            }
+        }
+        
+        if (became_ready && active_drainers_ < max_concurrency_) {
+            ++active_drainers_;
+            start_drainer = true;
+        }
+    }
+    
+    if (start_drainer) {
+        scheduler_.submit([this] { drainQueue(); });
+    }
+    return true;
+}
+
+void AsyncChainExecutor::drainQueue() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (!ready_.empty()) {
+        ReadyItem item = std::move(ready_.front());
+        ready_.pop_front();
+        
+        const bool ordered = !item.task;
+        std::function<void()> task = std::move(item.task);
+        if (ordered) {
+            auto& tasks = key_queues_[item.key];
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        queued_count_.fetch_sub(1);
+        lock.unlock();
+        not_full_.notify_one();
+        
+        try {
+            task();
+        } catch (const std::exception&) {
+            // 回调异常不影响继续处理后续请求
+        }
+        task = nullptr;
+        completed_count_++;
+        
+        // 执行期间该键不在就绪队列中，其他排空任务不会取出同一键的后续请求；
+        // 完成后有剩余请求时排到队尾，与其他键轮流执行
+        lock.lock();
+        if (ordered) {
+            auto it = key_queues_.find(item.key);
+            if (it->second.empty()) {
+                key_queues_.erase(it);
+            } else {
+                ready_.push_back({std::move(item.key), nullptr});
+            }
+        }
+    }
+    
+    // 持锁退出，shutdown返回后排空任务不再访问this
+    --active_drainers_;
+    idle_.notify_all();
+}
+
+} // namespace AlgorithmPlugins
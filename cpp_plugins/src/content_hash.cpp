@@ -0,0 +1,186 @@
+#include "content_hash.h"
+#include <algorithm>
+#include <cstring>
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// 按小端序读取，插件运行平台均为小端
+inline uint64_t read64(const unsigned char* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint32_t read32(const unsigned char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint64_t mixRound(uint64_t accumulator, uint64_t input) {
+    accumulator += input * kPrime2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t hash, uint64_t accumulator) {
+    hash ^= mixRound(0, accumulator);
+    return hash * kPrime1 + kPrime4;
+}
+
+} // namespace
+
+ContentHasher::ContentHasher(uint64_t seed) : seed_(seed) {
+    reset();
+}
+
+void ContentHasher::reset() {
+    accumulators_[0] = seed_ + kPrime1 + kPrime2;
+    accumulators_[1] = seed_ + kPrime2;
+    accumulators_[2] = seed_;
+    accumulators_[3] = seed_ - kPrime1;
+    total_length_ = 0;
+    buffer_size_ = 0;
+}
+
+void ContentHasher::update(const void* data, size_t length) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    total_length_ += length;
+
+    // 先补齐上次剩余的不足32字节部分
+    if (buffer_size_ > 0) {
+        size_t fill = std::min(length, sizeof(buffer_) - buffer_size_);
+        std::memcpy(buffer_ + buffer_size_, bytes, fill);
+        buffer_size_ += fill;
+        bytes += fill;
+        length -= fill;
+        if (buffer_size_ < sizeof(buffer_)) {
+            return;
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            accumulators_[lane] = mixRound(accumulators_[lane], read64(buffer_ + lane * 8));
+        }
+        buffer_size_ = 0;
+    }
+
+    // 整块数据直接处理，不经过缓冲区
+    while (length >= sizeof(buffer_)) {
+        for (int lane = 0; lane < 4; ++lane) {
+            accumulators_[lane] = mixRound(accumulators_[lane], read64(bytes + lane * 8));
+        }
+        bytes += sizeof(buffer_);
+        length -= sizeof(buffer_);
+    }
+
+    if (length > 0) {
+        std::memcpy(buffer_, bytes, length);
+        buffer_size_ = length;
+    }
+}
+
+void ContentHasher::update(uint64_t value) {
+    update(&value, sizeof(value));
+}
+
+void ContentHasher::update(int value) {
+    update(static_cast<uint64_t>(static_cast<int64_t>(value)));
+}
+
+void ContentHasher::update(double value) {
+    // 正负零视为相同的值
+    if (value == 0.0) {
+        value = 0.0;
+    }
+    update(&value, sizeof(value));
+}
+
+void ContentHasher::update(const std::string& value) {
+    update(static_cast<uint64_t>(value.size()));
+    update(value.data(), value.size());
+}
+
+void ContentHasher::update(const std::vector<double>& values) {
+    update(static_cast<uint64_t>(values.size()));
+    update(values.data(), values.size() * sizeof(double));
+}
+
+void ContentHasher::update(const std::map<std::string, double>& values) {
+    update(static_cast<uint64_t>(values.size()));
+    for (const auto& [key, value] : values) {
+        update(key);
+        update(value);
+    }
+}
+
+void ContentHasher::update(const std::map<std::string, std::string>& values) {
+    update(static_cast<uint64_t>(values.size()));
+    for (const auto& [key, value] : values) {
+        update(key);
+        update(value);
+    }
+}
+
+uint64_t ContentHasher::digest() const {
+    uint64_t hash;
+    if (total_length_ >= sizeof(buffer_)) {
+        hash = rotateLeft(accumulators_[0], 1) + rotateLeft(accumulators_[1], 7) +
+               rotateLeft(accumulators_[2], 12) + rotateLeft(accumulators_[3], 18);
+        for (int lane = 0; lane < 4; ++lane) {
+            hash = mergeRound(hash, accumulators_[lane]);
+        }
+    } else {
+        hash = seed_ + kPrime5;
+    }
+
+    hash += total_length_;
+
+    // 处理缓冲区中剩余的字节
+    const unsigned char* bytes = buffer_;
+    size_t remaining = buffer_size_;
+    while (remaining >= 8) {
+        hash ^= mixRound(0, read64(bytes));
+        hash = rotateLeft(hash, 27) * kPrime1 + kPrime4;
+        bytes += 8;
+        remaining -= 8;
+    }
+    if (remaining >= 4) {
+        hash ^= static_cast<uint64_t>(read32(bytes)) * kPrime1;
+        hash = rotateLeft(hash, 23) * kPrime2 + kPrime3;
+        bytes += 4;
+        remaining -= 4;
+    }
+    while (remaining > 0) {
+        hash ^= (*bytes) * kPrime5;
+        hash = rotateLeft(hash, 11) * kPrime1;
+        ++bytes;
+        --remaining;
+    }
+
+    // 雪崩混合
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t ContentHasher::hash(const void* data, size_t length, uint64_t seed) {
+    ContentHasher hasher(seed);
+    hasher.update(data, length);
+    return hasher.digest();
+}
+
+} // namespace AlgorithmPlugins
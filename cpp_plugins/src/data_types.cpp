@@ -1,4 +1,5 @@
 #include "data_types.h"
+#include "content_hash.h"
 #include <sstream>
 #include <iomanip>
 #include <cmath>
@@ -111,6 +112,18 @@ bool RealTimeData::deserialize(const std::string& data) {
     }
 }
 
+bool RealTimeData::getContentHash(uint64_t& hash) const {
+    ContentHasher hasher(static_cast<uint64_t>(DataType::REAL_TIME));
+    for (double value : {mean_hf_, mean_lf_, mean_, std_, feature1_, feature2_, feature3_, feature4_,
+                         temperature_, speed_, peak_freq_, peak_powers_}) {
+        hasher.update(value);
+    }
+    hasher.update(custom_features_);
+    hasher.update(extend_data_);
+    hash = hasher.digest();
+    return true;
+}
+
 // BatchData实现
 BatchData::BatchData(const std::string& deviceId, 
                      std::chrono::system_clock::time_point timestamp)
@@ -215,6 +228,18 @@ bool BatchData::deserialize(const std::string& data) {
     }
 }
 
+bool BatchData::getContentHash(uint64_t& hash) const {
+    ContentHasher hasher(static_cast<uint64_t>(DataType::BATCH_DATA));
+    hasher.update(sampling_rate_);
+    hasher.update(status_);
+    hasher.update(start_index_);
+    hasher.update(stop_index_);
+    hasher.update(speed_data_);
+    hasher.update(wave_data_);
+    hash = hasher.digest();
+    return true;
+}
+
 // FeatureData实现
 FeatureData::FeatureData(const std::string& deviceId, 
                          std::chrono::system_clock::time_point timestamp)
@@ -287,6 +312,13 @@ bool FeatureData::deserialize(const std::string& data) {
     }
 }
 
+bool FeatureData::getContentHash(uint64_t& hash) const {
+    ContentHasher hasher(static_cast<uint64_t>(DataType::FEATURE_DATA));
+    hasher.update(features_);
+    hash = hasher.digest();
+    return true;
+}
+
 // StatusData实现
 StatusData::StatusData(const std::string& deviceId, 
                        std::chrono::system_clock::time_point timestamp)
@@ -349,6 +381,19 @@ bool StatusData::deserialize(const std::string& data) {
     }
 }
 
+bool StatusData::getContentHash(uint64_t& hash) const {
+    ContentHasher hasher(static_cast<uint64_t>(DataType::STATUS_DATA));
+    hasher.update(status_);
+    hasher.update(status_desc_);
+    hasher.update(static_cast<uint64_t>(status_mapping_.size()));
+    for (const auto& [status, name] : status_mapping_) {
+        hasher.update(status);
+        hasher.update(name);
+    }
+    hash = hasher.digest();
+    return true;
+}
+
 // PluginResultImpl实现
 PluginResultImpl::PluginResultImpl() = default;
 
@@ -642,6 +687,24 @@ bool PluginParameterImpl::deserialize(const std::string& data) {
 }
 
 // PluginResultImpl数组方法实现
+void PluginResultImpl::copyTo(PluginResult& target) const {
+    for (const auto& [key, value] : string_data_) {
+        target.setData(key, value);
+    }
+    for (const auto& [key, value] : double_data_) {
+        target.setData(key, value);
+    }
+    for (const auto& [key, value] : int_data_) {
+        target.setData(key, value);
+    }
+}
+
+void PluginResultImpl::clear() {
+    string_data_.clear();
+    double_data_.clear();
+    int_data_.clear();
+}
+
 std::vector<std::string> PluginResultImpl::getStringArray(const std::string& key) const {
     // 简化实现，返回单个字符串作为数组
     std::string value = getStringData(key);
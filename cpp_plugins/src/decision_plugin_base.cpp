@@ -1,4 +1,5 @@
 #include "decision_plugin_base.h"
+#include "state_checkpoint.h"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
@@ -6,7 +7,8 @@
 namespace AlgorithmPlugins {
 
 // DecisionPluginBase实现
-DecisionPluginBase::DecisionPluginBase() = default;
+DecisionPluginBase::DecisionPluginBase() : status_history_(&status_histories_.get(0)) {
+}
 
 bool DecisionPluginBase::initialize(std::shared_ptr<PluginParameter> params) {
     try {
@@ -30,6 +32,65 @@ void DecisionPluginBase::cleanup() {
     parameters_.reset();
 }
 
+bool DecisionPluginBase::process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) {
+    if (!initialized_) {
+        setError("插件未初始化");
+        return false;
+    }
+    
+    if (!input || !output) {
+        setError("输入或输出数据为空");
+        return false;
+    }
+    
+    try {
+        return classifyStatus(input, output);
+    } catch (const std::exception& e) {
+        setError("状态识别异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool DecisionPluginBase::processBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                      const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                      std::vector<bool>& succeeded) {
+    succeeded.assign(inputs.size(), false);
+    
+    // 初始化与数量检查对整批只做一次
+    if (!initialized_) {
+        setError("插件未初始化");
+        return false;
+    }
+    
+    if (inputs.size() != outputs.size()) {
+        setError("批量输入输出数量不一致");
+        return false;
+    }
+    
+    try {
+        return classifyStatusBatch(inputs, outputs, succeeded);
+    } catch (const std::exception& e) {
+        setError("批量状态识别异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool DecisionPluginBase::classifyStatusBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                             const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                             std::vector<bool>& succeeded) {
+    bool all_succeeded = true;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!inputs[i] || !outputs[i]) {
+            setError("输入或输出数据为空");
+            all_succeeded = false;
+            continue;
+        }
+        succeeded[i] = classifyStatus(inputs[i], outputs[i]);
+        all_succeeded = all_succeeded && succeeded[i];
+    }
+    return all_succeeded;
+}
+
 bool DecisionPluginBase::classifyStatus(std::shared_ptr<PluginData> input, 
                                         std::shared_ptr<PluginResult> output) {
     if (!initialized_) {
@@ -53,18 +114,69 @@ bool DecisionPluginBase::classifyStatus(std::shared_ptr<PluginData> input,
     }
 }
 
+void DecisionPluginBase::selectDevice(DeviceHandle device) {
+    status_history_ = &status_histories_.get(device);
+}
+
+void DecisionPluginBase::selectInputDevice(const PluginData& input) {
+    selectDevice(DeviceRegistry::getInstance().getHandle(input.getDeviceId()));
+}
+
+namespace {
+
+// 状态快照格式版本，设备状态结构变化时递增
+constexpr uint32_t kDecisionStateVersion = 1;
+
+} // namespace
+
+bool DecisionPluginBase::saveState(StateWriter& writer, bool incremental) {
+    writer.writeU32(kDecisionStateVersion);
+    writeDeviceStates(writer, status_histories_, incremental,
+        [](StateWriter& w, const std::deque<int>& history) {
+            w.writeU64(history.size());
+            for (int status : history) {
+                w.writeI32(status);
+            }
+        });
+    return true;
+}
+
+bool DecisionPluginBase::loadState(StateReader& reader) {
+    uint32_t version = 0;
+    if (!reader.readU32(version) || version != kDecisionStateVersion) {
+        setError("状态快照版本不匹配");
+        return false;
+    }
+    bool ok = readDeviceStates(reader, status_histories_,
+        [](StateReader& r, std::deque<int>& history) {
+            uint64_t count = 0;
+            if (!r.readU64(count)) {
+                return false;
+            }
+            int status = 0;
+            for (uint64_t i = 0; i < count && r.readI32(status); ++i) {
+                history.push_back(status);
+            }
+            return !r.failed();
+        });
+    if (!ok) {
+        setError("状态快照数据不完整");
+    }
+    return ok;
+}
+
 void DecisionPluginBase::addStatusToHistory(int status) {
-    status_history_.push_back(status);
-    if (status_history_.size() > max_history_size_) {
-        status_history_.pop_front();
+    status_history_->push_back(status);
+    if (status_history_->size() > max_history_size_) {
+        status_history_->pop_front();
     }
 }
 
 int DecisionPluginBase::getMostFrequentStatus() const {
-    if (status_history_.empty()) return -1;
+    if (status_history_->empty()) return -1;
     
     std::map<int, int> status_count;
-    for (int status : status_history_) {
+    for (int status : *status_history_) {
         status_count[status]++;
     }
     
@@ -81,7 +193,50 @@ bool DecisionPluginBase::isStatusTransition(int current_status, int previous_sta
 }
 
 // UniversalClassifyPluginBase实现
-UniversalClassifyPluginBase::UniversalClassifyPluginBase() = default;
+UniversalClassifyPluginBase::UniversalClassifyPluginBase() : state_(&classify_states_.get(0)) {
+}
+
+void UniversalClassifyPluginBase::selectDevice(DeviceHandle device) {
+    DecisionPluginBase::selectDevice(device);
+    state_ = &classify_states_.get(device);
+}
+
+bool UniversalClassifyPluginBase::saveState(StateWriter& writer, bool incremental) {
+    if (!DecisionPluginBase::saveState(writer, incremental)) {
+        return false;
+    }
+    writeDeviceStates(writer, classify_states_, incremental,
+        [](StateWriter& w, const ClassifyState& state) {
+            w.writeTimePoint(state.prev_time);
+            w.writeTimePoint(state.time_point[0]);
+            w.writeTimePoint(state.time_point[1]);
+            w.writeI32(state.transition_counter);
+            w.writeI32(state.close_counter);
+            w.writeI32(state.time_series_counter);
+            w.writeI32(state.prev_status);
+        });
+    return true;
+}
+
+bool UniversalClassifyPluginBase::loadState(StateReader& reader) {
+    if (!DecisionPluginBase::loadState(reader)) {
+        return false;
+    }
+    bool ok = readDeviceStates(reader, classify_states_,
+        [](StateReader& r, ClassifyState& state) {
+            return r.readTimePoint(state.prev_time) &&
+                   r.readTimePoint(state.time_point[0]) &&
+                   r.readTimePoint(state.time_point[1]) &&
+                   r.readI32(state.transition_counter) &&
+                   r.readI32(state.close_counter) &&
+                   r.readI32(state.time_series_counter) &&
+                   r.readI32(state.prev_status);
+        });
+    if (!ok) {
+        setError("状态快照数据不完整");
+    }
+    return ok;
+}
 
 bool UniversalClassifyPluginBase::classifyStatus(std::shared_ptr<PluginData> input, 
                                                 std::shared_ptr<PluginResult> output) {
@@ -92,73 +247,159 @@ bool UniversalClassifyPluginBase::classifyStatus(std::shared_ptr<PluginData> inp
     }
     
     try {
+        // 切换到数据所属设备的历史状态
+        selectInputDevice(*feature_data);
+        
         // 离线检测
         offlineCheck(std::chrono::system_clock::now());
         
         // 获取特征值
-        std::map<std::string, double> features = feature_data->getFeatures();
+        const auto& features = feature_data->getFeatures();
+        const auto select_features = getSelectFeatures();
+        const auto thresholds = getThresholds();
         
         // 计算各特征状态
         std::vector<int> feature_statuses;
-        for (const auto& feature_name : getSelectFeatures()) {
-            auto it = features.find(feature_name);
-            if (it != features.end()) {
-                int status = calculateFeatureStatus(it->second, getThresholds()[feature_statuses.size()]);
-                feature_statuses.push_back(status);
-            } else {
-                setError("缺少特征: " + feature_name);
+        feature_statuses.reserve(select_features.size());
+        for (size_t i = 0; i < select_features.size(); ++i) {
+            auto it = features.find(select_features[i]);
+            if (it == features.end()) {
+                setError("缺少特征: " + select_features[i]);
                 return false;
             }
+            feature_statuses.push_back(calculateFeatureStatus(it->second, thresholds.at(i)));
         }
         
-        // 计算综合状态
-        int overall_status = calculateOverallStatus(feature_statuses);
+        return updateStatus(feature_statuses, getStatusMapping(), output);
         
-        // 处理过渡状态
-        if (prev_status_ != -1 && overall_status != prev_status_) {
-            if (handleTransition(overall_status, prev_status_)) {
-                overall_status = transition_status_;
-            }
-            
-            if (handleTimeSeriesTransition(overall_status, prev_status_)) {
-                overall_status = time_series_status_;
+    } catch (const std::exception& e) {
+        setError("状态分类异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool UniversalClassifyPluginBase::classifyStatusBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                                      const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                                      std::vector<bool>& succeeded) {
+    // 配置在整批内只取一次
+    const auto select_features = getSelectFeatures();
+    const auto thresholds = getThresholds();
+    const auto status_mapping = getStatusMapping();
+    if (thresholds.size() < select_features.size()) {
+        setError("阈值数量少于选择特征数量");
+        return false;
+    }
+    
+    const size_t item_count = inputs.size();
+    const size_t feature_count = select_features.size();
+    
+    // 收集特征矩阵（按特征列存放），缺失特征的数据整条标记为无效
+    std::vector<double> values(item_count * feature_count, 0.0);
+    std::vector<bool> valid(item_count, false);
+    for (size_t i = 0; i < item_count; ++i) {
+        auto* data = dynamic_cast<const FeatureData*>(inputs[i].get());
+        if (!data || !outputs[i]) {
+            continue;
+        }
+        const auto& features = data->getFeatures();
+        bool complete = true;
+        for (size_t f = 0; f < feature_count && complete; ++f) {
+            auto it = features.find(select_features[f]);
+            if (it == features.end()) {
+                complete = false;
+            } else {
+                values[f * item_count + i] = it->second;
             }
         }
+        valid[i] = complete;
+    }
+    
+    // 按特征列计算特征状态，同一列共用一组阈值
+    std::vector<int> statuses(item_count * feature_count, 0);
+    for (size_t f = 0; f < feature_count; ++f) {
+        const auto& threshold = thresholds[f];
+        const double* column = values.data() + f * item_count;
+        int* status_column = statuses.data() + f * item_count;
+        for (size_t i = 0; i < item_count; ++i) {
+            status_column[i] = calculateFeatureStatus(column[i], threshold);
+        }
+    }
+    
+    // 状态过渡依赖前一条结果，必须按输入顺序逐条处理
+    bool all_succeeded = true;
+    std::vector<int> feature_statuses(feature_count);
+    for (size_t i = 0; i < item_count; ++i) {
+        if (!valid[i]) {
+            setError("输入数据无效或缺少选择特征");
+            all_succeeded = false;
+            continue;
+        }
         
-        // 更新状态历史
-        addStatusToHistory(overall_status);
-        prev_status_ = overall_status;
-        
-        // 输出结果
-        output->setData("status", overall_status);
-        output->setData("status_name", getStatusMapping().at(overall_status));
-        output->setData("confidence", calculateConfidence(feature_statuses));
+        for (size_t f = 0; f < feature_count; ++f) {
+            feature_statuses[f] = statuses[f * item_count + i];
+        }
         
-        return true;
+        selectInputDevice(*inputs[i]);
+        offlineCheck(std::chrono::system_clock::now());
+        succeeded[i] = updateStatus(feature_statuses, status_mapping, outputs[i]);
+        all_succeeded = all_succeeded && succeeded[i];
+    }
+    
+    return all_succeeded;
+}
+
+bool UniversalClassifyPluginBase::updateStatus(const std::vector<int>& feature_statuses,
+                                               const std::map<int, std::string>& status_mapping,
+                                               std::shared_ptr<PluginResult> output) {
+    // 计算综合状态
+    int overall_status = calculateOverallStatus(feature_statuses);
+    
+    // 处理过渡状态
+    if (state_->prev_status != -1 && overall_status != state_->prev_status) {
+        if (handleTransition(overall_status, state_->prev_status)) {
+            overall_status = transition_status_;
+        }
         
-    } catch (const std::exception& e) {
-        setError("状态分类异常: " + std::string(e.what()));
+        if (handleTimeSeriesTransition(overall_status, state_->prev_status)) {
+            overall_status = time_series_status_;
+        }
+    }
+    
+    // 更新状态历史
+    addStatusToHistory(overall_status);
+    state_->prev_status = overall_status;
+    
+    auto name_it = status_mapping.find(overall_status);
+    if (name_it == status_mapping.end()) {
+        setError("状态映射中缺少状态: " + std::to_string(overall_status));
         return false;
     }
+    
+    // 输出结果
+    output->setData("status", overall_status);
+    output->setData("status_name", name_it->second);
+    output->setData("confidence", calculateConfidence(feature_statuses));
+    
+    return true;
 }
 
 void UniversalClassifyPluginBase::offlineCheck(std::chrono::system_clock::time_point current_time) {
-    if (prev_time_ != std::chrono::system_clock::time_point{}) {
-        auto duration = std::chrono::duration_cast<std::chrono::seconds>(current_time - prev_time_);
+    if (state_->prev_time != std::chrono::system_clock::time_point{}) {
+        auto duration = std::chrono::duration_cast<std::chrono::seconds>(current_time - state_->prev_time);
         if (duration.count() > offline_length_) {
             resetState();
         }
     }
-    prev_time_ = current_time;
+    state_->prev_time = current_time;
 }
 
 void UniversalClassifyPluginBase::resetState() {
-    transition_counter_ = 0;
-    close_counter_ = 0;
-    time_series_counter_ = 0;
-    prev_status_ = -1;
-    time_point_[0] = std::chrono::system_clock::time_point{};
-    time_point_[1] = std::chrono::system_clock::time_point{};
+    state_->transition_counter = 0;
+    state_->close_counter = 0;
+    state_->time_series_counter = 0;
+    state_->prev_status = -1;
+    state_->time_point[0] = std::chrono::system_clock::time_point{};
+    state_->time_point[1] = std::chrono::system_clock::time_point{};
 }
 
 int UniversalClassifyPluginBase::calculateFeatureStatus(double feature_value, const std::vector<double>& threshold) {
@@ -282,17 +523,17 @@ int Motor97Plugin::classifyByFeatures(const std::map<std::string, double>& featu
 bool Motor97Plugin::handleTransition(int current_status, int previous_status) {
     if (current_status == 1 && previous_status == 0) {
         // 开机过渡
-        transition_counter_++;
-        if (transition_counter_ >= transition_width_[0]) {
-            transition_counter_ = 0;
+        state_->transition_counter++;
+        if (state_->transition_counter >= transition_width_[0]) {
+            state_->transition_counter = 0;
             return true;
         }
     } else if (current_status == 0 && previous_status == 1) {
         // 关机过渡
-        close_counter_++;
-        if (close_counter_ >= transition_width_[1]) {
-            close_counter_ = 0;
-            transition_counter_ = 0;
+        state_->close_counter++;
+        if (state_->close_counter >= transition_width_[1]) {
+            state_->close_counter = 0;
+            state_->transition_counter = 0;
         }
     }
     
@@ -302,13 +543,13 @@ bool Motor97Plugin::handleTransition(int current_status, int previous_status) {
 bool Motor97Plugin::handleTimeSeriesTransition(int current_status, int previous_status) {
     if (time_series_width_[0] > 0) {
         if (current_status != previous_status) {
-            time_series_counter_++;
-            if (time_series_counter_ >= time_series_width_[0]) {
-                time_series_counter_ = 0;
+            state_->time_series_counter++;
+            if (state_->time_series_counter >= time_series_width_[0]) {
+                state_->time_series_counter = 0;
                 return true;
             }
         } else {
-            time_series_counter_ = 0;
+            state_->time_series_counter = 0;
         }
     }
     
@@ -376,7 +617,73 @@ void Motor97Plugin::parseAlarmRules(const std::string& rules_str) {
 }
 
 // UniversalClassify1Plugin实现
-UniversalClassify1Plugin::UniversalClassify1Plugin() = default;
+UniversalClassify1Plugin::UniversalClassify1Plugin() : sliding_windows_(&window_states_.get(0)) {
+}
+
+void UniversalClassify1Plugin::selectDevice(DeviceHandle device) {
+    UniversalClassifyPluginBase::selectDevice(device);
+    sliding_windows_ = &window_states_.get(device);
+    
+    // 设备首次出现时按当前配置创建窗口
+    if (sliding_windows_->empty()) {
+        initializeSlidingWindows();
+    }
+}
+
+bool UniversalClassify1Plugin::saveState(StateWriter& writer, bool incremental) {
+    if (!UniversalClassifyPluginBase::saveState(writer, incremental)) {
+        return false;
+    }
+    writeDeviceStates(writer, window_states_, incremental,
+        [](StateWriter& w, const SlidingWindows& windows) {
+            w.writeU64(windows.size());
+            for (const auto& feature_windows : windows) {
+                w.writeU64(feature_windows.size());
+                for (const auto& window : feature_windows) {
+                    w.writeDoubleArray(std::vector<double>(window.begin(), window.end()));
+                }
+            }
+        });
+    return true;
+}
+
+bool UniversalClassify1Plugin::loadState(StateReader& reader) {
+    if (!UniversalClassifyPluginBase::loadState(reader)) {
+        return false;
+    }
+    const size_t feature_count = select_features_.size();
+    bool ok = readDeviceStates(reader, window_states_,
+        [feature_count](StateReader& r, SlidingWindows& windows) {
+            uint64_t count = 0;
+            if (!r.readU64(count)) {
+                return false;
+            }
+            std::vector<double> values;
+            for (uint64_t i = 0; i < count; ++i) {
+                uint64_t window_count = 0;
+                if (!r.readU64(window_count)) {
+                    return false;
+                }
+                std::vector<std::deque<double>> feature_windows;
+                for (uint64_t j = 0; j < window_count; ++j) {
+                    if (!r.readDoubleArray(values)) {
+                        return false;
+                    }
+                    feature_windows.emplace_back(values.begin(), values.end());
+                }
+                windows.push_back(std::move(feature_windows));
+            }
+            // 特征配置已变化的窗口丢弃，切换到该设备时按当前配置重新创建
+            if (windows.size() != feature_count) {
+                windows.clear();
+            }
+            return true;
+        });
+    if (!ok) {
+        setError("状态快照数据不完整");
+    }
+    return ok;
+}
 
 bool UniversalClassify1Plugin::validateParameters() {
     // 获取必需参数
@@ -404,7 +711,8 @@ bool UniversalClassify1Plugin::validateParameters() {
     statistics_ = statistic_array;
     window_widths_ = window_width_array;
     
-    // 初始化滑动窗口
+    // 参数变化后各设备的窗口按新配置重建
+    window_states_.resetAll();
     initializeSlidingWindows();
     
     // 获取其他参数
@@ -517,7 +825,7 @@ int UniversalClassify1Plugin::calculateOverallStatus(const std::vector<int>& fea
 }
 
 void UniversalClassify1Plugin::initializeSlidingWindows() {
-    sliding_windows_.clear();
+    sliding_windows_->clear();
     
     for (size_t i = 0; i < select_features_.size(); ++i) {
         if (i < statistics_.size() && !statistics_[i].empty()) {
@@ -525,23 +833,23 @@ void UniversalClassify1Plugin::initializeSlidingWindows() {
             for (int width : window_widths_[i]) {
                 windows.emplace_back(width);
             }
-            sliding_windows_.push_back(windows);
+            sliding_windows_->push_back(windows);
         } else {
-            sliding_windows_.push_back({});
+            sliding_windows_->push_back({});
         }
     }
 }
 
 void UniversalClassify1Plugin::updateSlidingWindows(const std::vector<double>& stat_features) {
-    for (size_t i = 0; i < stat_features.size() && i < sliding_windows_.size(); ++i) {
-        for (auto& window : sliding_windows_[i]) {
+    for (size_t i = 0; i < stat_features.size() && i < sliding_windows_->size(); ++i) {
+        for (auto& window : (*sliding_windows_)[i]) {
             window.push_back(stat_features[i]);
         }
     }
 }
 
 void UniversalClassify1Plugin::clearSlidingWindows() {
-    for (auto& feature_windows : sliding_windows_) {
+    for (auto& feature_windows : *sliding_windows_) {
         for (auto& window : feature_windows) {
             window.clear();
         }
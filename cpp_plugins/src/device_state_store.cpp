@@ -0,0 +1,54 @@
+#include "device_state_store.h"
+#include <mutex>
+
+namespace AlgorithmPlugins {
+
+DeviceRegistry::DeviceRegistry() {
+    // 空设备ID固定占用句柄0，未设置设备ID的数据共用该状态
+    handles_.emplace("", 0);
+    device_ids_.emplace_back();
+}
+
+DeviceRegistry& DeviceRegistry::getInstance() {
+    static DeviceRegistry instance;
+    return instance;
+}
+
+DeviceHandle DeviceRegistry::getHandle(const std::string& device_id) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = handles_.find(device_id);
+        if (it != handles_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto [it, inserted] = handles_.emplace(device_id, static_cast<DeviceHandle>(device_ids_.size()));
+    if (inserted) {
+        device_ids_.push_back(device_id);
+    }
+    return it->second;
+}
+
+bool DeviceRegistry::findHandle(const std::string& device_id, DeviceHandle& handle) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = handles_.find(device_id);
+    if (it == handles_.end()) {
+        return false;
+    }
+    handle = it->second;
+    return true;
+}
+
+std::string DeviceRegistry::getDeviceId(DeviceHandle handle) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return handle < device_ids_.size() ? device_ids_[handle] : std::string();
+}
+
+size_t DeviceRegistry::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return device_ids_.size();
+}
+
+} // namespace AlgorithmPlugins
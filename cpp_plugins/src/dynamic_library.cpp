@@ -0,0 +1,224 @@
+#include "dynamic_library.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <elf.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+#if !defined(_WIN32)
+// 当前进程的ELF机器类型
+constexpr uint16_t nativeElfMachine() {
+#if defined(__x86_64__)
+    return EM_X86_64;
+#elif defined(__aarch64__)
+    return EM_AARCH64;
+#elif defined(__arm__)
+    return EM_ARM;
+#elif defined(__i386__)
+    return EM_386;
+#else
+    return EM_NONE;
+#endif
+}
+#endif
+
+} // namespace
+
+DynamicLibrary::DynamicLibrary(void* handle, const std::string& path, const FileStamp& stamp)
+    : handle_(handle), path_(path), stamp_(stamp) {
+}
+
+DynamicLibrary::~DynamicLibrary() {
+    if (!handle_) {
+        return;
+    }
+#if defined(_WIN32)
+    FreeLibrary(static_cast<HMODULE>(handle_));
+#else
+    dlclose(handle_);
+#endif
+    handle_ = nullptr;
+}
+
+std::shared_ptr<DynamicLibrary> DynamicLibrary::open(const std::string& file_path,
+                                                     bool lazy_binding,
+                                                     std::string& error) {
+    FileStamp stamp;
+    statFile(file_path, stamp);
+    return openAs(file_path, file_path, stamp, lazy_binding, error);
+}
+
+std::shared_ptr<DynamicLibrary> DynamicLibrary::openCopy(const std::string& file_path,
+                                                         bool lazy_binding,
+                                                         std::string& error) {
+#if defined(_WIN32)
+    // Windows下已加载的库文件被锁定，不会出现原地替换
+    (void)file_path;
+    (void)lazy_binding;
+    error = "当前平台不支持从副本加载插件库";
+    return nullptr;
+#else
+    FileStamp stamp;
+    if (!statFile(file_path, stamp)) {
+        error = "插件库文件不存在";
+        return nullptr;
+    }
+
+    // 副本文件名在进程内唯一，拥有独立的inode，dlopen不会复用旧映像
+    static std::atomic<uint64_t> copy_counter{0};
+    std::filesystem::path source(file_path);
+    std::filesystem::path copy_path = std::filesystem::temp_directory_path() /
+        ("algorithm_plugin_" + std::to_string(::getpid()) + "_" +
+         std::to_string(copy_counter.fetch_add(1, std::memory_order_relaxed)) + "_" +
+         source.filename().string());
+
+    std::error_code ec;
+    std::filesystem::copy_file(source, copy_path, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) {
+        error = "复制插件库失败: " + ec.message();
+        return nullptr;
+    }
+
+    auto library = openAs(copy_path.string(), file_path, stamp, lazy_binding, error);
+
+    // 映射建立后副本即可删除，库在dlclose前保持可用
+    std::filesystem::remove(copy_path, ec);
+    return library;
+#endif
+}
+
+std::shared_ptr<DynamicLibrary> DynamicLibrary::openAs(const std::string& load_path,
+                                                       const std::string& path,
+                                                       const FileStamp& stamp,
+                                                       bool lazy_binding,
+                                                       std::string& error) {
+#if defined(_WIN32)
+    (void)lazy_binding;
+    HMODULE handle = LoadLibraryA(load_path.c_str());
+    if (!handle) {
+        error = "LoadLibrary失败, 错误码: " + std::to_string(GetLastError());
+        return nullptr;
+    }
+#else
+    // RTLD_LOCAL避免不同插件库之间的符号互相覆盖
+    int flags = (lazy_binding ? RTLD_LAZY : RTLD_NOW) | RTLD_LOCAL;
+    void* handle = dlopen(load_path.c_str(), flags);
+    if (!handle) {
+        const char* dl_error = dlerror();
+        error = dl_error ? dl_error : "dlopen失败";
+        return nullptr;
+    }
+#endif
+
+    return std::shared_ptr<DynamicLibrary>(new DynamicLibrary(handle, path, stamp));
+}
+
+void* DynamicLibrary::getSymbol(const std::string& symbol_name) const {
+    if (!handle_) {
+        return nullptr;
+    }
+#if defined(_WIN32)
+    return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(handle_), symbol_name.c_str()));
+#else
+    return dlsym(handle_, symbol_name.c_str());
+#endif
+}
+
+bool DynamicLibrary::statFile(const std::string& file_path, FileStamp& stamp) {
+#if defined(_WIN32)
+    std::error_code ec;
+    auto size = std::filesystem::file_size(file_path, ec);
+    if (ec) {
+        return false;
+    }
+    auto mtime = std::filesystem::last_write_time(file_path, ec);
+    if (ec) {
+        return false;
+    }
+    stamp = FileStamp{};
+    stamp.size = size;
+    stamp.mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count();
+    return true;
+#else
+    struct stat st;
+    if (::stat(file_path.c_str(), &st) != 0) {
+        return false;
+    }
+    stamp.device = static_cast<uint64_t>(st.st_dev);
+    stamp.inode = static_cast<uint64_t>(st.st_ino);
+    stamp.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    stamp.size = static_cast<uint64_t>(st.st_size);
+    return true;
+#endif
+}
+
+bool DynamicLibrary::isSharedLibrary(const std::string& file_path) {
+#if defined(_WIN32)
+    return hasSharedLibraryExtension(file_path);
+#else
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    unsigned char ident[EI_NIDENT] = {0};
+    if (!file.read(reinterpret_cast<char*>(ident), EI_NIDENT)) {
+        return false;
+    }
+
+    if (std::memcmp(ident, ELFMAG, SELFMAG) != 0) {
+        return false;
+    }
+
+    // 位宽必须与当前进程一致
+    const unsigned char expected_class = (sizeof(void*) == 8) ? ELFCLASS64 : ELFCLASS32;
+    if (ident[EI_CLASS] != expected_class) {
+        return false;
+    }
+
+    // e_type和e_machine在32/64位ELF头中的偏移相同
+    uint16_t type_and_machine[2] = {0, 0};
+    if (!file.read(reinterpret_cast<char*>(type_and_machine), sizeof(type_and_machine))) {
+        return false;
+    }
+
+    if (type_and_machine[0] != ET_DYN) {
+        return false;
+    }
+
+    constexpr uint16_t machine = nativeElfMachine();
+    return machine == EM_NONE || type_and_machine[1] == machine;
+#endif
+}
+
+bool DynamicLibrary::hasSharedLibraryExtension(const std::string& file_path) {
+#if defined(_WIN32)
+    const std::string extension = ".dll";
+    return file_path.size() > extension.size() &&
+           file_path.compare(file_path.size() - extension.size(), extension.size(), extension) == 0;
+#else
+    // 同时接受带版本号的库文件，如libfoo.so.1
+    auto slash = file_path.find_last_of('/');
+    std::string file_name = (slash == std::string::npos) ? file_path : file_path.substr(slash + 1);
+    auto pos = file_name.find(".so");
+    if (pos == std::string::npos || pos == 0) {
+        return false;
+    }
+    return pos + 3 == file_name.size() || file_name[pos + 3] == '.';
+#endif
+}
+
+} // namespace AlgorithmPlugins
@@ -1,7 +1,11 @@
 #include "evaluation_plugin_base.h"
+#include "smoothing_kernels.h"
+#include "state_checkpoint.h"
+#include "trace_span.h"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <limits>
 
 namespace AlgorithmPlugins {
 
@@ -30,6 +34,65 @@ void EvaluationPluginBase::cleanup() {
     parameters_.reset();
 }
 
+bool EvaluationPluginBase::process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) {
+    if (!initialized_) {
+        setError("插件未初始化");
+        return false;
+    }
+    
+    if (!input || !output) {
+        setError("输入或输出数据为空");
+        return false;
+    }
+    
+    try {
+        return evaluateHealth(input, output);
+    } catch (const std::exception& e) {
+        setError("健康评估异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool EvaluationPluginBase::processBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                        const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                        std::vector<bool>& succeeded) {
+    succeeded.assign(inputs.size(), false);
+    
+    // 初始化与数量检查对整批只做一次
+    if (!initialized_) {
+        setError("插件未初始化");
+        return false;
+    }
+    
+    if (inputs.size() != outputs.size()) {
+        setError("批量输入输出数量不一致");
+        return false;
+    }
+    
+    try {
+        return evaluateHealthBatch(inputs, outputs, succeeded);
+    } catch (const std::exception& e) {
+        setError("批量健康评估异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool EvaluationPluginBase::evaluateHealthBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                               const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                               std::vector<bool>& succeeded) {
+    bool all_succeeded = true;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!inputs[i] || !outputs[i]) {
+            setError("输入或输出数据为空");
+            all_succeeded = false;
+            continue;
+        }
+        succeeded[i] = evaluateHealth(inputs[i], outputs[i]);
+        all_succeeded = all_succeeded && succeeded[i];
+    }
+    return all_succeeded;
+}
+
 bool EvaluationPluginBase::evaluateHealth(std::shared_ptr<PluginData> input, 
                                           std::shared_ptr<PluginResult> output) {
     if (!initialized_) {
@@ -107,59 +170,253 @@ std::map<std::string, double> EvaluationPluginBase::mergeHealthScores(const std:
 }
 
 // RealtimeHealthPluginBase实现
-RealtimeHealthPluginBase::RealtimeHealthPluginBase() = default;
+RealtimeHealthPluginBase::RealtimeHealthPluginBase() : state_(&health_states_.get(0)) {
+}
+
+void RealtimeHealthPluginBase::selectDevice(DeviceHandle device) {
+    state_ = &health_states_.get(device);
+}
+
+namespace {
+
+// 状态快照格式版本，HealthState结构变化时递增
+constexpr uint32_t kHealthStateVersion = 3;
+
+} // namespace
+
+bool RealtimeHealthPluginBase::saveState(StateWriter& writer, bool incremental) {
+    writer.writeU32(kHealthStateVersion);
+    writeDeviceStates(writer, health_states_, incremental,
+        [](StateWriter& w, const HealthState& state) {
+            w.writeU64(state.feature_history.size());
+            for (const auto& [key, history] : state.feature_history) {
+                w.writeString(key);
+                w.writeU64(history.values.size());
+                for (size_t i = 0; i < history.values.size(); ++i) {
+                    w.writeDouble(history.values[i]);
+                    w.writeTimePoint(history.times[i]);
+                }
+                history.long_term.save(w);
+            }
+            w.writeDoubleMap(state.last_health_scores);
+            w.writeI32(state.current_status);
+            w.writeI32(state.close_count);
+            w.writeI32(state.run_count);
+            w.writeTimePoint(state.prev_time);
+        });
+    return true;
+}
+
+bool RealtimeHealthPluginBase::loadState(StateReader& reader) {
+    uint32_t version = 0;
+    if (!reader.readU32(version) || version != kHealthStateVersion) {
+        setError("状态快照版本不匹配");
+        return false;
+    }
+    // 按当前容量恢复，快照中的数据多于容量时保留最新的部分
+    const size_t capacity = static_cast<size_t>(std::max(history_capacity_, 0));
+    bool ok = readDeviceStates(reader, health_states_,
+        [capacity](StateReader& r, HealthState& state) {
+            uint64_t count = 0;
+            std::string key;
+            if (!r.readU64(count)) {
+                return false;
+            }
+            for (uint64_t i = 0; i < count; ++i) {
+                uint64_t value_count = 0;
+                if (!r.readString(key) || !r.readU64(value_count)) {
+                    return false;
+                }
+                auto& history = state.feature_history[key];
+                history.values.setCapacity(capacity);
+                history.times.setCapacity(capacity);
+                double value = 0.0;
+                std::chrono::system_clock::time_point time;
+                for (uint64_t j = 0; j < value_count; ++j) {
+                    if (!r.readDouble(value) || !r.readTimePoint(time)) {
+                        return false;
+                    }
+                    history.values.push_back(value);
+                    history.times.push_back(time);
+                }
+                history.statistics.rebuild(history.values);
+                if (!history.long_term.load(r)) {
+                    return false;
+                }
+            }
+            return r.readDoubleMap(state.last_health_scores) &&
+                   r.readI32(state.current_status) &&
+                   r.readI32(state.close_count) &&
+                   r.readI32(state.run_count) &&
+                   r.readTimePoint(state.prev_time);
+        });
+    if (!ok) {
+        setError("状态快照数据不完整");
+    }
+    return ok;
+}
 
 bool RealtimeHealthPluginBase::evaluateHealth(std::shared_ptr<PluginData> input, 
                                               std::shared_ptr<PluginResult> output) {
     try {
-        // 离线检测
-        offlineCheck(std::chrono::system_clock::now());
-        
-        // 状态检查和数据缓存
-        if (!statusCheckAndCacheData(input, std::chrono::system_clock::now())) {
-            // 使用上次结果
-            for (const auto& [key, value] : last_health_scores_) {
-                output->setData(key, value);
-            }
-            return true;
-        }
-        
-        // 各特征的统计量计算与分数评估
-        std::map<std::string, double> stat_scores;
-        for (const auto& stat : getFeatureStats()) {
-            auto scores = calculateFeatureHealth(stat, feature_cache_[stat.analysis_features]);
-            stat_scores.insert(scores.begin(), scores.end());
+        return evaluateWithConfigs(input, output, getFeatureStats(), getHealthConfigs());
+    } catch (const std::exception& e) {
+        setError("实时健康度评估异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool RealtimeHealthPluginBase::evaluateHealthBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                                   const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                                   std::vector<bool>& succeeded) {
+    const auto feature_stats = getFeatureStats();
+    const auto health_configs = getHealthConfigs();
+    
+    // 第一阶段：缓存与状态计数依赖输入顺序，逐条处理并计算特征分数
+    std::vector<HealthState*> states(inputs.size(), nullptr);
+    std::vector<size_t> scored_indices;
+    std::vector<std::map<std::string, double>> scored_features;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!inputs[i] || !outputs[i]) {
+            setError("输入或输出数据为空");
+            continue;
         }
         
-        // 组合输出的健康度曲线
-        for (const auto& config : getHealthConfigs()) {
-            auto health_scores = calculateOverallHealth({config}, stat_scores);
-            for (const auto& [key, value] : health_scores) {
-                output->setData(key, value);
-                last_health_scores_[key] = value;
+        try {
+            TRACE_SPAN("health.evaluate", "evaluation");
+            std::map<std::string, double> stat_scores;
+            if (computeFeatureScores(inputs[i], feature_stats, stat_scores)) {
+                scored_indices.push_back(i);
+                scored_features.push_back(std::move(stat_scores));
             }
+            states[i] = state_;
+        } catch (const std::exception& e) {
+            setError("实时健康度评估异常: " + std::string(e.what()));
         }
-        
-        return true;
-        
+    }
+    
+    // 第二阶段：健康度只依赖特征分数，整批一次计算
+    std::vector<std::map<std::string, double>> health_scores;
+    try {
+        health_scores = calculateOverallHealthBatch(health_configs, scored_features);
     } catch (const std::exception& e) {
         setError("实时健康度评估异常: " + std::string(e.what()));
+        for (size_t index : scored_indices) {
+            states[index] = nullptr;
+        }
+        health_scores.assign(scored_indices.size(), {});
+    }
+    
+    // 第三阶段：按输入顺序写出结果，同一设备后续未评估的数据沿用前面数据的结果
+    bool all_succeeded = true;
+    size_t next_scored = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const bool scored = next_scored < scored_indices.size() && scored_indices[next_scored] == i;
+        HealthState* state = states[i];
+        if (state) {
+            if (scored) {
+                for (const auto& [key, value] : health_scores[next_scored]) {
+                    outputs[i]->setData(key, value);
+                    state->last_health_scores[key] = value;
+                }
+            } else {
+                for (const auto& [key, value] : state->last_health_scores) {
+                    outputs[i]->setData(key, value);
+                }
+            }
+            succeeded[i] = true;
+        }
+        if (scored) {
+            ++next_scored;
+        }
+        all_succeeded = all_succeeded && succeeded[i];
+    }
+    
+    return all_succeeded;
+}
+
+bool RealtimeHealthPluginBase::computeFeatureScores(std::shared_ptr<PluginData> input,
+                                                    const std::vector<FeatureStat>& feature_stats,
+                                                    std::map<std::string, double>& stat_scores) {
+    // 切换到数据所属设备的缓存
+    selectDevice(DeviceRegistry::getInstance().getHandle(input->getDeviceId()));
+    
+    // 离线检测
+    auto current_time = std::chrono::system_clock::now();
+    offlineCheck(current_time);
+    
+    // 状态检查和数据缓存
+    if (!statusCheckAndCacheData(input, current_time, feature_stats)) {
         return false;
     }
+    
+    // 各特征的统计量计算与分数评估
+    for (const auto& stat : feature_stats) {
+        auto scores = calculateFeatureHealth(stat, state_->feature_history[stat.analysis_features]);
+        stat_scores.insert(scores.begin(), scores.end());
+    }
+    return true;
+}
+
+bool RealtimeHealthPluginBase::evaluateWithConfigs(std::shared_ptr<PluginData> input,
+                                                   std::shared_ptr<PluginResult> output,
+                                                   const std::vector<FeatureStat>& feature_stats,
+                                                   const std::vector<HealthConfig>& health_configs) {
+    TRACE_SPAN("health.evaluate", "evaluation");
+    
+    std::map<std::string, double> stat_scores;
+    if (!computeFeatureScores(input, feature_stats, stat_scores)) {
+        // 使用上次结果
+        for (const auto& [key, value] : state_->last_health_scores) {
+            output->setData(key, value);
+        }
+        return true;
+    }
+    
+    // 组合输出的健康度曲线
+    for (const auto& config : health_configs) {
+        auto health_scores = calculateOverallHealth({config}, stat_scores);
+        for (const auto& [key, value] : health_scores) {
+            output->setData(key, value);
+            state_->last_health_scores[key] = value;
+        }
+    }
+    
+    return true;
+}
+
+std::vector<std::map<std::string, double>> RealtimeHealthPluginBase::calculateOverallHealthBatch(
+    const std::vector<HealthConfig>& configs,
+    const std::vector<std::map<std::string, double>>& feature_scores) {
+    std::vector<std::map<std::string, double>> results(feature_scores.size());
+    for (size_t i = 0; i < feature_scores.size(); ++i) {
+        for (const auto& config : configs) {
+            for (const auto& [key, value] : calculateOverallHealth({config}, feature_scores[i])) {
+                results[i][key] = value;
+            }
+        }
+    }
+    return results;
 }
 
 void RealtimeHealthPluginBase::offlineCheck(std::chrono::system_clock::time_point current_time) {
-    if (prev_time_ != std::chrono::system_clock::time_point{}) {
-        auto duration = std::chrono::duration_cast<std::chrono::seconds>(current_time - prev_time_);
+    if (state_->prev_time != std::chrono::system_clock::time_point{}) {
+        auto duration = std::chrono::duration_cast<std::chrono::seconds>(current_time - state_->prev_time);
         if (duration.count() > offline_length_) {
             resetCache(true);
         }
     }
-    prev_time_ = current_time;
+    state_->prev_time = current_time;
 }
 
 bool RealtimeHealthPluginBase::statusCheckAndCacheData(std::shared_ptr<PluginData> input_data,
                                                       std::chrono::system_clock::time_point current_time) {
+    return statusCheckAndCacheData(input_data, current_time, getFeatureStats());
+}
+
+bool RealtimeHealthPluginBase::statusCheckAndCacheData(std::shared_ptr<PluginData> input_data,
+                                                      std::chrono::system_clock::time_point current_time,
+                                                      const std::vector<FeatureStat>& feature_stats) {
     try {
         // 获取状态数据
         int status = 0;
@@ -185,25 +442,30 @@ bool RealtimeHealthPluginBase::statusCheckAndCacheData(std::shared_ptr<PluginDat
         
         // 状态检查
         if (status == 1) { // 运行状态
-            run_count_++;
-            close_count_ = 0;
+            state_->run_count++;
+            state_->close_count = 0;
             
-            // 缓存特征数据
-            for (const auto& stat : getFeatureStats()) {
-                auto it = features.find(stat.analysis_features);
-                if (it != features.end()) {
-                    feature_cache_[stat.analysis_features].push_back(it->second);
-                    time_cache_[stat.analysis_status].push_back(current_time);
+            // 缓存特征数据，多个统计共用的特征只写入一次
+            for (size_t i = 0; i < feature_stats.size(); ++i) {
+                const std::string& feature = feature_stats[i].analysis_features;
+                bool cached = false;
+                for (size_t j = 0; j < i && !cached; ++j) {
+                    cached = feature_stats[j].analysis_features == feature;
+                }
+                auto it = features.find(feature);
+                if (!cached && it != features.end()) {
+                    appendHistory(state_->feature_history[feature], historySettings(feature_stats, feature),
+                                  it->second, current_time);
                 }
             }
             
             return true;
         } else {
-            close_count_++;
-            run_count_ = 0;
+            state_->close_count++;
+            state_->run_count = 0;
             
             // 检查是否超过非关注状态持续时长
-            if (close_count_ >= close_width_) {
+            if (state_->close_count >= close_width_) {
                 resetCache(false);
                 return false;
             }
@@ -217,14 +479,92 @@ bool RealtimeHealthPluginBase::statusCheckAndCacheData(std::shared_ptr<PluginDat
     }
 }
 
+RealtimeHealthPluginBase::HistorySettings RealtimeHealthPluginBase::historySettings(
+    const std::vector<FeatureStat>& feature_stats, const std::string& feature) const {
+    // 只做长期平滑的统计不需要原始数据
+    HistorySettings settings;
+    for (const auto& stat : feature_stats) {
+        if (stat.analysis_features != feature) {
+            continue;
+        }
+        const bool long_term_only = stat.long_smooth_spec.enabled() && stat.statistic.empty();
+        if (!long_term_only) {
+            settings.capacity = static_cast<size_t>(std::max(history_capacity_, 0));
+        }
+        if (std::find(stat.statistic.begin(), stat.statistic.end(), "median") != stat.statistic.end()) {
+            settings.track_median = true;
+        }
+        if (!settings.long_smooth && stat.long_smooth_spec.enabled()) {
+            settings.long_smooth = &stat.long_smooth_spec;
+        }
+    }
+    return settings;
+}
+
+bool RealtimeHealthPluginBase::validateFeatureStats(const std::vector<FeatureStat>& feature_stats) {
+    for (size_t i = 0; i < feature_stats.size(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            const auto& a = feature_stats[i];
+            const auto& b = feature_stats[j];
+            if (a.analysis_features == b.analysis_features && a.long_smooth_spec.enabled() &&
+                b.long_smooth_spec.enabled() && a.long_smooth != b.long_smooth) {
+                setError("特征" + a.analysis_features + "的长期平滑参数不一致");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void RealtimeHealthPluginBase::appendHistory(FeatureHistory& history, const HistorySettings& settings, double value,
+                                             std::chrono::system_clock::time_point time) {
+    // 长期平滑只保存每个速率的当前状态
+    if (settings.long_smooth) {
+        history.long_term.update(*settings.long_smooth, value, time);
+    }
+    
+    // 首次写入或容量参数变化时调整容量，之后追加不再分配内存
+    const size_t capacity = settings.capacity;
+    const bool track_median = settings.track_median;
+    if (history.values.capacity() != capacity || history.statistics.tracksMedian() != track_median) {
+        history.values.setCapacity(capacity);
+        history.times.setCapacity(capacity);
+        history.statistics.setTrackMedian(track_median);
+        history.statistics.rebuild(history.values);
+    }
+    if (capacity == 0) {
+        return;
+    }
+    
+    if (history.values.full()) {
+        history.statistics.popFront(history.values.front());
+    }
+    history.values.push_back(value);
+    history.times.push_back(time);
+    history.statistics.push(value);
+    
+    // 时间按写入顺序递增，从头部淘汰超出保留时长的数据
+    const auto oldest = time - std::chrono::seconds(history_window_);
+    while (!history.times.empty() && history.times.front() < oldest) {
+        history.statistics.popFront(history.values.front());
+        history.values.pop_front();
+        history.times.pop_front();
+    }
+}
+
 void RealtimeHealthPluginBase::resetCache(bool all_cache) {
     if (all_cache) {
-        feature_cache_.clear();
-        time_cache_.clear();
+        // 保留已分配的缓冲区，设备恢复上线后直接复用
+        for (auto& [key, history] : state_->feature_history) {
+            history.values.clear();
+            history.times.clear();
+            history.statistics.clear();
+            history.long_term.clear();
+        }
     }
     
-    close_count_ = 0;
-    run_count_ = 0;
+    state_->close_count = 0;
+    state_->run_count = 0;
 }
 
 // CompRealtimeHealth34Plugin实现
@@ -249,10 +589,25 @@ bool CompRealtimeHealth34Plugin::validateParameters() {
     parseFeatureStats(feature_stats_str);
     parseHealthConfigs(healths_str);
     
+    // 长期平滑参数只解析一次，逐条数据更新时直接使用
+    for (auto& stat : feature_stats_) {
+        stat.long_smooth_spec = LongSmoothSpec::parse(stat.long_smooth);
+    }
+    if (!validateFeatureStats(feature_stats_)) {
+        return false;
+    }
+    
     // 获取可选参数
     offline_length_ = parameters_->getInt("offline_length", 86400 * 15);
     minimum_quantity_ = parameters_->getInt("minimum_quantity", 30);
     close_width_ = parameters_->getInt("close_width", 1);
+    history_capacity_ = parameters_->getInt("history_capacity", 86400);
+    history_window_ = parameters_->getInt("history_window", offline_length_);
+    
+    // 编译健康度公式，表达式错误在初始化时报告
+    if (!compileHealthFormulas(parameters_->getString("health_formulas", ""))) {
+        return false;
+    }
     
     // 获取健康度定义和默认分数
     auto health_def_array = parameters_->getStringArray("health_define");
@@ -281,21 +636,55 @@ std::vector<RealtimeHealthPluginBase::HealthConfig> CompRealtimeHealth34Plugin::
 }
 
 std::map<std::string, double> CompRealtimeHealth34Plugin::calculateFeatureHealth(const FeatureStat& stat,
-                                                                                 const std::vector<double>& data) {
+                                                                                 const FeatureHistory& history) {
+    TRACE_SPAN_LABEL("health.feature", "evaluation", stat.result_key);
+    
     std::map<std::string, double> scores;
     
-    if (data.size() < minimum_quantity_) {
+    // 只做长期平滑的特征不保留原始数据，按长期平滑已处理的数据量判断
+    const LongSmoothSpec& long_smooth = stat.long_smooth_spec;
+    const size_t quantity = long_smooth.enabled() && stat.statistic.empty() ?
+        static_cast<size_t>(history.long_term.count()) : history.values.size();
+    if (quantity < static_cast<size_t>(std::max(minimum_quantity_, 0))) {
         // 数据量不足，返回默认分数
         scores[stat.result_key] = 100.0;
         return scores;
     }
     
     try {
-        // 数据清洗
-        std::vector<double> cleaned_data = cleanData(data, stat.clean_formula);
+        // 长期平滑结果与统计方法一样换算为分数，多个速率时各速率分别给出
+        if (long_smooth.enabled()) {
+            const size_t rate_count = long_smooth.rates.size();
+            for (size_t rate = 0; rate < rate_count; ++rate) {
+                std::string key = stat.result_key + "_long";
+                if (rate_count > 1) {
+                    key += "_" + std::to_string(rate);
+                }
+                scores[key] = convertToScore(history.long_term.value(long_smooth, rate), stat.thresholds, stat.upper_limit);
+            }
+        }
+        
+        // 不需要清洗和平滑时统计量取自随历史增量维护的结果，代价与历史长度无关
+        const bool incremental = stat.clean_formula.empty() &&
+            !SmoothingSpec::parse(stat.move_smooth_param).enabled() &&
+            std::all_of(stat.statistic.begin(), stat.statistic.end(),
+                        [&history](const std::string& method) { return history.statistics.supports(method); });
+        if (incremental && history.statistics.size() == history.values.size()) {
+            for (const auto& method : stat.statistic) {
+                double stat_value = history.statistics.get(method);
+                scores[stat.result_key + "_" + method] = convertToScore(stat_value, stat.thresholds, stat.upper_limit);
+            }
+            addAverageScore(stat.result_key, scores);
+            return scores;
+        }
+        
+        // 数据清洗，历史数据按写入顺序展开为连续数组后原地清洗
+        std::vector<double> data;
+        history.values.copyTo(data);
+        cleanData(data, stat.clean_formula);
         
         // 平滑处理
-        std::vector<double> smoothed_data = smoothData(cleaned_data, stat.move_smooth_param);
+        std::vector<double> smoothed_data = smoothData(data, stat.move_smooth_param);
         
         // 计算统计量
         for (const auto& method : stat.statistic) {
@@ -304,14 +693,7 @@ std::map<std::string, double> CompRealtimeHealth34Plugin::calculateFeatureHealth
             scores[stat.result_key + "_" + method] = score;
         }
         
-        // 计算综合分数
-        double avg_score = 0.0;
-        for (const auto& [key, value] : scores) {
-            avg_score += value;
-        }
-        avg_score /= scores.size();
-        scores[stat.result_key] = avg_score;
-        
+        addAverageScore(stat.result_key, scores);
         return scores;
         
     } catch (const std::exception& e) {
@@ -321,8 +703,21 @@ std::map<std::string, double> CompRealtimeHealth34Plugin::calculateFeatureHealth
     }
 }
 
+void CompRealtimeHealth34Plugin::addAverageScore(const std::string& result_key,
+                                                 std::map<std::string, double>& scores) {
+    // 综合分数为各统计方法分数的平均值
+    double avg_score = 0.0;
+    for (const auto& [key, value] : scores) {
+        avg_score += value;
+    }
+    avg_score /= scores.size();
+    scores[result_key] = avg_score;
+}
+
 std::map<std::string, double> CompRealtimeHealth34Plugin::calculateOverallHealth(const std::vector<HealthConfig>& configs,
                                                                                  const std::map<std::string, double>& feature_scores) {
+    TRACE_SPAN("health.scoring", "evaluation");
+    
     std::map<std::string, double> health_scores;
     
     for (const auto& config : configs) {
@@ -344,15 +739,142 @@ std::map<std::string, double> CompRealtimeHealth34Plugin::calculateOverallHealth
                 health_scores[config.name] = 100.0; // 默认分数
             }
         } else {
-            // 其他计算公式
-            health_scores[config.name] = 100.0; // 默认分数
+            // 其他计算公式使用初始化时编译的表达式
+            auto formula_it = health_formulas_.find(config.name);
+            if (formula_it != health_formulas_.end()) {
+                health_scores[config.name] = evaluateFormula(formula_it->second, feature_scores);
+            } else {
+                health_scores[config.name] = 100.0; // 默认分数
+            }
         }
     }
     
     return health_scores;
 }
 
+std::vector<std::map<std::string, double>> CompRealtimeHealth34Plugin::calculateOverallHealthBatch(
+    const std::vector<HealthConfig>& configs,
+    const std::vector<std::map<std::string, double>>& feature_scores) {
+    TRACE_SPAN("health.scoring_batch", "evaluation");
+    
+    const size_t count = feature_scores.size();
+    std::vector<std::map<std::string, double>> results(count);
+    if (count == 0) {
+        return results;
+    }
+    
+    std::vector<double> slots;
+    std::vector<double> values(count);
+    for (const auto& config : configs) {
+        auto formula_it = health_formulas_.find(config.name);
+        if (config.formula == "weighted_average" || formula_it == health_formulas_.end()) {
+            for (size_t i = 0; i < count; ++i) {
+                for (const auto& [key, value] : calculateOverallHealth({config}, feature_scores[i])) {
+                    results[i][key] = value;
+                }
+            }
+            continue;
+        }
+        
+        // 按列填入公式引用的特征分数，整批执行一遍字节码
+        const HealthFormula& formula = formula_it->second;
+        slots.assign(formula_symbols_.size() * count, std::numeric_limits<double>::quiet_NaN());
+        for (size_t slot : formula.getReferencedSlots()) {
+            const std::string& name = formula_symbols_.names()[slot];
+            double* column = slots.data() + slot * count;
+            for (size_t i = 0; i < count; ++i) {
+                auto it = feature_scores[i].find(name);
+                if (it != feature_scores[i].end()) {
+                    column[i] = it->second;
+                }
+            }
+        }
+        formula.evaluateBatch(slots.data(), count, values.data());
+        
+        for (size_t i = 0; i < count; ++i) {
+            results[i][config.name] = std::isfinite(values[i]) ? values[i] : 100.0; // 默认分数
+        }
+    }
+    
+    return results;
+}
+
+double CompRealtimeHealth34Plugin::evaluateFormula(const HealthFormula& formula,
+                                                   const std::map<std::string, double>& feature_scores) {
+    formula_slots_.assign(formula_symbols_.size(), std::numeric_limits<double>::quiet_NaN());
+    for (size_t slot : formula.getReferencedSlots()) {
+        auto it = feature_scores.find(formula_symbols_.names()[slot]);
+        if (it != feature_scores.end()) {
+            formula_slots_[slot] = it->second;
+        }
+    }
+    
+    double value = formula.evaluate(formula_slots_.data());
+    return std::isfinite(value) ? value : 100.0; // 默认分数
+}
+
+bool CompRealtimeHealth34Plugin::compileHealthFormulas(const std::string& formulas_str) {
+    // 名称=表达式，多个公式以分号分隔
+    size_t begin = 0;
+    while (begin < formulas_str.size()) {
+        size_t end = formulas_str.find(';', begin);
+        if (end == std::string::npos) {
+            end = formulas_str.size();
+        }
+        std::string entry = formulas_str.substr(begin, end - begin);
+        begin = end + 1;
+        
+        if (entry.find_first_not_of(" \t") == std::string::npos) {
+            continue;
+        }
+        size_t equal = entry.find('=');
+        if (equal == std::string::npos) {
+            setError("health_formulas格式错误: " + entry);
+            return false;
+        }
+        
+        std::string name = entry.substr(0, equal);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (name.empty()) {
+            setError("health_formulas缺少健康度名称: " + entry);
+            return false;
+        }
+        
+        HealthConfig config;
+        config.name = name;
+        config.formula = entry.substr(equal + 1);
+        health_configs_.push_back(config);
+    }
+    
+    // 编译全部非weighted_average的公式，依赖的特征由表达式中的变量确定
+    formula_symbols_ = FormulaSymbols();
+    health_formulas_.clear();
+    for (auto& config : health_configs_) {
+        if (config.formula == "weighted_average") {
+            continue;
+        }
+        
+        HealthFormula formula;
+        std::string error;
+        if (!formula.compile(config.formula, formula_symbols_, error)) {
+            setError("健康度公式" + config.name + "编译失败: " + error);
+            return false;
+        }
+        
+        config.dependencies.clear();
+        for (size_t slot : formula.getReferencedSlots()) {
+            config.dependencies.push_back(formula_symbols_.names()[slot]);
+        }
+        health_formulas_[config.name] = std::move(formula);
+    }
+    
+    return true;
+}
+
 double CompRealtimeHealth34Plugin::calculateStatistic(const std::vector<double>& data, const std::string& method) {
+    TRACE_SPAN_LABEL("health.statistic", "evaluation", method);
+    
     if (data.empty()) return 0.0;
     
     if (method == "mean") {
@@ -370,80 +892,54 @@ double CompRealtimeHealth34Plugin::calculateStatistic(const std::vector<double>&
     } else if (method == "min") {
         return *std::min_element(data.begin(), data.end());
     } else if (method == "median") {
-        std::vector<double> sorted_data = data;
-        std::sort(sorted_data.begin(), sorted_data.end());
-        size_t n = sorted_data.size();
+        // 选择算法取中位数，偶数个数据时较小的中间值为上半部分之前的最大值
+        std::vector<double> selected = data;
+        size_t n = selected.size();
+        std::nth_element(selected.begin(), selected.begin() + n/2, selected.end());
+        double upper_middle = selected[n/2];
         if (n % 2 == 0) {
-            return (sorted_data[n/2 - 1] + sorted_data[n/2]) / 2.0;
-        } else {
-            return sorted_data[n/2];
+            double lower_middle = *std::max_element(selected.begin(), selected.begin() + n/2);
+            return (lower_middle + upper_middle) / 2.0;
         }
+        return upper_middle;
     }
     
     return 0.0;
 }
 
-std::vector<double> CompRealtimeHealth34Plugin::cleanData(const std::vector<double>& data, 
-                                                          const std::map<std::string, std::string>& clean_formula) {
-    std::vector<double> cleaned_data = data;
+void CompRealtimeHealth34Plugin::cleanData(std::vector<double>& data,
+                                           const std::map<std::string, std::string>& clean_formula) {
+    TRACE_SPAN("health.clean", "evaluation");
+    
+    // 去头去尾只移动有效区间的边界，全部清洗完成后一次性收缩
+    size_t begin = 0;
+    size_t end = data.size();
     
     for (const auto& [method, params] : clean_formula) {
         if (method == "remove_edges") {
             // 去头去尾
-            if (cleaned_data.size() > 4) {
-                cleaned_data.erase(cleaned_data.begin());
-                cleaned_data.erase(cleaned_data.end() - 1);
-            }
-        } else if (method == "percentile_cleaning") {
-            // 百分位清洗
-            std::vector<double> sorted_data = cleaned_data;
-            std::sort(sorted_data.begin(), sorted_data.end());
-            
-            size_t n = sorted_data.size();
-            double lower_percentile = sorted_data[static_cast<size_t>(n * 0.05)];
-            double upper_percentile = sorted_data[static_cast<size_t>(n * 0.95)];
-            
-            for (double& value : cleaned_data) {
-                if (value < lower_percentile) value = lower_percentile;
-                if (value > upper_percentile) value = upper_percentile;
+            if (end - begin > 4) {
+                ++begin;
+                --end;
             }
+        } else if (method == "percentile_cleaning" && end > begin) {
+            // 百分位清洗：截断到第5和第95百分位数，O(n)
+            clampToPercentiles(data.begin() + begin, data.begin() + end, 0.05, 0.95);
         }
     }
     
-    return cleaned_data;
+    if (begin > 0 || end < data.size()) {
+        std::copy(data.begin() + begin, data.begin() + end, data.begin());
+        data.resize(end - begin);
+    }
 }
 
 std::vector<double> CompRealtimeHealth34Plugin::smoothData(const std::vector<double>& data,
                                                            const std::map<std::string, std::string>& smooth_param) {
-    std::vector<double> smoothed_data = data;
-    
-    auto win_length_it = smooth_param.find("win_length");
-    auto func_it = smooth_param.find("func");
-    
-    if (win_length_it != smooth_param.end() && func_it != smooth_param.end()) {
-        int win_length = std::stoi(win_length_it->second);
-        std::string func = func_it->second;
-        
-        if (win_length > 1 && win_length < static_cast<int>(data.size())) {
-            std::vector<double> temp_data = smoothed_data;
-            
-            for (size_t i = win_length/2; i < data.size() - win_length/2; ++i) {
-                std::vector<double> window;
-                for (int j = -win_length/2; j <= win_length/2; ++j) {
-                    window.push_back(data[i + j]);
-                }
-                
-                if (func == "mean") {
-                    smoothed_data[i] = std::accumulate(window.begin(), window.end(), 0.0) / window.size();
-                } else if (func == "min") {
-                    smoothed_data[i] = *std::min_element(window.begin(), window.end());
-                } else if (func == "max") {
-                    smoothed_data[i] = *std::max_element(window.begin(), window.end());
-                }
-            }
-        }
-    }
+    TRACE_SPAN("health.smooth", "evaluation");
     
+    std::vector<double> smoothed_data;
+    SmoothingKernel::apply(SmoothingSpec::parse(smooth_param), data, smoothed_data);
     return smoothed_data;
 }
 
@@ -510,10 +1006,22 @@ bool ErrorDetectionPluginBase::evaluateHealth(std::shared_ptr<PluginData> input,
         }
         
         // 计算错误健康度
+        auto current_time = std::chrono::system_clock::now();
+        LongTermStates* long_term_states = nullptr;
         for (const auto& config : getErrorConfigs()) {
             auto it = features.find(config.feature_name);
             if (it != features.end()) {
-                auto scores = calculateErrorHealth(config, {it->second});
+                // 配置了长期平滑时以第一个速率的平滑结果代替原始值，平滑状态按设备区分
+                double value = it->second;
+                if (config.long_smooth.enabled()) {
+                    if (!long_term_states) {
+                        long_term_states = &long_term_states_.get(DeviceRegistry::getInstance().getHandle(input->getDeviceId()));
+                    }
+                    auto& long_term = (*long_term_states)[config.feature_name];
+                    long_term.update(config.long_smooth, value, current_time);
+                    value = long_term.value(config.long_smooth);
+                }
+                auto scores = calculateErrorHealth(config, {value});
                 for (const auto& [key, value] : scores) {
                     output->setData(key, value);
                     last_scores_[key] = value;
@@ -529,35 +1037,56 @@ bool ErrorDetectionPluginBase::evaluateHealth(std::shared_ptr<PluginData> input,
     }
 }
 
-std::vector<double> ErrorDetectionPluginBase::smoothData(const std::vector<double>& data,
-                                                         const std::map<std::string, std::string>& smooth_param) {
-    std::vector<double> smoothed_data = data;
-    
-    auto win_length_it = smooth_param.find("win_length");
-    auto func_it = smooth_param.find("func");
-    
-    if (win_length_it != smooth_param.end() && func_it != smooth_param.end()) {
-        int win_length = std::stoi(win_length_it->second);
-        std::string func = func_it->second;
-        
-        if (win_length > 1 && win_length < static_cast<int>(data.size())) {
-            for (size_t i = win_length/2; i < data.size() - win_length/2; ++i) {
-                std::vector<double> window;
-                for (int j = -win_length/2; j <= win_length/2; ++j) {
-                    window.push_back(data[i + j]);
-                }
-                
-                if (func == "mean") {
-                    smoothed_data[i] = std::accumulate(window.begin(), window.end(), 0.0) / window.size();
-                } else if (func == "min") {
-                    smoothed_data[i] = *std::min_element(window.begin(), window.end());
-                } else if (func == "max") {
-                    smoothed_data[i] = *std::max_element(window.begin(), window.end());
+namespace {
+
+// 长期平滑状态快照格式版本
+constexpr uint32_t kLongTermStateVersion = 1;
+
+} // namespace
+
+bool ErrorDetectionPluginBase::saveState(StateWriter& writer, bool incremental) {
+    writer.writeU32(kLongTermStateVersion);
+    writeDeviceStates(writer, long_term_states_, incremental,
+        [](StateWriter& w, const LongTermStates& states) {
+            w.writeU64(states.size());
+            for (const auto& [feature_name, long_term] : states) {
+                w.writeString(feature_name);
+                long_term.save(w);
+            }
+        });
+    return true;
+}
+
+bool ErrorDetectionPluginBase::loadState(StateReader& reader) {
+    uint32_t version = 0;
+    if (!reader.readU32(version) || version != kLongTermStateVersion) {
+        setError("状态快照版本不匹配");
+        return false;
+    }
+    bool ok = readDeviceStates(reader, long_term_states_,
+        [](StateReader& r, LongTermStates& states) {
+            uint64_t count = 0;
+            std::string feature_name;
+            if (!r.readU64(count)) {
+                return false;
+            }
+            for (uint64_t i = 0; i < count; ++i) {
+                if (!r.readString(feature_name) || !states[feature_name].load(r)) {
+                    return false;
                 }
             }
-        }
+            return true;
+        });
+    if (!ok) {
+        setError("状态快照数据不完整");
     }
-    
+    return ok;
+}
+
+std::vector<double> ErrorDetectionPluginBase::smoothData(const std::vector<double>& data,
+                                                         const std::map<std::string, std::string>& smooth_param) {
+    std::vector<double> smoothed_data;
+    SmoothingKernel::apply(SmoothingSpec::parse(smooth_param), data, smoothed_data);
     return smoothed_data;
 }
 
@@ -589,6 +1118,7 @@ bool Error18Plugin::validateParameters() {
     
     parseSmoothParams(move_smooth_str, move_smooth_param_);
     parseSmoothParams(long_smooth_str, long_smooth_);
+    long_smooth_spec_ = LongSmoothSpec::parse(long_smooth_);
     
     auto_mode_ = parameters_->getBool("auto", false);
     error_width_ = parameters_->getInt("error_width", 30);
@@ -621,6 +1151,7 @@ std::vector<ErrorDetectionPluginBase::ErrorConfig> Error18Plugin::getErrorConfig
         config.thresholds = thresholds_[i];
         config.upper_limit = upper_limits_[i];
         config.smooth_param = move_smooth_param_;
+        config.long_smooth = long_smooth_spec_;
         config.error_width = error_width_;
         
         configs.push_back(config);
@@ -1,4 +1,5 @@
 #include "event_plugin_base.h"
+#include "state_checkpoint.h"
 #include <algorithm>
 #include <chrono>
 
@@ -29,6 +30,20 @@ void EventPluginBase::cleanup() {
     parameters_.reset();
 }
 
+bool EventPluginBase::process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) {
+    if (!initialized_) {
+        setError("插件未初始化");
+        return false;
+    }
+    
+    if (!input || !output) {
+        setError("输入或输出数据为空");
+        return false;
+    }
+    
+    return processEvent(input, output);
+}
+
 bool EventPluginBase::processEvent(std::shared_ptr<PluginData> input, 
                                   std::shared_ptr<PluginResult> output) {
     if (!initialized_) {
@@ -78,11 +93,109 @@ int EventPluginBase::calculateAlarmLevel(double score, const std::vector<double>
 }
 
 // ScoreAlarmPluginBase实现
-ScoreAlarmPluginBase::ScoreAlarmPluginBase() = default;
+namespace {
+
+// 状态快照格式版本，报警状态结构变化时递增
+constexpr uint32_t kAlarmStateVersion = 1;
+
+// 报警状态按健康度名称或状态值索引
+void writeKey(StateWriter& writer, const std::string& key) { writer.writeString(key); }
+void writeKey(StateWriter& writer, int key) { writer.writeI32(key); }
+bool readKey(StateReader& reader, std::string& key) { return reader.readString(key); }
+bool readKey(StateReader& reader, int& key) { return reader.readI32(key); }
+
+template <typename Key>
+void writeAlarmTimes(StateWriter& writer, const std::map<Key, std::chrono::system_clock::time_point>& times) {
+    writer.writeU64(times.size());
+    for (const auto& [key, time] : times) {
+        writeKey(writer, key);
+        writer.writeTimePoint(time);
+    }
+}
+
+template <typename Key>
+void writeAlarmCounts(StateWriter& writer, const std::map<Key, int>& counts) {
+    writer.writeU64(counts.size());
+    for (const auto& [key, count] : counts) {
+        writeKey(writer, key);
+        writer.writeI32(count);
+    }
+}
+
+template <typename Key>
+bool readAlarmTimes(StateReader& reader, std::map<Key, std::chrono::system_clock::time_point>& times) {
+    uint64_t count = 0;
+    if (!reader.readU64(count)) {
+        return false;
+    }
+    Key key{};
+    std::chrono::system_clock::time_point time;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!readKey(reader, key) || !reader.readTimePoint(time)) {
+            return false;
+        }
+        times[key] = time;
+    }
+    return true;
+}
+
+template <typename Key>
+bool readAlarmCounts(StateReader& reader, std::map<Key, int>& counts) {
+    uint64_t count = 0;
+    if (!reader.readU64(count)) {
+        return false;
+    }
+    Key key{};
+    int value = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!readKey(reader, key) || !reader.readI32(value)) {
+            return false;
+        }
+        counts[key] = value;
+    }
+    return true;
+}
+
+} // namespace
+
+ScoreAlarmPluginBase::ScoreAlarmPluginBase() : state_(&alarm_states_.get(0)) {
+}
+
+bool ScoreAlarmPluginBase::saveState(StateWriter& writer, bool incremental) {
+    writer.writeU32(kAlarmStateVersion);
+    writeDeviceStates(writer, alarm_states_, incremental,
+        [](StateWriter& w, const AlarmState& state) {
+            writeAlarmTimes(w, state.last_alarm_time);
+            writeAlarmCounts(w, state.alarm_count);
+            writeAlarmCounts(w, state.tolerable_count);
+        });
+    return true;
+}
+
+bool ScoreAlarmPluginBase::loadState(StateReader& reader) {
+    uint32_t version = 0;
+    if (!reader.readU32(version) || version != kAlarmStateVersion) {
+        setError("状态快照版本不匹配");
+        return false;
+    }
+    bool ok = readDeviceStates(reader, alarm_states_,
+        [](StateReader& r, AlarmState& state) {
+            return readAlarmTimes(r, state.last_alarm_time) &&
+                   readAlarmCounts(r, state.alarm_count) &&
+                   readAlarmCounts(r, state.tolerable_count);
+        });
+    if (!ok) {
+        setError("状态快照数据不完整");
+    }
+    return ok;
+}
 
 bool ScoreAlarmPluginBase::processEvent(std::shared_ptr<PluginData> input, 
                                        std::shared_ptr<PluginResult> output) {
     try {
+        // 切换到数据所属设备的报警状态
+        state_ = &alarm_states_.get(input ? DeviceRegistry::getInstance().getHandle(input->getDeviceId()) : 0);
+        
         // 获取健康度数据
         std::map<std::string, double> health_scores;
         
@@ -126,12 +239,12 @@ bool ScoreAlarmPluginBase::processEvent(std::shared_ptr<PluginData> input,
 }
 
 bool ScoreAlarmPluginBase::shouldTriggerAlarm(const std::string& health_name, double score) {
-    auto last_time_it = last_alarm_time_.find(health_name);
-    auto count_it = alarm_count_.find(health_name);
-    auto tolerable_it = tolerable_count_.find(health_name);
+    auto last_time_it = state_->last_alarm_time.find(health_name);
+    auto count_it = state_->alarm_count.find(health_name);
+    auto tolerable_it = state_->tolerable_count.find(health_name);
     
     // 检查报警间隔
-    if (last_time_it != last_alarm_time_.end()) {
+    if (last_time_it != state_->last_alarm_time.end()) {
         auto now = std::chrono::system_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - last_time_it->second);
         if (duration.count() < alarm_interval_) {
@@ -140,8 +253,8 @@ bool ScoreAlarmPluginBase::shouldTriggerAlarm(const std::string& health_name, do
     }
     
     // 检查可容忍次数
-    int current_count = (count_it != alarm_count_.end()) ? count_it->second : 0;
-    int tolerable_count = (tolerable_it != tolerable_count_.end()) ? tolerable_it->second : 0;
+    int current_count = (count_it != state_->alarm_count.end()) ? count_it->second : 0;
+    int tolerable_count = (tolerable_it != state_->tolerable_count.end()) ? tolerable_it->second : 0;
     
     if (current_count < tolerable_count) {
         return false;
@@ -151,17 +264,17 @@ bool ScoreAlarmPluginBase::shouldTriggerAlarm(const std::string& health_name, do
 }
 
 void ScoreAlarmPluginBase::updateAlarmState(const std::string& health_name, double score) {
-    last_alarm_time_[health_name] = std::chrono::system_clock::now();
+    state_->last_alarm_time[health_name] = std::chrono::system_clock::now();
     
-    auto count_it = alarm_count_.find(health_name);
-    if (count_it != alarm_count_.end()) {
+    auto count_it = state_->alarm_count.find(health_name);
+    if (count_it != state_->alarm_count.end()) {
         count_it->second++;
     } else {
-        alarm_count_[health_name] = 1;
+        state_->alarm_count[health_name] = 1;
     }
     
     // 重置可容忍计数
-    tolerable_count_[health_name] = 0;
+    state_->tolerable_count[health_name] = 0;
 }
 
 // ScoreAlarm5Plugin实现
@@ -215,11 +328,42 @@ bool ScoreAlarm5Plugin::processAlarm(const std::map<std::string, double>& health
 }
 
 // StatusAlarmPluginBase实现
-StatusAlarmPluginBase::StatusAlarmPluginBase() = default;
+StatusAlarmPluginBase::StatusAlarmPluginBase() : state_(&alarm_states_.get(0)) {
+}
+
+bool StatusAlarmPluginBase::saveState(StateWriter& writer, bool incremental) {
+    writer.writeU32(kAlarmStateVersion);
+    writeDeviceStates(writer, alarm_states_, incremental,
+        [](StateWriter& w, const StatusAlarmState& state) {
+            writeAlarmTimes(w, state.last_alarm_time);
+            writeAlarmCounts(w, state.alarm_count);
+        });
+    return true;
+}
+
+bool StatusAlarmPluginBase::loadState(StateReader& reader) {
+    uint32_t version = 0;
+    if (!reader.readU32(version) || version != kAlarmStateVersion) {
+        setError("状态快照版本不匹配");
+        return false;
+    }
+    bool ok = readDeviceStates(reader, alarm_states_,
+        [](StateReader& r, StatusAlarmState& state) {
+            return readAlarmTimes(r, state.last_alarm_time) &&
+                   readAlarmCounts(r, state.alarm_count);
+        });
+    if (!ok) {
+        setError("状态快照数据不完整");
+    }
+    return ok;
+}
 
 bool StatusAlarmPluginBase::processEvent(std::shared_ptr<PluginData> input, 
                                         std::shared_ptr<PluginResult> output) {
     try {
+        // 切换到数据所属设备的报警记录
+        state_ = &alarm_states_.get(input ? DeviceRegistry::getInstance().getHandle(input->getDeviceId()) : 0);
+        
         // 获取状态数据
         int status = 0;
         std::string status_name = "未知";
@@ -263,12 +407,12 @@ bool StatusAlarmPluginBase::processEvent(std::shared_ptr<PluginData> input,
 bool StatusAlarmPluginBase::shouldTriggerStatusAlarm(int status) {
     if (!alarm_enabled_) return false;
     
-    auto last_time_it = last_alarm_time_.find(status);
-    auto count_it = alarm_count_.find(status);
+    auto last_time_it = state_->last_alarm_time.find(status);
+    auto count_it = state_->alarm_count.find(status);
     auto max_num_it = max_alarm_num_.find(status);
     
     // 检查最大报警次数
-    int current_count = (count_it != alarm_count_.end()) ? count_it->second : 0;
+    int current_count = (count_it != state_->alarm_count.end()) ? count_it->second : 0;
     int max_count = (max_num_it != max_alarm_num_.end()) ? max_num_it->second : 10;
     
     if (current_count >= max_count) {
@@ -276,7 +420,7 @@ bool StatusAlarmPluginBase::shouldTriggerStatusAlarm(int status) {
     }
     
     // 检查报警间隔
-    if (last_time_it != last_alarm_time_.end()) {
+    if (last_time_it != state_->last_alarm_time.end()) {
         auto now = std::chrono::system_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - last_time_it->second);
         
@@ -292,13 +436,13 @@ bool StatusAlarmPluginBase::shouldTriggerStatusAlarm(int status) {
 }
 
 void StatusAlarmPluginBase::updateStatusAlarmState(int status) {
-    last_alarm_time_[status] = std::chrono::system_clock::now();
+    state_->last_alarm_time[status] = std::chrono::system_clock::now();
     
-    auto count_it = alarm_count_.find(status);
-    if (count_it != alarm_count_.end()) {
+    auto count_it = state_->alarm_count.find(status);
+    if (count_it != state_->alarm_count.end()) {
         count_it->second++;
     } else {
-        alarm_count_[status] = 1;
+        state_->alarm_count[status] = 1;
     }
 }
 
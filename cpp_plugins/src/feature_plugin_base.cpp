@@ -30,6 +30,65 @@ void FeaturePluginBase::cleanup() {
     parameters_.reset();
 }
 
+bool FeaturePluginBase::process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) {
+    if (!initialized_) {
+        setError("插件未初始化");
+        return false;
+    }
+    
+    if (!input || !output) {
+        setError("输入或输出数据为空");
+        return false;
+    }
+    
+    try {
+        return extractFeatures(input, output);
+    } catch (const std::exception& e) {
+        setError("特征提取异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool FeaturePluginBase::processBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                     const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                     std::vector<bool>& succeeded) {
+    succeeded.assign(inputs.size(), false);
+    
+    // 初始化与数量检查对整批只做一次
+    if (!initialized_) {
+        setError("插件未初始化");
+        return false;
+    }
+    
+    if (inputs.size() != outputs.size()) {
+        setError("批量输入输出数量不一致");
+        return false;
+    }
+    
+    try {
+        return extractFeaturesBatch(inputs, outputs, succeeded);
+    } catch (const std::exception& e) {
+        setError("批量特征提取异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool FeaturePluginBase::extractFeaturesBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                             const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                             std::vector<bool>& succeeded) {
+    bool all_succeeded = true;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!inputs[i] || !outputs[i]) {
+            setError("输入或输出数据为空");
+            all_succeeded = false;
+            continue;
+        }
+        succeeded[i] = extractFeatures(inputs[i], outputs[i]);
+        all_succeeded = all_succeeded && succeeded[i];
+    }
+    return all_succeeded;
+}
+
 bool FeaturePluginBase::extractFeatures(std::shared_ptr<PluginData> input, 
                                         std::shared_ptr<PluginResult> output) {
     if (!initialized_) {
@@ -0,0 +1,503 @@
+#include "health_formula.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+
+namespace AlgorithmPlugins {
+
+// ===== FormulaSymbols =====
+
+size_t FormulaSymbols::slot(const std::string& name) {
+    auto it = slots_.find(name);
+    if (it != slots_.end()) {
+        return it->second;
+    }
+    size_t index = names_.size();
+    slots_.emplace(name, index);
+    names_.push_back(name);
+    return index;
+}
+
+bool FormulaSymbols::find(const std::string& name, size_t& slot) const {
+    auto it = slots_.find(name);
+    if (it == slots_.end()) {
+        return false;
+    }
+    slot = it->second;
+    return true;
+}
+
+// ===== 语法树与解析 =====
+
+struct HealthFormula::Node {
+    enum class Kind { CONSTANT, VARIABLE, OPERATION };
+
+    Kind kind = Kind::CONSTANT;
+    OpCode op = OpCode::CONST;
+    double value = 0.0;
+    size_t slot = 0;
+    size_t height = 1;  // 子树高度，编译和析构按高度递归
+    std::vector<std::unique_ptr<Node>> children;
+};
+
+namespace {
+
+// NaN参与比较时结果为NaN，与算术运算的缺失值语义一致
+inline double minOf(double a, double b) { return (a < b || a != a) ? a : b; }
+inline double maxOf(double a, double b) { return (a > b || a != a) ? a : b; }
+
+constexpr size_t kMaxParseDepth = 256;
+
+} // namespace
+
+class HealthFormula::Parser {
+public:
+    Parser(const std::string& text, FormulaSymbols& symbols, std::string& error)
+        : text_(text), symbols_(symbols), error_(error) {}
+
+    std::unique_ptr<Node> parse() {
+        auto node = parseExpression();
+        if (node) {
+            skipSpace();
+            if (position_ < text_.size()) {
+                return fail("无法识别的字符");
+            }
+        }
+        return node;
+    }
+
+private:
+    const std::string& text_;
+    FormulaSymbols& symbols_;
+    std::string& error_;
+    size_t position_ = 0;
+    size_t depth_ = 0;
+
+    std::unique_ptr<Node> fail(const std::string& message) {
+        if (error_.empty()) {
+            error_ = message + "（位置" + std::to_string(position_) + "）";
+        }
+        return nullptr;
+    }
+
+    void skipSpace() {
+        while (position_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[position_]))) {
+            ++position_;
+        }
+    }
+
+    bool accept(char c) {
+        skipSpace();
+        if (position_ < text_.size() && text_[position_] == c) {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    // 限制语法树高度：左结合的长链（a+a+...）不经过递归下降的嵌套，同样计入深度上限
+    std::unique_ptr<Node> makeOperation(OpCode op, std::vector<std::unique_ptr<Node>> children) {
+        auto node = std::make_unique<Node>();
+        node->kind = Node::Kind::OPERATION;
+        node->op = op;
+        for (const auto& child : children) {
+            node->height = std::max(node->height, child->height + 1);
+        }
+        if (node->height > kMaxParseDepth) {
+            return fail("表达式嵌套过深");
+        }
+        node->children = std::move(children);
+        return fold(std::move(node));
+    }
+
+    std::unique_ptr<Node> makeBinary(OpCode op, std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs) {
+        std::vector<std::unique_ptr<Node>> children;
+        children.push_back(std::move(lhs));
+        children.push_back(std::move(rhs));
+        return makeOperation(op, std::move(children));
+    }
+
+    // 常量折叠：操作数全为常量时在编译期求值
+    static std::unique_ptr<Node> fold(std::unique_ptr<Node> node) {
+        double args[kMaxStackDepth];
+        if (node->children.size() > kMaxStackDepth) {
+            return node;
+        }
+        for (size_t i = 0; i < node->children.size(); ++i) {
+            if (node->children[i]->kind != Node::Kind::CONSTANT) {
+                return node;
+            }
+            args[i] = node->children[i]->value;
+        }
+        auto constant = std::make_unique<Node>();
+        constant->value = applyScalar(node->op, args, node->children.size());
+        return constant;
+    }
+
+    std::unique_ptr<Node> parseExpression() {
+        if (++depth_ > kMaxParseDepth) {
+            return fail("表达式嵌套过深");
+        }
+        auto lhs = parseTerm();
+        while (lhs) {
+            if (accept('+')) {
+                auto rhs = parseTerm();
+                lhs = rhs ? makeBinary(OpCode::ADD, std::move(lhs), std::move(rhs)) : nullptr;
+            } else if (accept('-')) {
+                auto rhs = parseTerm();
+                lhs = rhs ? makeBinary(OpCode::SUB, std::move(lhs), std::move(rhs)) : nullptr;
+            } else {
+                break;
+            }
+        }
+        --depth_;
+        return lhs;
+    }
+
+    std::unique_ptr<Node> parseTerm() {
+        auto lhs = parseUnary();
+        while (lhs) {
+            if (accept('*')) {
+                auto rhs = parseUnary();
+                lhs = rhs ? makeBinary(OpCode::MUL, std::move(lhs), std::move(rhs)) : nullptr;
+            } else if (accept('/')) {
+                auto rhs = parseUnary();
+                lhs = rhs ? makeBinary(OpCode::DIV, std::move(lhs), std::move(rhs)) : nullptr;
+            } else {
+                break;
+            }
+        }
+        return lhs;
+    }
+
+    std::unique_ptr<Node> parseUnary() {
+        if (accept('-')) {
+            if (++depth_ > kMaxParseDepth) {
+                return fail("表达式嵌套过深");
+            }
+            auto operand = parseUnary();
+            --depth_;
+            if (!operand) {
+                return nullptr;
+            }
+            std::vector<std::unique_ptr<Node>> children;
+            children.push_back(std::move(operand));
+            return makeOperation(OpCode::NEG, std::move(children));
+        }
+        if (accept('+')) {
+            if (++depth_ > kMaxParseDepth) {
+                return fail("表达式嵌套过深");
+            }
+            auto operand = parseUnary();
+            --depth_;
+            return operand;
+        }
+        return parsePower();
+    }
+
+    // 乘方为右结合，指数可带负号；连续乘方每层计入嵌套深度
+    std::unique_ptr<Node> parsePower() {
+        auto base = parsePrimary();
+        if (base && accept('^')) {
+            if (++depth_ > kMaxParseDepth) {
+                return fail("表达式嵌套过深");
+            }
+            auto exponent = parseUnary();
+            --depth_;
+            return exponent ? makeBinary(OpCode::POW, std::move(base), std::move(exponent)) : nullptr;
+        }
+        return base;
+    }
+
+    std::unique_ptr<Node> parsePrimary() {
+        skipSpace();
+        if (position_ >= text_.size()) {
+            return fail("表达式不完整");
+        }
+
+        char c = text_[position_];
+        if (c == '(') {
+            ++position_;
+            auto node = parseExpression();
+            if (node && !accept(')')) {
+                return fail("缺少右括号");
+            }
+            return node;
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            const char* begin = text_.c_str() + position_;
+            char* end = nullptr;
+            double value = std::strtod(begin, &end);
+            if (end == begin) {
+                return fail("无效的数值");
+            }
+            position_ += static_cast<size_t>(end - begin);
+            auto node = std::make_unique<Node>();
+            node->value = value;
+            return node;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t begin = position_;
+            while (position_ < text_.size() &&
+                   (std::isalnum(static_cast<unsigned char>(text_[position_])) ||
+                    text_[position_] == '_' || text_[position_] == '.')) {
+                ++position_;
+            }
+            std::string name = text_.substr(begin, position_ - begin);
+            if (accept('(')) {
+                return parseCall(name);
+            }
+            auto node = std::make_unique<Node>();
+            node->kind = Node::Kind::VARIABLE;
+            node->slot = symbols_.slot(name);
+            return node;
+        }
+
+        return fail("无法识别的字符");
+    }
+
+    std::unique_ptr<Node> parseCall(const std::string& name) {
+        std::vector<std::unique_ptr<Node>> args;
+        if (!accept(')')) {
+            do {
+                auto arg = parseExpression();
+                if (!arg) {
+                    return nullptr;
+                }
+                args.push_back(std::move(arg));
+            } while (accept(','));
+            if (!accept(')')) {
+                return fail("函数" + name + "缺少右括号");
+            }
+        }
+
+        struct Function {
+            const char* name;
+            OpCode op;
+            size_t min_args;
+            size_t max_args;
+        };
+        static const Function functions[] = {
+            {"min", OpCode::MIN, 1, kMaxStackDepth},
+            {"max", OpCode::MAX, 1, kMaxStackDepth},
+            {"avg", OpCode::AVG, 1, kMaxStackDepth},
+            {"abs", OpCode::ABS, 1, 1},
+            {"sqrt", OpCode::SQRT, 1, 1},
+            {"clamp", OpCode::CLAMP, 3, 3},
+        };
+        for (const auto& function : functions) {
+            if (name == function.name) {
+                if (args.size() < function.min_args || args.size() > function.max_args) {
+                    return fail("函数" + name + "的参数个数不正确");
+                }
+                return makeOperation(function.op, std::move(args));
+            }
+        }
+        return fail("未知函数" + name);
+    }
+};
+
+// ===== 编译 =====
+
+bool HealthFormula::compile(const std::string& expression, FormulaSymbols& symbols, std::string& error) {
+    code_.clear();
+    constants_.clear();
+    referenced_slots_.clear();
+    stack_depth_ = 0;
+    error.clear();
+
+    Parser parser(expression, symbols, error);
+    auto root = parser.parse();
+    if (!root) {
+        if (error.empty()) {
+            error = "公式解析失败";
+        }
+        return false;
+    }
+
+    emit(*root, 0);
+    if (stack_depth_ > kMaxStackDepth) {
+        code_.clear();
+        error = "表达式嵌套过深";
+        return false;
+    }
+    return true;
+}
+
+void HealthFormula::emit(const Node& node, size_t depth) {
+    stack_depth_ = std::max(stack_depth_, depth + 1);
+    switch (node.kind) {
+        case Node::Kind::CONSTANT:
+            code_.push_back({OpCode::CONST, static_cast<uint32_t>(constants_.size())});
+            constants_.push_back(node.value);
+            return;
+        case Node::Kind::VARIABLE:
+            code_.push_back({OpCode::LOAD, static_cast<uint32_t>(node.slot)});
+            if (std::find(referenced_slots_.begin(), referenced_slots_.end(), node.slot) == referenced_slots_.end()) {
+                referenced_slots_.push_back(node.slot);
+            }
+            return;
+        case Node::Kind::OPERATION:
+            for (size_t i = 0; i < node.children.size(); ++i) {
+                emit(*node.children[i], depth + i);
+            }
+            code_.push_back({node.op, static_cast<uint32_t>(node.children.size())});
+            return;
+    }
+}
+
+bool HealthFormula::isConstant() const {
+    return code_.size() == 1 && code_.front().op == OpCode::CONST;
+}
+
+// ===== 求值 =====
+
+double HealthFormula::applyScalar(OpCode op, const double* args, size_t count) {
+    switch (op) {
+        case OpCode::ADD: return args[0] + args[1];
+        case OpCode::SUB: return args[0] - args[1];
+        case OpCode::MUL: return args[0] * args[1];
+        case OpCode::DIV: return args[0] / args[1];
+        case OpCode::POW: return std::pow(args[0], args[1]);
+        case OpCode::NEG: return -args[0];
+        case OpCode::ABS: return std::fabs(args[0]);
+        case OpCode::SQRT: return std::sqrt(args[0]);
+        case OpCode::CLAMP: return minOf(maxOf(args[0], args[1]), args[2]);
+        case OpCode::MIN: {
+            double result = args[0];
+            for (size_t i = 1; i < count; ++i) {
+                result = minOf(result, args[i]);
+            }
+            return result;
+        }
+        case OpCode::MAX: {
+            double result = args[0];
+            for (size_t i = 1; i < count; ++i) {
+                result = maxOf(result, args[i]);
+            }
+            return result;
+        }
+        case OpCode::AVG: {
+            double sum = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                sum += args[i];
+            }
+            return sum / static_cast<double>(count);
+        }
+        default:
+            return 0.0;
+    }
+}
+
+double HealthFormula::evaluate(const double* slots) const {
+    double stack[kMaxStackDepth];
+    size_t top = 0;
+    for (const auto& instruction : code_) {
+        switch (instruction.op) {
+            case OpCode::CONST:
+                stack[top++] = constants_[instruction.operand];
+                break;
+            case OpCode::LOAD:
+                stack[top++] = slots[instruction.operand];
+                break;
+            default: {
+                // 操作数位于栈顶的operand个位置，结果写回第一个操作数的位置
+                top -= instruction.operand;
+                stack[top] = applyScalar(instruction.op, stack + top, instruction.operand);
+                ++top;
+                break;
+            }
+        }
+    }
+    return top > 0 ? stack[0] : 0.0;
+}
+
+void HealthFormula::evaluateBatch(const double* slots, size_t count, double* results) const {
+    if (code_.empty() || count == 0) {
+        return;
+    }
+
+    // 每个栈位置为一列，逐条指令对整列计算，内层循环无分支便于编译器向量化
+    std::vector<double> columns(stack_depth_ * count);
+    auto column = [&columns, count](size_t index) { return columns.data() + index * count; };
+    size_t top = 0;
+
+    for (const auto& instruction : code_) {
+        switch (instruction.op) {
+            case OpCode::CONST:
+                std::fill(column(top), column(top) + count, constants_[instruction.operand]);
+                ++top;
+                continue;
+            case OpCode::LOAD:
+                std::copy(slots + instruction.operand * count, slots + (instruction.operand + 1) * count, column(top));
+                ++top;
+                continue;
+            default:
+                break;
+        }
+
+        const size_t arity = instruction.operand;
+        top -= arity;
+        double* out = column(top);
+        const double* b = arity > 1 ? column(top + 1) : nullptr;
+        switch (instruction.op) {
+            case OpCode::ADD:
+                for (size_t i = 0; i < count; ++i) out[i] += b[i];
+                break;
+            case OpCode::SUB:
+                for (size_t i = 0; i < count; ++i) out[i] -= b[i];
+                break;
+            case OpCode::MUL:
+                for (size_t i = 0; i < count; ++i) out[i] *= b[i];
+                break;
+            case OpCode::DIV:
+                for (size_t i = 0; i < count; ++i) out[i] /= b[i];
+                break;
+            case OpCode::POW:
+                for (size_t i = 0; i < count; ++i) out[i] = std::pow(out[i], b[i]);
+                break;
+            case OpCode::NEG:
+                for (size_t i = 0; i < count; ++i) out[i] = -out[i];
+                break;
+            case OpCode::ABS:
+                for (size_t i = 0; i < count; ++i) out[i] = std::fabs(out[i]);
+                break;
+            case OpCode::SQRT:
+                for (size_t i = 0; i < count; ++i) out[i] = std::sqrt(out[i]);
+                break;
+            case OpCode::CLAMP: {
+                const double* upper = column(top + 2);
+                for (size_t i = 0; i < count; ++i) out[i] = minOf(maxOf(out[i], b[i]), upper[i]);
+                break;
+            }
+            case OpCode::MIN:
+            case OpCode::MAX:
+            case OpCode::AVG:
+                for (size_t k = 1; k < arity; ++k) {
+                    const double* arg = column(top + k);
+                    if (instruction.op == OpCode::MIN) {
+                        for (size_t i = 0; i < count; ++i) out[i] = minOf(out[i], arg[i]);
+                    } else if (instruction.op == OpCode::MAX) {
+                        for (size_t i = 0; i < count; ++i) out[i] = maxOf(out[i], arg[i]);
+                    } else {
+                        for (size_t i = 0; i < count; ++i) out[i] += arg[i];
+                    }
+                }
+                if (instruction.op == OpCode::AVG) {
+                    for (size_t i = 0; i < count; ++i) out[i] /= static_cast<double>(arity);
+                }
+                break;
+            default:
+                break;
+        }
+        ++top;
+    }
+
+    std::copy(column(0), column(0) + count, results);
+}
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,132 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+// 最高有效位的位置，value必须非0
+size_t highestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - static_cast<size_t>(__builtin_clzll(value));
+#else
+    size_t bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram& other) : LatencyHistogram() {
+    merge(other);
+}
+
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& other) {
+    if (this != &other) {
+        reset();
+        merge(other);
+    }
+    return *this;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t count = other.buckets_[i].load(std::memory_order_relaxed);
+        if (count > 0) {
+            buckets_[i].fetch_add(count, std::memory_order_relaxed);
+            count_.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getPercentile(double quantile) const {
+    // 按桶计数求和，与并发记录时单独读取的总数可能略有出入
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    quantile = std::min(std::max(quantile, 0.0), 1.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * total)));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return bucketUpperBound(i);
+        }
+    }
+    return bucketUpperBound(kBucketCount - 1);
+}
+
+void LatencyHistogram::getCumulativeCounts(const std::vector<uint64_t>& bounds,
+                                           std::vector<uint64_t>& counts) const {
+    counts.assign(bounds.size(), 0);
+
+    uint64_t seen = 0;
+    size_t bound = 0;
+    for (size_t i = 0; i < kBucketCount && bound < bounds.size(); ++i) {
+        while (bound < bounds.size() && bucketUpperBound(i) > bounds[bound]) {
+            counts[bound++] = seen;
+        }
+        seen += buckets_[i].load(std::memory_order_relaxed);
+    }
+    while (bound < bounds.size()) {
+        counts[bound++] = seen;
+    }
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    value = std::min(value, kMaxValue);
+    if (value < 2 * kSubBucketCount) {
+        return static_cast<size_t>(value);
+    }
+
+    // 最高位决定区间，其后kSubBucketBits位决定子桶
+    size_t shift = highestBit(value) - kSubBucketBits;
+    return shift * kSubBucketCount + static_cast<size_t>(value >> shift);
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) {
+    if (index < 2 * kSubBucketCount) {
+        return index;
+    }
+    size_t shift = index / kSubBucketCount - 1;
+    uint64_t sub_bucket = index % kSubBucketCount + kSubBucketCount;
+    return sub_bucket << shift;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < 2 * kSubBucketCount) {
+        return index;
+    }
+    size_t shift = index / kSubBucketCount - 1;
+    return bucketLowerBound(index) + (uint64_t(1) << shift) - 1;
+}
+
+} // namespace AlgorithmPlugins
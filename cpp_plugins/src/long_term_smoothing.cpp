@@ -0,0 +1,201 @@
+#include "long_term_smoothing.h"
+#include "state_checkpoint.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+// 解析逗号分隔的正数列表，任一项无效时返回空
+std::vector<double> parseRates(const std::string& text) {
+    std::vector<double> rates;
+    size_t begin = 0;
+    while (begin <= text.size()) {
+        size_t end = text.find(',', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        std::string item = text.substr(begin, end - begin);
+        char* parse_end = nullptr;
+        double rate = std::strtod(item.c_str(), &parse_end);
+        if (parse_end == item.c_str() || !(rate > 0.0)) {
+            return {};
+        }
+        rates.push_back(rate);
+        begin = end + 1;
+    }
+    return rates;
+}
+
+} // namespace
+
+// ===== LongSmoothSpec =====
+
+LongSmoothSpec LongSmoothSpec::parse(const std::map<std::string, std::string>& params) {
+    LongSmoothSpec spec;
+    auto func_it = params.find("func");
+    if (func_it == params.end()) {
+        return spec;
+    }
+
+    const std::string& func = func_it->second;
+    LongSmoothFunction function = LongSmoothFunction::NONE;
+    if (func == "ewma") {
+        function = LongSmoothFunction::EWMA;
+    } else if (func == "holt") {
+        function = LongSmoothFunction::HOLT;
+    } else if (func == "decayed_min") {
+        function = LongSmoothFunction::DECAYED_MIN;
+    } else if (func == "decayed_max") {
+        function = LongSmoothFunction::DECAYED_MAX;
+    } else {
+        return spec;
+    }
+
+    auto half_life_it = params.find("half_life");
+    auto alpha_it = params.find("alpha");
+    auto win_length_it = params.find("win_length");
+    if (half_life_it != params.end()) {
+        spec.time_based = true;
+        spec.rates = parseRates(half_life_it->second);
+    } else if (alpha_it != params.end()) {
+        spec.rates = parseRates(alpha_it->second);
+        if (std::any_of(spec.rates.begin(), spec.rates.end(), [](double alpha) { return alpha > 1.0; })) {
+            spec.rates.clear();
+        }
+    } else if (win_length_it != params.end()) {
+        int win_length = std::atoi(win_length_it->second.c_str());
+        if (win_length > 0) {
+            spec.rates.push_back(2.0 / (win_length + 1));
+        }
+    }
+
+    auto trend_it = params.find(spec.time_based ? "trend_half_life" : "beta");
+    if (trend_it != params.end()) {
+        double trend_rate = std::atof(trend_it->second.c_str());
+        if (trend_rate > 0.0 && (spec.time_based || trend_rate <= 1.0)) {
+            spec.trend_rate = trend_rate;
+        }
+    }
+
+    auto horizon_it = params.find("horizon");
+    if (horizon_it != params.end()) {
+        spec.horizon = std::atof(horizon_it->second.c_str());
+    }
+
+    if (!spec.rates.empty()) {
+        spec.function = function;
+    }
+    return spec;
+}
+
+double LongSmoothSpec::coefficient(size_t rate, double elapsed) const {
+    if (!time_based) {
+        return rates[rate];
+    }
+    // 半衰期h下经过t秒后旧值保留2^(-t/h)
+    return elapsed > 0.0 ? 1.0 - std::exp2(-elapsed / rates[rate]) : 0.0;
+}
+
+double LongSmoothSpec::trendCoefficient(size_t rate, double elapsed) const {
+    if (trend_rate <= 0.0) {
+        return coefficient(rate, elapsed);
+    }
+    if (!time_based) {
+        return trend_rate;
+    }
+    return elapsed > 0.0 ? 1.0 - std::exp2(-elapsed / trend_rate) : 0.0;
+}
+
+// ===== LongTermSmoother =====
+
+void LongTermSmoother::update(const LongSmoothSpec& spec, double value, std::chrono::system_clock::time_point time) {
+    if (!spec.enabled() || !std::isfinite(value)) {
+        return;
+    }
+    // 速率个数或函数变化后已有状态不再适用
+    const size_t trend_count = spec.function == LongSmoothFunction::HOLT ? spec.rates.size() : 0;
+    if (levels_.size() != spec.rates.size() || trends_.size() != trend_count) {
+        clear();
+    }
+
+    if (count_ == 0) {
+        levels_.assign(spec.rates.size(), value);
+        trends_.assign(trend_count, 0.0);
+        count_ = 1;
+        last_time_ = time;
+        return;
+    }
+
+    // 按时间衰减时以秒为间隔，时间回退视为同一时刻；否则每条数据间隔为1
+    double elapsed = 1.0;
+    if (spec.time_based) {
+        elapsed = std::max(std::chrono::duration<double>(time - last_time_).count(), 0.0);
+    }
+
+    for (size_t rate = 0; rate < levels_.size(); ++rate) {
+        double alpha = spec.coefficient(rate, elapsed);
+        double& level = levels_[rate];
+        switch (spec.function) {
+            case LongSmoothFunction::EWMA:
+                level += alpha * (value - level);
+                break;
+            case LongSmoothFunction::HOLT: {
+                double& trend = trends_[rate];
+                double predicted = level + trend * elapsed;
+                double next_level = predicted + alpha * (value - predicted);
+                if (elapsed > 0.0) {
+                    double beta = spec.trendCoefficient(rate, elapsed);
+                    trend += beta * ((next_level - level) / elapsed - trend);
+                }
+                level = next_level;
+                break;
+            }
+            case LongSmoothFunction::DECAYED_MIN:
+                level = std::min(value, level + alpha * (value - level));
+                break;
+            case LongSmoothFunction::DECAYED_MAX:
+                level = std::max(value, level + alpha * (value - level));
+                break;
+            default:
+                break;
+        }
+    }
+    ++count_;
+    last_time_ = std::max(last_time_, time);
+}
+
+void LongTermSmoother::clear() {
+    levels_.clear();
+    trends_.clear();
+    count_ = 0;
+    last_time_ = std::chrono::system_clock::time_point{};
+}
+
+double LongTermSmoother::value(const LongSmoothSpec& spec, size_t rate) const {
+    if (count_ == 0 || rate >= levels_.size()) {
+        return 0.0;
+    }
+    if (spec.function == LongSmoothFunction::HOLT && rate < trends_.size()) {
+        return levels_[rate] + trends_[rate] * spec.horizon;
+    }
+    return levels_[rate];
+}
+
+void LongTermSmoother::save(StateWriter& writer) const {
+    writer.writeU64(count_);
+    writer.writeDoubleArray(levels_);
+    writer.writeDoubleArray(trends_);
+    writer.writeTimePoint(last_time_);
+}
+
+bool LongTermSmoother::load(StateReader& reader) {
+    return reader.readU64(count_) &&
+           reader.readDoubleArray(levels_) &&
+           reader.readDoubleArray(trends_) &&
+           reader.readTimePoint(last_time_);
+}
+
+} // namespace AlgorithmPlugins
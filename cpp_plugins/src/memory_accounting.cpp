@@ -0,0 +1,173 @@
+#include "memory_accounting.h"
+#include <cstdlib>
+#include <new>
+
+#if defined(ALGORITHM_PLUGINS_ALLOCATION_TRACKING) && defined(__GLIBC__)
+#include <malloc.h>
+#define ALGORITHM_PLUGINS_ALLOCATION_HOOKS 1
+#endif
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+// 常量初始化的线程局部指针，分配钩子中访问不会触发动态初始化
+thread_local MemoryAccount* current_account = nullptr;
+
+} // namespace
+
+void MemoryAccount::recordAllocation(size_t bytes) {
+    for (MemoryAccount* account = this; account; account = account->parent_) {
+        account->bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+        account->allocation_count_.fetch_add(1, std::memory_order_relaxed);
+
+        int64_t live = account->live_bytes_.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) +
+                       static_cast<int64_t>(bytes);
+        if (live <= 0) {
+            continue;
+        }
+        uint64_t peak = account->peak_live_bytes_.load(std::memory_order_relaxed);
+        while (static_cast<uint64_t>(live) > peak &&
+               !account->peak_live_bytes_.compare_exchange_weak(peak, static_cast<uint64_t>(live),
+                                                                std::memory_order_relaxed)) {
+        }
+    }
+}
+
+void MemoryAccount::recordDeallocation(size_t bytes) {
+    // 释放作用域外分配的内存时存活字节数可能为负，峰值只在分配时更新
+    for (MemoryAccount* account = this; account; account = account->parent_) {
+        account->bytes_freed_.fetch_add(bytes, std::memory_order_relaxed);
+        account->free_count_.fetch_add(1, std::memory_order_relaxed);
+        account->live_bytes_.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    }
+}
+
+MemoryUsage MemoryAccount::getUsage() const {
+    MemoryUsage usage;
+    usage.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+    usage.bytes_freed = bytes_freed_.load(std::memory_order_relaxed);
+    usage.allocation_count = allocation_count_.load(std::memory_order_relaxed);
+    usage.free_count = free_count_.load(std::memory_order_relaxed);
+    usage.peak_live_bytes = peak_live_bytes_.load(std::memory_order_relaxed);
+    return usage;
+}
+
+MemoryAccount* MemoryAccount::current() {
+    return current_account;
+}
+
+void MemoryAccount::setCurrent(MemoryAccount* account) {
+    current_account = account;
+}
+
+bool MemoryAccount::isAllocationTrackingEnabled() {
+#if defined(ALGORITHM_PLUGINS_ALLOCATION_HOOKS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace AlgorithmPlugins
+
+#if defined(ALGORITHM_PLUGINS_ALLOCATION_HOOKS)
+
+/**
+ * 全局operator new/delete替换
+ *
+ * 直接使用malloc/free，块大小取malloc_usable_size，分配和释放按同一口径计数。
+ * 当前线程未安装账户时只多一次线程局部变量读取
+ */
+namespace {
+
+using AlgorithmPlugins::MemoryAccount;
+
+inline void trackAllocation(void* ptr) {
+    if (MemoryAccount* account = MemoryAccount::current()) {
+        account->recordAllocation(malloc_usable_size(ptr));
+    }
+}
+
+inline void trackDeallocation(void* ptr) {
+    if (MemoryAccount* account = MemoryAccount::current()) {
+        account->recordDeallocation(malloc_usable_size(ptr));
+    }
+}
+
+void* allocate(std::size_t size, std::size_t alignment) {
+    if (size == 0) {
+        size = 1;
+    }
+
+    while (true) {
+        void* ptr = nullptr;
+        if (alignment <= alignof(std::max_align_t)) {
+            ptr = std::malloc(size);
+        } else if (posix_memalign(&ptr, alignment, size) != 0) {
+            ptr = nullptr;
+        }
+        if (ptr) {
+            trackAllocation(ptr);
+            return ptr;
+        }
+
+        // 与标准实现一致：调用new_handler后重试，未设置时抛出bad_alloc
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* allocateNoThrow(std::size_t size, std::size_t alignment) noexcept {
+    try {
+        return allocate(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void deallocate(void* ptr) noexcept {
+    if (ptr) {
+        trackDeallocation(ptr);
+        std::free(ptr);
+    }
+}
+
+constexpr std::size_t kDefaultAlignment = alignof(std::max_align_t);
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size, kDefaultAlignment); }
+void* operator new[](std::size_t size) { return allocate(size, kDefaultAlignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size, kDefaultAlignment); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size, kDefaultAlignment); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(ptr); }
+
+#endif
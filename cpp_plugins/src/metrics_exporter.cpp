@@ -0,0 +1,607 @@
+#include "metrics_exporter.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+// 延迟直方图导出的桶上限（秒），细粒度直方图在导出时按这些上限累计
+const std::vector<double> kLatencyBucketSeconds = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+};
+
+std::string formatDouble(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+// 桶上限（纳秒），末尾为+Inf，累计结果即总数
+const std::vector<uint64_t>& latencyBucketBounds() {
+    static const std::vector<uint64_t> bounds = [] {
+        std::vector<uint64_t> values;
+        for (double seconds : kLatencyBucketSeconds) {
+            values.push_back(static_cast<uint64_t>(seconds * 1e9));
+        }
+        values.push_back(UINT64_MAX);
+        return values;
+    }();
+    return bounds;
+}
+
+const std::vector<std::string>& latencyBucketLabels() {
+    static const std::vector<std::string> labels = [] {
+        std::vector<std::string> values;
+        for (double seconds : kLatencyBucketSeconds) {
+            values.push_back(formatDouble(seconds));
+        }
+        values.push_back("+Inf");
+        return values;
+    }();
+    return labels;
+}
+
+// 标签值转义：反斜杠、双引号和换行
+void appendLabelValue(std::string& out, const std::string& value) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '"': out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            default: out += c; break;
+        }
+    }
+}
+
+std::string labels(std::initializer_list<std::pair<const char*, const std::string*>> pairs) {
+    std::string out;
+    for (const auto& [name, value] : pairs) {
+        if (!out.empty()) {
+            out += ',';
+        }
+        out += name;
+        out += "=\"";
+        appendLabelValue(out, *value);
+        out += '"';
+    }
+    return out;
+}
+
+/**
+ * @brief OpenMetrics文本拼接
+ */
+class MetricsWriter {
+public:
+    MetricsWriter(std::string& out, const std::string& prefix) : out_(out), prefix_(prefix) {}
+
+    void family(const char* name, const char* type, const char* help) {
+        out_ += "# TYPE ";
+        appendName(name, "");
+        out_ += ' ';
+        out_ += type;
+        out_ += "\n# HELP ";
+        appendName(name, "");
+        out_ += ' ';
+        out_ += help;
+        out_ += '\n';
+    }
+
+    void sample(const char* name, const char* suffix, const std::string& label_text, const std::string& value) {
+        appendName(name, suffix);
+        if (!label_text.empty()) {
+            out_ += '{';
+            out_ += label_text;
+            out_ += '}';
+        }
+        out_ += ' ';
+        out_ += value;
+        out_ += '\n';
+    }
+
+    void sample(const char* name, const char* suffix, const std::string& label_text, uint64_t value) {
+        sample(name, suffix, label_text, std::to_string(value));
+    }
+
+    // 直方图的累计桶、总数和总和，counts为按latencyBucketBounds累计的计数
+    void histogram(const char* name, const std::string& label_text, const std::vector<uint64_t>& counts,
+                   double sum_seconds) {
+        const auto& bucket_labels = latencyBucketLabels();
+        std::string bucket_label_text;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            bucket_label_text = label_text;
+            bucket_label_text += label_text.empty() ? "le=\"" : ",le=\"";
+            bucket_label_text += bucket_labels[i];
+            bucket_label_text += '"';
+            sample(name, "_bucket", bucket_label_text, counts[i]);
+        }
+        sample(name, "_count", label_text, counts.back());
+        sample(name, "_sum", label_text, formatDouble(sum_seconds));
+    }
+
+private:
+    std::string& out_;
+    const std::string& prefix_;
+
+    void appendName(const char* name, const char* suffix) {
+        out_ += prefix_;
+        out_ += '_';
+        out_ += name;
+        out_ += suffix;
+    }
+};
+
+// 执行时间总和（秒）
+double executionSeconds(const PluginMonitorManager::PluginMetrics& metrics) {
+    return metrics.avg_execution_time_ms * metrics.execution_count / 1000.0;
+}
+
+// 进程常驻内存和虚拟内存（字节），不支持的平台返回false
+bool readProcessMemory(uint64_t& resident_bytes, uint64_t& virtual_bytes) {
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size_pages = 0;
+    uint64_t resident_pages = 0;
+    if (!(statm >> size_pages >> resident_pages)) {
+        return false;
+    }
+    const uint64_t page_size = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    resident_bytes = resident_pages * page_size;
+    virtual_bytes = size_pages * page_size;
+    return true;
+#else
+    (void)resident_bytes;
+    (void)virtual_bytes;
+    return false;
+#endif
+}
+
+const char* const kContentType = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+} // namespace
+
+OpenMetricsExporter::OpenMetricsExporter(const std::string& prefix) : prefix_(prefix) {
+}
+
+OpenMetricsExporter::~OpenMetricsExporter() {
+    stop();
+}
+
+void OpenMetricsExporter::setMonitor(const PluginMonitorManager* monitor) {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    monitor_ = monitor;
+}
+
+void OpenMetricsExporter::setScheduler(const TaskScheduler* scheduler) {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    scheduler_ = scheduler;
+}
+
+void OpenMetricsExporter::setAsyncExecutor(const std::string& name, const AsyncChainExecutor* executor) {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    if (executor) {
+        async_executors_[name] = executor;
+    } else {
+        async_executors_.erase(name);
+    }
+}
+
+void OpenMetricsExporter::setPipeline(const std::string& name, const PipelinedChainExecutor* pipeline) {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    if (pipeline) {
+        pipelines_[name] = pipeline;
+    } else {
+        pipelines_.erase(name);
+    }
+}
+
+void OpenMetricsExporter::setResultCache(const std::string& name, const ResultCache* cache) {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    if (cache) {
+        result_caches_[name] = cache;
+    } else {
+        result_caches_.erase(name);
+    }
+}
+
+std::string OpenMetricsExporter::render() const {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+
+    std::string out;
+    out.reserve(16 * 1024);
+    MetricsWriter writer(out, prefix_);
+
+    // 插件执行统计，每个插件和链节点只合并一次，各指标族由同一快照生成
+    if (monitor_) {
+        const std::string success = "success";
+        const std::string error = "error";
+        
+        std::vector<PluginMonitorManager::MetricsSnapshot> plugins;
+        std::vector<PluginMonitorManager::MetricsSnapshot> stages;
+        monitor_->snapshotMetrics(latencyBucketBounds(), plugins, stages);
+        
+        std::vector<std::string> plugin_labels;
+        plugin_labels.reserve(plugins.size());
+        for (const auto& snapshot : plugins) {
+            plugin_labels.push_back(labels({{"plugin", &snapshot.metrics.plugin_name}}));
+        }
+        std::vector<std::string> stage_labels;
+        stage_labels.reserve(stages.size());
+        for (const auto& snapshot : stages) {
+            stage_labels.push_back(labels({{"chain", &snapshot.chain_name}, {"plugin", &snapshot.metrics.plugin_name}}));
+        }
+        
+        writer.family("plugin_executions", "counter", "Plugin executions by result.");
+        for (const auto& snapshot : plugins) {
+            const auto& metrics = snapshot.metrics;
+            writer.sample("plugin_executions", "_total",
+                          labels({{"plugin", &metrics.plugin_name}, {"result", &success}}), metrics.success_count);
+            writer.sample("plugin_executions", "_total",
+                          labels({{"plugin", &metrics.plugin_name}, {"result", &error}}), metrics.error_count);
+        }
+        
+        writer.family("plugin_execution_seconds", "histogram", "Plugin execution time.");
+        for (size_t i = 0; i < plugins.size(); ++i) {
+            writer.histogram("plugin_execution_seconds", plugin_labels[i], plugins[i].latency_counts,
+                             executionSeconds(plugins[i].metrics));
+        }
+        
+        writer.family("chain_stage_execution_seconds", "histogram", "Plugin chain stage execution time.");
+        for (size_t i = 0; i < stages.size(); ++i) {
+            writer.histogram("chain_stage_execution_seconds", stage_labels[i], stages[i].latency_counts,
+                             executionSeconds(stages[i].metrics));
+        }
+        
+        writer.family("chain_stage_errors", "counter", "Plugin chain stage failures.");
+        for (size_t i = 0; i < stages.size(); ++i) {
+            writer.sample("chain_stage_errors", "_total", stage_labels[i], stages[i].metrics.error_count);
+        }
+        
+        // 内存统计，只导出记录过内存的插件和链节点
+        writer.family("plugin_allocated_bytes", "counter", "Bytes allocated during plugin executions.");
+        for (size_t i = 0; i < plugins.size(); ++i) {
+            if (plugins[i].metrics.memory_samples > 0) {
+                writer.sample("plugin_allocated_bytes", "_total", plugin_labels[i], plugins[i].metrics.bytes_allocated);
+            }
+        }
+        
+        writer.family("plugin_peak_memory_bytes", "gauge", "Highest live bytes within a single plugin execution.");
+        for (size_t i = 0; i < plugins.size(); ++i) {
+            if (plugins[i].metrics.memory_samples > 0) {
+                writer.sample("plugin_peak_memory_bytes", "", plugin_labels[i], plugins[i].metrics.peak_memory_bytes);
+            }
+        }
+        
+        writer.family("plugin_retained_bytes", "gauge", "Bytes allocated by plugin executions and not yet freed.");
+        for (size_t i = 0; i < plugins.size(); ++i) {
+            if (plugins[i].metrics.memory_samples > 0) {
+                writer.sample("plugin_retained_bytes", "", plugin_labels[i],
+                              std::to_string(plugins[i].metrics.retained_bytes));
+            }
+        }
+        
+        writer.family("chain_stage_allocated_bytes", "counter", "Bytes allocated by plugin chain stages.");
+        for (size_t i = 0; i < stages.size(); ++i) {
+            if (stages[i].metrics.memory_samples > 0) {
+                writer.sample("chain_stage_allocated_bytes", "_total", stage_labels[i], stages[i].metrics.bytes_allocated);
+            }
+        }
+        
+        writer.family("chain_stage_allocations", "counter", "Allocations made by plugin chain stages.");
+        for (size_t i = 0; i < stages.size(); ++i) {
+            if (stages[i].metrics.memory_samples > 0) {
+                writer.sample("chain_stage_allocations", "_total", stage_labels[i], stages[i].metrics.allocation_count);
+            }
+        }
+        
+        writer.family("chain_stage_peak_memory_bytes", "gauge", "Highest live bytes within a single stage execution.");
+        for (size_t i = 0; i < stages.size(); ++i) {
+            if (stages[i].metrics.memory_samples > 0) {
+                writer.sample("chain_stage_peak_memory_bytes", "", stage_labels[i], stages[i].metrics.peak_memory_bytes);
+            }
+        }
+        
+        writer.family("chain_stage_retained_bytes", "gauge", "Bytes allocated by stage executions and not yet freed.");
+        for (size_t i = 0; i < stages.size(); ++i) {
+            if (stages[i].metrics.memory_samples > 0) {
+                writer.sample("chain_stage_retained_bytes", "", stage_labels[i],
+                              std::to_string(stages[i].metrics.retained_bytes));
+            }
+        }
+    }
+
+    // 异步执行器
+    if (!async_executors_.empty()) {
+        writer.family("async_queue_depth", "gauge", "Requests waiting in the async executor queue.");
+        for (const auto& [name, executor] : async_executors_) {
+            writer.sample("async_queue_depth", "", labels({{"executor", &name}}), executor->getQueueDepth());
+        }
+        writer.family("async_queue_capacity", "gauge", "Async executor queue capacity.");
+        for (const auto& [name, executor] : async_executors_) {
+            writer.sample("async_queue_capacity", "", labels({{"executor", &name}}), executor->getQueueCapacity());
+        }
+        writer.family("async_workers", "gauge", "Async executor worker threads.");
+        for (const auto& [name, executor] : async_executors_) {
+            writer.sample("async_workers", "", labels({{"executor", &name}}), executor->getWorkerCount());
+        }
+        writer.family("async_completed", "counter", "Requests completed by the async executor.");
+        for (const auto& [name, executor] : async_executors_) {
+            writer.sample("async_completed", "_total", labels({{"executor", &name}}), executor->getCompletedCount());
+        }
+        writer.family("async_rejected", "counter", "Requests rejected because the queue was full.");
+        for (const auto& [name, executor] : async_executors_) {
+            writer.sample("async_rejected", "_total", labels({{"executor", &name}}), executor->getRejectedCount());
+        }
+    }
+
+    // 流水线执行器
+    if (!pipelines_.empty()) {
+        writer.family("pipeline_queue_depth", "gauge", "Items waiting in each pipeline stage queue.");
+        for (const auto& [name, pipeline] : pipelines_) {
+            for (size_t stage = 0; stage < pipeline->getStageCount(); ++stage) {
+                const std::string stage_index = std::to_string(stage);
+                writer.sample("pipeline_queue_depth", "", labels({{"pipeline", &name}, {"stage", &stage_index}}),
+                              pipeline->getQueueDepth(stage));
+            }
+        }
+        writer.family("pipeline_in_flight", "gauge", "Items submitted to the pipeline and not yet completed.");
+        for (const auto& [name, pipeline] : pipelines_) {
+            writer.sample("pipeline_in_flight", "", labels({{"pipeline", &name}}), pipeline->getInFlightCount());
+        }
+    }
+
+    // 任务调度器
+    if (scheduler_) {
+        writer.family("scheduler_threads", "gauge", "Task scheduler worker threads.");
+        writer.sample("scheduler_threads", "", "", scheduler_->getThreadCount());
+        writer.family("scheduler_active_threads", "gauge", "Task scheduler workers currently running a task.");
+        writer.sample("scheduler_active_threads", "", "", scheduler_->getActiveCount());
+        writer.family("scheduler_pending_tasks", "gauge", "Tasks waiting in the task scheduler.");
+        writer.sample("scheduler_pending_tasks", "", "", scheduler_->getPendingCount());
+    }
+
+    // 结果缓存
+    if (!result_caches_.empty()) {
+        writer.family("result_cache_entries", "gauge", "Entries in the pure plugin result cache.");
+        for (const auto& [name, cache] : result_caches_) {
+            writer.sample("result_cache_entries", "", labels({{"cache", &name}}), cache->size());
+        }
+        writer.family("result_cache_hits", "counter", "Result cache hits.");
+        for (const auto& [name, cache] : result_caches_) {
+            writer.sample("result_cache_hits", "_total", labels({{"cache", &name}}), cache->getHitCount());
+        }
+        writer.family("result_cache_misses", "counter", "Result cache misses.");
+        for (const auto& [name, cache] : result_caches_) {
+            writer.sample("result_cache_misses", "_total", labels({{"cache", &name}}), cache->getMissCount());
+        }
+        writer.family("result_cache_evictions", "counter", "Result cache evictions.");
+        for (const auto& [name, cache] : result_caches_) {
+            writer.sample("result_cache_evictions", "_total", labels({{"cache", &name}}), cache->getEvictionCount());
+        }
+    }
+
+    // 进程内存
+    uint64_t resident_bytes = 0;
+    uint64_t virtual_bytes = 0;
+    if (readProcessMemory(resident_bytes, virtual_bytes)) {
+        writer.family("process_resident_memory_bytes", "gauge", "Resident memory size.");
+        writer.sample("process_resident_memory_bytes", "", "", resident_bytes);
+        writer.family("process_virtual_memory_bytes", "gauge", "Virtual memory size.");
+        writer.sample("process_virtual_memory_bytes", "", "", virtual_bytes);
+    }
+
+    out += "# EOF\n";
+    return out;
+}
+
+bool OpenMetricsExporter::writeToFile(const std::string& file_path) const {
+    const std::string temp_path = file_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            setError("无法创建指标文件: " + temp_path);
+            return false;
+        }
+        file << render();
+        if (!file.good()) {
+            setError("写入指标文件失败: " + temp_path);
+            return false;
+        }
+    }
+
+    // 抓取方读取时文件总是完整的
+    std::error_code ec;
+    std::filesystem::rename(temp_path, file_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        setError("重命名指标文件失败: " + file_path);
+        return false;
+    }
+    return true;
+}
+
+bool OpenMetricsExporter::startFileExport(const std::string& file_path, std::chrono::milliseconds interval) {
+    if (file_thread_.joinable()) {
+        setError("文件导出已在运行");
+        return false;
+    }
+    if (interval.count() <= 0) {
+        setError("导出间隔必须大于0");
+        return false;
+    }
+
+    file_thread_ = std::thread(&OpenMetricsExporter::fileExportLoop, this, file_path, interval);
+    return true;
+}
+
+void OpenMetricsExporter::fileExportLoop(std::string file_path, std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    while (!stopping_) {
+        lock.unlock();
+        writeToFile(file_path);
+        lock.lock();
+        stop_signal_.wait_for(lock, interval, [this] { return stopping_.load(); });
+    }
+}
+
+bool OpenMetricsExporter::startHttpServer(uint16_t port, const std::string& address) {
+#if defined(_WIN32)
+    (void)port;
+    (void)address;
+    setError("当前平台不支持HTTP导出，请使用文件导出");
+    return false;
+#else
+    if (http_thread_.joinable()) {
+        setError("HTTP监听已在运行");
+        return false;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        setError("无效的监听地址: " + address);
+        return false;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        setError("无法创建监听套接字");
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 16) != 0) {
+        ::close(fd);
+        setError("无法监听端口: " + address + ":" + std::to_string(port));
+        return false;
+    }
+
+    socklen_t length = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    http_port_ = ntohs(addr.sin_port);
+
+    listen_socket_ = fd;
+    http_thread_ = std::thread(&OpenMetricsExporter::httpServerLoop, this);
+    return true;
+#endif
+}
+
+void OpenMetricsExporter::httpServerLoop() {
+#if !defined(_WIN32)
+    // 定期醒来检查停止标志，抓取间隔通常为秒级，逐个处理连接即可
+    while (!stopping_) {
+        pollfd listen_poll{listen_socket_, POLLIN, 0};
+        if (::poll(&listen_poll, 1, 200) <= 0) {
+            continue;
+        }
+        int client = ::accept(listen_socket_, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        handleHttpConnection(client);
+        ::close(client);
+    }
+#endif
+}
+
+void OpenMetricsExporter::handleHttpConnection(int client_socket) const {
+#if defined(_WIN32)
+    (void)client_socket;
+#else
+    timeval timeout{1, 0};
+    ::setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(client_socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // 只需要请求行，读到请求头结束或8KB为止
+    std::string request;
+    char buffer[1024];
+    while (request.size() < 8192 && request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t received = ::recv(client_socket, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    std::string status = "404 Not Found";
+    std::string content_type = "text/plain; charset=utf-8";
+    std::string body = "not found\n";
+    if (request.compare(0, 4, "GET ") == 0) {
+        size_t path_end = request.find(' ', 4);
+        std::string path = request.substr(4, path_end == std::string::npos ? std::string::npos : path_end - 4);
+        if (path == "/metrics" || path == "/") {
+            status = "200 OK";
+            content_type = kContentType;
+            body = render();
+        }
+    } else {
+        status = "405 Method Not Allowed";
+        body = "method not allowed\n";
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\nContent-Type: " + content_type +
+                           "\r\nContent-Length: " + std::to_string(body.size()) +
+                           "\r\nConnection: close\r\n\r\n" + body;
+
+#if defined(MSG_NOSIGNAL)
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = ::send(client_socket, response.data() + sent, response.size() - sent, flags);
+        if (written <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(written);
+    }
+#endif
+}
+
+void OpenMetricsExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        stopping_ = true;
+    }
+    stop_signal_.notify_all();
+
+    if (file_thread_.joinable()) {
+        file_thread_.join();
+    }
+    if (http_thread_.joinable()) {
+        http_thread_.join();
+    }
+#if !defined(_WIN32)
+    if (listen_socket_ >= 0) {
+        ::close(listen_socket_);
+        listen_socket_ = -1;
+    }
+#endif
+    http_port_ = 0;
+    stopping_ = false;
+}
+
+std::string OpenMetricsExporter::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+void OpenMetricsExporter::setError(const std::string& error) const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = error;
+}
+
+} // namespace AlgorithmPlugins
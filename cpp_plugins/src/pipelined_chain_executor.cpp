@@ -0,0 +1,267 @@
+#include "pipelined_chain_executor.h"
+#include <chrono>
+
+namespace AlgorithmPlugins {
+
+PipelinedChainExecutor::PipelinedChainExecutor(size_t queue_capacity)
+    : queue_capacity_(queue_capacity) {
+}
+
+PipelinedChainExecutor::~PipelinedChainExecutor() {
+    stop();
+}
+
+bool PipelinedChainExecutor::start(const PluginChainManager::ChainConfig& config) {
+    if (!stages_.empty()) {
+        setError("流水线已启动");
+        return false;
+    }
+
+    if (config.plugin_names.empty()) {
+        setError("插件链为空");
+        return false;
+    }
+
+    // DAG的汇合节点需要等待多个上游结果，无法映射为单一前后级关系
+    if (!config.data_mappings.empty()) {
+        setError("流水线模式仅支持串行链");
+        return false;
+    }
+
+    // 各级实例在启动时创建；有状态插件的历史会与PluginChainManager中的实例分叉，不允许进入流水线
+    auto& manager = PluginManager::getInstance();
+    std::vector<std::unique_ptr<Stage>> stages;
+    for (size_t i = 0; i < config.plugin_names.size(); ++i) {
+        auto stage = std::make_unique<Stage>(queue_capacity_);
+        stage->plugin_name = config.plugin_names[i];
+        stage->stage_key = PluginMonitorManager::stageKey(config.chain_name, stage->plugin_name);
+        stage->params = (i < config.plugin_params.size()) ? config.plugin_params[i] : nullptr;
+        stage->registry_generation = manager.getRegistryGeneration();
+        stage->plugin_generation = manager.getPluginGeneration(stage->plugin_name);
+        stage->plugin = manager.createPlugin(stage->plugin_name, stage->params);
+        if (!stage->plugin) {
+            setError("插件创建失败: " + stage->plugin_name);
+            return false;
+        }
+        if (stage->plugin->isStateful()) {
+            setError("流水线模式不支持有状态插件: " + stage->plugin_name);
+            return false;
+        }
+        stages.push_back(std::move(stage));
+    }
+
+    config_ = config;
+    stages_ = std::move(stages);
+
+    stopping_ = false;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        stages_[i]->worker = std::thread(&PipelinedChainExecutor::stageLoop, this, i);
+    }
+
+    accepting_ = true;
+    return true;
+}
+
+bool PipelinedChainExecutor::submit(std::shared_ptr<PluginData> input_data,
+                                    std::shared_ptr<PluginResult> output_result,
+                                    Completion on_complete) {
+    // 先登记再检查状态，stop()等待登记数归零时不会漏掉正在提交的数据
+    in_flight_++;
+    if (!accepting_.load()) {
+        releaseInFlight();
+        return false;
+    }
+
+    auto item = std::make_unique<PipelineItem>();
+    item->trace_context = TRACE_CURRENT_CONTEXT();
+    item->input_data = std::move(input_data);
+    item->output_result = std::move(output_result);
+    item->on_complete = std::move(on_complete);
+
+    // 第一级队列已满时拒绝，调用方可稍后重试
+    Stage& first = *stages_.front();
+    if (!first.queue.tryPush(item)) {
+        releaseInFlight();
+        return false;
+    }
+
+    wakeStage(first);
+    return true;
+}
+
+bool PipelinedChainExecutor::submit(std::shared_ptr<PluginData> input_data,
+                                    std::shared_ptr<PluginResult> output_result,
+                                    std::future<bool>& result) {
+    // std::function要求可拷贝，promise通过shared_ptr持有
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future();
+
+    bool accepted = submit(std::move(input_data), std::move(output_result),
+                           [promise](bool success, std::shared_ptr<PluginResult>) {
+                               promise->set_value(success);
+                           });
+    if (accepted) {
+        result = std::move(future);
+    }
+
+    return accepted;
+}
+
+void PipelinedChainExecutor::stop() {
+    if (stages_.empty()) {
+        return;
+    }
+
+    accepting_ = false;
+
+    // 等待已提交的数据流出最后一级
+    {
+        std::unique_lock<std::mutex> lock(drain_mutex_);
+        drained_.wait(lock, [this] { return in_flight_.load() == 0; });
+    }
+
+    stopping_ = true;
+    for (auto& stage : stages_) {
+        {
+            std::lock_guard<std::mutex> lock(stage->wait_mutex);
+        }
+        stage->ready.notify_all();
+    }
+
+    for (auto& stage : stages_) {
+        if (stage->worker.joinable()) {
+            stage->worker.join();
+        }
+    }
+
+    stages_.clear();
+}
+
+size_t PipelinedChainExecutor::getQueueDepth(size_t stage_index) const {
+    return stage_index < stages_.size() ? stages_[stage_index]->queue.size() : 0;
+}
+
+void PipelinedChainExecutor::stageLoop(size_t stage_index) {
+    Stage& stage = *stages_[stage_index];
+    const bool last_stage = (stage_index + 1 == stages_.size());
+
+    while (true) {
+        std::unique_ptr<PipelineItem> item;
+        if (!stage.queue.tryPop(item)) {
+            std::unique_lock<std::mutex> lock(stage.wait_mutex);
+            stage.waiting = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // 登记等待后再检查一次，避免与生产者的入队交错丢失唤醒
+            if (!stage.queue.tryPop(item)) {
+                stage.ready.wait(lock, [this, &stage] {
+                    return stopping_.load() || !stage.queue.empty();
+                });
+                stage.waiting = false;
+                if (stopping_.load() && stage.queue.empty()) {
+                    return;
+                }
+                continue;
+            }
+            stage.waiting = false;
+        }
+
+        // 前级失败的数据跳过本级插件，但仍按顺序向后传递
+        if (!item->failed) {
+            item->failed = !executeStage(stage, *item);
+        }
+
+        if (last_stage) {
+            if (item->on_complete) {
+                try {
+                    item->on_complete(!item->failed, item->output_result);
+                } catch (const std::exception&) {
+                    // 回调异常不影响流水线继续处理
+                }
+            }
+            item.reset();
+            releaseInFlight();
+        } else {
+            pushToStage(stage_index + 1, std::move(item));
+        }
+    }
+}
+
+void PipelinedChainExecutor::pushToStage(size_t stage_index, std::unique_ptr<PipelineItem> item) {
+    Stage& stage = *stages_[stage_index];
+
+    // 下一级队列已满时让出CPU等待其消费，形成逐级反压
+    while (!stage.queue.tryPush(item)) {
+        wakeStage(stage);
+        std::this_thread::yield();
+    }
+
+    wakeStage(stage);
+}
+
+void PipelinedChainExecutor::wakeStage(Stage& stage) {
+    // 与工作线程登记等待后的再次检查配对，保证入队对其可见或其等待状态对本线程可见
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (stage.waiting.load()) {
+        {
+            std::lock_guard<std::mutex> lock(stage.wait_mutex);
+        }
+        stage.ready.notify_one();
+    }
+}
+
+void PipelinedChainExecutor::releaseInFlight() {
+    if (in_flight_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        drained_.notify_all();
+    }
+}
+
+bool PipelinedChainExecutor::executeStage(Stage& stage, PipelineItem& item) {
+    TRACE_CONTEXT_SCOPE(item.trace_context);
+    TRACE_SPAN_LABEL("pipelineStage", "plugin", stage.stage_key);
+
+    auto plugin = acquirePlugin(stage);
+    if (!plugin) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool success;
+    try {
+        success = plugin->process(item.input_data, item.output_result);
+    } catch (const std::exception&) {
+        success = false;
+    }
+
+    if (PluginMonitorManager* monitor = monitor_.load(std::memory_order_acquire)) {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        monitor->recordStageExecution(stage.stage_key, success, elapsed.count());
+    }
+    return success;
+}
+
+std::shared_ptr<IPlugin> PipelinedChainExecutor::acquirePlugin(Stage& stage) {
+    auto& manager = PluginManager::getInstance();
+
+    // 插件被替换后重建实例，旧库在实例释放后卸载；新版本变为有状态插件时不再执行
+    uint64_t registry_generation = manager.getRegistryGeneration();
+    if (registry_generation != stage.registry_generation) {
+        uint64_t plugin_generation = manager.getPluginGeneration(stage.plugin_name);
+        if (plugin_generation != stage.plugin_generation) {
+            stage.plugin.reset();
+            stage.plugin_generation = plugin_generation;
+        }
+        stage.registry_generation = registry_generation;
+    }
+
+    if (!stage.plugin) {
+        stage.plugin = manager.createPlugin(stage.plugin_name, stage.params);
+    }
+    if (stage.plugin && stage.plugin->isStateful()) {
+        stage.plugin.reset();
+    }
+    return stage.plugin;
+}
+
+} // namespace AlgorithmPlugins
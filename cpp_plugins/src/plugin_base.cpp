@@ -4,14 +4,23 @@
 
 namespace AlgorithmPlugins {
 
-// PluginData基类实现
-PluginData::~PluginData() = default;
-
-// PluginResult基类实现
-PluginResult::~PluginResult() = default;
-
-// PluginParameter基类实现
-PluginParameter::~PluginParameter() = default;
+// IPlugin默认批量处理实现
+bool IPlugin::processBatch(const std::vector<std::shared_ptr<PluginData>>& inputs,
+                           const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                           std::vector<bool>& succeeded) {
+    succeeded.assign(inputs.size(), false);
+    if (inputs.size() != outputs.size()) {
+        return false;
+    }
+    
+    bool all_succeeded = true;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        succeeded[i] = process(inputs[i], outputs[i]);
+        all_succeeded = all_succeeded && succeeded[i];
+    }
+    
+    return all_succeeded;
+}
 
 // AlgorithmWork基类实现
 AlgorithmWork::AlgorithmWork() {
@@ -3,6 +3,7 @@
 #include "decision_plugin_base.h"
 #include "evaluation_plugin_base.h"
 #include "event_plugin_base.h"
+#include "trace_span.h"
 
 namespace AlgorithmPlugins {
 
@@ -196,4 +197,19 @@ extern "C" {
     void register_algorithm_plugins() {
         AlgorithmPlugins::registerAllPlugins();
     }
+    
+    // 追踪开关，每sample_interval个请求采样一个
+    void algorithm_plugins_set_tracing(int enabled, unsigned int sample_interval) {
+        auto& tracer = AlgorithmPlugins::Tracer::getInstance();
+        tracer.setSampleInterval(sample_interval);
+        tracer.setEnabled(enabled != 0);
+    }
+    
+    // 将已记录的区间导出为Chrome trace JSON，成功返回0
+    int algorithm_plugins_export_trace(const char* file_path) {
+        if (!file_path) {
+            return -1;
+        }
+        return AlgorithmPlugins::Tracer::getInstance().exportChromeTrace(file_path) ? 0 : -1;
+    }
 }
@@ -1,8 +1,18 @@
 #include "plugin_manager.h"
+#include "data_types.h"
+#include "content_hash.h"
+#include "trace_span.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
 #include <mutex>
+#include <optional>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <queue>
+#include <unordered_map>
 
 namespace AlgorithmPlugins {
 
@@ -19,7 +29,9 @@ bool PluginManager::registerPluginFactory(std::shared_ptr<IPluginFactory> factor
     
     std::lock_guard<std::mutex> lock(mutex_);
     std::string plugin_name = factory->getPluginName();
+    releasePluginLibrary(plugin_name);
     plugin_factories_[plugin_name] = factory;
+    bumpPluginGeneration(plugin_name);
     return true;
 }
 
@@ -30,7 +42,9 @@ bool PluginManager::registerPluginFactory(const std::string& plugin_name,
     }
     
     std::lock_guard<std::mutex> lock(mutex_);
+    releasePluginLibrary(plugin_name);
     plugin_factories_[plugin_name] = factory;
+    bumpPluginGeneration(plugin_name);
     return true;
 }
 
@@ -42,7 +56,20 @@ std::shared_ptr<IPlugin> PluginManager::createPlugin(const std::string& plugin_n
         return nullptr;
     }
     
-    return factory->createPlugin();
+    auto plugin = factory->createPlugin();
+    
+    // 动态加载的插件实例持有所属库的引用，保证实例析构前库不会被卸载
+    auto lib_it = plugin_libraries_.find(plugin_name);
+    if (plugin && lib_it != plugin_libraries_.end()) {
+        auto library = lib_it->second;
+        IPlugin* raw_plugin = plugin.get();
+        return std::shared_ptr<IPlugin>(raw_plugin, [plugin, library](IPlugin*) mutable {
+            plugin.reset();
+            library.reset();
+        });
+    }
+    
+    return plugin;
 }
 
 std::shared_ptr<IPlugin> PluginManager::createPlugin(const std::string& plugin_name, 
@@ -156,40 +183,75 @@ std::vector<std::string> PluginManager::getOptionalParameters(const std::string&
     return {};
 }
 
-bool PluginManager::loadPluginFromFile(const std::string& file_path) {
+bool PluginManager::loadPluginFromFile(const std::string& file_path, bool lazy_binding) {
     try {
-        // 简化的插件加载实现
-        // 生产环境应使用动态库加载机制
-        std::ifstream file(file_path);
-        if (!file.is_open()) {
-            return false;
+        std::string canonical_path = std::filesystem::weakly_canonical(file_path).string();
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (loaded_libraries_.find(canonical_path) != loaded_libraries_.end()) {
+                return true;
+            }
         }
         
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
+        // 打开库和解析入口不持有锁
+        auto result = openPluginLibrary(canonical_path, lazy_binding);
         
-        // 这里应该解析插件配置文件并注册插件
-        // 简化实现，直接返回成功
-        return true;
+        std::lock_guard<std::mutex> lock(mutex_);
+        return registerLoadedLibrary(result, false);
         
     } catch (const std::exception& e) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        load_errors_[file_path] = e.what();
         return false;
     }
 }
 
-bool PluginManager::loadPluginsFromDirectory(const std::string& directory_path) {
+bool PluginManager::loadPluginsFromDirectory(const std::string& directory_path, bool lazy_binding) {
     try {
         std::filesystem::path dir_path(directory_path);
         if (!std::filesystem::exists(dir_path) || !std::filesystem::is_directory(dir_path)) {
             return false;
         }
         
-        bool success = true;
+        // 收集候选插件库
+        std::vector<std::string> candidates;
         for (const auto& entry : std::filesystem::directory_iterator(dir_path)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                if (!loadPluginFromFile(entry.path().string())) {
-                    success = false;
-                }
+            if (entry.is_regular_file() && 
+                DynamicLibrary::hasSharedLibraryExtension(entry.path().filename().string())) {
+                candidates.push_back(std::filesystem::weakly_canonical(entry.path()).string());
+            }
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                [this](const std::string& path) {
+                    return loaded_libraries_.find(path) != loaded_libraries_.end();
+                }), candidates.end());
+        }
+        
+        if (candidates.empty()) {
+            return true;
+        }
+        
+        // 排序保证同名插件的注册顺序稳定
+        std::sort(candidates.begin(), candidates.end());
+        
+        // 各插件库相互独立，并行完成ELF校验、dlopen和入口解析
+        std::vector<LibraryLoadResult> results(candidates.size());
+        parallelFor(0, candidates.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                results[i] = openPluginLibrary(candidates[i], lazy_binding);
+            }
+        });
+        
+        // 统一注册，只加锁一次
+        bool success = true;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& result : results) {
+            if (!registerLoadedLibrary(result, false)) {
+                success = false;
             }
         }
         
@@ -200,21 +262,114 @@ bool PluginManager::loadPluginsFromDirectory(const std::string& directory_path)
     }
 }
 
+bool PluginManager::swapPluginLibrary(const std::string& plugin_name,
+                                      const std::string& file_path,
+                                      bool lazy_binding) {
+    try {
+        std::string canonical_path = std::filesystem::weakly_canonical(file_path).string();
+        
+        bool reload_in_place = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto lib_it = plugin_libraries_.find(plugin_name);
+            if (lib_it != plugin_libraries_.end() && lib_it->second->getPath() == canonical_path) {
+                // 同一路径的dlopen返回已加载的映像，文件未被替换时无法得到新代码
+                DynamicLibrary::FileStamp stamp;
+                if (!DynamicLibrary::statFile(canonical_path, stamp) ||
+                    stamp == lib_it->second->getFileStamp()) {
+                    load_errors_[canonical_path] = "插件库文件未变化，无法从同一路径重新加载";
+                    return false;
+                }
+                reload_in_place = true;
+            } else if (loaded_libraries_.find(canonical_path) != loaded_libraries_.end()) {
+                load_errors_[canonical_path] = "插件库已被其他插件占用";
+                return false;
+            }
+        }
+        
+        // 新版本库的打开和初始化在锁外完成，不阻塞正在执行的请求
+        auto result = openPluginLibrary(canonical_path, lazy_binding, reload_in_place);
+        if (result.factory && result.factory->getPluginName() != plugin_name) {
+            result.error = "插件名称不匹配: " + result.factory->getPluginName();
+            result.factory.reset();
+            result.library.reset();
+        }
+        
+        // 替换工厂只需一次加锁，旧版本实例继续持有旧库直到释放
+        std::lock_guard<std::mutex> lock(mutex_);
+        return registerLoadedLibrary(result, true);
+        
+    } catch (const std::exception& e) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        load_errors_[file_path] = e.what();
+        return false;
+    }
+}
+
+std::vector<std::string> PluginManager::getLoadedLibraries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    std::vector<std::string> libraries;
+    for (const auto& [path, library] : loaded_libraries_) {
+        libraries.push_back(path);
+    }
+    
+    return libraries;
+}
+
+std::vector<std::string> PluginManager::getDrainingLibraries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    std::vector<std::string> libraries;
+    for (const auto& [path, library] : draining_libraries_) {
+        if (!library.expired()) {
+            libraries.push_back(path);
+        }
+    }
+    
+    return libraries;
+}
+
+std::map<std::string, std::string> PluginManager::getLoadErrors() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return load_errors_;
+}
+
+uint64_t PluginManager::getPluginGeneration(const std::string& plugin_name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto it = plugin_generations_.find(plugin_name);
+    return (it != plugin_generations_.end()) ? it->second : 0;
+}
+
 bool PluginManager::unregisterPlugin(const std::string& plugin_name) {
     std::lock_guard<std::mutex> lock(mutex_);
     
     auto it = plugin_factories_.find(plugin_name);
-    if (it != plugin_factories_.end()) {
-        plugin_factories_.erase(it);
-        return true;
+    if (it == plugin_factories_.end()) {
+        return false;
     }
     
-    return false;
+    plugin_factories_.erase(it);
+    releasePluginLibrary(plugin_name);
+    bumpPluginGeneration(plugin_name);
+    
+    return true;
 }
 
 void PluginManager::clearAllPlugins() {
     std::lock_guard<std::mutex> lock(mutex_);
+    
+    for (const auto& [path, library] : loaded_libraries_) {
+        draining_libraries_.emplace_back(path, library);
+    }
+    
     plugin_factories_.clear();
+    plugin_libraries_.clear();
+    loaded_libraries_.clear();
+    load_errors_.clear();
+    plugin_generations_.clear();
+    registry_generation_.fetch_add(1, std::memory_order_acq_rel);
 }
 
 std::map<std::string, std::string> PluginManager::getPluginStatus() const {
@@ -222,7 +377,18 @@ std::map<std::string, std::string> PluginManager::getPluginStatus() const {
     
     std::map<std::string, std::string> status;
     for (const auto& [name, factory] : plugin_factories_) {
-        status[name] = "Available";
+        auto lib_it = plugin_libraries_.find(name);
+        if (lib_it != plugin_libraries_.end()) {
+            status[name] = "Loaded: " + lib_it->second->getPath();
+        } else {
+            status[name] = "Available";
+        }
+    }
+    
+    for (const auto& [path, library] : draining_libraries_) {
+        if (!library.expired()) {
+            status[path] = "Draining";
+        }
     }
     
     return status;
@@ -233,14 +399,127 @@ std::shared_ptr<IPluginFactory> PluginManager::getPluginFactory(const std::strin
     return (it != plugin_factories_.end()) ? it->second : nullptr;
 }
 
+PluginManager::LibraryLoadResult PluginManager::openPluginLibrary(const std::string& file_path, 
+                                                                  bool lazy_binding,
+                                                                  bool load_from_copy) {
+    LibraryLoadResult result;
+    result.file_path = file_path;
+    
+    try {
+        if (!DynamicLibrary::isSharedLibrary(file_path)) {
+            result.error = "不是当前平台的共享库文件";
+            return result;
+        }
+        
+        auto library = load_from_copy ? DynamicLibrary::openCopy(file_path, lazy_binding, result.error)
+                                      : DynamicLibrary::open(file_path, lazy_binding, result.error);
+        if (!library) {
+            return result;
+        }
+        
+        using AbiVersionFunc = int (*)();
+        using FactoryFunc = IPluginFactory* (*)();
+        
+        // ABI版本检查，先于工厂入口执行
+        auto abi_func = reinterpret_cast<AbiVersionFunc>(library->getSymbol(ALGORITHM_PLUGIN_ABI_SYMBOL));
+        if (!abi_func) {
+            result.error = "缺少ABI版本入口: " ALGORITHM_PLUGIN_ABI_SYMBOL;
+            return result;
+        }
+        
+        int abi_version = abi_func();
+        if (abi_version != ALGORITHM_PLUGIN_ABI_VERSION) {
+            result.error = "ABI版本不匹配: 插件" + std::to_string(abi_version) +
+                           ", 框架" + std::to_string(ALGORITHM_PLUGIN_ABI_VERSION);
+            return result;
+        }
+        
+        auto factory_func = reinterpret_cast<FactoryFunc>(library->getSymbol(ALGORITHM_PLUGIN_FACTORY_SYMBOL));
+        if (!factory_func) {
+            result.error = "缺少工厂入口: " ALGORITHM_PLUGIN_FACTORY_SYMBOL;
+            return result;
+        }
+        
+        IPluginFactory* factory = factory_func();
+        if (!factory || factory->getPluginName().empty()) {
+            result.error = "插件工厂无效";
+            return result;
+        }
+        
+        // 工厂对象位于插件库内部，别名构造使工厂引用同时持有库
+        result.library = library;
+        result.factory = std::shared_ptr<IPluginFactory>(library, factory);
+        
+    } catch (const std::exception& e) {
+        result.error = "插件库加载异常: " + std::string(e.what());
+        result.library.reset();
+        result.factory.reset();
+    }
+    
+    return result;
+}
+
+bool PluginManager::registerLoadedLibrary(const LibraryLoadResult& result, bool replace) {
+    if (!result.factory) {
+        load_errors_[result.file_path] = result.error;
+        return false;
+    }
+    
+    std::string plugin_name = result.factory->getPluginName();
+    
+    // 同名插件（如同一库的副本或硬链接）不静默覆盖，新库随result释放
+    if (!replace && plugin_factories_.find(plugin_name) != plugin_factories_.end()) {
+        auto lib_it = plugin_libraries_.find(plugin_name);
+        load_errors_[result.file_path] = "插件名称重复: " + plugin_name +
+            (lib_it != plugin_libraries_.end() ? "，已由" + lib_it->second->getPath() + "注册" : "");
+        return false;
+    }
+    
+    // 同名插件的旧版本库转入待卸载状态
+    releasePluginLibrary(plugin_name);
+    
+    load_errors_.erase(result.file_path);
+    loaded_libraries_[result.file_path] = result.library;
+    plugin_libraries_[plugin_name] = result.library;
+    plugin_factories_[plugin_name] = result.factory;
+    bumpPluginGeneration(plugin_name);
+    
+    return true;
+}
+
+void PluginManager::bumpPluginGeneration(const std::string& plugin_name) {
+    uint64_t generation = registry_generation_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    plugin_generations_[plugin_name] = generation;
+}
+
+void PluginManager::releasePluginLibrary(const std::string& plugin_name) {
+    auto lib_it = plugin_libraries_.find(plugin_name);
+    if (lib_it == plugin_libraries_.end()) {
+        return;
+    }
+    
+    auto library = lib_it->second;
+    plugin_libraries_.erase(lib_it);
+    
+    // 库中已无注册插件时释放库引用，已创建的实例仍持有库直到析构
+    bool still_used = std::any_of(plugin_libraries_.begin(), plugin_libraries_.end(),
+        [&library](const auto& entry) { return entry.second == library; });
+    if (!still_used) {
+        loaded_libraries_.erase(library->getPath());
+        draining_libraries_.emplace_back(library->getPath(), library);
+    }
+    
+    // 清理已卸载的旧库记录
+    draining_libraries_.erase(std::remove_if(draining_libraries_.begin(), draining_libraries_.end(),
+        [](const auto& entry) { return entry.second.expired(); }), draining_libraries_.end());
+}
+
 // PluginChainManager实现
 PluginChainManager::PluginChainManager() = default;
 
 PluginChainManager::~PluginChainManager() = default;
 
 bool PluginChainManager::createChain(const ChainConfig& config) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (config.chain_name.empty() || config.plugin_names.empty()) {
         return false;
     }
@@ -253,215 +532,1009 @@ bool PluginChainManager::createChain(const ChainConfig& config) {
         }
     }
     
+    // 初始化插件实例，验证链中插件均可创建
+    auto runtime = std::make_shared<ChainRuntime>();
+    runtime->plan = compileChain(std::make_shared<const ChainConfig>(config));
+    runtime->initial_set = std::make_shared<ChainInstanceSet>();
+    if (!refreshInstanceSet(*runtime->initial_set, runtime->plan)) {
+        return false;
+    }
+    
     // 创建插件链
-    plugin_chains_[config.chain_name] = config;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    plugin_chains_[config.chain_name] = runtime;
+    
+    return true;
+}
+
+bool PluginChainManager::addPluginToChain(const std::string& chain_name, 
+                                          const std::string& plugin_name,
+                                          std::shared_ptr<PluginParameter> params) {
+    auto& manager = PluginManager::getInstance();
+    if (!manager.isPluginAvailable(plugin_name)) {
+        return false;
+    }
+    
+    // 各设备实例集合在下次执行时创建新插件实例
+    return updateChainConfig(chain_name, [&](ChainConfig& config) {
+        config.plugin_names.push_back(plugin_name);
+        config.plugin_params.push_back(params);
+        return true;
+    });
+}
+
+bool PluginChainManager::removePluginFromChain(const std::string& chain_name, 
+                                                const std::string& plugin_name) {
+    return updateChainConfig(chain_name, [&](ChainConfig& config) {
+        auto plugin_it = std::find(config.plugin_names.begin(), config.plugin_names.end(), plugin_name);
+        if (plugin_it == config.plugin_names.end()) {
+            return false;
+        }
+        
+        size_t index = std::distance(config.plugin_names.begin(), plugin_it);
+        config.plugin_names.erase(plugin_it);
+        
+        if (index < config.plugin_params.size()) {
+            config.plugin_params.erase(config.plugin_params.begin() + index);
+        }
+        
+        return true;
+    });
+}
+
+bool PluginChainManager::clearChain(const std::string& chain_name) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    
+    // 正在执行的请求持有运行时状态的引用，插件实例在其结束后释放
+    return plugin_chains_.erase(chain_name) > 0;
+}
+
+bool PluginChainManager::executeChain(const std::string& chain_name, 
+                                     std::shared_ptr<PluginData> input_data,
+                                     std::shared_ptr<PluginResult> output_result) {
+    TRACE_REQUEST();
+    TRACE_SPAN_LABEL("executeChain", "chain", chain_name);
+    
+    std::shared_ptr<const ExecutionPlan> plan;
+    auto runtime = findChainRuntime(chain_name, plan);
+    if (!runtime || !plan->valid) {
+        return false;
+    }
+    
+    // 不同设备使用各自的实例集合并行执行，同一设备按到达顺序执行
+    auto instance_set = acquireInstanceSet(*runtime, instanceSetKey(*plan->config, input_data));
+    std::lock_guard<TicketLock> execution_lock(instance_set->execution_lock);
+    
+    // 执行计划或插件注册发生变化（如热替换）时刷新实例
+    if (!refreshInstanceSet(*instance_set, plan)) {
+        return false;
+    }
+    
+    if (plan->use_graph) {
+        return executeChainGraph(*plan, *instance_set, input_data, output_result);
+    }
+    
+    // 串行链的各插件直接写入输出结果，失败时输出中可能保留已执行插件的结果
+    for (size_t node = 0; node < instance_set->node_plugins.size(); ++node) {
+        if (!executeNodeInChain(*instance_set, node, input_data, output_result)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool PluginChainManager::executeChainBatch(const std::string& chain_name,
+                                          const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                          const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                          std::vector<bool>& succeeded) {
+    TRACE_REQUEST();
+    TRACE_SPAN_LABEL("executeChainBatch", "chain", chain_name);
+    
+    succeeded.assign(inputs.size(), false);
+    if (inputs.size() != outputs.size()) {
+        return false;
+    }
+    
+    std::shared_ptr<const ExecutionPlan> plan;
+    auto runtime = findChainRuntime(chain_name, plan);
+    if (!runtime || !plan->valid) {
+        return false;
+    }
+    
+    // 按实例集合分组，组内保持输入顺序
+    std::map<std::string, std::vector<size_t>> groups;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        groups[instanceSetKey(*plan->config, inputs[i])].push_back(i);
+    }
+    
+    bool all_succeeded = true;
+    std::vector<size_t> active;
+    std::vector<std::shared_ptr<PluginData>> group_inputs;
+    std::vector<std::shared_ptr<PluginResult>> group_outputs;
+    std::vector<bool> group_succeeded;
+    
+    for (const auto& [set_key, indices] : groups) {
+        auto instance_set = acquireInstanceSet(*runtime, set_key);
+        std::lock_guard<TicketLock> execution_lock(instance_set->execution_lock);
+        
+        if (!refreshInstanceSet(*instance_set, plan)) {
+            all_succeeded = false;
+            continue;
+        }
+        
+        if (plan->use_graph) {
+            for (size_t index : indices) {
+                succeeded[index] = executeChainGraph(*plan, *instance_set, inputs[index], outputs[index]);
+                all_succeeded = all_succeeded && succeeded[index];
+            }
+            continue;
+        }
+        
+        // 串行链逐个插件处理整组数据，失败的数据不再传给后续插件
+        active = indices;
+        for (size_t node = 0; node < instance_set->node_plugins.size(); ++node) {
+            if (active.empty()) {
+                break;
+            }
+            
+            group_inputs.clear();
+            group_outputs.clear();
+            for (size_t index : active) {
+                group_inputs.push_back(inputs[index]);
+                group_outputs.push_back(outputs[index]);
+            }
+            
+            executeNodeBatchInChain(*instance_set, node, group_inputs, group_outputs, group_succeeded);
+            
+            size_t kept = 0;
+            for (size_t k = 0; k < active.size(); ++k) {
+                if (group_succeeded[k]) {
+                    active[kept++] = active[k];
+                }
+            }
+            active.resize(kept);
+        }
+        
+        for (size_t index : active) {
+            succeeded[index] = true;
+        }
+        all_succeeded = all_succeeded && active.size() == indices.size();
+    }
+    
+    return all_succeeded;
+}
+
+std::vector<std::string> PluginChainManager::getAvailableChains() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    
+    std::vector<std::string> chains;
+    for (const auto& [name, runtime] : plugin_chains_) {
+        chains.push_back(name);
+    }
     
-    // 初始化插件实例
-    return initializeChainPlugins(config.chain_name);
+    return chains;
+}
+
+std::vector<std::string> PluginChainManager::getChainPlugins(const std::string& chain_name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    
+    auto it = plugin_chains_.find(chain_name);
+    if (it != plugin_chains_.end()) {
+        return it->second->plan->config->plugin_names;
+    }
+    
+    return {};
+}
+
+bool PluginChainManager::isChainAvailable(const std::string& chain_name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return plugin_chains_.find(chain_name) != plugin_chains_.end();
+}
+
+size_t PluginChainManager::getChainInstanceSetCount(const std::string& chain_name) const {
+    std::shared_ptr<ChainRuntime> runtime;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = plugin_chains_.find(chain_name);
+        if (it == plugin_chains_.end()) {
+            return 0;
+        }
+        runtime = it->second;
+    }
+    
+    std::lock_guard<std::mutex> lock(runtime->instance_sets_mutex);
+    return runtime->instance_sets.size();
+}
+
+size_t PluginChainManager::releaseIdleInstanceSets(std::chrono::steady_clock::duration max_idle) {
+    std::vector<std::shared_ptr<ChainRuntime>> runtimes;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (const auto& [chain_name, runtime] : plugin_chains_) {
+            runtimes.push_back(runtime);
+        }
+    }
+    
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<ChainInstanceSet>> released;
+    {
+        // 与检查点写入互斥，回收后的第一个检查点须为全量
+        std::lock_guard<std::mutex> checkpoint_lock(checkpoint_mutex_);
+        for (const auto& runtime : runtimes) {
+            std::lock_guard<std::mutex> lock(runtime->instance_sets_mutex);
+            for (auto it = runtime->instance_sets.begin(); it != runtime->instance_sets.end();) {
+                // 取用方在同一把锁内复制引用，引用计数为1说明没有请求正在使用
+                if (it->second.use_count() == 1 && now - it->second->last_used >= max_idle) {
+                    released.push_back(std::move(it->second));
+                    it = runtime->instance_sets.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        
+        if (!released.empty()) {
+            checkpoint_directory_.clear();
+        }
+    }
+    
+    // 插件实例在锁外释放，cleanup可能较慢
+    size_t count = released.size();
+    released.clear();
+    return count;
+}
+
+bool PluginChainManager::getChainConfig(const std::string& chain_name, ChainConfig& config) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    
+    auto it = plugin_chains_.find(chain_name);
+    if (it == plugin_chains_.end()) {
+        return false;
+    }
+    
+    config = *it->second->plan->config;
+    return true;
+}
+
+namespace {
+
+// 检查点段键：链名、实例集合键、插件名以单元分隔符连接
+constexpr char kCheckpointKeySeparator = '\x1f';
+
+std::string checkpointKey(const std::string& chain_name, const std::string& set_key,
+                          const std::string& plugin_name) {
+    return chain_name + kCheckpointKeySeparator + set_key + kCheckpointKeySeparator + plugin_name;
+}
+
+bool parseCheckpointKey(const std::string& key, std::string& chain_name, std::string& set_key,
+                        std::string& plugin_name) {
+    size_t first = key.find(kCheckpointKeySeparator);
+    size_t last = key.rfind(kCheckpointKeySeparator);
+    if (first == std::string::npos || first == last) {
+        return false;
+    }
+    chain_name = key.substr(0, first);
+    set_key = key.substr(first + 1, last - first - 1);
+    plugin_name = key.substr(last + 1);
+    return true;
+}
+
+} // namespace
+
+bool PluginChainManager::collectCheckpointSections(bool incremental,
+                                                   std::vector<StateCheckpoint::Section>& sections,
+                                                   bool& replaced) {
+    std::map<std::string, std::shared_ptr<ChainRuntime>> chains;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        chains = plugin_chains_;
+    }
+    
+    replaced = false;
+    for (const auto& [chain_name, runtime] : chains) {
+        std::map<std::string, std::shared_ptr<ChainInstanceSet>> instance_sets;
+        {
+            std::lock_guard<std::mutex> lock(runtime->instance_sets_mutex);
+            instance_sets = runtime->instance_sets;
+        }
+        
+        // 逐个实例集合加锁保存，其余设备的执行不受影响
+        for (const auto& [set_key, instance_set] : instance_sets) {
+            std::lock_guard<TicketLock> execution_lock(instance_set->execution_lock);
+            for (const auto& [plugin_name, plugin] : instance_set->instances) {
+                if (!plugin->isStateful()) {
+                    continue;
+                }
+                
+                // 被替换的实例不含旧实例的历史，增量检查点无法表达，改写全量检查点
+                auto recorded = instance_set->checkpoint_instances.find(plugin_name);
+                if (incremental && recorded != instance_set->checkpoint_instances.end() &&
+                    recorded->second.lock() != plugin) {
+                    replaced = true;
+                    return false;
+                }
+                
+                StateWriter writer;
+                try {
+                    if (!plugin->saveState(writer, incremental)) {
+                        checkpoint_error_ = "插件状态保存失败: " + chain_name + "/" + plugin_name + 
+                                            ": " + plugin->getLastError();
+                        return false;
+                    }
+                } catch (const std::exception& e) {
+                    checkpoint_error_ = "插件状态保存异常: " + chain_name + "/" + plugin_name + 
+                                        ": " + e.what();
+                    return false;
+                }
+                
+                sections.push_back({checkpointKey(chain_name, set_key, plugin_name), writer.data()});
+                instance_set->checkpoint_instances[plugin_name] = plugin;
+            }
+        }
+    }
+    
+    return true;
+}
+
+bool PluginChainManager::writeCheckpoint(const std::string& directory, bool incremental) {
+    std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+    
+    // 增量检查点以同一目录中已有的全量检查点为基础
+    incremental = incremental && checkpoint_directory_ == directory;
+    
+    std::vector<StateCheckpoint::Section> sections;
+    bool replaced = false;
+    bool collected = collectCheckpointSections(incremental, sections, replaced);
+    if (!collected && replaced) {
+        sections.clear();
+        incremental = false;
+        collected = collectCheckpointSections(false, sections, replaced);
+    }
+    
+    // 插件的修改标记已被清除，写入失败后只能以全量检查点重新开始
+    if (!collected || !StateCheckpoint::write(directory, checkpoint_sequence_ + 1, incremental,
+                                              sections, checkpoint_error_)) {
+        checkpoint_directory_.clear();
+        return false;
+    }
+    
+    checkpoint_sequence_++;
+    checkpoint_directory_ = directory;
+    return true;
+}
+
+bool PluginChainManager::restoreCheckpoint(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+    
+    auto handler = [this](const std::string& key, StateReader& reader) {
+        std::string chain_name, set_key, plugin_name;
+        if (!parseCheckpointKey(key, chain_name, set_key, plugin_name)) {
+            return false;
+        }
+        
+        std::shared_ptr<const ExecutionPlan> plan;
+        auto runtime = findChainRuntime(chain_name, plan);
+        if (!runtime || !plan->valid) {
+            return true;
+        }
+        
+        auto instance_set = acquireInstanceSet(*runtime, set_key);
+        std::lock_guard<TicketLock> execution_lock(instance_set->execution_lock);
+        if (!refreshInstanceSet(*instance_set, plan)) {
+            return false;
+        }
+        
+        auto it = instance_set->instances.find(plugin_name);
+        if (it == instance_set->instances.end() || !it->second->isStateful()) {
+            return true;
+        }
+        
+        try {
+            if (!it->second->loadState(reader)) {
+                return false;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+        instance_set->checkpoint_instances[plugin_name] = it->second;
+        return true;
+    };
+    
+    uint64_t sequence = 0;
+    if (!StateCheckpoint::restore(directory, handler, sequence, checkpoint_error_)) {
+        checkpoint_directory_.clear();
+        return false;
+    }
+    
+    // 后续增量检查点接在恢复的序号之后
+    checkpoint_sequence_ = sequence;
+    checkpoint_directory_ = sequence > 0 ? directory : std::string();
+    return true;
+}
+
+uint64_t PluginChainManager::getCheckpointSequence() const {
+    std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+    return checkpoint_sequence_;
+}
+
+std::string PluginChainManager::getLastCheckpointError() const {
+    std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+    return checkpoint_error_;
+}
+
+bool PluginChainManager::setDataMapping(const std::string& chain_name,
+                                       const std::string& source_plugin,
+                                       const std::string& target_plugin,
+                                       const std::string& data_key) {
+    return updateChainConfig(chain_name, [&](ChainConfig& config) {
+        std::string mapping_key = source_plugin + "->" + target_plugin;
+        config.data_mappings[mapping_key] = data_key;
+        return true;
+    });
+}
+
+bool PluginChainManager::updateChainConfig(const std::string& chain_name,
+                                          const std::function<bool(ChainConfig&)>& update) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    
+    auto it = plugin_chains_.find(chain_name);
+    if (it == plugin_chains_.end()) {
+        return false;
+    }
+    
+    // 复制后修改并重新编译，正在执行的请求继续使用旧的执行计划
+    auto config = std::make_shared<ChainConfig>(*it->second->plan->config);
+    if (!update(*config)) {
+        return false;
+    }
+    
+    it->second->plan = compileChain(std::move(config));
+    return true;
+}
+
+std::shared_ptr<PluginChainManager::ChainRuntime> PluginChainManager::findChainRuntime(
+    const std::string& chain_name,
+    std::shared_ptr<const ExecutionPlan>& plan) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    
+    auto it = plugin_chains_.find(chain_name);
+    if (it == plugin_chains_.end()) {
+        return nullptr;
+    }
+    
+    plan = it->second->plan;
+    return it->second;
+}
+
+std::string PluginChainManager::instanceSetKey(const ChainConfig& config,
+                                               const std::shared_ptr<PluginData>& input_data) {
+    std::string device_id = input_data ? input_data->getDeviceId() : "";
+    
+    // 分片模式下同一分片的设备共享实例集合
+    if (config.instance_shards > 0) {
+        return "#" + std::to_string(std::hash<std::string>{}(device_id) % config.instance_shards);
+    }
+    return device_id;
+}
+
+std::shared_ptr<PluginChainManager::ChainInstanceSet> PluginChainManager::acquireInstanceSet(
+    ChainRuntime& runtime,
+    const std::string& set_key) {
+    std::lock_guard<std::mutex> lock(runtime.instance_sets_mutex);
+    
+    auto& instance_set = runtime.instance_sets[set_key];
+    if (!instance_set) {
+        instance_set = runtime.initial_set ? std::move(runtime.initial_set)
+                                           : std::make_shared<ChainInstanceSet>();
+    }
+    instance_set->last_used = std::chrono::steady_clock::now();
+    
+    return instance_set;
+}
+
+bool PluginChainManager::refreshInstanceSet(ChainInstanceSet& instance_set,
+                                           const std::shared_ptr<const ExecutionPlan>& plan) {
+    auto& manager = PluginManager::getInstance();
+    
+    // 先记录注册版本号，刷新期间发生的替换会在下次执行时被刷新
+    uint64_t registry_generation = manager.getRegistryGeneration();
+    if (instance_set.plan == plan && instance_set.registry_generation == registry_generation) {
+        return true;
+    }
+    
+    const auto& config = *plan->config;
+    bool complete = true;
+    for (size_t i = 0; i < config.plugin_names.size(); ++i) {
+        const auto& plugin_name = config.plugin_names[i];
+        uint64_t generation = manager.getPluginGeneration(plugin_name);
+        
+        bool has_instance = instance_set.instances.find(plugin_name) != instance_set.instances.end();
+        auto gen_it = instance_set.generations.find(plugin_name);
+        if (has_instance && gen_it != instance_set.generations.end() && gen_it->second == generation) {
+            continue;
+        }
+        
+        std::shared_ptr<PluginParameter> params = (i < config.plugin_params.size()) 
+            ? config.plugin_params[i] : nullptr;
+        
+        // 新版本实例创建失败时保留旧实例继续服务
+        auto plugin = manager.createPlugin(plugin_name, params);
+        if (!plugin) {
+            complete = complete && has_instance;
+            continue;
+        }
+        
+        // 旧实例引用在此释放，所属旧库在所有实例释放后卸载
+        instance_set.instances[plugin_name] = plugin;
+        instance_set.generations[plugin_name] = generation;
+    }
+    
+    // 释放已移出链的插件实例
+    for (auto it = instance_set.instances.begin(); it != instance_set.instances.end();) {
+        if (std::find(config.plugin_names.begin(), config.plugin_names.end(), it->first) 
+            == config.plugin_names.end()) {
+            instance_set.generations.erase(it->first);
+            it = instance_set.instances.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    // 存在缺失实例时不记录版本号，下次执行时重试
+    if (!complete) {
+        return false;
+    }
+    
+    // 按节点下标解析插件实例，执行时不再按名称查找
+    const size_t node_count = config.plugin_names.size();
+    instance_set.node_plugins.resize(node_count);
+    instance_set.node_cache_seeds.resize(node_count);
+    instance_set.node_stage_keys.resize(node_count);
+    for (size_t i = 0; i < node_count; ++i) {
+        const auto& plugin_name = config.plugin_names[i];
+        instance_set.node_plugins[i] = instance_set.instances[plugin_name];
+        instance_set.node_stage_keys[i] = PluginMonitorManager::stageKey(config.chain_name, plugin_name);
+        instance_set.node_cache_seeds[i] = pluginCacheSeed(
+            *instance_set.node_plugins[i], plugin_name, instance_set.generations[plugin_name],
+            (i < config.plugin_params.size()) ? config.plugin_params[i] : nullptr);
+    }
+    
+    // 预分配DAG执行所需的缓冲区
+    if (plan->use_graph) {
+        instance_set.node_results.resize(node_count);
+        instance_set.join_inputs.resize(node_count);
+        instance_set.remaining_inputs.resize(node_count);
+        for (size_t i = 0; i < node_count; ++i) {
+            if (!instance_set.node_results[i]) {
+                instance_set.node_results[i] = std::make_shared<PluginResultImpl>();
+            }
+            if (!plan->graph.predecessors[i].empty() && !instance_set.join_inputs[i]) {
+                instance_set.join_inputs[i] = std::make_shared<FeatureData>("", std::chrono::system_clock::time_point());
+            }
+        }
+    }
+    
+    instance_set.plan = plan;
+    instance_set.registry_generation = registry_generation;
+    
+    return true;
+}
+
+bool PluginChainManager::executePluginInChain(IPlugin& plugin,
+                                             const std::shared_ptr<PluginData>& input_data,
+                                             const std::shared_ptr<PluginResult>& output_result) {
+    try {
+        return plugin.process(input_data, output_result);
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void PluginChainManager::executePluginBatchInChain(IPlugin& plugin,
+                                                  const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                                  const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                                  std::vector<bool>& succeeded) {
+    try {
+        plugin.processBatch(inputs, outputs, succeeded);
+    } catch (const std::exception&) {
+        succeeded.assign(inputs.size(), false);
+    }
+    
+    // 插件未按约定填写逐条结果时整组视为失败
+    if (succeeded.size() != inputs.size()) {
+        succeeded.assign(inputs.size(), false);
+    }
+}
+
+uint64_t PluginChainManager::pluginCacheSeed(const IPlugin& plugin,
+                                            const std::string& plugin_name,
+                                            uint64_t generation,
+                                            const std::shared_ptr<PluginParameter>& params) {
+    if (!plugin.isPure()) {
+        return 0;
+    }
+    
+    // 插件替换后注册版本号变化，旧版本的缓存结果不会再被命中
+    ContentHasher hasher;
+    hasher.update(plugin_name);
+    hasher.update(generation);
+    hasher.update(params ? params->serialize() : std::string());
+    uint64_t seed = hasher.digest();
+    return seed != 0 ? seed : 1;
+}
+
+bool PluginChainManager::executeNodeInChain(ChainInstanceSet& instance_set, size_t node,
+                                           const std::shared_ptr<PluginData>& input_data,
+                                           const std::shared_ptr<PluginResult>& output_result) {
+    TRACE_SPAN_LABEL("plugin", "plugin", instance_set.node_stage_keys[node]);
+    
+    PluginMonitorManager* monitor = monitor_.load(std::memory_order_acquire);
+    if (!monitor) {
+        return executeNodeCached(instance_set, node, input_data, output_result);
+    }
+    
+    // 节点账户挂在当前账户（如整次请求的账户）之下，节点内的分配同时计入两者
+    MemoryAccount memory_account(MemoryAccount::current());
+    bool success;
+    auto start = std::chrono::steady_clock::now();
+    {
+        MemoryAccountScope memory_scope(&memory_account);
+        success = executeNodeCached(instance_set, node, input_data, output_result);
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    monitor->recordStageExecution(instance_set.node_stage_keys[node], success, elapsed.count());
+    if (MemoryAccount::isAllocationTrackingEnabled()) {
+        monitor->recordStageMemoryUsage(instance_set.node_stage_keys[node], memory_account.getUsage());
+    }
+    return success;
+}
+
+void PluginChainManager::executeNodeBatchInChain(ChainInstanceSet& instance_set, size_t node,
+                                                const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                                const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                                std::vector<bool>& succeeded) {
+    TRACE_SPAN_LABEL("pluginBatch", "plugin", instance_set.node_stage_keys[node]);
+    
+    PluginMonitorManager* monitor = monitor_.load(std::memory_order_acquire);
+    if (!monitor || inputs.empty()) {
+        executeNodeBatchCached(instance_set, node, inputs, outputs, succeeded);
+        return;
+    }
+    
+    // 整组只计时一次，按数据条数均摊；内存统计整组记录一次
+    MemoryAccount memory_account(MemoryAccount::current());
+    auto start = std::chrono::steady_clock::now();
+    {
+        MemoryAccountScope memory_scope(&memory_account);
+        executeNodeBatchCached(instance_set, node, inputs, outputs, succeeded);
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    double per_item_ms = elapsed.count() / inputs.size();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        monitor->recordStageExecution(instance_set.node_stage_keys[node],
+                                      i < succeeded.size() && succeeded[i], per_item_ms);
+    }
+    if (MemoryAccount::isAllocationTrackingEnabled()) {
+        monitor->recordStageMemoryUsage(instance_set.node_stage_keys[node], memory_account.getUsage());
+    }
 }
 
-bool PluginChainManager::addPluginToChain(const std::string& chain_name, 
-                                          const std::string& plugin_name,
-                                          std::shared_ptr<PluginParameter> params) {
-    std::lock_guard<std::mutex> lock(mutex_);
+bool PluginChainManager::executeNodeCached(ChainInstanceSet& instance_set, size_t node,
+                                          const std::shared_ptr<PluginData>& input_data,
+                                          const std::shared_ptr<PluginResult>& output_result) {
+    IPlugin& plugin = *instance_set.node_plugins[node];
+    uint64_t seed = instance_set.node_cache_seeds[node];
+    uint64_t input_hash = 0;
+    if (seed == 0 || !result_cache_.isEnabled() || !input_data || !input_data->getContentHash(input_hash)) {
+        return executePluginInChain(plugin, input_data, output_result);
+    }
     
-    auto it = plugin_chains_.find(chain_name);
-    if (it == plugin_chains_.end()) {
-        return false;
+    ContentHasher key_hasher(seed);
+    key_hasher.update(input_hash);
+    uint64_t key = key_hasher.digest();
+    
+    if (auto cached = result_cache_.find(key)) {
+        cached->copyTo(*output_result);
+        return true;
     }
     
-    auto& manager = PluginManager::getInstance();
-    if (!manager.isPluginAvailable(plugin_name)) {
+    // 写入独立的结果对象后再合并，缓存中只保存本插件的结果
+    auto result = std::make_shared<PluginResultImpl>();
+    if (!executePluginInChain(plugin, input_data, result)) {
         return false;
     }
-    
-    it->second.plugin_names.push_back(plugin_name);
-    it->second.plugin_params.push_back(params);
-    
+    result->copyTo(*output_result);
+    result_cache_.insert(key, std::move(result));
     return true;
 }
 
-bool PluginChainManager::removePluginFromChain(const std::string& chain_name, 
-                                                const std::string& plugin_name) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = plugin_chains_.find(chain_name);
-    if (it == plugin_chains_.end()) {
-        return false;
+void PluginChainManager::executeNodeBatchCached(ChainInstanceSet& instance_set, size_t node,
+                                               const std::vector<std::shared_ptr<PluginData>>& inputs,
+                                               const std::vector<std::shared_ptr<PluginResult>>& outputs,
+                                               std::vector<bool>& succeeded) {
+    IPlugin& plugin = *instance_set.node_plugins[node];
+    uint64_t seed = instance_set.node_cache_seeds[node];
+    if (seed == 0 || !result_cache_.isEnabled()) {
+        executePluginBatchInChain(plugin, inputs, outputs, succeeded);
+        return;
     }
     
-    auto& config = it->second;
-    auto plugin_it = std::find(config.plugin_names.begin(), config.plugin_names.end(), plugin_name);
-    if (plugin_it != config.plugin_names.end()) {
-        size_t index = std::distance(config.plugin_names.begin(), plugin_it);
-        config.plugin_names.erase(plugin_it);
+    // 命中缓存的数据直接写入结果，其余数据成组交给插件计算
+    succeeded.assign(inputs.size(), false);
+    std::vector<size_t> pending;
+    std::vector<uint64_t> pending_keys;
+    std::vector<std::shared_ptr<PluginData>> pending_inputs;
+    std::vector<std::shared_ptr<PluginResult>> pending_outputs;
+    
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        uint64_t input_hash = 0;
+        if (!inputs[i] || !inputs[i]->getContentHash(input_hash)) {
+            pending.push_back(i);
+            pending_keys.push_back(0);
+            pending_inputs.push_back(inputs[i]);
+            pending_outputs.push_back(outputs[i]);
+            continue;
+        }
         
-        if (index < config.plugin_params.size()) {
-            config.plugin_params.erase(config.plugin_params.begin() + index);
+        ContentHasher key_hasher(seed);
+        key_hasher.update(input_hash);
+        uint64_t key = key_hasher.digest();
+        
+        if (auto cached = result_cache_.find(key)) {
+            cached->copyTo(*outputs[i]);
+            succeeded[i] = true;
+            continue;
         }
         
-        return true;
+        pending.push_back(i);
+        pending_keys.push_back(key);
+        pending_inputs.push_back(inputs[i]);
+        pending_outputs.push_back(std::make_shared<PluginResultImpl>());
     }
     
-    return false;
-}
-
-bool PluginChainManager::clearChain(const std::string& chain_name) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending.empty()) {
+        return;
+    }
     
-    auto it = plugin_chains_.find(chain_name);
-    if (it != plugin_chains_.end()) {
-        plugin_chains_.erase(it);
-        
-        // 清理插件实例
-        auto instance_it = plugin_instances_.find(chain_name);
-        if (instance_it != plugin_instances_.end()) {
-            plugin_instances_.erase(instance_it);
+    std::vector<bool> pending_succeeded;
+    executePluginBatchInChain(plugin, pending_inputs, pending_outputs, pending_succeeded);
+    
+    for (size_t k = 0; k < pending.size(); ++k) {
+        size_t index = pending[k];
+        succeeded[index] = pending_succeeded[k];
+        if (!pending_succeeded[k] || pending_outputs[k] == outputs[index]) {
+            continue;
         }
         
-        return true;
+        auto result = std::static_pointer_cast<PluginResultImpl>(pending_outputs[k]);
+        result->copyTo(*outputs[index]);
+        result_cache_.insert(pending_keys[k], std::move(result));
     }
-    
-    return false;
 }
 
-bool PluginChainManager::executeChain(const std::string& chain_name, 
-                                     std::shared_ptr<PluginData> input_data,
-                                     std::shared_ptr<PluginResult> output_result) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = plugin_chains_.find(chain_name);
-    if (it == plugin_chains_.end()) {
-        return false;
+std::shared_ptr<const PluginChainManager::ExecutionPlan> PluginChainManager::compileChain(
+    std::shared_ptr<const ChainConfig> config) {
+    auto plan = std::make_shared<ExecutionPlan>();
+    plan->config = std::move(config);
+    plan->use_graph = !plan->config->data_mappings.empty();
+    if (plan->use_graph) {
+        plan->valid = buildChainGraph(*plan->config, plan->graph);
     }
+    return plan;
+}
+
+bool PluginChainManager::buildChainGraph(const ChainConfig& config, ChainGraph& graph) {
+    const size_t node_count = config.plugin_names.size();
     
-    const auto& config = it->second;
-    auto current_data = input_data;
-    auto current_result = std::make_shared<PluginResultImpl>();
+    std::map<std::string, size_t> node_index;
+    for (size_t i = 0; i < node_count; ++i) {
+        node_index.emplace(config.plugin_names[i], i);
+    }
     
-    // 依次执行插件链中的每个插件
-    for (size_t i = 0; i < config.plugin_names.size(); ++i) {
-        const auto& plugin_name = config.plugin_names[i];
-        std::shared_ptr<PluginParameter> params = (i < config.plugin_params.size()) 
-            ? config.plugin_params[i] : nullptr;
+    graph.successors.assign(node_count, {});
+    graph.predecessors.assign(node_count, {});
+    graph.topo_order.clear();
+    graph.roots.clear();
+    graph.has_parallel_branches = false;
+    
+    // 解析"源插件->目标插件"映射
+    for (const auto& [mapping, data_keys] : config.data_mappings) {
+        auto arrow = mapping.find("->");
+        if (arrow == std::string::npos) {
+            continue;
+        }
         
-        if (!executePluginInChain(chain_name, plugin_name, current_data, current_result)) {
+        auto source_it = node_index.find(mapping.substr(0, arrow));
+        auto target_it = node_index.find(mapping.substr(arrow + 2));
+        if (source_it == node_index.end() || target_it == node_index.end() ||
+            source_it->second == target_it->second) {
             return false;
         }
         
-        // 准备下一个插件的输入数据
-        if (i < config.plugin_names.size() - 1) {
-            current_data = convertDataForPlugin(current_data, 
-                plugin_instances_[chain_name][plugin_name]);
+        ChainEdge edge{source_it->second, {}};
+        std::istringstream iss(data_keys);
+        std::string key;
+        while (std::getline(iss, key, ',')) {
+            key.erase(0, key.find_first_not_of(" \t"));
+            key.erase(key.find_last_not_of(" \t") + 1);
+            if (!key.empty() && key != "*") {
+                edge.keys.push_back(key);
+            }
         }
+        
+        graph.successors[source_it->second].push_back(target_it->second);
+        graph.predecessors[target_it->second].push_back(std::move(edge));
     }
     
-    // 复制最终结果到输出
-    *output_result = *current_result;
-    
-    return true;
-}
-
-std::vector<std::string> PluginChainManager::getAvailableChains() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    std::vector<std::string> chains;
-    for (const auto& [name, config] : plugin_chains_) {
-        chains.push_back(name);
+    // 拓扑排序，同层节点保持配置顺序
+    std::vector<size_t> in_degree(node_count);
+    std::queue<size_t> ready;
+    for (size_t i = 0; i < node_count; ++i) {
+        in_degree[i] = graph.predecessors[i].size();
+        if (in_degree[i] == 0) {
+            ready.push(i);
+            graph.roots.push_back(i);
+        }
+        if (graph.successors[i].size() > 1) {
+            graph.has_parallel_branches = true;
+        }
     }
+    graph.has_parallel_branches = graph.has_parallel_branches || graph.roots.size() > 1;
     
-    return chains;
-}
-
-std::vector<std::string> PluginChainManager::getChainPlugins(const std::string& chain_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = plugin_chains_.find(chain_name);
-    if (it != plugin_chains_.end()) {
-        return it->second.plugin_names;
+    while (!ready.empty()) {
+        size_t node = ready.front();
+        ready.pop();
+        graph.topo_order.push_back(node);
+        
+        for (size_t successor : graph.successors[node]) {
+            if (--in_degree[successor] == 0) {
+                ready.push(successor);
+            }
+        }
     }
     
-    return {};
-}
-
-bool PluginChainManager::isChainAvailable(const std::string& chain_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return plugin_chains_.find(chain_name) != plugin_chains_.end();
+    // 存在环路
+    return graph.topo_order.size() == node_count;
 }
 
-bool PluginChainManager::setDataMapping(const std::string& chain_name,
-                                       const std::string& source_plugin,
-                                       const std::string& target_plugin,
-                                       const std::string& data_key) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = plugin_chains_.find(chain_name);
-    if (it == plugin_chains_.end()) {
-        return false;
+bool PluginChainManager::executeChainGraph(const ExecutionPlan& plan,
+                                          ChainInstanceSet& instance_set,
+                                          const std::shared_ptr<PluginData>& input_data,
+                                          const std::shared_ptr<PluginResult>& output_result) {
+    const auto& graph = plan.graph;
+    const size_t node_count = graph.predecessors.size();
+    
+    // 每个节点写入独立的结果缓冲区，汇合节点从中读取输入
+    auto& node_results = instance_set.node_results;
+    auto& remaining_inputs = instance_set.remaining_inputs;
+    for (size_t i = 0; i < node_count; ++i) {
+        node_results[i]->clear();
+        remaining_inputs[i] = graph.predecessors[i].size();
     }
     
-    std::string mapping_key = source_plugin + "->" + target_plugin;
-    it->second.data_mappings[mapping_key] = data_key;
-    
-    return true;
-}
-
-bool PluginChainManager::initializeChainPlugins(const std::string& chain_name) {
-    auto it = plugin_chains_.find(chain_name);
-    if (it == plugin_chains_.end()) {
-        return false;
+    // 执行状态，节点任务在共享调度器上执行，当前线程等待期间协助执行
+    const TraceContext trace_context = TRACE_CURRENT_CONTEXT();
+    MemoryAccount* const memory_account = MemoryAccount::current();
+    std::mutex state_mutex;
+    size_t completed = 0;
+    bool failed = false;
+    std::optional<TaskGroup> node_group;
+    if (graph.has_parallel_branches) {
+        node_group.emplace(TaskScheduler::getInstance(), TaskPriority::HIGH);
     }
     
-    const auto& config = it->second;
-    auto& manager = PluginManager::getInstance();
+    // 执行节点后由当前线程继续执行一个新就绪的后继节点，其余后继提交到调度器
+    auto run_node = [&](auto& self, size_t node) -> void {
+        while (true) {
+            std::shared_ptr<PluginData> node_input = input_data;
+            if (!graph.predecessors[node].empty()) {
+                auto& join_input = instance_set.join_inputs[node];
+                buildJoinInput(*join_input, input_data, graph.predecessors[node], node_results);
+                node_input = join_input;
+            }
+            bool success = executeNodeInChain(instance_set, node, node_input, node_results[node]);
+            
+            std::lock_guard<std::mutex> lock(state_mutex);
+            size_t next_node = node_count;
+            
+            if (!success) {
+                failed = true;
+            } else {
+                ++completed;
+            }
+            
+            if (!failed) {
+                for (size_t successor : graph.successors[node]) {
+                    if (--remaining_inputs[successor] != 0) {
+                        continue;
+                    }
+                    if (next_node == node_count) {
+                        next_node = successor;
+                    } else {
+                        node_group->run([&self, &trace_context, memory_account, successor] {
+                            TRACE_CONTEXT_SCOPE(trace_context);
+                            MemoryAccountScope memory_scope(memory_account);
+                            self(self, successor);
+                        });
+                    }
+                }
+            }
+            
+            if (next_node == node_count) {
+                return;
+            }
+            node = next_node;
+        }
+    };
+    
+    for (size_t i = 1; i < graph.roots.size(); ++i) {
+        size_t root = graph.roots[i];
+        node_group->run([&run_node, &trace_context, memory_account, root] {
+            TRACE_CONTEXT_SCOPE(trace_context);
+            MemoryAccountScope memory_scope(memory_account);
+            run_node(run_node, root);
+        });
+    }
+    if (!graph.roots.empty()) {
+        run_node(run_node, graph.roots.front());
+    }
     
-    // 创建插件实例
-    for (size_t i = 0; i < config.plugin_names.size(); ++i) {
-        const auto& plugin_name = config.plugin_names[i];
-        std::shared_ptr<PluginParameter> params = (i < config.plugin_params.size()) 
-            ? config.plugin_params[i] : nullptr;
-        
-        auto plugin = manager.createPlugin(plugin_name, params);
-        if (!plugin) {
+    // 等待所有已调度节点结束，之后才能释放执行状态
+    if (node_group) {
+        node_group->wait();
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (failed || completed != node_count) {
             return false;
         }
-        
-        plugin_instances_[chain_name][plugin_name] = plugin;
+    }
+    
+    // 按拓扑顺序合并各节点结果，下游节点的同名结果覆盖上游
+    for (size_t node : graph.topo_order) {
+        node_results[node]->copyTo(*output_result);
     }
     
     return true;
 }
 
-bool PluginChainManager::executePluginInChain(const std::string& chain_name,
-                                             const std::string& plugin_name,
-                                             std::shared_ptr<PluginData> input_data,
-                                             std::shared_ptr<PluginResult> output_result) {
-    auto instance_it = plugin_instances_.find(chain_name);
-    if (instance_it == plugin_instances_.end()) {
-        return false;
+void PluginChainManager::buildJoinInput(FeatureData& join_input,
+                                       const std::shared_ptr<PluginData>& chain_input,
+                                       const std::vector<ChainEdge>& predecessors,
+                                       const std::vector<std::shared_ptr<PluginResultImpl>>& node_results) {
+    if (chain_input) {
+        join_input.reset(chain_input->getDeviceId(), chain_input->getTimestamp());
+    } else {
+        join_input.reset("", std::chrono::system_clock::now());
     }
     
-    auto plugin_it = instance_it->second.find(plugin_name);
-    if (plugin_it == instance_it->second.end()) {
-        return false;
+    for (const auto& edge : predecessors) {
+        const auto& double_data = node_results[edge.source]->getAllDoubleData();
+        const auto& int_data = node_results[edge.source]->getAllIntData();
+        
+        if (edge.keys.empty()) {
+            for (const auto& [key, value] : double_data) {
+                join_input.setFeature(key, value);
+            }
+            for (const auto& [key, value] : int_data) {
+                join_input.setFeature(key, static_cast<double>(value));
+            }
+            continue;
+        }
+        
+        for (const auto& key : edge.keys) {
+            auto double_it = double_data.find(key);
+            if (double_it != double_data.end()) {
+                join_input.setFeature(key, double_it->second);
+                continue;
+            }
+            auto int_it = int_data.find(key);
+            if (int_it != int_data.end()) {
+                join_input.setFeature(key, static_cast<double>(int_it->second));
+            }
+        }
     }
-    
-    auto plugin = plugin_it->second;
-    return plugin->process(input_data, output_result);
-}
-
-std::shared_ptr<PluginData> PluginChainManager::convertDataForPlugin(std::shared_ptr<PluginData> input_data,
-                                                                    std::shared_ptr<IPlugin> target_plugin) {
-    // 简化的数据转换实现
-    // 生产环境应实现更复杂的数据转换逻辑
-    return input_data;
-}
-
-std::shared_ptr<PluginResult> PluginChainManager::convertResultForPlugin(std::shared_ptr<PluginResult> input_result,
-                                                                         std::shared_ptr<IPlugin> source_plugin) {
-    // 简化的结果转换实现
-    // 生产环境应实现更复杂的结果转换逻辑
-    return input_result;
 }
 
 // PluginConfigManager实现
@@ -689,87 +1762,433 @@ std::map<std::string, std::string> PluginConfigManager::getAllGlobalConfigs() co
 }
 
 // PluginMonitorManager实现
-PluginMonitorManager::PluginMonitorManager() = default;
+namespace {
+
+// 管理器编号，区分同一线程中不同管理器的分片缓存
+std::atomic<uint64_t> next_monitor_instance_id{1};
+
+// 存活的管理器，线程退出时据此归还分片。有意不析构：其他线程可能在静态对象析构后才退出
+struct LiveMonitors {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, PluginMonitorManager*> monitors;
+};
 
-PluginMonitorManager::~PluginMonitorManager() = default;
+LiveMonitors& liveMonitors() {
+    static LiveMonitors* live = new LiveMonitors();
+    return *live;
+}
+
+uint64_t toNanoseconds(double milliseconds) {
+    return milliseconds > 0.0 ? static_cast<uint64_t>(std::llround(milliseconds * 1e6)) : 0;
+}
+
+double toMilliseconds(uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1e6;
+}
+
+} // namespace
+
+// 线程本地的插件名到分片的映射，只由所属线程访问
+struct PluginMonitorManager::ThreadCache {
+    uint64_t entries_version = 0;
+    std::unordered_map<std::string, MetricsShard*> shards;
+    std::unordered_map<std::string, MetricsShard*> stage_shards;
+};
+
+// 线程的全部分片缓存，线程退出时把分片交还给仍存活的管理器
+struct PluginMonitorManager::ThreadCacheSet {
+    std::unordered_map<uint64_t, ThreadCache> caches;
+    
+    ~ThreadCacheSet() {
+        // 持有登记表锁期间管理器不会析构
+        LiveMonitors& live = liveMonitors();
+        std::lock_guard<std::mutex> lock(live.mutex);
+        for (const auto& [instance_id, cache] : caches) {
+            auto it = live.monitors.find(instance_id);
+            if (it != live.monitors.end()) {
+                it->second->releaseThreadCache(cache);
+            }
+        }
+    }
+};
+
+PluginMonitorManager::PluginMonitorManager() : instance_id_(next_monitor_instance_id++) {
+    LiveMonitors& live = liveMonitors();
+    std::lock_guard<std::mutex> lock(live.mutex);
+    live.monitors[instance_id_] = this;
+}
+
+PluginMonitorManager::~PluginMonitorManager() {
+    LiveMonitors& live = liveMonitors();
+    std::lock_guard<std::mutex> lock(live.mutex);
+    live.monitors.erase(instance_id_);
+}
 
 void PluginMonitorManager::startMonitoring(const std::string& plugin_name) {
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (monitoring_enabled_) {
-        monitored_plugins_.insert(plugin_name);
-        
-        // 初始化监控数据
-        if (plugin_metrics_.find(plugin_name) == plugin_metrics_.end()) {
-            PluginMetrics metrics;
-            metrics.plugin_name = plugin_name;
-            plugin_metrics_[plugin_name] = metrics;
+        auto& entry = plugins_[plugin_name];
+        if (!entry) {
+            entry = std::make_unique<PluginEntry>();
+            entry->plugin_name = plugin_name;
+            entries_version_++;
         }
+        entry->monitored = true;
     }
 }
 
 void PluginMonitorManager::stopMonitoring(const std::string& plugin_name) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    monitored_plugins_.erase(plugin_name);
+    auto it = plugins_.find(plugin_name);
+    if (it != plugins_.end()) {
+        it->second->monitored = false;
+    }
+}
+
+PluginMonitorManager::MetricsShard* PluginMonitorManager::findShard(const std::string& key, bool stage) {
+    // 已退出管理器的缓存条目不会再被访问，编号不复用
+    thread_local ThreadCacheSet cache_set;
+    auto& cache = cache_set.caches[instance_id_];
+    
+    uint64_t version = entries_version_.load(std::memory_order_acquire);
+    if (cache.entries_version != version) {
+        // 新增的监控条目可能对应此前缓存为未监控的插件
+        for (auto it = cache.shards.begin(); it != cache.shards.end();) {
+            it = it->second ? std::next(it) : cache.shards.erase(it);
+        }
+        cache.entries_version = version;
+    }
+    
+    auto& shards = stage ? cache.stage_shards : cache.shards;
+    auto cached = shards.find(key);
+    if (cached != shards.end()) {
+        return cached->second;
+    }
+    
+    // 每个线程对每个插件只在首次记录时加锁创建分片
+    std::lock_guard<std::mutex> lock(mutex_);
+    PluginEntry* entry = nullptr;
+    if (stage) {
+        auto& stage_entry = stages_[key];
+        if (!stage_entry) {
+            stage_entry = std::make_unique<PluginEntry>();
+            stage_entry->plugin_name = key.substr(key.rfind('/') + 1);
+            stage_entry->monitored = true;
+        }
+        entry = stage_entry.get();
+    } else {
+        auto it = plugins_.find(key);
+        if (it != plugins_.end()) {
+            entry = it->second.get();
+        }
+    }
+    
+    MetricsShard* shard = nullptr;
+    if (entry) {
+        entry->shards.push_back(std::make_shared<MetricsShard>());
+        shard = entry->shards.back().get();
+        shard->entry = entry;
+    }
+    shards.emplace(key, shard);
+    return shard;
 }
 
 void PluginMonitorManager::recordExecution(const std::string& plugin_name, 
                                           bool success, 
                                           double execution_time_ms,
                                           const std::string& error_message) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (!monitoring_enabled_.load(std::memory_order_relaxed)) {
+        return;
+    }
     
-    if (!monitoring_enabled_ || monitored_plugins_.find(plugin_name) == monitored_plugins_.end()) {
+    MetricsShard* shard = findShard(plugin_name, false);
+    if (!shard || !shard->entry->monitored.load(std::memory_order_relaxed)) {
         return;
     }
     
-    auto it = plugin_metrics_.find(plugin_name);
-    if (it == plugin_metrics_.end()) {
-        PluginMetrics metrics;
-        metrics.plugin_name = plugin_name;
-        plugin_metrics_[plugin_name] = metrics;
-        it = plugin_metrics_.find(plugin_name);
+    recordToShard(*shard, success, execution_time_ms, &error_message);
+}
+
+std::string PluginMonitorManager::stageKey(const std::string& chain_name, const std::string& plugin_name) {
+    // 链名中的'/'不影响解析，插件名取最后一个'/'之后的部分
+    return chain_name + "/" + plugin_name;
+}
+
+void PluginMonitorManager::recordStageExecution(const std::string& stage_key, bool success, double execution_time_ms) {
+    if (!monitoring_enabled_.load(std::memory_order_relaxed)) {
+        return;
     }
     
-    auto& metrics = it->second;
-    metrics.execution_count++;
+    if (MetricsShard* shard = findShard(stage_key, true)) {
+        recordToShard(*shard, success, execution_time_ms, nullptr);
+    }
+}
+
+void PluginMonitorManager::recordToShard(MetricsShard& shard, bool success, double execution_time_ms,
+                                         const std::string* error_message) {
+    // 分片只由当前线程写入，计数无需读-改-写原子操作
+    auto increment = [](std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    };
     
+    increment(shard.execution_count);
     if (success) {
-        metrics.success_count++;
+        increment(shard.success_count);
     } else {
-        metrics.error_count++;
-        metrics.last_error_message = error_message;
+        increment(shard.error_count);
+        if (error_message) {
+            std::lock_guard<std::mutex> lock(shard.entry->error_mutex);
+            shard.entry->last_error_message = *error_message;
+        }
     }
     
     // 更新执行时间统计
-    if (metrics.min_execution_time_ms == 0.0 || execution_time_ms < metrics.min_execution_time_ms) {
-        metrics.min_execution_time_ms = execution_time_ms;
+    uint64_t time_ns = toNanoseconds(execution_time_ms);
+    shard.total_time_ns.store(shard.total_time_ns.load(std::memory_order_relaxed) + time_ns,
+                              std::memory_order_relaxed);
+    if (time_ns < shard.min_time_ns.load(std::memory_order_relaxed)) {
+        shard.min_time_ns.store(time_ns, std::memory_order_relaxed);
+    }
+    if (time_ns > shard.max_time_ns.load(std::memory_order_relaxed)) {
+        shard.max_time_ns.store(time_ns, std::memory_order_relaxed);
+    }
+    shard.latency.record(time_ns);
+    
+    shard.last_execution_ns.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count(),
+        std::memory_order_relaxed);
+}
+
+void PluginMonitorManager::recordMemoryUsage(const std::string& plugin_name, const MemoryUsage& usage) {
+    if (!monitoring_enabled_.load(std::memory_order_relaxed)) {
+        return;
     }
     
-    if (execution_time_ms > metrics.max_execution_time_ms) {
-        metrics.max_execution_time_ms = execution_time_ms;
+    MetricsShard* shard = findShard(plugin_name, false);
+    if (!shard || !shard->entry->monitored.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    recordMemoryToShard(*shard, usage);
+}
+
+void PluginMonitorManager::recordStageMemoryUsage(const std::string& stage_key, const MemoryUsage& usage) {
+    if (!monitoring_enabled_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    if (MetricsShard* shard = findShard(stage_key, true)) {
+        recordMemoryToShard(*shard, usage);
+    }
+}
+
+void PluginMonitorManager::recordMemoryToShard(MetricsShard& shard, const MemoryUsage& usage) {
+    // 分片只由当前线程写入
+    auto add = [](auto& counter, auto value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    };
+    
+    add(shard.memory_samples, uint64_t(1));
+    add(shard.bytes_allocated, usage.bytes_allocated);
+    add(shard.allocation_count, usage.allocation_count);
+    add(shard.retained_bytes, usage.retainedBytes());
+    if (usage.peak_live_bytes > shard.peak_memory_bytes.load(std::memory_order_relaxed)) {
+        shard.peak_memory_bytes.store(usage.peak_live_bytes, std::memory_order_relaxed);
+    }
+}
+
+void PluginMonitorManager::releaseThreadCache(const ThreadCache& cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    for (const auto* shards : {&cache.shards, &cache.stage_shards}) {
+        for (const auto& [key, shard] : *shards) {
+            if (!shard) {
+                continue;
+            }
+            PluginEntry& entry = *shard->entry;
+            
+            // 归并到新分片后替换，正在合并旧分片的查询看到的仍是一致的集合
+            auto retired = std::make_shared<MetricsShard>();
+            retired->entry = &entry;
+            if (entry.retired) {
+                foldShard(*retired, *entry.retired);
+            }
+            foldShard(*retired, *shard);
+            
+            auto& entry_shards = entry.shards;
+            entry_shards.erase(std::remove_if(entry_shards.begin(), entry_shards.end(),
+                                              [&](const std::shared_ptr<MetricsShard>& candidate) {
+                                                  return candidate.get() == shard ||
+                                                         candidate.get() == entry.retired;
+                                              }),
+                               entry_shards.end());
+            entry.retired = retired.get();
+            entry_shards.push_back(std::move(retired));
+        }
+    }
+}
+
+void PluginMonitorManager::foldShard(MetricsShard& into, const MetricsShard& from) {
+    auto add = [](auto& target, const auto& source) {
+        target.store(target.load(std::memory_order_relaxed) + source.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
+    };
+    auto keepMax = [](auto& target, const auto& source) {
+        target.store(std::max(target.load(std::memory_order_relaxed), source.load(std::memory_order_relaxed)),
+                     std::memory_order_relaxed);
+    };
+    add(into.execution_count, from.execution_count);
+    add(into.success_count, from.success_count);
+    add(into.error_count, from.error_count);
+    add(into.total_time_ns, from.total_time_ns);
+    into.min_time_ns.store(std::min(into.min_time_ns.load(std::memory_order_relaxed),
+                                    from.min_time_ns.load(std::memory_order_relaxed)),
+                           std::memory_order_relaxed);
+    keepMax(into.max_time_ns, from.max_time_ns);
+    keepMax(into.last_execution_ns, from.last_execution_ns);
+    add(into.memory_samples, from.memory_samples);
+    add(into.bytes_allocated, from.bytes_allocated);
+    add(into.allocation_count, from.allocation_count);
+    keepMax(into.peak_memory_bytes, from.peak_memory_bytes);
+    add(into.retained_bytes, from.retained_bytes);
+    into.latency.merge(from.latency);
+}
+
+PluginMonitorManager::PluginMetrics PluginMonitorManager::mergeShards(const PluginEntry& entry,
+                                                                     const std::vector<std::shared_ptr<MetricsShard>>& shards,
+                                                                     LatencyHistogram& latency) {
+    PluginMetrics metrics;
+    metrics.plugin_name = entry.plugin_name;
+    
+    latency.reset();
+    uint64_t total_time_ns = 0;
+    uint64_t min_time_ns = UINT64_MAX;
+    uint64_t max_time_ns = 0;
+    int64_t last_execution_ns = 0;
+    for (const auto& shard : shards) {
+        metrics.execution_count += shard->execution_count.load(std::memory_order_relaxed);
+        metrics.success_count += shard->success_count.load(std::memory_order_relaxed);
+        metrics.error_count += shard->error_count.load(std::memory_order_relaxed);
+        total_time_ns += shard->total_time_ns.load(std::memory_order_relaxed);
+        min_time_ns = std::min(min_time_ns, shard->min_time_ns.load(std::memory_order_relaxed));
+        max_time_ns = std::max(max_time_ns, shard->max_time_ns.load(std::memory_order_relaxed));
+        last_execution_ns = std::max(last_execution_ns, shard->last_execution_ns.load(std::memory_order_relaxed));
+        latency.merge(shard->latency);
+        
+        metrics.memory_samples += shard->memory_samples.load(std::memory_order_relaxed);
+        metrics.bytes_allocated += shard->bytes_allocated.load(std::memory_order_relaxed);
+        metrics.allocation_count += shard->allocation_count.load(std::memory_order_relaxed);
+        metrics.retained_bytes += shard->retained_bytes.load(std::memory_order_relaxed);
+        metrics.peak_memory_bytes = std::max(metrics.peak_memory_bytes,
+                                             shard->peak_memory_bytes.load(std::memory_order_relaxed));
+    }
+    
+    if (metrics.execution_count > 0) {
+        metrics.avg_execution_time_ms = toMilliseconds(total_time_ns) / metrics.execution_count;
+        metrics.min_execution_time_ms = toMilliseconds(min_time_ns);
+        metrics.max_execution_time_ms = toMilliseconds(max_time_ns);
+        
+        // 分位数取桶上界，不超过实际最大值
+        auto percentile = [&](double quantile) {
+            return toMilliseconds(std::min(latency.getPercentile(quantile), max_time_ns));
+        };
+        metrics.p50_execution_time_ms = percentile(0.5);
+        metrics.p90_execution_time_ms = percentile(0.9);
+        metrics.p99_execution_time_ms = percentile(0.99);
+        metrics.p999_execution_time_ms = percentile(0.999);
+        metrics.last_execution_time = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(last_execution_ns)));
     }
     
-    // 更新平均执行时间
-    metrics.avg_execution_time_ms = (metrics.avg_execution_time_ms * (metrics.execution_count - 1) + execution_time_ms) / metrics.execution_count;
+    {
+        std::lock_guard<std::mutex> lock(entry.error_mutex);
+        metrics.last_error_message = entry.last_error_message;
+    }
     
-    metrics.last_execution_time = std::chrono::system_clock::now();
+    return metrics;
 }
 
 PluginMonitorManager::PluginMetrics PluginMonitorManager::getPluginMetrics(const std::string& plugin_name) const {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = plugin_metrics_.find(plugin_name);
-    return (it != plugin_metrics_.end()) ? it->second : PluginMetrics();
+    LatencyHistogram latency;
+    auto it = plugins_.find(plugin_name);
+    return (it != plugins_.end()) ? mergeShards(*it->second, it->second->shards, latency) : PluginMetrics();
+}
+
+PluginMonitorManager::PluginMetrics PluginMonitorManager::getStageMetrics(const std::string& chain_name,
+                                                                         const std::string& plugin_name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    LatencyHistogram latency;
+    auto it = stages_.find(stageKey(chain_name, plugin_name));
+    return (it != stages_.end()) ? mergeShards(*it->second, it->second->shards, latency) : PluginMetrics();
+}
+
+void PluginMonitorManager::snapshotMetrics(const std::vector<uint64_t>& latency_bounds,
+                                           std::vector<MetricsSnapshot>& plugins,
+                                           std::vector<MetricsSnapshot>& stages) const {
+    struct PendingEntry {
+        const PluginEntry* entry;
+        std::string chain_name;
+        std::vector<std::shared_ptr<MetricsShard>> shards;
+    };
+    
+    // 条目创建后不删除，持锁只复制分片指针，复制的分片在线程退出归并后仍然有效
+    std::vector<PendingEntry> pending_plugins;
+    std::vector<PendingEntry> pending_stages;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        auto collect = [](const PluginEntry& entry, std::string chain_name) {
+            return PendingEntry{&entry, std::move(chain_name), entry.shards};
+        };
+        
+        pending_plugins.reserve(plugins_.size());
+        for (const auto& [plugin_name, entry] : plugins_) {
+            pending_plugins.push_back(collect(*entry, std::string()));
+        }
+        pending_stages.reserve(stages_.size());
+        for (const auto& [key, entry] : stages_) {
+            pending_stages.push_back(collect(*entry, key.substr(0, key.size() - entry->plugin_name.size() - 1)));
+        }
+    }
+    
+    LatencyHistogram latency;
+    auto merge = [&](std::vector<PendingEntry>& pending, std::vector<MetricsSnapshot>& snapshots) {
+        snapshots.clear();
+        snapshots.reserve(pending.size());
+        for (auto& item : pending) {
+            MetricsSnapshot snapshot;
+            snapshot.chain_name = std::move(item.chain_name);
+            snapshot.metrics = mergeShards(*item.entry, item.shards, latency);
+            latency.getCumulativeCounts(latency_bounds, snapshot.latency_counts);
+            snapshots.push_back(std::move(snapshot));
+        }
+    };
+    merge(pending_plugins, plugins);
+    merge(pending_stages, stages);
+}
+
+size_t PluginMonitorManager::getShardCount(const std::string& plugin_name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto it = plugins_.find(plugin_name);
+    return (it != plugins_.end()) ? it->second->shards.size() : 0;
 }
 
 std::vector<std::string> PluginMonitorManager::getMonitoredPlugins() const {
     std::lock_guard<std::mutex> lock(mutex_);
     
     std::vector<std::string> plugins;
-    for (const auto& plugin_name : monitored_plugins_) {
-        plugins.push_back(plugin_name);
+    for (const auto& [plugin_name, entry] : plugins_) {
+        if (entry->monitored) {
+            plugins.push_back(plugin_name);
+        }
     }
     
     return plugins;
@@ -777,22 +2196,24 @@ std::vector<std::string> PluginMonitorManager::getMonitoredPlugins() const {
 
 std::map<std::string, PluginMonitorManager::PluginMetrics> PluginMonitorManager::getAllMetrics() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return plugin_metrics_;
+    
+    LatencyHistogram latency;
+    std::map<std::string, PluginMetrics> metrics;
+    for (const auto& [plugin_name, entry] : plugins_) {
+        metrics[plugin_name] = mergeShards(*entry, entry->shards, latency);
+    }
+    
+    return metrics;
 }
 
 double PluginMonitorManager::getAverageExecutionTime(const std::string& plugin_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = plugin_metrics_.find(plugin_name);
-    return (it != plugin_metrics_.end()) ? it->second.avg_execution_time_ms : 0.0;
+    return getPluginMetrics(plugin_name).avg_execution_time_ms;
 }
 
 double PluginMonitorManager::getSuccessRate(const std::string& plugin_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = plugin_metrics_.find(plugin_name);
-    if (it != plugin_metrics_.end() && it->second.execution_count > 0) {
-        return static_cast<double>(it->second.success_count) / it->second.execution_count;
+    auto metrics = getPluginMetrics(plugin_name);
+    if (metrics.execution_count > 0) {
+        return static_cast<double>(metrics.success_count) / metrics.execution_count;
     }
     
     return 0.0;
@@ -801,8 +2222,31 @@ double PluginMonitorManager::getSuccessRate(const std::string& plugin_name) cons
 uint64_t PluginMonitorManager::getExecutionCount(const std::string& plugin_name) const {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = plugin_metrics_.find(plugin_name);
-    return (it != plugin_metrics_.end()) ? it->second.execution_count : 0;
+    uint64_t count = 0;
+    auto it = plugins_.find(plugin_name);
+    if (it != plugins_.end()) {
+        for (const auto& shard : it->second->shards) {
+            count += shard->execution_count.load(std::memory_order_relaxed);
+        }
+    }
+    return count;
+}
+
+LatencyHistogram PluginMonitorManager::getLatencyHistogram(const std::string& plugin_name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    LatencyHistogram latency;
+    auto it = plugins_.find(plugin_name);
+    if (it != plugins_.end()) {
+        for (const auto& shard : it->second->shards) {
+            latency.merge(shard->latency);
+        }
+    }
+    return latency;
+}
+
+double PluginMonitorManager::getExecutionTimePercentile(const std::string& plugin_name, double quantile) const {
+    return toMilliseconds(getLatencyHistogram(plugin_name).getPercentile(quantile));
 }
 
 } // namespace AlgorithmPlugins
@@ -0,0 +1,80 @@
+#include "result_cache.h"
+
+namespace AlgorithmPlugins {
+
+ResultCache::ResultCache(size_t capacity) : capacity_(capacity) {
+}
+
+std::shared_ptr<const PluginResultImpl> ResultCache::find(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        misses_++;
+        return nullptr;
+    }
+
+    entries_.splice(entries_.begin(), entries_, it->second);
+    hits_++;
+    return it->second->second;
+}
+
+void ResultCache::insert(uint64_t key, std::shared_ptr<const PluginResultImpl> result) {
+    size_t capacity = capacity_.load();
+    if (capacity == 0 || !result) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 并发执行的相同数据可能先后插入，保留后插入的结果
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->second = std::move(result);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    entries_.emplace_front(key, std::move(result));
+    index_[key] = entries_.begin();
+    evictLocked(capacity);
+}
+
+void ResultCache::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evictLocked(capacity);
+}
+
+size_t ResultCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
+
+double ResultCache::getHitRate() const {
+    uint64_t hits = hits_.load();
+    uint64_t total = hits + misses_.load();
+    return total > 0 ? static_cast<double>(hits) / total : 0.0;
+}
+
+void ResultCache::resetStatistics() {
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+void ResultCache::evictLocked(size_t capacity) {
+    while (entries_.size() > capacity) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+        evictions_++;
+    }
+}
+
+} // namespace AlgorithmPlugins
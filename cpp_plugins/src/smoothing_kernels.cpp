@@ -0,0 +1,168 @@
+#include "smoothing_kernels.h"
+#include "streaming_statistics.h"
+#include <cstdlib>
+
+namespace AlgorithmPlugins {
+
+SmoothingSpec SmoothingSpec::parse(const std::map<std::string, std::string>& params) {
+    SmoothingSpec spec;
+    auto func_it = params.find("func");
+    if (func_it == params.end()) {
+        return spec;
+    }
+
+    const std::string& func = func_it->second;
+    if (func == "mean") {
+        spec.function = SmoothingFunction::MEAN;
+    } else if (func == "min") {
+        spec.function = SmoothingFunction::MIN;
+    } else if (func == "max") {
+        spec.function = SmoothingFunction::MAX;
+    } else if (func == "median") {
+        spec.function = SmoothingFunction::MEDIAN;
+    } else if (func == "ewma") {
+        spec.function = SmoothingFunction::EWMA;
+    }
+
+    auto win_length_it = params.find("win_length");
+    if (win_length_it != params.end()) {
+        spec.win_length = std::atoi(win_length_it->second.c_str());
+    }
+
+    auto alpha_it = params.find("alpha");
+    if (alpha_it != params.end()) {
+        spec.alpha = std::atof(alpha_it->second.c_str());
+    } else if (spec.win_length > 0) {
+        spec.alpha = 2.0 / (spec.win_length + 1);
+    }
+
+    // 窗口类函数需要win_length，ewma需要有效的平滑系数
+    if (spec.function == SmoothingFunction::EWMA) {
+        if (spec.alpha <= 0.0 || spec.alpha > 1.0) {
+            spec.function = SmoothingFunction::NONE;
+        }
+    } else if (win_length_it == params.end()) {
+        spec.function = SmoothingFunction::NONE;
+    }
+    return spec;
+}
+
+bool SmoothingSpec::enabled() const {
+    switch (function) {
+        case SmoothingFunction::NONE:
+            return false;
+        case SmoothingFunction::EWMA:
+            return alpha < 1.0;
+        default:
+            return win_length > 1;
+    }
+}
+
+void SmoothingKernel::apply(const SmoothingSpec& spec, const std::vector<double>& input,
+                            std::vector<double>& output) {
+    // 输入输出为同一数组时先保留原始数据，各核按原始数据计算窗口
+    std::vector<double> aliased;
+    const std::vector<double>* source = &input;
+    if (&input == &output) {
+        aliased = input;
+        source = &aliased;
+    } else {
+        output.assign(input.begin(), input.end());
+    }
+
+    if (!spec.enabled()) {
+        return;
+    }
+    if (spec.function == SmoothingFunction::EWMA) {
+        ewma(*source, spec.alpha, output);
+        return;
+    }
+    if (spec.win_length >= static_cast<int>(source->size())) {
+        return;
+    }
+
+    const size_t half = static_cast<size_t>(spec.win_length) / 2;
+    switch (spec.function) {
+        case SmoothingFunction::MEAN:
+            slidingMean(*source, half, output);
+            break;
+        case SmoothingFunction::MIN:
+            slidingExtremum(*source, half, false, output);
+            break;
+        case SmoothingFunction::MAX:
+            slidingExtremum(*source, half, true, output);
+            break;
+        case SmoothingFunction::MEDIAN:
+            slidingMedian(*source, half, output);
+            break;
+        default:
+            break;
+    }
+}
+
+void SmoothingKernel::slidingMean(const std::vector<double>& input, size_t half, std::vector<double>& output) {
+    const size_t width = 2 * half + 1;
+    double sum = 0.0;
+    for (size_t j = 0; j < width; ++j) {
+        sum += input[j];
+    }
+    output[half] = sum / width;
+    for (size_t i = half + 1; i + half < input.size(); ++i) {
+        sum += input[i + half] - input[i - half - 1];
+        output[i] = sum / width;
+    }
+}
+
+void SmoothingKernel::slidingExtremum(const std::vector<double>& input, size_t half, bool maximum,
+                                      std::vector<double>& output) {
+    // 单调队列保存下标，每个下标至多入队出队各一次；队列存储一次分配
+    std::vector<size_t> queue(input.size());
+    size_t head = 0;
+    size_t tail = 0;
+    auto dominated = [&input, maximum](size_t kept, size_t incoming) {
+        return maximum ? input[kept] <= input[incoming] : input[kept] >= input[incoming];
+    };
+
+    const size_t width = 2 * half + 1;
+    for (size_t j = 0; j < input.size(); ++j) {
+        while (tail > head && dominated(queue[tail - 1], j)) {
+            --tail;
+        }
+        queue[tail++] = j;
+
+        if (j + 1 >= width) {
+            // 窗口[j-2*half, j]对应中心点j-half
+            while (queue[head] + width <= j) {
+                ++head;
+            }
+            output[j - half] = input[queue[head]];
+        }
+    }
+}
+
+void SmoothingKernel::slidingMedian(const std::vector<double>& input, size_t half, std::vector<double>& output) {
+    const size_t width = 2 * half + 1;
+    SlidingMedian window;
+    for (size_t j = 0; j < width; ++j) {
+        window.add(input[j]);
+    }
+    output[half] = window.median();
+    for (size_t i = half + 1; i + half < input.size(); ++i) {
+        window.replace(input[i - half - 1], input[i + half]);
+        output[i] = window.median();
+    }
+}
+
+void SmoothingKernel::ewma(const std::vector<double>& input, double alpha, std::vector<double>& output) {
+    if (input.empty()) {
+        return;
+    }
+    double value = input[0];
+    output[0] = value;
+    for (size_t i = 1; i < input.size(); ++i) {
+        value += alpha * (input[i] - value);
+        output[i] = value;
+    }
+}
+
+} // namespace AlgorithmPlugins
@@ -0,0 +1,635 @@
+#include "state_checkpoint.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+// 文件头：魔数、格式版本、类型、段数量、序号、保留字段、文件头CRC
+constexpr char kCheckpointMagic[4] = {'A', 'P', 'C', 'K'};
+constexpr uint32_t kCheckpointFormatVersion = 1;
+constexpr uint32_t kCheckpointFull = 0;
+constexpr uint32_t kCheckpointDelta = 1;
+constexpr size_t kHeaderSize = 32;
+
+const char* const kFullFileName = "state.ckpt";
+const char* const kDeltaPrefix = "state.";
+const char* const kDeltaSuffix = ".delta";
+
+void storeU32(char* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+void storeU64(char* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+uint32_t loadU32(const char* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t loadU64(const char* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+std::string deltaFileName(uint64_t sequence) {
+    std::string digits = std::to_string(sequence);
+    // 补零到固定宽度，目录列表按文件名即按序号排列
+    return kDeltaPrefix + std::string(20 - std::min<size_t>(digits.size(), 20), '0') + digits + kDeltaSuffix;
+}
+
+bool parseDeltaFileName(const std::string& name, uint64_t& sequence) {
+    const size_t prefix = std::strlen(kDeltaPrefix);
+    const size_t suffix = std::strlen(kDeltaSuffix);
+    if (name.size() <= prefix + suffix ||
+        name.compare(0, prefix, kDeltaPrefix) != 0 ||
+        name.compare(name.size() - suffix, suffix, kDeltaSuffix) != 0) {
+        return false;
+    }
+
+    std::string digits = name.substr(prefix, name.size() - prefix - suffix);
+    if (digits.empty() || digits.size() > 20 ||
+        !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    try {
+        sequence = std::stoull(digits);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+// 按序号列出目录中的增量检查点
+std::vector<std::pair<uint64_t, std::filesystem::path>> listDeltaFiles(const std::filesystem::path& directory) {
+    std::vector<std::pair<uint64_t, std::filesystem::path>> deltas;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        uint64_t sequence = 0;
+        if (entry.is_regular_file(ec) && parseDeltaFileName(entry.path().filename().string(), sequence)) {
+            deltas.emplace_back(sequence, entry.path());
+        }
+    }
+    std::sort(deltas.begin(), deltas.end());
+    return deltas;
+}
+
+// 只读映射的检查点文件
+class MappedFile {
+public:
+    bool open(const std::string& path, std::string& error) {
+#if defined(_WIN32)
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = "无法打开检查点文件: " + path;
+            return false;
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            error = "无法打开检查点文件: " + path;
+            return false;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            error = "无法读取检查点文件信息: " + path;
+            return false;
+        }
+
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ > 0) {
+            void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                error = "无法映射检查点文件: " + path;
+                return false;
+            }
+            mapped_ = mapped;
+            data_ = static_cast<const char*>(mapped);
+        }
+        ::close(fd);
+        return true;
+#endif
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        if (mapped_) {
+            ::munmap(mapped_, size_);
+        }
+#endif
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    std::string buffer_;
+#else
+    void* mapped_ = nullptr;
+#endif
+};
+
+// 写入文件并同步到磁盘
+class SyncedFile {
+public:
+    bool open(const std::string& path) {
+#if defined(_WIN32)
+        file_.open(path, std::ios::binary | std::ios::trunc);
+        return file_.is_open();
+#else
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        return fd_ >= 0;
+#endif
+    }
+
+    bool write(const char* data, size_t length) {
+#if defined(_WIN32)
+        file_.write(data, static_cast<std::streamsize>(length));
+        return file_.good();
+#else
+        while (length > 0) {
+            ssize_t written = ::write(fd_, data, length);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+        return true;
+#endif
+    }
+
+    bool syncAndClose() {
+#if defined(_WIN32)
+        file_.flush();
+        bool ok = file_.good();
+        file_.close();
+        return ok;
+#else
+        bool ok = ::fsync(fd_) == 0;
+        ok = ::close(fd_) == 0 && ok;
+        fd_ = -1;
+        return ok;
+#endif
+    }
+
+    ~SyncedFile() {
+#if !defined(_WIN32)
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+#endif
+    }
+
+private:
+#if defined(_WIN32)
+    std::ofstream file_;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// 同步目录项，保证重命名在掉电后仍然生效
+void syncDirectory(const std::filesystem::path& directory) {
+#if !defined(_WIN32)
+    int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)directory;
+#endif
+}
+
+} // namespace
+
+// ===== StateWriter =====
+
+void StateWriter::writeBytes(const void* data, size_t length) {
+    buffer_.append(static_cast<const char*>(data), length);
+}
+
+void StateWriter::writeU32(uint32_t value) {
+    char bytes[4];
+    storeU32(bytes, value);
+    writeBytes(bytes, sizeof(bytes));
+}
+
+void StateWriter::writeU64(uint64_t value) {
+    char bytes[8];
+    storeU64(bytes, value);
+    writeBytes(bytes, sizeof(bytes));
+}
+
+void StateWriter::writeDouble(double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU64(bits);
+}
+
+void StateWriter::writeString(const std::string& value) {
+    writeU64(value.size());
+    writeBytes(value.data(), value.size());
+}
+
+void StateWriter::writeTimePoint(std::chrono::system_clock::time_point value) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(value.time_since_epoch()).count();
+    writeU64(static_cast<uint64_t>(ns));
+}
+
+void StateWriter::writeDoubleArray(const std::vector<double>& values) {
+    writeU64(values.size());
+    buffer_.reserve(buffer_.size() + values.size() * 8);
+    for (double value : values) {
+        writeDouble(value);
+    }
+}
+
+void StateWriter::writeDoubleMap(const std::map<std::string, double>& values) {
+    writeU64(values.size());
+    for (const auto& [key, value] : values) {
+        writeString(key);
+        writeDouble(value);
+    }
+}
+
+// ===== StateReader =====
+
+bool StateReader::readBytes(void* data, size_t length) {
+    if (failed_ || length > size_ - position_) {
+        failed_ = true;
+        return false;
+    }
+    std::memcpy(data, data_ + position_, length);
+    position_ += length;
+    return true;
+}
+
+bool StateReader::readCount(uint64_t& count, size_t min_element_size) {
+    if (!readU64(count)) {
+        return false;
+    }
+    // 元素数量超过剩余数据能容纳的上限时视为损坏，避免按错误长度分配内存
+    if (min_element_size > 0 && count > (size_ - position_) / min_element_size) {
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool StateReader::readU32(uint32_t& value) {
+    char bytes[4];
+    if (!readBytes(bytes, sizeof(bytes))) {
+        return false;
+    }
+    value = loadU32(bytes);
+    return true;
+}
+
+bool StateReader::readU64(uint64_t& value) {
+    char bytes[8];
+    if (!readBytes(bytes, sizeof(bytes))) {
+        return false;
+    }
+    value = loadU64(bytes);
+    return true;
+}
+
+bool StateReader::readI32(int& value) {
+    uint32_t bits = 0;
+    if (!readU32(bits)) {
+        return false;
+    }
+    value = static_cast<int>(bits);
+    return true;
+}
+
+bool StateReader::readDouble(double& value) {
+    uint64_t bits = 0;
+    if (!readU64(bits)) {
+        return false;
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool StateReader::readString(std::string& value) {
+    uint64_t length = 0;
+    if (!readCount(length, 1)) {
+        return false;
+    }
+    value.assign(data_ + position_, static_cast<size_t>(length));
+    position_ += static_cast<size_t>(length);
+    return true;
+}
+
+bool StateReader::readTimePoint(std::chrono::system_clock::time_point& value) {
+    uint64_t ns = 0;
+    if (!readU64(ns)) {
+        return false;
+    }
+    value = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(static_cast<int64_t>(ns))));
+    return true;
+}
+
+bool StateReader::readDoubleArray(std::vector<double>& values) {
+    uint64_t count = 0;
+    if (!readCount(count, 8)) {
+        return false;
+    }
+    values.resize(static_cast<size_t>(count));
+    for (double& value : values) {
+        readDouble(value);
+    }
+    return !failed_;
+}
+
+bool StateReader::readDoubleMap(std::map<std::string, double>& values) {
+    uint64_t count = 0;
+    if (!readCount(count, 16)) {
+        return false;
+    }
+    values.clear();
+    std::string key;
+    double value = 0.0;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!readString(key) || !readDouble(value)) {
+            return false;
+        }
+        values.emplace_hint(values.end(), key, value);
+    }
+    return true;
+}
+
+// ===== StateCheckpoint =====
+
+uint32_t StateCheckpoint::crc32(const void* data, size_t length, uint32_t crc) {
+    static const std::array<uint32_t, 256> table = makeCrcTable();
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+bool StateCheckpoint::writeFile(const std::string& path, uint64_t sequence, bool incremental,
+                                const std::vector<Section>& sections, std::string& error) {
+    const std::string temp_path = path + ".tmp";
+
+    SyncedFile file;
+    if (!file.open(temp_path)) {
+        error = "无法创建检查点文件: " + temp_path;
+        return false;
+    }
+
+    char header[kHeaderSize] = {};
+    std::memcpy(header, kCheckpointMagic, sizeof(kCheckpointMagic));
+    storeU32(header + 4, kCheckpointFormatVersion);
+    storeU32(header + 8, incremental ? kCheckpointDelta : kCheckpointFull);
+    storeU32(header + 12, static_cast<uint32_t>(sections.size()));
+    storeU64(header + 16, sequence);
+    storeU32(header + 28, crc32(header, 28));
+
+    bool ok = file.write(header, kHeaderSize);
+    for (const auto& section : sections) {
+        if (!ok) {
+            break;
+        }
+        // 段：键长度、键、数据长度、数据CRC、数据
+        char key_length[4];
+        storeU32(key_length, static_cast<uint32_t>(section.key.size()));
+        char payload_info[12];
+        storeU64(payload_info, section.payload.size());
+        storeU32(payload_info + 8, crc32(section.payload.data(), section.payload.size()));
+
+        ok = file.write(key_length, sizeof(key_length)) &&
+             file.write(section.key.data(), section.key.size()) &&
+             file.write(payload_info, sizeof(payload_info)) &&
+             file.write(section.payload.data(), section.payload.size());
+    }
+    ok = file.syncAndClose() && ok;
+
+    std::error_code ec;
+    if (!ok) {
+        std::filesystem::remove(temp_path, ec);
+        error = "写入检查点文件失败: " + temp_path;
+        return false;
+    }
+
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        error = "重命名检查点文件失败: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool StateCheckpoint::readFile(const std::string& path, const SectionHandler& handler,
+                               uint64_t& sequence, std::string& error) {
+    MappedFile file;
+    if (!file.open(path, error)) {
+        return false;
+    }
+
+    const char* data = file.data();
+    const size_t size = file.size();
+    if (size < kHeaderSize || std::memcmp(data, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0) {
+        error = "检查点文件格式无效: " + path;
+        return false;
+    }
+    if (loadU32(data + 28) != crc32(data, 28)) {
+        error = "检查点文件头校验失败: " + path;
+        return false;
+    }
+    if (loadU32(data + 4) != kCheckpointFormatVersion) {
+        error = "不支持的检查点格式版本: " + path;
+        return false;
+    }
+
+    const uint32_t section_count = loadU32(data + 12);
+    sequence = loadU64(data + 16);
+
+    // 先校验全部段，文件损坏时不应用任何状态
+    struct SectionView {
+        std::string key;
+        const char* payload;
+        size_t length;
+    };
+    std::vector<SectionView> views;
+    views.reserve(section_count);
+
+    size_t position = kHeaderSize;
+    for (uint32_t i = 0; i < section_count; ++i) {
+        if (size - position < 4) {
+            error = "检查点文件不完整: " + path;
+            return false;
+        }
+        const size_t key_length = loadU32(data + position);
+        position += 4;
+        if (size - position < key_length + 12) {
+            error = "检查点文件不完整: " + path;
+            return false;
+        }
+        std::string key(data + position, key_length);
+        position += key_length;
+
+        const uint64_t payload_length = loadU64(data + position);
+        const uint32_t payload_crc = loadU32(data + position + 8);
+        position += 12;
+        if (payload_length > size - position) {
+            error = "检查点文件不完整: " + path;
+            return false;
+        }
+        if (crc32(data + position, static_cast<size_t>(payload_length)) != payload_crc) {
+            error = "检查点数据校验失败: " + path + " (" + key + ")";
+            return false;
+        }
+
+        views.push_back({std::move(key), data + position, static_cast<size_t>(payload_length)});
+        position += static_cast<size_t>(payload_length);
+    }
+    if (position != size) {
+        error = "检查点文件包含多余数据: " + path;
+        return false;
+    }
+
+    for (const auto& view : views) {
+        StateReader reader(view.payload, view.length);
+        if (!handler(view.key, reader)) {
+            error = "应用检查点数据失败: " + path + " (" + view.key + ")";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StateCheckpoint::write(const std::string& directory, uint64_t sequence, bool incremental,
+                            const std::vector<Section>& sections, std::string& error) {
+    try {
+        std::filesystem::path dir_path(directory);
+        std::error_code ec;
+        std::filesystem::create_directories(dir_path, ec);
+        if (ec) {
+            error = "无法创建检查点目录: " + directory;
+            return false;
+        }
+
+        const std::filesystem::path path = dir_path / (incremental ? deltaFileName(sequence) : kFullFileName);
+        if (!writeFile(path.string(), sequence, incremental, sections, error)) {
+            return false;
+        }
+        syncDirectory(dir_path);
+
+        // 全量检查点已包含全部状态，目录中的增量检查点（包括其他进程遗留的）不再适用
+        if (!incremental) {
+            for (const auto& delta : listDeltaFiles(dir_path)) {
+                std::filesystem::remove(delta.second, ec);
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        error = "写入检查点异常: " + std::string(e.what());
+        return false;
+    }
+}
+
+bool StateCheckpoint::restore(const std::string& directory, const SectionHandler& handler,
+                              uint64_t& last_sequence, std::string& error) {
+    last_sequence = 0;
+    try {
+        std::filesystem::path dir_path(directory);
+        const std::filesystem::path full_path = dir_path / kFullFileName;
+        std::error_code ec;
+        if (!std::filesystem::exists(full_path, ec)) {
+            return true;
+        }
+
+        uint64_t sequence = 0;
+        if (!readFile(full_path.string(), handler, sequence, error)) {
+            return false;
+        }
+        last_sequence = sequence;
+
+        // 增量检查点必须按序号连续应用，缺失或损坏之后的增量依赖的状态已不可得，一并删除
+        bool broken = false;
+        for (const auto& [delta_sequence, delta_path] : listDeltaFiles(dir_path)) {
+            if (delta_sequence <= last_sequence) {
+                continue;
+            }
+            if (!broken) {
+                std::string delta_error;
+                if (delta_sequence == last_sequence + 1 &&
+                    readFile(delta_path.string(), handler, sequence, delta_error) &&
+                    sequence == delta_sequence) {
+                    last_sequence = sequence;
+                    continue;
+                }
+                broken = true;
+            }
+            std::filesystem::remove(delta_path, ec);
+        }
+        return true;
+    } catch (const std::exception& e) {
+        error = "恢复检查点异常: " + std::string(e.what());
+        return false;
+    }
+}
+
+} // namespace AlgorithmPlugins
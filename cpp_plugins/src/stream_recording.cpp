@@ -0,0 +1,309 @@
+#include "stream_recording.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+constexpr char kRecordingMagic[4] = {'A', 'P', 'R', 'S'};
+constexpr uint32_t kRecordingFormatVersion = 1;
+
+std::chrono::system_clock::time_point parseJsonTimestamp(const std::string& line) {
+    const std::string key = "\"timestamp\":";
+    size_t pos = line.find(key);
+    if (pos == std::string::npos) {
+        return std::chrono::system_clock::time_point();
+    }
+    long long milliseconds = std::strtoll(line.c_str() + pos + key.size(), nullptr, 10);
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(milliseconds));
+}
+
+bool isBlank(const std::string& line) {
+    return line.find_first_not_of(" \t\r\n") == std::string::npos;
+}
+
+} // namespace
+
+std::shared_ptr<PluginData> StreamRecording::parseJsonLine(const std::string& line) {
+    auto timestamp = parseJsonTimestamp(line);
+
+    std::shared_ptr<PluginData> data;
+    if (line.find("\"type\":\"real_time\"") != std::string::npos) {
+        data = std::make_shared<RealTimeData>("", timestamp);
+    } else if (line.find("\"type\":\"batch_data\"") != std::string::npos) {
+        data = std::make_shared<BatchData>("", timestamp);
+    } else if (line.find("\"type\":\"feature_data\"") != std::string::npos) {
+        data = std::make_shared<FeatureData>("", timestamp);
+    } else if (line.find("\"type\":\"status_data\"") != std::string::npos) {
+        data = std::make_shared<StatusData>("", timestamp);
+    } else {
+        return nullptr;
+    }
+    return data->deserialize(line) ? data : nullptr;
+}
+
+void StreamRecording::encodeRecord(StateWriter& writer, const PluginData& data) {
+    writer.writeTimePoint(data.getTimestamp());
+    writer.writeString(data.getDeviceId());
+    writer.writeU32(static_cast<uint32_t>(data.getType()));
+    encodePayload(writer, data);
+}
+
+std::shared_ptr<PluginData> StreamRecording::decodeRecord(StateReader& reader) {
+    std::chrono::system_clock::time_point timestamp;
+    std::string device_id;
+    uint32_t type = 0;
+    if (!reader.readTimePoint(timestamp) || !reader.readString(device_id) || !reader.readU32(type)) {
+        return nullptr;
+    }
+    return decodePayload(reader, static_cast<DataType>(type), device_id, timestamp);
+}
+
+std::shared_ptr<PluginData> StreamRecording::withDeviceId(const PluginData& data, const std::string& device_id) {
+    StateWriter writer;
+    encodePayload(writer, data);
+    StateReader reader(writer.data().data(), writer.size());
+    return decodePayload(reader, data.getType(), device_id, data.getTimestamp());
+}
+
+void StreamRecording::encodePayload(StateWriter& writer, const PluginData& data) {
+    switch (data.getType()) {
+        case DataType::REAL_TIME: {
+            const auto& real_time = static_cast<const RealTimeData&>(data);
+            for (double value : {real_time.getMeanHF(), real_time.getMeanLF(), real_time.getMean(),
+                                 real_time.getStd(), real_time.getFeature1(), real_time.getFeature2(),
+                                 real_time.getFeature3(), real_time.getFeature4(), real_time.getTemperature(),
+                                 real_time.getSpeed(), real_time.getPeakFreq(), real_time.getPeakPowers()}) {
+                writer.writeDouble(value);
+            }
+            writer.writeDoubleMap(real_time.getCustomFeatures());
+            const auto& extend_data = real_time.getExtendDataMap();
+            writer.writeU64(extend_data.size());
+            for (const auto& [key, value] : extend_data) {
+                writer.writeString(key);
+                writer.writeString(value);
+            }
+            break;
+        }
+        case DataType::BATCH_DATA: {
+            const auto& batch = static_cast<const BatchData&>(data);
+            writer.writeI32(batch.getSamplingRate());
+            writer.writeI32(batch.getStatus());
+            writer.writeI32(batch.getStartIndex());
+            writer.writeI32(batch.getStopIndex());
+            writer.writeDoubleArray(batch.getWaveData());
+            writer.writeDoubleArray(batch.getSpeedData());
+            break;
+        }
+        case DataType::FEATURE_DATA:
+            writer.writeDoubleMap(static_cast<const FeatureData&>(data).getFeatures());
+            break;
+        case DataType::STATUS_DATA: {
+            const auto& status = static_cast<const StatusData&>(data);
+            writer.writeI32(status.getStatus());
+            writer.writeString(status.getStatusDescription());
+            const auto& mapping = status.getStatusMapping();
+            writer.writeU64(mapping.size());
+            for (const auto& [value, name] : mapping) {
+                writer.writeI32(value);
+                writer.writeString(name);
+            }
+            break;
+        }
+    }
+}
+
+std::shared_ptr<PluginData> StreamRecording::decodePayload(StateReader& reader, DataType type,
+                                                           const std::string& device_id,
+                                                           std::chrono::system_clock::time_point timestamp) {
+    switch (type) {
+        case DataType::REAL_TIME: {
+            auto data = std::make_shared<RealTimeData>(device_id, timestamp);
+            double values[12];
+            for (double& value : values) {
+                if (!reader.readDouble(value)) {
+                    return nullptr;
+                }
+            }
+            data->setMeanHF(values[0]);
+            data->setMeanLF(values[1]);
+            data->setMean(values[2]);
+            data->setStd(values[3]);
+            data->setFeature1(values[4]);
+            data->setFeature2(values[5]);
+            data->setFeature3(values[6]);
+            data->setFeature4(values[7]);
+            data->setTemperature(values[8]);
+            data->setSpeed(values[9]);
+            data->setPeakFreq(values[10]);
+            data->setPeakPowers(values[11]);
+
+            std::map<std::string, double> custom_features;
+            uint64_t extend_count = 0;
+            if (!reader.readDoubleMap(custom_features) || !reader.readU64(extend_count)) {
+                return nullptr;
+            }
+            for (const auto& [key, value] : custom_features) {
+                data->setCustomFeature(key, value);
+            }
+            std::string key;
+            std::string value;
+            for (uint64_t i = 0; i < extend_count; ++i) {
+                if (!reader.readString(key) || !reader.readString(value)) {
+                    return nullptr;
+                }
+                data->setExtendData(key, value);
+            }
+            return data;
+        }
+        case DataType::BATCH_DATA: {
+            auto data = std::make_shared<BatchData>(device_id, timestamp);
+            int sampling_rate = 0;
+            int status = 0;
+            int start_index = 0;
+            int stop_index = 0;
+            std::vector<double> wave_data;
+            std::vector<double> speed_data;
+            if (!reader.readI32(sampling_rate) || !reader.readI32(status) ||
+                !reader.readI32(start_index) || !reader.readI32(stop_index) ||
+                !reader.readDoubleArray(wave_data) || !reader.readDoubleArray(speed_data)) {
+                return nullptr;
+            }
+            data->setSamplingRate(sampling_rate);
+            data->setStatus(status);
+            data->setStartIndex(start_index);
+            data->setStopIndex(stop_index);
+            data->setWaveData(wave_data);
+            data->setSpeedData(speed_data);
+            return data;
+        }
+        case DataType::FEATURE_DATA: {
+            auto data = std::make_shared<FeatureData>(device_id, timestamp);
+            std::map<std::string, double> features;
+            if (!reader.readDoubleMap(features)) {
+                return nullptr;
+            }
+            data->setFeatures(features);
+            return data;
+        }
+        case DataType::STATUS_DATA: {
+            auto data = std::make_shared<StatusData>(device_id, timestamp);
+            int status = 0;
+            std::string description;
+            uint64_t mapping_count = 0;
+            if (!reader.readI32(status) || !reader.readString(description) || !reader.readU64(mapping_count)) {
+                return nullptr;
+            }
+            std::map<int, std::string> mapping;
+            int value = 0;
+            std::string name;
+            for (uint64_t i = 0; i < mapping_count; ++i) {
+                if (!reader.readI32(value) || !reader.readString(name)) {
+                    return nullptr;
+                }
+                mapping.emplace(value, name);
+            }
+            data->setStatus(status);
+            data->setStatusDescription(description);
+            data->setStatusMapping(mapping);
+            return data;
+        }
+    }
+    return nullptr;
+}
+
+bool StreamRecording::read(const std::string& path, std::vector<std::shared_ptr<PluginData>>& records,
+                           std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "无法打开录制文件: " + path;
+        return false;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    records.clear();
+
+    // 二进制格式：魔数、版本号、记录数和逐条记录
+    if (content.size() >= sizeof(kRecordingMagic) &&
+        std::memcmp(content.data(), kRecordingMagic, sizeof(kRecordingMagic)) == 0) {
+        StateReader reader(content.data() + sizeof(kRecordingMagic), content.size() - sizeof(kRecordingMagic));
+        uint32_t version = 0;
+        uint64_t count = 0;
+        if (!reader.readU32(version) || version != kRecordingFormatVersion) {
+            error = "不支持的录制文件版本: " + path;
+            return false;
+        }
+        if (!reader.readU64(count)) {
+            error = "录制文件不完整: " + path;
+            return false;
+        }
+        for (uint64_t i = 0; i < count; ++i) {
+            auto record = decodeRecord(reader);
+            if (!record) {
+                error = "录制文件第" + std::to_string(i + 1) + "条记录损坏: " + path;
+                return false;
+            }
+            records.push_back(std::move(record));
+        }
+        return true;
+    }
+
+    // JSON行格式，空行跳过
+    size_t line_number = 0;
+    size_t begin = 0;
+    while (begin < content.size()) {
+        size_t end = content.find('\n', begin);
+        if (end == std::string::npos) {
+            end = content.size();
+        }
+        std::string line = content.substr(begin, end - begin);
+        begin = end + 1;
+        ++line_number;
+
+        if (isBlank(line)) {
+            continue;
+        }
+        auto record = parseJsonLine(line);
+        if (!record) {
+            error = "录制文件第" + std::to_string(line_number) + "行无法解析: " + path;
+            return false;
+        }
+        records.push_back(std::move(record));
+    }
+    return true;
+}
+
+bool StreamRecording::write(const std::string& path, const std::vector<std::shared_ptr<PluginData>>& records,
+                            RecordingFormat format, std::string& error) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "无法创建录制文件: " + path;
+        return false;
+    }
+
+    if (format == RecordingFormat::BINARY) {
+        StateWriter writer;
+        writer.writeU32(kRecordingFormatVersion);
+        writer.writeU64(records.size());
+        for (const auto& record : records) {
+            encodeRecord(writer, *record);
+        }
+        file.write(kRecordingMagic, sizeof(kRecordingMagic));
+        file.write(writer.data().data(), static_cast<std::streamsize>(writer.size()));
+    } else {
+        for (const auto& record : records) {
+            file << record->serialize() << '\n';
+        }
+    }
+
+    file.flush();
+    if (!file) {
+        error = "写入录制文件失败: " + path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace AlgorithmPlugins
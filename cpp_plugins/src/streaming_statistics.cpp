@@ -0,0 +1,205 @@
+#include "streaming_statistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AlgorithmPlugins {
+
+// ===== RunningMoments =====
+
+void RunningMoments::add(double value) {
+    ++count_;
+    double delta = value - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (value - mean_);
+}
+
+void RunningMoments::remove(double value) {
+    if (count_ <= 1) {
+        clear();
+        return;
+    }
+    --count_;
+    double delta = value - mean_;
+    mean_ -= delta / count_;
+    m2_ -= delta * (value - mean_);
+    // 反复增删的舍入误差可能使m2_略小于0
+    if (m2_ < 0.0) {
+        m2_ = 0.0;
+    }
+}
+
+void RunningMoments::clear() {
+    count_ = 0;
+    mean_ = 0.0;
+    m2_ = 0.0;
+}
+
+double RunningMoments::sampleVariance() const {
+    return count_ > 1 ? m2_ / (count_ - 1) : 0.0;
+}
+
+double RunningMoments::sampleStd() const {
+    return std::sqrt(sampleVariance());
+}
+
+// ===== SlidingMedian =====
+
+void SlidingMedian::add(double value) {
+    if (lower_.empty() || value <= *lower_.rbegin()) {
+        lower_.insert(value);
+    } else {
+        upper_.insert(value);
+    }
+    rebalance();
+}
+
+void SlidingMedian::remove(double value) {
+    // upper_中的元素都不小于lower_的最大值，等于该值的元素可从任一侧移除
+    if (!lower_.empty() && value <= *lower_.rbegin()) {
+        auto it = lower_.find(value);
+        if (it != lower_.end()) {
+            lower_.erase(it);
+        }
+    } else {
+        auto it = upper_.find(value);
+        if (it != upper_.end()) {
+            upper_.erase(it);
+        }
+    }
+    rebalance();
+}
+
+void SlidingMedian::replace(double old_value, double new_value) {
+    std::multiset<double>::node_type node;
+    if (!lower_.empty() && old_value <= *lower_.rbegin()) {
+        auto it = lower_.find(old_value);
+        if (it != lower_.end()) {
+            node = lower_.extract(it);
+        }
+    } else {
+        auto it = upper_.find(old_value);
+        if (it != upper_.end()) {
+            node = upper_.extract(it);
+        }
+    }
+    if (node.empty()) {
+        add(new_value);
+        return;
+    }
+
+    node.value() = new_value;
+    if (lower_.empty() || new_value <= *lower_.rbegin()) {
+        lower_.insert(std::move(node));
+    } else {
+        upper_.insert(std::move(node));
+    }
+    rebalance();
+}
+
+void SlidingMedian::clear() {
+    lower_.clear();
+    upper_.clear();
+}
+
+double SlidingMedian::median() const {
+    if (lower_.empty()) {
+        return 0.0;
+    }
+    if (lower_.size() > upper_.size()) {
+        return *lower_.rbegin();
+    }
+    return (*lower_.rbegin() + *upper_.begin()) / 2.0;
+}
+
+void SlidingMedian::rebalance() {
+    // 节点在两个集合间移动，不重新分配内存
+    if (lower_.size() > upper_.size() + 1) {
+        upper_.insert(lower_.extract(std::prev(lower_.end())));
+    } else if (upper_.size() > lower_.size()) {
+        lower_.insert(upper_.extract(upper_.begin()));
+    }
+}
+
+// ===== WindowStatistics =====
+
+void WindowStatistics::push(double value) {
+    moments_.add(value);
+    max_.push(value);
+    min_.push(value);
+    if (track_median_) {
+        median_.add(value);
+    }
+}
+
+void WindowStatistics::popFront(double value) {
+    moments_.remove(value);
+    max_.popFront();
+    min_.popFront();
+    if (track_median_) {
+        median_.remove(value);
+    }
+}
+
+void WindowStatistics::clear() {
+    moments_.clear();
+    max_.clear();
+    min_.clear();
+    median_.clear();
+}
+
+void WindowStatistics::rebuild(const RingBuffer<double>& values) {
+    clear();
+    auto [first, second] = values.spans();
+    for (double value : first) {
+        push(value);
+    }
+    for (double value : second) {
+        push(value);
+    }
+}
+
+bool WindowStatistics::supports(const std::string& method) const {
+    return method == "mean" || method == "std" || method == "max" || method == "min" ||
+           (method == "median" && track_median_);
+}
+
+double WindowStatistics::get(const std::string& method) const {
+    if (moments_.count() == 0) {
+        return 0.0;
+    }
+    if (method == "mean") {
+        return moments_.mean();
+    } else if (method == "std") {
+        return moments_.sampleStd();
+    } else if (method == "max") {
+        return max_.value();
+    } else if (method == "min") {
+        return min_.value();
+    } else if (method == "median" && track_median_) {
+        return median_.median();
+    }
+    return 0.0;
+}
+
+void clampToPercentiles(std::vector<double>::iterator first, std::vector<double>::iterator last,
+                        double lower_fraction, double upper_fraction) {
+    const size_t n = static_cast<size_t>(last - first);
+    if (n == 0) {
+        return;
+    }
+    const size_t lower_rank = std::min(static_cast<size_t>(n * lower_fraction), n - 1);
+    const size_t upper_rank = std::max(std::min(static_cast<size_t>(n * upper_fraction), n - 1), lower_rank);
+    
+    std::vector<double> scratch(first, last);
+    std::nth_element(scratch.begin(), scratch.begin() + lower_rank, scratch.end());
+    const double lower = scratch[lower_rank];
+    // 第一次选择后lower_rank之后的元素都不小于它，第二次只需在后半部分选择
+    std::nth_element(scratch.begin() + lower_rank, scratch.begin() + upper_rank, scratch.end());
+    const double upper = scratch[upper_rank];
+    
+    for (auto it = first; it != last; ++it) {
+        *it = std::min(std::max(*it, lower), upper);
+    }
+}
+
+} // namespace AlgorithmPlugins
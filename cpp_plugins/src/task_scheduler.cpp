@@ -0,0 +1,268 @@
+#include "task_scheduler.h"
+#include <algorithm>
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+// 当前线程所属的调度器及其工作线程下标
+thread_local const TaskScheduler* current_scheduler = nullptr;
+thread_local size_t current_worker_index = 0;
+
+} // namespace
+
+TaskScheduler::TaskScheduler(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    worker_queues_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        worker_queues_.push_back(std::make_unique<WorkerQueues>());
+    }
+
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+TaskScheduler& TaskScheduler::getInstance() {
+    static TaskScheduler instance;
+    return instance;
+}
+
+bool TaskScheduler::isWorkerThread() const {
+    return current_scheduler == this;
+}
+
+void TaskScheduler::submit(std::function<void()> task, TaskPriority priority) {
+    auto level = static_cast<size_t>(priority);
+
+    // 工作线程提交的任务进入本地队列，便于就近执行和被窃取
+    TaskQueue& queue = isWorkerThread()
+        ? worker_queues_[current_worker_index]->queues[level]
+        : injection_queues_[level];
+
+    // 先计数再入队，计数不会小于实际任务数
+    pending_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    {
+        // 持锁通知，避免与工作线程的空闲检查交错丢失唤醒
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    wake_.notify_one();
+}
+
+bool TaskScheduler::runPendingTask() {
+    std::function<void()> task;
+    size_t worker_index = isWorkerThread() ? current_worker_index : worker_queues_.size();
+    if (!takeTask(worker_index, task)) {
+        return false;
+    }
+
+    try {
+        task();
+    } catch (...) {
+        // 调度器不关心任务结果，需要结果的任务由TaskGroup捕获异常
+    }
+    return true;
+}
+
+bool TaskScheduler::takeTask(size_t worker_index, std::function<void()>& task) {
+    const size_t worker_count = worker_queues_.size();
+
+    auto pop_back = [&task](TaskQueue& queue) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    };
+    auto pop_front = [&task](TaskQueue& queue) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    };
+
+    // 按优先级依次查找：本地队列（后进先出）、注入队列、其他线程的本地队列（先进先出）
+    for (size_t level = 0; level < kPriorityCount; ++level) {
+        bool found = (worker_index < worker_count && pop_back(worker_queues_[worker_index]->queues[level]))
+                  || pop_front(injection_queues_[level]);
+
+        for (size_t offset = 1; !found && offset <= worker_count; ++offset) {
+            size_t victim = (worker_index + offset) % worker_count;
+            if (victim != worker_index) {
+                found = pop_front(worker_queues_[victim]->queues[level]);
+            }
+        }
+
+        if (found) {
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TaskScheduler::workerLoop(size_t worker_index) {
+    current_scheduler = this;
+    current_worker_index = worker_index;
+
+    while (true) {
+        std::function<void()> task;
+        if (takeTask(worker_index, task)) {
+            active_.fetch_add(1, std::memory_order_relaxed);
+            try {
+                task();
+            } catch (...) {
+                // 调度器不关心任务结果，需要结果的任务由TaskGroup捕获异常
+            }
+            active_.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+
+        // 停止时仍需执行完已提交的任务
+        if (stopping_ && pending_.load() == 0) {
+            return;
+        }
+    }
+}
+
+// TaskGroup实现
+TaskGroup::TaskGroup(TaskScheduler& scheduler, TaskPriority priority)
+    : scheduler_(scheduler), priority_(priority), state_(std::make_shared<State>()) {
+}
+
+TaskGroup::~TaskGroup() {
+    // 析构时必须等待，任务可能引用调用方栈上的数据
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    state_->pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->queued.push_back(std::move(task));
+    }
+
+    // 调度器中只放占位任务，任务本身可能已被wait()取走执行
+    scheduler_.submit([state = state_] { runQueuedTask(state); }, priority_);
+}
+
+bool TaskGroup::runQueuedTask(const std::shared_ptr<State>& state) {
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->queued.empty()) {
+            return false;
+        }
+        task = std::move(state->queued.front());
+        state->queued.pop_front();
+    }
+
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->error) {
+            state->error = std::current_exception();
+        }
+    }
+
+    if (state->pending.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->finished.notify_all();
+    }
+    return true;
+}
+
+void TaskGroup::wait() {
+    // 只协助执行本组任务：调用方可能持有不可重入的锁，执行其他任务可能重入该锁而死锁
+    while (runQueuedTask(state_)) {
+    }
+
+    // 剩余任务均已在其他线程开始执行，阻塞等待即可
+    {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->finished.wait(lock, [this] { return state_->pending.load() == 0; });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        std::swap(error, state_->error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void parallelFor(size_t begin, size_t end, size_t grain_size,
+                 const std::function<void(size_t, size_t)>& func,
+                 TaskPriority priority) {
+    if (begin >= end) {
+        return;
+    }
+
+    grain_size = std::max<size_t>(1, grain_size);
+
+    // 区间不足两块时直接在当前线程执行
+    if (end - begin <= grain_size) {
+        func(begin, end);
+        return;
+    }
+
+    TaskGroup group(TaskScheduler::getInstance(), priority);
+    size_t chunk_begin = begin + grain_size;
+    for (; chunk_begin < end; chunk_begin += grain_size) {
+        size_t chunk_end = std::min(chunk_begin + grain_size, end);
+        group.run([&func, chunk_begin, chunk_end] { func(chunk_begin, chunk_end); });
+    }
+
+    // 第一块由当前线程执行
+    std::exception_ptr error;
+    try {
+        func(begin, std::min(begin + grain_size, end));
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    group.wait();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace AlgorithmPlugins
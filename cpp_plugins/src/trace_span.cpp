@@ -0,0 +1,248 @@
+#include "trace_span.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace AlgorithmPlugins {
+
+namespace {
+
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void appendJsonString(std::string& out, const char* text) {
+    out += '"';
+    for (const char* p = text; *p; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += static_cast<char>(c);
+                }
+                break;
+        }
+    }
+    out += '"';
+}
+
+// 纳秒转为Chrome trace使用的微秒
+void appendMicros(std::string& out, uint64_t ns) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%llu.%03llu",
+                  static_cast<unsigned long long>(ns / 1000), static_cast<unsigned long long>(ns % 1000));
+    out += buffer;
+}
+
+} // namespace
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::Tracer() : epoch_ns_(steadyNowNs()) {
+}
+
+void Tracer::setSampleInterval(uint32_t interval) {
+    sample_interval_.store(std::max<uint32_t>(interval, 1), std::memory_order_relaxed);
+}
+
+void Tracer::setBufferCapacity(size_t capacity) {
+    buffer_capacity_.store(std::max<size_t>(capacity, 1), std::memory_order_relaxed);
+}
+
+TraceContext& Tracer::currentContext() {
+    thread_local TraceContext context;
+    return context;
+}
+
+uint64_t Tracer::sampleRequest() {
+    if (!isEnabled()) {
+        return 0;
+    }
+    uint64_t sequence = request_counter_.fetch_add(1, std::memory_order_relaxed);
+    if (sequence % sample_interval_.load(std::memory_order_relaxed) != 0) {
+        return 0;
+    }
+    return sequence + 1;
+}
+
+uint64_t Tracer::nowNs() const {
+    return steadyNowNs() - epoch_ns_;
+}
+
+Tracer::ThreadBuffer& Tracer::threadBuffer() {
+    // 缓冲区由注册表共同持有，线程退出后已记录的事件仍可导出
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.resize(buffer_capacity_.load(std::memory_order_relaxed));
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffer->thread_index = next_thread_index_++;
+        buffers_.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::record(const char* name, const char* category, const std::string& label,
+                    uint64_t start_ns, uint64_t duration_ns, uint64_t request_id, uint32_t depth) {
+    ThreadBuffer& buffer = threadBuffer();
+
+    // 只有导出时才会与其他线程竞争
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    TraceEvent& event = buffer.events[buffer.next];
+    event.name = name;
+    event.category = category;
+    event.label.assign(label);
+    event.start_ns = start_ns;
+    event.duration_ns = duration_ns;
+    event.request_id = request_id;
+    event.depth = depth;
+
+    buffer.next = (buffer.next + 1) % buffer.events.size();
+    if (buffer.size < buffer.events.size()) {
+        ++buffer.size;
+    } else {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::string Tracer::renderChromeTrace() const {
+    std::string out;
+    out.reserve(64 * 1024);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    std::lock_guard<std::mutex> registry_lock(buffers_mutex_);
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if (buffer->size == 0) {
+            continue;
+        }
+
+        const std::string tid = std::to_string(buffer->thread_index);
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + tid +
+               ",\"args\":{\"name\":\"thread " + tid + "\"}}";
+
+        // 从最早的事件开始输出
+        size_t capacity = buffer->events.size();
+        size_t index = (buffer->next + capacity - buffer->size) % capacity;
+        for (size_t i = 0; i < buffer->size; ++i, index = (index + 1) % capacity) {
+            const TraceEvent& event = buffer->events[index];
+            out += ",\n{\"ph\":\"X\",\"name\":";
+            appendJsonString(out, event.name);
+            out += ",\"cat\":";
+            appendJsonString(out, event.category);
+            out += ",\"ts\":";
+            appendMicros(out, event.start_ns);
+            out += ",\"dur\":";
+            appendMicros(out, event.duration_ns);
+            out += ",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"request\":" + std::to_string(event.request_id) +
+                   ",\"depth\":" + std::to_string(event.depth);
+            if (!event.label.empty()) {
+                out += ",\"label\":";
+                appendJsonString(out, event.label.c_str());
+            }
+            out += "}}";
+        }
+    }
+
+    out += "\n]}\n";
+    return out;
+}
+
+bool Tracer::exportChromeTrace(const std::string& file_path) const {
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file << renderChromeTrace();
+    return file.good();
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> registry_lock(buffers_mutex_);
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->next = 0;
+        buffer->size = 0;
+    }
+
+    // 只被注册表持有的缓冲区属于已退出的线程
+    buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                  [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                                      return buffer.use_count() == 1;
+                                  }),
+                   buffers_.end());
+    dropped_.store(0, std::memory_order_relaxed);
+}
+
+size_t Tracer::getEventCount() const {
+    std::lock_guard<std::mutex> registry_lock(buffers_mutex_);
+    size_t count = 0;
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        count += buffer->size;
+    }
+    return count;
+}
+
+TraceRequestScope::TraceRequestScope() {
+    TraceContext& context = Tracer::currentContext();
+    saved_ = context;
+    if (context.request_id == 0) {
+        context.request_id = Tracer::getInstance().sampleRequest();
+        context.depth = 0;
+    }
+}
+
+TraceRequestScope::~TraceRequestScope() {
+    Tracer::currentContext() = saved_;
+}
+
+TraceContextScope::TraceContextScope(const TraceContext& context) {
+    TraceContext& current = Tracer::currentContext();
+    saved_ = current;
+    current = context;
+}
+
+TraceContextScope::~TraceContextScope() {
+    Tracer::currentContext() = saved_;
+}
+
+void TraceSpan::begin(const char* name, const char* category, const std::string* label, TraceContext& context) {
+    name_ = name;
+    category_ = category;
+    if (label) {
+        label_ = *label;
+    }
+    request_id_ = context.request_id;
+    depth_ = context.depth++;
+    start_ns_ = Tracer::getInstance().nowNs();
+}
+
+void TraceSpan::end() {
+    Tracer& tracer = Tracer::getInstance();
+    uint64_t end_ns = tracer.nowNs();
+    TraceContext& context = Tracer::currentContext();
+    if (context.depth > 0) {
+        --context.depth;
+    }
+    tracer.record(name_, category_, label_, start_ns_, end_ns - start_ns_, request_id_, depth_);
+}
+
+} // namespace AlgorithmPlugins
@@ -1,4 +1,7 @@
 #include "vibrate31_plugin.h"
+#include "task_scheduler.h"
+#include "trace_span.h"
+#include "memory_accounting.h"
 #include <algorithm>
 #include <cmath>
 #include <numeric>
@@ -63,6 +66,8 @@ bool Vibrate31Plugin::computeVibrationFeatures(const std::vector<double>& wave_d
                                                const std::vector<double>& speed_data,
                                                int sampling_rate,
                                                std::map<std::string, double>& features) {
+    TRACE_SPAN("vibrate31.features", "vibrate31");
+    
     try {
         // 1. 数据长度校验
         double duration = static_cast<double>(wave_data.size()) / sampling_rate;
@@ -96,16 +101,31 @@ bool Vibrate31Plugin::computeVibrationFeatures(const std::vector<double>& wave_d
             return false;
         }
         
-        // 计算每个工况段的特征
+        // 各工况段相互独立，在共享调度器上并行计算
+        std::vector<std::map<std::string, double>> segment_results(segments.size());
+        std::vector<std::string> segment_errors(segments.size());
+        std::vector<char> segment_valid(segments.size(), 0);
+        const TraceContext trace_context = TRACE_CURRENT_CONTEXT();
+        MemoryAccount* const memory_account = MemoryAccount::current();
+        parallelFor(0, segments.size(), 1, [&](size_t begin, size_t end) {
+            TRACE_CONTEXT_SCOPE(trace_context);
+            MemoryAccountScope memory_scope(memory_account);
+            for (size_t i = begin; i < end; ++i) {
+                if (segments[i].size() / sampling_rate < duration_limit_) {
+                    continue; // 跳过时长不足的段
+                }
+                segment_valid[i] = computeSegmentFeatures(segments[i], speed_data, statuses[i],
+                                                          segment_results[i], segment_errors[i]);
+            }
+        });
+        
+        // 按段顺序收集结果
         std::vector<std::map<std::string, double>> segment_features;
         for (size_t i = 0; i < segments.size(); ++i) {
-            if (segments[i].size() / sampling_rate < duration_limit_) {
-                continue; // 跳过时长不足的段
-            }
-            
-            std::map<std::string, double> seg_features;
-            if (computeSegmentFeatures(segments[i], speed_data, statuses[i], seg_features)) {
-                segment_features.push_back(seg_features);
+            if (segment_valid[i]) {
+                segment_features.push_back(std::move(segment_results[i]));
+            } else if (!segment_errors[i].empty()) {
+                setError(segment_errors[i]);
             }
         }
         
@@ -126,7 +146,10 @@ bool Vibrate31Plugin::computeVibrationFeatures(const std::vector<double>& wave_d
 bool Vibrate31Plugin::computeSegmentFeatures(const std::vector<double>& segment_wave,
                                              const std::vector<double>& speed_data,
                                              int status,
-                                             std::map<std::string, double>& features) {
+                                             std::map<std::string, double>& features,
+                                             std::string& error) {
+    TRACE_SPAN("vibrate31.segment", "vibrate31");
+    
     try {
         // 计算基础统计特征
         features["mean"] = computeMean(segment_wave);
@@ -136,7 +159,8 @@ bool Vibrate31Plugin::computeSegmentFeatures(const std::vector<double>& segment_
         
         // 计算频谱特征
         std::vector<double> frequencies, amplitudes;
-        if (computeSpectrum(segment_wave, sampling_rate_, frequencies, amplitudes)) {
+        if (segment_wave.size() >= 2) {
+            computeAmplitudeSpectrum(segment_wave, sampling_rate_, frequencies, amplitudes);
             features["peak_freq"] = findPeakFrequency(frequencies, amplitudes);
             features["peak_power"] = findPeakPower(amplitudes);
             features["spectrum_energy"] = computeSpectrumEnergy(amplitudes);
@@ -148,7 +172,7 @@ bool Vibrate31Plugin::computeSegmentFeatures(const std::vector<double>& segment_
         return true;
         
     } catch (const std::exception& e) {
-        setError("计算段特征时发生异常: " + std::string(e.what()));
+        error = "计算段特征时发生异常: " + std::string(e.what());
         return false;
     }
 }
@@ -246,20 +270,37 @@ bool Vibrate31Plugin::computeSpectrum(const std::vector<double>& wave_data,
                                       std::vector<double>& amplitudes) {
     try {
         // 简化的FFT实现（实际项目中应使用FFTW或其他专业库）
-        int n = wave_data.size();
-        if (n < 2) return false;
+        if (wave_data.size() < 2) return false;
         
-        frequencies.clear();
-        amplitudes.clear();
+        computeAmplitudeSpectrum(wave_data, sampling_rate, frequencies, amplitudes);
         
-        // 计算频率分辨率
-        double freq_resolution = static_cast<double>(sampling_rate) / n;
+        return true;
         
-        // 计算幅度谱（简化实现）
-        for (int i = 0; i < n / 2; ++i) {
-            frequencies.push_back(i * freq_resolution);
+    } catch (const std::exception& e) {
+        setError("频谱计算异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+void Vibrate31Plugin::computeAmplitudeSpectrum(const std::vector<double>& wave_data,
+                                               int sampling_rate,
+                                               std::vector<double>& frequencies,
+                                               std::vector<double>& amplitudes) {
+    TRACE_SPAN("vibrate31.spectrum", "vibrate31");
+    
+    int n = wave_data.size();
+    
+    // 计算频率分辨率
+    double freq_resolution = static_cast<double>(sampling_rate) / n;
+    
+    frequencies.assign(n / 2, 0.0);
+    amplitudes.assign(n / 2, 0.0);
+    
+    // 各频点相互独立，按块并行计算幅度谱（简化实现）
+    parallelFor(0, static_cast<size_t>(n / 2), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            frequencies[i] = i * freq_resolution;
             
-            // 简化的幅度计算
             double real = 0.0, imag = 0.0;
             for (int j = 0; j < n; ++j) {
                 double angle = -2.0 * M_PI * i * j / n;
@@ -267,16 +308,9 @@ bool Vibrate31Plugin::computeSpectrum(const std::vector<double>& wave_data,
                 imag += wave_data[j] * std::sin(angle);
             }
             
-            double amplitude = std::sqrt(real * real + imag * imag) / n;
-            amplitudes.push_back(amplitude);
+            amplitudes[i] = std::sqrt(real * real + imag * imag) / n;
         }
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        setError("频谱计算异常: " + std::string(e.what()));
-        return false;
-    }
+    });
 }
 
 double Vibrate31Plugin::findPeakFrequency(const std::vector<double>& frequencies,
@@ -311,6 +345,8 @@ bool Vibrate31Plugin::segmentByStatus(const std::vector<double>& wave_data,
                                      const std::vector<double>& speed_data,
                                      std::vector<std::vector<double>>& segments,
                                      std::vector<int>& statuses) {
+    TRACE_SPAN("vibrate31.segmentation", "vibrate31");
+    
     try {
         // 简化的工况分割实现
         // 实际项目中应根据具体需求实现更复杂的工况识别算法
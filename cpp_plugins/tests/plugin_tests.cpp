@@ -3,8 +3,41 @@
 #include <chrono>
 #include <vector>
 #include <map>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <tuple>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <limits>
+#include <random>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 #include "plugin_manager.h"
+#include "async_chain_executor.h"
+#include "pipelined_chain_executor.h"
+#include "task_scheduler.h"
+#include "device_state_store.h"
+#include "ring_buffer.h"
+#include "streaming_statistics.h"
+#include "smoothing_kernels.h"
+#include "health_formula.h"
+#include "long_term_smoothing.h"
+#include "state_checkpoint.h"
+#include "metrics_exporter.h"
+#include "memory_accounting.h"
+#include "stream_recording.h"
+#include "trace_span.h"
 #include "data_types.h"
 #include "feature_plugin_base.h"
 #include "decision_plugin_base.h"
@@ -81,6 +114,93 @@ public:
     }
 };
 
+/**
+ * @brief 测试插件的行为配置，各测试只声明需要的行为
+ */
+struct TestPluginOptions {
+    bool pure = false;               // 声明为纯插件，结果可缓存
+    bool counting = false;           // 按设备计数，输出"<名称>_count"并保存到状态快照
+    size_t retained_bytes = 0;       // 每次执行保留（不释放）的内存
+    size_t scratch_bytes = 0;        // 每次执行临时分配并释放的内存
+    std::function<void(const std::string& device_id)> on_process;  // 处理前调用，用于阻塞或记录顺序
+};
+
+/**
+ * @brief 插件链测试用插件，输出输入特征数量
+ */
+class TestPlugin : public IPlugin {
+public:
+    explicit TestPlugin(const std::string& name, const TestPluginOptions& options = {})
+        : name_(name), options_(options) {}
+    
+    std::string getName() const override { return name_; }
+    std::string getVersion() const override { return "1.0.0"; }
+    std::string getDescription() const override { return "插件链测试插件"; }
+    PluginType getType() const override { return PluginType::OTHER; }
+    
+    bool initialize(std::shared_ptr<PluginParameter>) override { return true; }
+    bool isPure() const override { return options_.pure; }
+    
+    bool process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) override {
+        ++process_count;
+        if (options_.on_process) {
+            options_.on_process(input->getDeviceId());
+        }
+        if (options_.scratch_bytes > 0) {
+            std::vector<char> scratch(options_.scratch_bytes);
+        }
+        if (options_.retained_bytes > 0) {
+            retained_.push_back(std::make_unique<char[]>(options_.retained_bytes));
+        }
+        if (options_.counting) {
+            int& count = counts_.get(DeviceRegistry::getInstance().getHandle(input->getDeviceId()));
+            output->setData(name_ + "_count", ++count);
+        }
+        auto features = std::dynamic_pointer_cast<FeatureData>(input);
+        output->setData(name_, static_cast<int>(features ? features->getFeatures().size() : 0));
+        output->setData(name_ + "_value", 1.0);
+        return true;
+    }
+    void cleanup() override {}
+    bool isInitialized() const override { return true; }
+    std::string getLastError() const override { return ""; }
+    
+    std::vector<std::string> getRequiredParameters() const override { return {}; }
+    std::vector<std::string> getOptionalParameters() const override { return {}; }
+    
+    bool isStateful() const override { return options_.counting; }
+    bool saveState(StateWriter& writer, bool incremental) override {
+        writeDeviceStates(writer, counts_, incremental, [](StateWriter& w, int count) { w.writeI32(count); });
+        return true;
+    }
+    bool loadState(StateReader& reader) override {
+        return readDeviceStates(reader, counts_, [](StateReader& r, int& count) { return r.readI32(count); });
+    }
+    
+    // 全部测试插件实例的实际计算次数
+    static inline std::atomic<int> process_count{0};
+
+private:
+    std::string name_;
+    TestPluginOptions options_;
+    std::vector<std::unique_ptr<char[]>> retained_;
+    DeviceStateStore<int> counts_;
+};
+
+class TestPluginFactory : public IPluginFactory {
+public:
+    explicit TestPluginFactory(const std::string& name, const TestPluginOptions& options = {})
+        : name_(name), options_(options) {}
+    
+    std::shared_ptr<IPlugin> createPlugin() override { return std::make_shared<TestPlugin>(name_, options_); }
+    std::string getPluginName() const override { return name_; }
+    PluginType getPluginType() const override { return PluginType::OTHER; }
+
+private:
+    std::string name_;
+    TestPluginOptions options_;
+};
+
 /**
  * @brief 插件基类测试
  */
@@ -95,6 +215,31 @@ protected:
         plugin_manager_->clearAllPlugins();
     }
     
+    // 注册一组行为相同的测试插件
+    void registerTestPlugins(std::initializer_list<const char*> names, const TestPluginOptions& options = {}) {
+        for (const char* name : names) {
+            ASSERT_TRUE(plugin_manager_->registerPluginFactory(std::make_shared<TestPluginFactory>(name, options)));
+        }
+    }
+    
+    // 测试插件链配置，data_mappings为空时按插件顺序执行
+    static PluginChainManager::ChainConfig chainConfig(const std::string& chain_name,
+                                                       const std::vector<std::string>& plugin_names,
+                                                       const std::map<std::string, std::string>& data_mappings = {}) {
+        PluginChainManager::ChainConfig config;
+        config.chain_name = chain_name;
+        config.plugin_names = plugin_names;
+        config.data_mappings = data_mappings;
+        return config;
+    }
+    
+    // 以设备的特征数据执行插件链，失败时返回nullptr
+    static std::shared_ptr<PluginResultImpl> runChain(PluginChainManager& chain_manager, const std::string& chain_name,
+                                                      const std::string& device_id = "test_device") {
+        auto output = std::make_shared<PluginResultImpl>();
+        return chain_manager.executeChain(chain_name, TestDataHelper::createFeatureData(device_id), output) ? output : nullptr;
+    }
+    
     PluginManager* plugin_manager_;
     std::shared_ptr<PluginParameterImpl> test_params_;
 };
@@ -193,16 +338,208 @@ TEST_F(PluginBaseTest, PluginManagerTest) {
     // EXPECT_FALSE(plugin_manager_->getPluginDescription("test_plugin").empty());
 }
 
+/**
+ * @brief 插件库加载测试
+ */
+TEST_F(PluginBaseTest, PluginLibraryLoadingTest) {
+    auto plugin_dir = std::filesystem::temp_directory_path() / "algorithm_plugins_load_test";
+    std::filesystem::remove_all(plugin_dir);
+    std::filesystem::create_directories(plugin_dir);
+    
+    // 空目录加载成功
+    EXPECT_TRUE(plugin_manager_->loadPluginsFromDirectory(plugin_dir.string()));
+    EXPECT_FALSE(plugin_manager_->loadPluginsFromDirectory((plugin_dir / "missing").string()));
+    
+    // 非ELF文件被拒绝并记录错误
+    auto bad_library = plugin_dir / "libbroken.so";
+    std::ofstream(bad_library) << "not a shared object";
+    EXPECT_FALSE(plugin_manager_->loadPluginFromFile(bad_library.string()));
+    EXPECT_FALSE(plugin_manager_->loadPluginsFromDirectory(plugin_dir.string()));
+    EXPECT_EQ(plugin_manager_->getLoadErrors().size(), 1);
+    EXPECT_TRUE(plugin_manager_->getLoadedLibraries().empty());
+    
+    // 非共享库扩展名的文件不参与目录扫描
+    EXPECT_TRUE(DynamicLibrary::hasSharedLibraryExtension("libvibrate.so"));
+    EXPECT_TRUE(DynamicLibrary::hasSharedLibraryExtension("libvibrate.so.1"));
+    EXPECT_FALSE(DynamicLibrary::hasSharedLibraryExtension("vibrate.json"));
+    
+    std::filesystem::remove_all(plugin_dir);
+}
+
+/**
+ * @brief 插件库加载、创建、执行、卸载完整流程测试
+ */
+TEST_F(PluginBaseTest, PluginLibraryRoundTripTest) {
+    std::string library_path = std::filesystem::weakly_canonical(TEST_ECHO_PLUGIN_PATH).string();
+    ASSERT_TRUE(DynamicLibrary::isSharedLibrary(library_path));
+
+    ASSERT_TRUE(plugin_manager_->loadPluginFromFile(library_path))
+        << plugin_manager_->getLoadErrors()[library_path];
+    EXPECT_TRUE(plugin_manager_->isPluginAvailable("echo_test_plugin"));
+    EXPECT_EQ(plugin_manager_->getPluginType("echo_test_plugin"), PluginType::OTHER);
+    EXPECT_EQ(plugin_manager_->getLoadedLibraries(), std::vector<std::string>{library_path});
+
+    // 重复加载同一文件不会重复注册
+    uint64_t generation = plugin_manager_->getPluginGeneration("echo_test_plugin");
+    EXPECT_TRUE(plugin_manager_->loadPluginFromFile(library_path));
+    EXPECT_EQ(plugin_manager_->getPluginGeneration("echo_test_plugin"), generation);
+    
+    // 指向同一文件的符号链接按解析后的路径去重
+    auto link_dir = std::filesystem::temp_directory_path() / "algorithm_plugins_link_test";
+    std::filesystem::remove_all(link_dir);
+    std::filesystem::create_directories(link_dir);
+    std::filesystem::create_symlink(library_path, link_dir / "libecho_link.so");
+    EXPECT_TRUE(plugin_manager_->loadPluginFromFile((link_dir / "libecho_link.so").string()));
+    EXPECT_EQ(plugin_manager_->getPluginGeneration("echo_test_plugin"), generation);
+    EXPECT_EQ(plugin_manager_->getLoadedLibraries(), std::vector<std::string>{library_path});
+    std::filesystem::remove_all(link_dir);
+    
+    // 其他路径的同名插件库被拒绝，不覆盖已注册的插件
+    std::string other_path = std::filesystem::weakly_canonical(TEST_ECHO_PLUGIN_V2_PATH).string();
+    EXPECT_FALSE(plugin_manager_->loadPluginFromFile(other_path));
+    EXPECT_NE(plugin_manager_->getLoadErrors()[other_path].find("插件名称重复"), std::string::npos);
+    EXPECT_EQ(plugin_manager_->getPluginGeneration("echo_test_plugin"), generation);
+    EXPECT_EQ(plugin_manager_->getLoadedLibraries(), std::vector<std::string>{library_path});
+
+    auto plugin = plugin_manager_->createPlugin("echo_test_plugin", test_params_);
+    ASSERT_NE(plugin, nullptr);
+    EXPECT_TRUE(plugin->isInitialized());
+    EXPECT_EQ(plugin->getName(), "echo_test_plugin");
+
+    auto input = TestDataHelper::createRealTimeData("device_round_trip");
+    for (int i = 1; i <= 3; ++i) {
+        auto output = std::make_shared<PluginResultImpl>();
+        ASSERT_TRUE(plugin->process(input, output));
+        EXPECT_EQ(output->getStringData("echo_device"), "device_round_trip");
+        EXPECT_EQ(output->getIntData("echo_calls"), i);
+    }
+
+    // 注销后库进入待卸载状态，实例释放后库被关闭
+    EXPECT_TRUE(plugin_manager_->unregisterPlugin("echo_test_plugin"));
+    EXPECT_FALSE(plugin_manager_->isPluginAvailable("echo_test_plugin"));
+    EXPECT_TRUE(plugin_manager_->getLoadedLibraries().empty());
+    EXPECT_EQ(plugin_manager_->getDrainingLibraries(), std::vector<std::string>{library_path});
+
+    auto output = std::make_shared<PluginResultImpl>();
+    EXPECT_TRUE(plugin->process(input, output));
+    EXPECT_EQ(output->getIntData("echo_calls"), 4);
+
+    plugin.reset();
+    EXPECT_TRUE(plugin_manager_->getDrainingLibraries().empty());
+
+    // 卸载后可以重新加载，新实例的状态从零开始
+    ASSERT_TRUE(plugin_manager_->loadPluginFromFile(library_path));
+    plugin = plugin_manager_->createPlugin("echo_test_plugin", test_params_);
+    ASSERT_NE(plugin, nullptr);
+    output = std::make_shared<PluginResultImpl>();
+    ASSERT_TRUE(plugin->process(input, output));
+    EXPECT_EQ(output->getIntData("echo_calls"), 1);
+}
+
+/**
+ * @brief 插件热替换测试
+ */
+TEST_F(PluginBaseTest, PluginHotSwapTest) {
+    class HotSwapTestFactory : public IPluginFactory {
+    public:
+        std::shared_ptr<IPlugin> createPlugin() override { return nullptr; }
+        std::string getPluginName() const override { return "hot_swap_plugin"; }
+        PluginType getPluginType() const override { return PluginType::FEATURE; }
+    };
+    
+    // 注册和注销均推进版本号
+    uint64_t generation = plugin_manager_->getRegistryGeneration();
+    EXPECT_TRUE(plugin_manager_->registerPluginFactory(std::make_shared<HotSwapTestFactory>()));
+    uint64_t first_generation = plugin_manager_->getPluginGeneration("hot_swap_plugin");
+    EXPECT_GT(first_generation, generation);
+    
+    EXPECT_TRUE(plugin_manager_->registerPluginFactory(std::make_shared<HotSwapTestFactory>()));
+    EXPECT_GT(plugin_manager_->getPluginGeneration("hot_swap_plugin"), first_generation);
+    
+    // 替换失败时保留原插件
+    auto plugin_dir = std::filesystem::temp_directory_path() / "algorithm_plugins_swap_test";
+    std::filesystem::create_directories(plugin_dir);
+    auto bad_library = plugin_dir / "libhot_swap_plugin.so";
+    std::ofstream(bad_library) << "not a shared object";
+    
+    uint64_t current_generation = plugin_manager_->getPluginGeneration("hot_swap_plugin");
+    EXPECT_FALSE(plugin_manager_->swapPluginLibrary("hot_swap_plugin", bad_library.string()));
+    EXPECT_TRUE(plugin_manager_->isPluginAvailable("hot_swap_plugin"));
+    EXPECT_EQ(plugin_manager_->getPluginGeneration("hot_swap_plugin"), current_generation);
+    EXPECT_TRUE(plugin_manager_->getDrainingLibraries().empty());
+    
+    EXPECT_TRUE(plugin_manager_->unregisterPlugin("hot_swap_plugin"));
+    EXPECT_GT(plugin_manager_->getRegistryGeneration(), current_generation);
+    
+    std::filesystem::remove_all(plugin_dir);
+}
+
+/**
+ * @brief 同一路径插件库热替换测试
+ */
+TEST_F(PluginBaseTest, PluginSamePathSwapTest) {
+    auto plugin_dir = std::filesystem::temp_directory_path() / "algorithm_plugins_same_path_swap_test";
+    std::filesystem::remove_all(plugin_dir);
+    std::filesystem::create_directories(plugin_dir);
+    std::string library_path = std::filesystem::weakly_canonical(plugin_dir / "libecho.so").string();
+    std::filesystem::copy_file(TEST_ECHO_PLUGIN_PATH, library_path);
+    
+    ASSERT_TRUE(plugin_manager_->loadPluginFromFile(library_path));
+    auto old_plugin = plugin_manager_->createPlugin("echo_test_plugin", test_params_);
+    ASSERT_NE(old_plugin, nullptr);
+    EXPECT_EQ(old_plugin->getVersion(), "1.0.0");
+    
+    // 文件未变化时同路径替换会得到同一映像，直接拒绝
+    uint64_t generation = plugin_manager_->getPluginGeneration("echo_test_plugin");
+    EXPECT_FALSE(plugin_manager_->swapPluginLibrary("echo_test_plugin", library_path));
+    EXPECT_EQ(plugin_manager_->getPluginGeneration("echo_test_plugin"), generation);
+    EXPECT_EQ(plugin_manager_->getLoadErrors().count(library_path), 1);
+    EXPECT_TRUE(plugin_manager_->getDrainingLibraries().empty());
+    
+    // 以重命名方式部署新版本，同路径替换从副本加载新代码
+    auto staged_path = plugin_dir / "libecho.so.staged";
+    std::filesystem::copy_file(TEST_ECHO_PLUGIN_V2_PATH, staged_path);
+    std::filesystem::rename(staged_path, library_path);
+    
+    ASSERT_TRUE(plugin_manager_->swapPluginLibrary("echo_test_plugin", library_path))
+        << plugin_manager_->getLoadErrors()[library_path];
+    EXPECT_GT(plugin_manager_->getPluginGeneration("echo_test_plugin"), generation);
+    EXPECT_EQ(plugin_manager_->getLoadedLibraries(), std::vector<std::string>{library_path});
+    EXPECT_EQ(plugin_manager_->getDrainingLibraries(), std::vector<std::string>{library_path});
+    
+    auto new_plugin = plugin_manager_->createPlugin("echo_test_plugin", test_params_);
+    ASSERT_NE(new_plugin, nullptr);
+    EXPECT_EQ(new_plugin->getVersion(), "2.0.0");
+    
+    // 旧实例继续运行旧代码，释放后旧映像卸载
+    auto input = TestDataHelper::createRealTimeData("device_swap");
+    auto old_output = std::make_shared<PluginResultImpl>();
+    auto new_output = std::make_shared<PluginResultImpl>();
+    ASSERT_TRUE(old_plugin->process(input, old_output));
+    ASSERT_TRUE(new_plugin->process(input, new_output));
+    EXPECT_EQ(old_output->getStringData("echo_version"), "1.0.0");
+    EXPECT_EQ(new_output->getStringData("echo_version"), "2.0.0");
+    
+    old_plugin.reset();
+    EXPECT_TRUE(plugin_manager_->getDrainingLibraries().empty());
+    
+    // 新版本已加载后再次同路径替换仍被拒绝
+    EXPECT_FALSE(plugin_manager_->swapPluginLibrary("echo_test_plugin", library_path));
+    
+    new_plugin.reset();
+    plugin_manager_->clearAllPlugins();
+    std::filesystem::remove_all(plugin_dir);
+}
+
 /**
  * @brief 插件链管理器测试
  */
 TEST_F(PluginBaseTest, PluginChainManagerTest) {
+    registerTestPlugins({"plugin1", "plugin2"});
     PluginChainManager chain_manager;
     
     // 创建插件链配置
-    PluginChainManager::ChainConfig config;
-    config.chain_name = "test_chain";
-    config.plugin_names = {"plugin1", "plugin2"};
+    auto config = chainConfig("test_chain", {"plugin1", "plugin2"});
     config.plugin_params = {test_params_, test_params_};
     
     // 测试插件链创建
@@ -220,6 +557,1117 @@ TEST_F(PluginBaseTest, PluginChainManagerTest) {
     EXPECT_FALSE(chain_manager.isChainAvailable("test_chain"));
 }
 
+/**
+ * @brief 插件链DAG执行测试
+ */
+TEST_F(PluginBaseTest, PluginChainGraphTest) {
+    registerTestPlugins({"chain_vibration", "chain_current", "chain_health"});
+    PluginChainManager chain_manager;
+    
+    // 两个特征插件并行执行后汇合到健康评估插件
+    auto config = chainConfig("fan_in_chain", {"chain_vibration", "chain_current", "chain_health"}, {
+        {"chain_vibration->chain_health", "*"},
+        {"chain_current->chain_health", "chain_current_value"}
+    });
+    EXPECT_TRUE(chain_manager.createChain(config));
+    
+    auto input_data = TestDataHelper::createFeatureData();
+    auto output_result = std::make_shared<PluginResultImpl>();
+    EXPECT_TRUE(chain_manager.executeChain("fan_in_chain", input_data, output_result));
+    
+    // 根节点接收链输入，汇合节点接收上游结果：chain_vibration的2个数值结果和chain_current的1个指定结果
+    EXPECT_EQ(output_result->getIntData("chain_vibration"), 3);
+    EXPECT_EQ(output_result->getIntData("chain_current"), 3);
+    EXPECT_EQ(output_result->getIntData("chain_health"), 3);
+    
+    // 环路和未知插件映射的链执行失败
+    config.chain_name = "cyclic_chain";
+    config.data_mappings["chain_health->chain_vibration"] = "";
+    EXPECT_TRUE(chain_manager.createChain(config));
+    EXPECT_FALSE(chain_manager.executeChain("cyclic_chain", input_data, output_result));
+    
+    EXPECT_TRUE(chain_manager.setDataMapping("fan_in_chain", "chain_vibration", "missing_plugin", ""));
+    EXPECT_FALSE(chain_manager.executeChain("fan_in_chain", input_data, output_result));
+}
+
+/**
+ * @brief 插件链执行计划重新编译测试
+ */
+TEST_F(PluginBaseTest, PluginChainPlanTest) {
+    registerTestPlugins({"plan_first", "plan_second"});
+    PluginChainManager chain_manager;
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("plan_chain", {"plan_first", "plan_second"})));
+    
+    auto input_data = TestDataHelper::createFeatureData();
+    auto output_result = std::make_shared<PluginResultImpl>();
+    EXPECT_TRUE(chain_manager.executeChain("plan_chain", input_data, output_result));
+    EXPECT_TRUE(output_result->hasData("plan_first"));
+    EXPECT_TRUE(output_result->hasData("plan_second"));
+    
+    // 修改链配置后按新的执行计划执行
+    EXPECT_TRUE(chain_manager.removePluginFromChain("plan_chain", "plan_second"));
+    output_result = std::make_shared<PluginResultImpl>();
+    EXPECT_TRUE(chain_manager.executeChain("plan_chain", input_data, output_result));
+    EXPECT_TRUE(output_result->hasData("plan_first"));
+    EXPECT_FALSE(output_result->hasData("plan_second"));
+    
+    EXPECT_TRUE(chain_manager.addPluginToChain("plan_chain", "plan_second", nullptr));
+    EXPECT_TRUE(chain_manager.setDataMapping("plan_chain", "plan_first", "plan_second", "plan_first"));
+    output_result = std::make_shared<PluginResultImpl>();
+    EXPECT_TRUE(chain_manager.executeChain("plan_chain", input_data, output_result));
+    EXPECT_EQ(output_result->getIntData("plan_second"), 1);
+}
+
+/**
+ * @brief 插件链按设备并发执行测试
+ */
+TEST_F(PluginBaseTest, PluginChainDeviceInstanceTest) {
+    registerTestPlugins({"chain_device"});
+    PluginChainManager chain_manager;
+    auto config = chainConfig("device_chain", {"chain_device"});
+    EXPECT_TRUE(chain_manager.createChain(config));
+    
+    // 每个设备独占一套插件实例，不同设备并发执行
+    std::vector<std::thread> workers;
+    std::atomic<int> success_count{0};
+    for (int device = 0; device < 4; ++device) {
+        workers.emplace_back([&chain_manager, &success_count, device] {
+            for (int i = 0; i < 50; ++i) {
+                if (runChain(chain_manager, "device_chain", "device_" + std::to_string(device))) {
+                    ++success_count;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(success_count.load(), 200);
+    EXPECT_EQ(chain_manager.getChainInstanceSetCount("device_chain"), 4);
+    
+    // 分片模式下实例集合数量不超过分片数
+    config.chain_name = "sharded_chain";
+    config.instance_shards = 2;
+    EXPECT_TRUE(chain_manager.createChain(config));
+    for (int device = 0; device < 8; ++device) {
+        EXPECT_TRUE(runChain(chain_manager, "sharded_chain", "device_" + std::to_string(device)));
+    }
+    EXPECT_LE(chain_manager.getChainInstanceSetCount("sharded_chain"), 2);
+}
+
+/**
+ * @brief 空闲实例集合回收测试
+ */
+TEST_F(PluginBaseTest, PluginChainIdleReleaseTest) {
+    TestPluginOptions counting;
+    counting.counting = true;
+    registerTestPlugins({"idle_counter"}, counting);
+    PluginChainManager chain_manager;
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("idle_chain", {"idle_counter"})));
+    
+    auto count_of = [&chain_manager](const std::string& device_id) {
+        auto output = runChain(chain_manager, "idle_chain", device_id);
+        return output ? output->getIntData("idle_counter_count") : -1;
+    };
+    for (int device = 0; device < 5; ++device) {
+        EXPECT_EQ(count_of("idle_device_" + std::to_string(device)), 1);
+    }
+    EXPECT_EQ(count_of("idle_device_0"), 2);
+    EXPECT_EQ(chain_manager.getChainInstanceSetCount("idle_chain"), 5);
+    
+    // 未超过空闲时长的集合保留
+    EXPECT_EQ(chain_manager.releaseIdleInstanceSets(std::chrono::hours(1)), 0);
+    EXPECT_EQ(chain_manager.getChainInstanceSetCount("idle_chain"), 5);
+    
+    // 回收后设备再次出现时重新创建实例，历史状态从头开始
+    EXPECT_EQ(chain_manager.releaseIdleInstanceSets(std::chrono::steady_clock::duration::zero()), 5);
+    EXPECT_EQ(chain_manager.getChainInstanceSetCount("idle_chain"), 0);
+    EXPECT_EQ(count_of("idle_device_0"), 1);
+    EXPECT_EQ(chain_manager.getChainInstanceSetCount("idle_chain"), 1);
+}
+
+/**
+ * @brief 工作窃取调度器测试
+ */
+TEST_F(PluginBaseTest, TaskSchedulerTest) {
+    TaskScheduler scheduler(2);
+    EXPECT_EQ(scheduler.getThreadCount(), 2);
+    EXPECT_FALSE(scheduler.isWorkerThread());
+    
+    // 嵌套任务组在工作线程内创建，等待期间协助执行不会耗尽线程
+    std::atomic<int> leaf_count{0};
+    {
+        TaskGroup outer(scheduler);
+        for (int i = 0; i < 8; ++i) {
+            outer.run([&scheduler, &leaf_count] {
+                TaskGroup inner(scheduler, TaskPriority::HIGH);
+                for (int j = 0; j < 16; ++j) {
+                    inner.run([&leaf_count] { ++leaf_count; });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+    }
+    EXPECT_EQ(leaf_count.load(), 128);
+    
+    // 任务异常在wait中重新抛出
+    TaskGroup failing(scheduler, TaskPriority::LOW);
+    failing.run([] { throw std::runtime_error("task failed"); });
+    EXPECT_THROW(failing.wait(), std::runtime_error);
+    
+    // parallelFor覆盖整个区间且各块互不重叠
+    std::vector<int> hits(1000, 0);
+    parallelFor(0, hits.size(), 7, [&hits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            hits[i]++;
+        }
+    });
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 1000);
+}
+
+/**
+ * @brief 插件链批量执行测试
+ */
+TEST_F(PluginBaseTest, PluginChainBatchTest) {
+    registerTestPlugins({"batch_first", "batch_second"});
+    
+    // 默认批量实现逐条调用process
+    auto plugin = plugin_manager_->createPlugin("batch_first");
+    ASSERT_NE(plugin, nullptr);
+    std::vector<std::shared_ptr<PluginData>> inputs;
+    std::vector<std::shared_ptr<PluginResult>> outputs;
+    for (int i = 0; i < 6; ++i) {
+        inputs.push_back(TestDataHelper::createFeatureData("device_" + std::to_string(i % 3)));
+        outputs.push_back(std::make_shared<PluginResultImpl>());
+    }
+    std::vector<bool> succeeded;
+    EXPECT_TRUE(plugin->processBatch(inputs, outputs, succeeded));
+    EXPECT_EQ(succeeded, std::vector<bool>(6, true));
+    EXPECT_TRUE(outputs[5]->hasData("batch_first"));
+    
+    // 输入输出数量不一致时整批失败
+    EXPECT_FALSE(plugin->processBatch(inputs, {outputs[0]}, succeeded));
+    EXPECT_EQ(succeeded, std::vector<bool>(6, false));
+    
+    PluginChainManager chain_manager;
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("batch_chain", {"batch_first", "batch_second"})));
+    
+    // 多设备混合的批量数据按设备分组执行
+    for (auto& output : outputs) {
+        output = std::make_shared<PluginResultImpl>();
+    }
+    EXPECT_TRUE(chain_manager.executeChainBatch("batch_chain", inputs, outputs, succeeded));
+    EXPECT_EQ(succeeded, std::vector<bool>(6, true));
+    for (const auto& output : outputs) {
+        EXPECT_TRUE(output->hasData("batch_first"));
+        EXPECT_TRUE(output->hasData("batch_second"));
+    }
+    EXPECT_EQ(chain_manager.getChainInstanceSetCount("batch_chain"), 3);
+    
+    // DAG链同样支持批量执行
+    EXPECT_TRUE(chain_manager.setDataMapping("batch_chain", "batch_first", "batch_second", "batch_first"));
+    for (auto& output : outputs) {
+        output = std::make_shared<PluginResultImpl>();
+    }
+    EXPECT_TRUE(chain_manager.executeChainBatch("batch_chain", inputs, outputs, succeeded));
+    EXPECT_EQ(outputs[0]->getIntData("batch_second"), 1);
+    
+    EXPECT_FALSE(chain_manager.executeChainBatch("missing_chain", inputs, outputs, succeeded));
+}
+
+/**
+ * @brief 插件链异步执行测试
+ */
+TEST_F(PluginBaseTest, PluginChainAsyncTest) {
+    registerTestPlugins({"chain_async"});
+    PluginChainManager chain_manager;
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("async_chain", {"chain_async"})));
+    
+    AsyncChainExecutor::Options options;
+    options.worker_count = 1;
+    options.queue_capacity = 2;
+    options.overflow_policy = AsyncChainExecutor::OverflowPolicy::REJECT;
+    AsyncChainExecutor executor(chain_manager, options);
+    EXPECT_EQ(executor.getWorkerCount(), 1);
+    
+    // 阻塞唯一的工作线程后填满队列
+    std::promise<void> gate;
+    std::shared_future<void> gate_future = gate.get_future().share();
+    std::promise<void> started;
+    EXPECT_TRUE(executor.submitTask([gate_future, &started] {
+        started.set_value();
+        gate_future.wait();
+    }));
+    started.get_future().wait();
+    
+    auto input_data = TestDataHelper::createFeatureData();
+    auto output_result = std::make_shared<PluginResultImpl>();
+    std::future<bool> result;
+    EXPECT_TRUE(executor.submit("async_chain", input_data, output_result, result));
+    
+    std::atomic<bool> callback_success{false};
+    EXPECT_TRUE(executor.submit("missing_chain", input_data, std::make_shared<PluginResultImpl>(),
+        [&callback_success](bool success, std::shared_ptr<PluginResult>) {
+            callback_success = !success;
+        }));
+    EXPECT_EQ(executor.getQueueDepth(), 2);
+    
+    // 队列已满时拒绝
+    std::future<bool> rejected;
+    EXPECT_FALSE(executor.submit("async_chain", input_data, std::make_shared<PluginResultImpl>(), rejected));
+    EXPECT_EQ(executor.getRejectedCount(), 1);
+    
+    gate.set_value();
+    EXPECT_TRUE(result.get());
+    EXPECT_TRUE(output_result->hasData("chain_async"));
+    
+    // 停止时等待已入队的请求完成，之后不再接收请求
+    executor.shutdown();
+    EXPECT_TRUE(callback_success.load());
+    EXPECT_EQ(executor.getCompletedCount(), 3);
+    EXPECT_FALSE(executor.submitTask([] {}));
+    
+    // 默认并发上限等于共享调度器线程数，执行器不创建自己的线程
+    AsyncChainExecutor shared_executor(chain_manager);
+    EXPECT_EQ(shared_executor.getWorkerCount(), TaskScheduler::getInstance().getThreadCount());
+    
+    std::atomic<int> executed{0};
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(shared_executor.submitTask([&executed] { executed++; }));
+    }
+    shared_executor.shutdown();
+    EXPECT_EQ(executed.load(), 100);
+    EXPECT_EQ(shared_executor.getCompletedCount(), 100);
+}
+
+TEST_F(PluginBaseTest, PluginChainAsyncOrderingTest) {
+    registerTestPlugins({"ordered_async"});
+    PluginChainManager chain_manager;
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("ordered_chain", {"ordered_async"})));
+    
+    // 独立调度器提供多个线程，单核环境下也有多个排空任务并发
+    TaskScheduler scheduler(4);
+    AsyncChainExecutor::Options options;
+    options.worker_count = 4;
+    options.scheduler = &scheduler;
+    AsyncChainExecutor executor(chain_manager, options);
+    
+    // 同一设备的插件链请求按提交顺序完成
+    const int kDevices = 3;
+    const int kRequestsPerDevice = 50;
+    std::mutex order_mutex;
+    std::map<std::string, std::vector<int>> completion_order;
+    for (int i = 0; i < kDevices * kRequestsPerDevice; ++i) {
+        std::string device_id = "device_" + std::to_string(i % kDevices);
+        EXPECT_TRUE(executor.submit("ordered_chain", TestDataHelper::createFeatureData(device_id),
+            std::make_shared<PluginResultImpl>(),
+            [&, device_id, i](bool success, std::shared_ptr<PluginResult>) {
+                EXPECT_TRUE(success);
+                std::lock_guard<std::mutex> lock(order_mutex);
+                completion_order[device_id].push_back(i);
+            }));
+    }
+    
+    // 同一排序键的任务不会并发执行，不同键可以并发
+    std::atomic<int> in_flight[kDevices] = {};
+    std::atomic<bool> overlapped{false};
+    for (int i = 0; i < kDevices * 20; ++i) {
+        int key = i % kDevices;
+        EXPECT_TRUE(executor.submitTask("key_" + std::to_string(key), [&, key] {
+            if (in_flight[key].fetch_add(1) != 0) {
+                overlapped = true;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            in_flight[key].fetch_sub(1);
+        }));
+    }
+    
+    executor.shutdown();
+    EXPECT_FALSE(overlapped.load());
+    EXPECT_EQ(executor.getCompletedCount(), static_cast<uint64_t>(kDevices * (kRequestsPerDevice + 20)));
+    EXPECT_EQ(completion_order.size(), static_cast<size_t>(kDevices));
+    for (const auto& [device_id, order] : completion_order) {
+        EXPECT_EQ(order.size(), static_cast<size_t>(kRequestsPerDevice));
+        EXPECT_TRUE(std::is_sorted(order.begin(), order.end())) << device_id;
+    }
+}
+
+TEST_F(PluginBaseTest, PluginChainSyncAsyncSameDeviceTest) {
+    // 并行分支的链在持有设备锁时等待节点任务组，等待期间不得执行同一设备的异步排空任务
+    PluginChainManager chain_manager;
+    AsyncChainExecutor executor(chain_manager);
+    std::atomic<int> submitted{0};
+    std::atomic<int> async_success{0};
+    const int kRequests = 20;
+    
+    // 右分支在工作线程上执行时提交同一设备的异步请求，并停顿到当前线程进入等待之后
+    TestPluginOptions left_options;
+    left_options.on_process = [](const std::string&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    };
+    TestPluginOptions right_options;
+    right_options.on_process = [&](const std::string& device_id) {
+        if (submitted.fetch_add(1) < kRequests) {
+            EXPECT_TRUE(executor.submit("mixed_chain", TestDataHelper::createFeatureData(device_id),
+                std::make_shared<PluginResultImpl>(),
+                [&async_success](bool success, std::shared_ptr<PluginResult>) {
+                    if (success) {
+                        ++async_success;
+                    }
+                }));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    };
+    registerTestPlugins({"mixed_left", "mixed_join"}, left_options);
+    registerTestPlugins({"mixed_right"}, right_options);
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("mixed_chain", {"mixed_left", "mixed_right", "mixed_join"}, {
+        {"mixed_left->mixed_join", "*"},
+        {"mixed_right->mixed_join", "*"}
+    })));
+    
+    for (int i = 0; i < kRequests; ++i) {
+        EXPECT_TRUE(runChain(chain_manager, "mixed_chain", "device_0"));
+    }
+    
+    executor.shutdown();
+    EXPECT_EQ(async_success.load(), std::min(submitted.load(), kRequests));
+}
+
+/**
+ * @brief 插件链流水线执行测试
+ */
+TEST_F(PluginBaseTest, PluginChainPipelineTest) {
+    registerTestPlugins({"pipe_feature", "pipe_decision", "pipe_evaluation"});
+    auto config = chainConfig("pipe_chain", {"pipe_feature", "pipe_decision", "pipe_evaluation"});
+    
+    // DAG链不支持流水线模式
+    PipelinedChainExecutor dag_pipeline;
+    config.data_mappings["pipe_feature->pipe_decision"] = "";
+    EXPECT_FALSE(dag_pipeline.start(config));
+    config.data_mappings.clear();
+    
+    // 有状态插件的历史会与插件链管理器中的实例分叉，不允许进入流水线
+    TestPluginOptions counting;
+    counting.counting = true;
+    registerTestPlugins({"pipe_counter"}, counting);
+    PipelinedChainExecutor stateful_pipeline;
+    EXPECT_FALSE(stateful_pipeline.start(chainConfig("pipe_stateful", {"pipe_feature", "pipe_counter"})));
+    EXPECT_NE(stateful_pipeline.getLastError().find("pipe_counter"), std::string::npos);
+    
+    PluginMonitorManager monitor_manager;
+    PipelinedChainExecutor pipeline(8);
+    pipeline.setMonitor(&monitor_manager);
+    ASSERT_TRUE(pipeline.start(config));
+    EXPECT_EQ(pipeline.getStageCount(), 3);
+    
+    // 同一设备的数据按提交顺序完成
+    std::mutex order_mutex;
+    std::map<std::string, std::vector<int>> completion_order;
+    std::atomic<int> success_count{0};
+    for (int reading = 0; reading < 30; ++reading) {
+        std::string device_id = "device_" + std::to_string(reading % 3);
+        auto input_data = TestDataHelper::createFeatureData(device_id);
+        auto output_result = std::make_shared<PluginResultImpl>();
+        auto on_complete = [&, device_id, reading](bool success, std::shared_ptr<PluginResult> result) {
+            if (success && result->hasData("pipe_evaluation")) {
+                ++success_count;
+            }
+            std::lock_guard<std::mutex> lock(order_mutex);
+            completion_order[device_id].push_back(reading);
+        };
+        
+        // 第一级队列满时稍后重试
+        while (!pipeline.submit(input_data, output_result, on_complete)) {
+            std::this_thread::yield();
+        }
+    }
+    
+    std::future<bool> result;
+    while (!pipeline.submit(TestDataHelper::createFeatureData(), std::make_shared<PluginResultImpl>(), result)) {
+        std::this_thread::yield();
+    }
+    EXPECT_TRUE(result.get());
+    
+    pipeline.stop();
+    EXPECT_FALSE(pipeline.isRunning());
+    EXPECT_EQ(success_count.load(), 30);
+    for (const auto& [device_id, order] : completion_order) {
+        EXPECT_EQ(order.size(), 10);
+        EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+    }
+    
+    // 各级执行时间按"链/插件"记录，与插件链管理器一致
+    EXPECT_EQ(monitor_manager.getStageMetrics("pipe_chain", "pipe_decision").execution_count, 31);
+    EXPECT_FALSE(pipeline.submit(TestDataHelper::createFeatureData(), std::make_shared<PluginResultImpl>(), result));
+}
+
+/**
+ * @brief 纯插件结果缓存测试
+ */
+TEST_F(PluginBaseTest, PluginChainResultCacheTest) {
+    TestPluginOptions pure;
+    pure.pure = true;
+    registerTestPlugins({"cache_pure"}, pure);
+    registerTestPlugins({"cache_plain"});
+    
+    // 内容哈希不含设备ID和时间戳
+    uint64_t first_hash = 0;
+    uint64_t second_hash = 0;
+    EXPECT_TRUE(TestDataHelper::createBatchData("device_a")->getContentHash(first_hash));
+    EXPECT_TRUE(TestDataHelper::createBatchData("device_b")->getContentHash(second_hash));
+    EXPECT_EQ(first_hash, second_hash);
+    auto changed = TestDataHelper::createBatchData("device_a");
+    changed->setSamplingRate(2000);
+    EXPECT_TRUE(changed->getContentHash(second_hash));
+    EXPECT_NE(first_hash, second_hash);
+    
+    PluginChainManager chain_manager;
+    auto& cache = chain_manager.getResultCache();
+    cache.setCapacity(2);
+    
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("cache_chain", {"cache_pure", "cache_plain"})));
+    
+    // 不同设备的相同数据只计算一次纯插件，非纯插件每次都执行
+    TestPlugin::process_count = 0;
+    for (const auto& device_id : {"device_0", "device_1", "device_0"}) {
+        auto output = runChain(chain_manager, "cache_chain", device_id);
+        ASSERT_NE(output, nullptr);
+        EXPECT_EQ(output->getIntData("cache_pure"), 3);
+        EXPECT_TRUE(output->hasData("cache_plain"));
+    }
+    EXPECT_EQ(TestPlugin::process_count.load(), 4);
+    EXPECT_EQ(cache.getHitCount(), 2);
+    EXPECT_EQ(cache.getMissCount(), 1);
+    
+    // 批量执行同样使用缓存，超出容量时淘汰最久未使用的结果
+    std::vector<std::shared_ptr<PluginData>> inputs;
+    std::vector<std::shared_ptr<PluginResult>> outputs;
+    inputs.push_back(TestDataHelper::createFeatureData("device_0"));
+    outputs.push_back(std::make_shared<PluginResultImpl>());
+    for (int i = 1; i < 4; ++i) {
+        auto input = TestDataHelper::createFeatureData("device_" + std::to_string(i));
+        input->setFeature("reading", i);
+        inputs.push_back(input);
+        outputs.push_back(std::make_shared<PluginResultImpl>());
+    }
+    
+    std::vector<bool> succeeded;
+    TestPlugin::process_count = 0;
+    EXPECT_TRUE(chain_manager.executeChainBatch("cache_chain", inputs, outputs, succeeded));
+    EXPECT_EQ(succeeded, std::vector<bool>(4, true));
+    EXPECT_EQ(outputs[0]->getIntData("cache_pure"), 3);
+    EXPECT_EQ(outputs[3]->getIntData("cache_pure"), 4);
+    EXPECT_EQ(TestPlugin::process_count.load(), 7);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.getEvictionCount(), 2);
+    
+    // 容量为0时禁用缓存
+    cache.setCapacity(0);
+    EXPECT_EQ(cache.size(), 0);
+    TestPlugin::process_count = 0;
+    EXPECT_TRUE(runChain(chain_manager, "cache_chain"));
+    EXPECT_EQ(TestPlugin::process_count.load(), 2);
+}
+
+/**
+ * @brief 按设备划分的状态存储测试
+ */
+TEST_F(PluginBaseTest, DeviceStateStoreTest) {
+    auto& registry = DeviceRegistry::getInstance();
+    EXPECT_EQ(registry.getHandle(""), 0);
+    
+    // 同一设备ID始终对应同一句柄
+    DeviceHandle first = registry.getHandle("state_device_a");
+    DeviceHandle second = registry.getHandle("state_device_b");
+    EXPECT_NE(first, second);
+    EXPECT_EQ(registry.getHandle("state_device_a"), first);
+    EXPECT_EQ(registry.getDeviceId(second), "state_device_b");
+    DeviceHandle found = 0;
+    EXPECT_TRUE(registry.findHandle("state_device_b", found));
+    EXPECT_EQ(found, second);
+    EXPECT_FALSE(registry.findHandle("state_device_missing", found));
+    
+    // 槽位按需创建，各设备状态互不影响
+    struct CounterState {
+        int count = 0;
+    };
+    DeviceStateStore<CounterState> store;
+    EXPECT_EQ(store.find(first), nullptr);
+    CounterState* first_state = &store.get(first);
+    for (int reading = 0; reading < 3; ++reading) {
+        store.get(first).count++;
+    }
+    store.get(second).count++;
+    EXPECT_EQ(store.size(), 2);
+    EXPECT_EQ(store.get(first).count, 3);
+    EXPECT_EQ(store.get(second).count, 1);
+    
+    // 大量设备扩容后已有状态地址不变
+    store.get(10000).count = 7;
+    EXPECT_EQ(&store.get(first), first_state);
+    EXPECT_EQ(store.find(10000)->count, 7);
+    
+    size_t visited = 0;
+    store.forEach([&visited](DeviceHandle, CounterState&) { ++visited; });
+    EXPECT_EQ(visited, 3);
+    
+    store.reset(first);
+    EXPECT_EQ(first_state->count, 0);
+    store.resetAll();
+    EXPECT_EQ(store.get(10000).count, 0);
+    EXPECT_EQ(store.size(), 3);
+}
+
+/**
+ * @brief 定容环形缓冲区测试
+ */
+TEST_F(PluginBaseTest, RingBufferTest) {
+    RingBuffer<int> buffer(4);
+    for (int i = 0; i < 6; ++i) {
+        buffer.push_back(i);
+    }
+    
+    // 写满后覆盖最早的元素，按写入顺序分为两段连续内存
+    EXPECT_TRUE(buffer.full());
+    EXPECT_EQ(buffer.front(), 2);
+    EXPECT_EQ(buffer.back(), 5);
+    auto [first, second] = buffer.spans();
+    EXPECT_EQ(std::vector<int>(first.begin(), first.end()), std::vector<int>({2, 3}));
+    EXPECT_EQ(std::vector<int>(second.begin(), second.end()), std::vector<int>({4, 5}));
+    
+    // 从头部移除后继续追加
+    buffer.pop_front(3);
+    buffer.push_back(6);
+    std::vector<int> values;
+    buffer.copyTo(values);
+    EXPECT_EQ(values, std::vector<int>({5, 6}));
+    
+    // 缩小容量时保留最新的元素
+    buffer.push_back(7);
+    buffer.setCapacity(2);
+    buffer.copyTo(values);
+    EXPECT_EQ(values, std::vector<int>({6, 7}));
+    
+    buffer.clear();
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.capacity(), 2);
+}
+
+/**
+ * @brief 增量统计量测试
+ */
+TEST_F(PluginBaseTest, StreamingStatisticsTest) {
+    // 随定容窗口滑动，与对窗口数据直接计算的结果一致
+    RingBuffer<double> window(16);
+    WindowStatistics statistics;
+    statistics.setTrackMedian(true);
+    EXPECT_TRUE(statistics.supports("median"));
+    EXPECT_FALSE(statistics.supports("kurtosis"));
+    
+    for (int i = 0; i < 200; ++i) {
+        double value = static_cast<double>((i * 37) % 23) * 0.5;
+        if (window.full()) {
+            statistics.popFront(window.front());
+        }
+        window.push_back(value);
+        statistics.push(value);
+        
+        std::vector<double> data;
+        window.copyTo(data);
+        double mean = std::accumulate(data.begin(), data.end(), 0.0) / data.size();
+        double sum_sq = 0.0;
+        for (double x : data) {
+            sum_sq += (x - mean) * (x - mean);
+        }
+        std::vector<double> sorted = data;
+        std::sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        double median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+        
+        EXPECT_NEAR(statistics.get("mean"), mean, 1e-9);
+        if (n > 1) {
+            EXPECT_NEAR(statistics.get("std"), std::sqrt(sum_sq / (n - 1)), 1e-9);
+        }
+        EXPECT_EQ(statistics.get("max"), sorted.back());
+        EXPECT_EQ(statistics.get("min"), sorted.front());
+        EXPECT_EQ(statistics.get("median"), median);
+    }
+    
+    // 重建与逐条更新的结果一致
+    WindowStatistics rebuilt;
+    rebuilt.setTrackMedian(true);
+    rebuilt.rebuild(window);
+    EXPECT_EQ(rebuilt.size(), window.size());
+    EXPECT_EQ(rebuilt.get("median"), statistics.get("median"));
+    EXPECT_NEAR(rebuilt.get("std"), statistics.get("std"), 1e-9);
+    
+    statistics.clear();
+    EXPECT_EQ(statistics.size(), 0);
+    EXPECT_EQ(statistics.get("mean"), 0.0);
+}
+
+/**
+ * @brief 分位数截断测试：与整体排序后按位置取界的结果逐元素一致
+ */
+TEST_F(PluginBaseTest, ClampToPercentilesTest) {
+    auto reference = [](std::vector<double> data, double lower_fraction, double upper_fraction) {
+        if (data.empty()) {
+            return data;
+        }
+        std::vector<double> sorted = data;
+        std::sort(sorted.begin(), sorted.end());
+        const size_t n = sorted.size();
+        const double lower = sorted[static_cast<size_t>(n * lower_fraction)];
+        const double upper = sorted[static_cast<size_t>(n * upper_fraction)];
+        for (double& value : data) {
+            value = std::min(std::max(value, lower), upper);
+        }
+        return data;
+    };
+    
+    const double inf = std::numeric_limits<double>::infinity();
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> few_values(0, 3);
+    std::uniform_real_distribution<double> spread(-1000.0, 1000.0);
+    
+    // n从0到60覆盖奇偶长度，以及n < 20时下界取最小值的情况
+    for (size_t n = 0; n <= 60; ++n) {
+        std::vector<std::vector<double>> cases(4);
+        for (size_t i = 0; i < n; ++i) {
+            cases[0].push_back(few_values(rng));                          // 大量重复值
+            cases[1].push_back(spread(rng));                              // 互不相同
+            cases[2].push_back(i % 2 ? inf : -inf);                       // 只有两端极值
+            cases[3].push_back(i == 0 ? -inf : i + 1 == n ? inf : 5.0);   // 极值与常数
+        }
+        for (const auto& data : cases) {
+            std::vector<double> clamped = data;
+            clampToPercentiles(clamped.begin(), clamped.end(), 0.05, 0.95);
+            EXPECT_EQ(clamped, reference(data, 0.05, 0.95)) << "n=" << n;
+        }
+    }
+    
+    // 只截断子区间，区间外的数据不变
+    std::vector<double> data = {100.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, -100.0};
+    clampToPercentiles(data.begin() + 1, data.end() - 1, 0.1, 0.8);
+    EXPECT_EQ(data, (std::vector<double>{100.0, 2.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 9.0, -100.0}));
+}
+
+/**
+ * @brief 平滑核测试
+ */
+TEST_F(PluginBaseTest, SmoothingKernelTest) {
+    const std::vector<double> data = {5, 1, 4, 2, 8, 7, 3, 6, 0, 9};
+    
+    // 与逐点取窗口直接计算的结果一致，两端不足半个窗口的点保持原值
+    auto reference = [&data](int win_length, const std::string& func) {
+        std::vector<double> expected = data;
+        const int half = win_length / 2;
+        for (int i = half; i + half < static_cast<int>(data.size()); ++i) {
+            std::vector<double> window(data.begin() + i - half, data.begin() + i + half + 1);
+            std::sort(window.begin(), window.end());
+            if (func == "mean") {
+                expected[i] = std::accumulate(window.begin(), window.end(), 0.0) / window.size();
+            } else if (func == "min") {
+                expected[i] = window.front();
+            } else if (func == "max") {
+                expected[i] = window.back();
+            } else {
+                size_t n = window.size();
+                expected[i] = n % 2 ? window[n / 2] : (window[n / 2 - 1] + window[n / 2]) / 2.0;
+            }
+        }
+        return expected;
+    };
+    
+    for (const std::string func : {"mean", "min", "max", "median"}) {
+        for (int win_length : {2, 3, 5}) {
+            auto spec = SmoothingSpec::parse({{"func", func}, {"win_length", std::to_string(win_length)}});
+            EXPECT_TRUE(spec.enabled());
+            std::vector<double> smoothed;
+            SmoothingKernel::apply(spec, data, smoothed);
+            auto expected = reference(win_length, func);
+            for (size_t i = 0; i < data.size(); ++i) {
+                EXPECT_NEAR(smoothed[i], expected[i], 1e-12) << func << " " << win_length << " " << i;
+            }
+        }
+    }
+    
+    // 窗口不短于数据或参数不完整时不平滑
+    std::vector<double> unchanged;
+    SmoothingKernel::apply(SmoothingSpec::parse({{"func", "mean"}, {"win_length", "10"}}), data, unchanged);
+    EXPECT_EQ(unchanged, data);
+    EXPECT_FALSE(SmoothingSpec::parse({{"func", "mean"}}).enabled());
+    EXPECT_FALSE(SmoothingSpec::parse({{"win_length", "3"}}).enabled());
+    
+    // ewma从第一个点开始递推
+    std::vector<double> ewma;
+    SmoothingKernel::apply(SmoothingSpec::parse({{"func", "ewma"}, {"alpha", "0.5"}}), {2, 4, 8}, ewma);
+    EXPECT_EQ(ewma, std::vector<double>({2, 3, 5.5}));
+}
+
+/**
+ * @brief 健康度公式测试
+ */
+TEST_F(PluginBaseTest, HealthFormulaTest) {
+    FormulaSymbols symbols;
+    HealthFormula formula;
+    std::string error;
+    
+    // 运算符优先级、右结合的乘方和函数调用
+    ASSERT_TRUE(formula.compile("0.6 * vibration_health + 0.4 * min(current_health, 90) - 2 ^ -1", symbols, error)) << error;
+    size_t vibration = 0;
+    size_t current = 0;
+    ASSERT_TRUE(symbols.find("vibration_health", vibration));
+    ASSERT_TRUE(symbols.find("current_health", current));
+    EXPECT_EQ(formula.getReferencedSlots().size(), 2u);
+    
+    std::vector<double> slots(symbols.size());
+    slots[vibration] = 80.0;
+    slots[current] = 95.0;
+    EXPECT_DOUBLE_EQ(formula.evaluate(slots.data()), 0.6 * 80.0 + 0.4 * 90.0 - 0.5);
+    
+    // 常量在编译期折叠
+    HealthFormula constant;
+    ASSERT_TRUE(constant.compile("clamp(1 + 2 * 3, 0, 5) + avg(1, 2, 3)", symbols, error)) << error;
+    EXPECT_TRUE(constant.isConstant());
+    EXPECT_DOUBLE_EQ(constant.evaluate(nullptr), 7.0);
+    
+    // 缺失的特征为NaN并传播到结果
+    slots[current] = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_TRUE(std::isnan(formula.evaluate(slots.data())));
+    
+    // 列式批量求值与逐点求值一致
+    const size_t count = 5;
+    std::vector<double> columns(symbols.size() * count);
+    for (size_t i = 0; i < count; ++i) {
+        columns[vibration * count + i] = 60.0 + 10.0 * i;
+        columns[current * count + i] = 100.0 - 7.0 * i;
+    }
+    std::vector<double> results(count);
+    formula.evaluateBatch(columns.data(), count, results.data());
+    for (size_t i = 0; i < count; ++i) {
+        slots[vibration] = columns[vibration * count + i];
+        slots[current] = columns[current * count + i];
+        EXPECT_DOUBLE_EQ(results[i], formula.evaluate(slots.data())) << i;
+    }
+    
+    // 语法错误在编译时报告
+    HealthFormula invalid;
+    EXPECT_FALSE(invalid.compile("(vibration_health + 1", symbols, error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(invalid.compile("unknown(vibration_health)", symbols, error));
+    EXPECT_FALSE(invalid.compile("clamp(vibration_health, 0)", symbols, error));
+    EXPECT_FALSE(invalid.compile("vibration_health current_health", symbols, error));
+    EXPECT_FALSE(invalid.isCompiled());
+    
+    // 一元正号和连续乘方的深层递归在解析时拒绝，不耗尽栈
+    HealthFormula deep;
+    EXPECT_FALSE(deep.compile(std::string(1000000, '+') + "1", symbols, error));
+    EXPECT_NE(error.find("表达式嵌套过深"), std::string::npos) << error;
+    
+    std::string power_chain;
+    for (size_t i = 0; i < 200000; ++i) {
+        power_chain += "vibration_health^";
+    }
+    power_chain += "vibration_health";
+    EXPECT_FALSE(deep.compile(power_chain, symbols, error));
+    EXPECT_NE(error.find("表达式嵌套过深"), std::string::npos) << error;
+    
+    // 左结合的长链同样计入深度上限
+    for (const char* op : {"+", "*"}) {
+        std::string binary_chain = "vibration_health";
+        for (size_t i = 0; i < 50000; ++i) {
+            binary_chain += op;
+            binary_chain += "vibration_health";
+        }
+        EXPECT_FALSE(deep.compile(binary_chain, symbols, error)) << op;
+        EXPECT_NE(error.find("表达式嵌套过深"), std::string::npos) << error;
+    }
+    
+    // 限制以内的嵌套仍可编译
+    EXPECT_TRUE(deep.compile("+ + -2 ^ 2 ^ vibration_health", symbols, error)) << error;
+    std::string short_chain = "vibration_health";
+    for (size_t i = 0; i < 100; ++i) {
+        short_chain += "+current_health*2";
+    }
+    EXPECT_TRUE(deep.compile(short_chain, symbols, error)) << error;
+}
+
+/**
+ * @brief 长期平滑测试
+ */
+TEST_F(PluginBaseTest, LongTermSmoothingTest) {
+    const auto start = std::chrono::system_clock::time_point{} + std::chrono::hours(24);
+    
+    // 按半衰期衰减，多个速率同时维护；采样间隔不影响时间尺度
+    auto ewma = LongSmoothSpec::parse({{"func", "ewma"}, {"half_life", "10,100"}});
+    ASSERT_TRUE(ewma.enabled());
+    EXPECT_TRUE(ewma.time_based);
+    EXPECT_EQ(ewma.rates.size(), 2u);
+    LongTermSmoother smoother;
+    smoother.update(ewma, 0.0, start);
+    smoother.update(ewma, 100.0, start + std::chrono::seconds(10));
+    EXPECT_NEAR(smoother.value(ewma, 0), 50.0, 1e-9);
+    EXPECT_NEAR(smoother.value(ewma, 1), 100.0 * (1.0 - std::exp2(-0.1)), 1e-9);
+    
+    LongTermSmoother dense;
+    dense.update(ewma, 0.0, start);
+    for (int i = 1; i <= 10; ++i) {
+        dense.update(ewma, 100.0, start + std::chrono::seconds(i));
+    }
+    EXPECT_NEAR(dense.value(ewma, 0), 50.0, 1e-9);
+    
+    // holt跟踪线性趋势并向前外推
+    auto holt = LongSmoothSpec::parse({{"func", "holt"}, {"alpha", "0.5"}, {"horizon", "2"}});
+    ASSERT_TRUE(holt.enabled());
+    LongTermSmoother trend;
+    for (int i = 0; i < 200; ++i) {
+        trend.update(holt, 3.0 * i + 1.0, start + std::chrono::seconds(i));
+    }
+    EXPECT_NEAR(trend.value(holt), 3.0 * 201 + 1.0, 1e-6);
+    
+    // 衰减最大值：新高立即跟随，之后逐步回落到当前值
+    auto decayed_max = LongSmoothSpec::parse({{"func", "decayed_max"}, {"win_length", "3"}});
+    LongTermSmoother peak;
+    std::vector<double> peaks;
+    for (double value : {1.0, 10.0, 2.0, 2.0, 20.0}) {
+        peak.update(decayed_max, value, start);
+        peaks.push_back(peak.value(decayed_max));
+    }
+    EXPECT_EQ(peaks, std::vector<double>({1.0, 10.0, 6.0, 4.0, 20.0}));
+    
+    // 状态可保存恢复
+    StateWriter writer;
+    trend.save(writer);
+    StateReader reader(writer.data().data(), writer.size());
+    LongTermSmoother restored;
+    ASSERT_TRUE(restored.load(reader));
+    EXPECT_EQ(restored.count(), trend.count());
+    EXPECT_DOUBLE_EQ(restored.value(holt), trend.value(holt));
+    
+    // 未知函数或参数无效时不启用
+    EXPECT_FALSE(LongSmoothSpec::parse({{"func", "min"}, {"win_length", "10"}}).enabled());
+    EXPECT_FALSE(LongSmoothSpec::parse({{"func", "ewma"}, {"alpha", "1.5"}}).enabled());
+    EXPECT_FALSE(LongSmoothSpec::parse({{"func", "ewma"}, {"half_life", "10,x"}}).enabled());
+    EXPECT_FALSE(LongSmoothSpec::parse({{"func", "ewma"}}).enabled());
+}
+
+/**
+ * @brief 长期平滑后直接输出平滑值的错误检测测试插件
+ */
+class LongTermErrorTestPlugin : public ErrorDetectionPluginBase {
+public:
+    std::string getName() const override { return "long_term_error_test"; }
+    std::string getVersion() const override { return "1.0.0"; }
+    std::string getDescription() const override { return "长期平滑错误检测测试插件"; }
+    std::vector<std::string> getRequiredParameters() const override { return {}; }
+    std::vector<std::string> getOptionalParameters() const override { return {}; }
+    std::vector<std::string> getHealthDefinitions() const override { return {"error"}; }
+    std::vector<int> getDefaultScores() const override { return {100}; }
+
+protected:
+    bool validateParameters() override { return true; }
+    
+    std::vector<ErrorConfig> getErrorConfigs() const override {
+        ErrorConfig config;
+        config.feature_name = "mean_hf";
+        config.upper_limit = 0.0;
+        config.long_smooth = LongSmoothSpec::parse({{"func", "ewma"}, {"alpha", "0.5"}});
+        config.error_width = 30;
+        return {config};
+    }
+    
+    std::map<std::string, double> calculateErrorHealth(const ErrorConfig& config,
+                                                       const std::vector<double>& data) override {
+        return {{config.feature_name + "_long", data.back()}};
+    }
+};
+
+/**
+ * @brief 错误检测长期平滑按设备隔离测试
+ */
+TEST_F(PluginBaseTest, ErrorDetectionLongTermDeviceTest) {
+    auto process = [](LongTermErrorTestPlugin& plugin, const std::string& device_id, double value) {
+        auto input = std::make_shared<FeatureData>(device_id, std::chrono::system_clock::now());
+        input->setFeature("mean_hf", value);
+        auto output = std::make_shared<PluginResultImpl>();
+        EXPECT_TRUE(plugin.process(input, output)) << plugin.getLastError();
+        return output->getDoubleData("mean_hf_long");
+    };
+    
+    // 两台设备交替输入，各自的平滑值只受本设备数据影响
+    LongTermErrorTestPlugin plugin;
+    ASSERT_TRUE(plugin.initialize(std::make_shared<PluginParameterImpl>()));
+    EXPECT_DOUBLE_EQ(process(plugin, "long_term_device_a", 10.0), 10.0);
+    EXPECT_DOUBLE_EQ(process(plugin, "long_term_device_b", 90.0), 90.0);
+    EXPECT_DOUBLE_EQ(process(plugin, "long_term_device_a", 30.0), 20.0);
+    EXPECT_DOUBLE_EQ(process(plugin, "long_term_device_b", 50.0), 70.0);
+    
+    // 状态快照恢复后各设备从各自的平滑值继续
+    ASSERT_TRUE(plugin.isStateful());
+    StateWriter writer;
+    ASSERT_TRUE(plugin.saveState(writer, false));
+    LongTermErrorTestPlugin restored;
+    ASSERT_TRUE(restored.initialize(std::make_shared<PluginParameterImpl>()));
+    StateReader reader(writer.data().data(), writer.size());
+    ASSERT_TRUE(restored.loadState(reader)) << restored.getLastError();
+    EXPECT_DOUBLE_EQ(process(restored, "long_term_device_b", 70.0), 70.0);
+    EXPECT_DOUBLE_EQ(process(restored, "long_term_device_a", 40.0), 30.0);
+}
+
+// 两个统计共用同一特征的历史，分别使用均值和中位数，输出各自看到的历史状态
+class SharedHistoryTestPlugin : public RealtimeHealthPluginBase {
+public:
+    explicit SharedHistoryTestPlugin(const std::string& second_alpha = "0.5") {
+        for (const auto& [key, statistic, alpha] : {std::make_tuple("mean_stat", "mean", "0.5"),
+                                                   std::make_tuple("median_stat", "median", second_alpha.c_str())}) {
+            FeatureStat stat;
+            stat.analysis_features = "mean_hf";
+            stat.statistic = {statistic};
+            stat.result_key = key;
+            stat.upper_limit = 100.0;
+            stat.long_smooth = {{"func", "ewma"}, {"alpha", alpha}};
+            stat.long_smooth_spec = LongSmoothSpec::parse(stat.long_smooth);
+            stats_.push_back(stat);
+        }
+    }
+    
+    std::string getName() const override { return "shared_history_test"; }
+    std::string getVersion() const override { return "1.0.0"; }
+    std::string getDescription() const override { return "共用特征历史测试插件"; }
+    std::vector<std::string> getRequiredParameters() const override { return {}; }
+    std::vector<std::string> getOptionalParameters() const override { return {}; }
+    std::vector<std::string> getHealthDefinitions() const override { return {}; }
+    std::vector<int> getDefaultScores() const override { return {}; }
+
+protected:
+    bool validateParameters() override { return validateFeatureStats(stats_); }
+    std::vector<FeatureStat> getFeatureStats() const override { return stats_; }
+    std::vector<HealthConfig> getHealthConfigs() const override { return {HealthConfig{}}; }
+    
+    std::map<std::string, double> calculateFeatureHealth(const FeatureStat& stat,
+                                                         const FeatureHistory& history) override {
+        return {{stat.result_key + "_count", static_cast<double>(history.values.size())},
+                {stat.result_key + "_median", history.statistics.tracksMedian() ? 1.0 : 0.0},
+                {stat.result_key + "_long", static_cast<double>(history.long_term.count())}};
+    }
+    
+    std::map<std::string, double> calculateOverallHealth(const std::vector<HealthConfig>&,
+                                                         const std::map<std::string, double>& feature_scores) override {
+        return feature_scores;
+    }
+
+private:
+    std::vector<FeatureStat> stats_;
+};
+
+/**
+ * @brief 多个统计共用特征历史测试
+ */
+TEST_F(PluginBaseTest, RealtimeHealthSharedHistoryTest) {
+    // 缓存参数按共用特征的所有统计汇总，每条数据只写入一次，设置不会随统计交替而重建
+    SharedHistoryTestPlugin plugin;
+    ASSERT_TRUE(plugin.initialize(std::make_shared<PluginParameterImpl>())) << plugin.getLastError();
+    std::shared_ptr<PluginResultImpl> output;
+    for (int i = 1; i <= 5; ++i) {
+        auto input = std::make_shared<FeatureData>("shared_history_device", std::chrono::system_clock::now());
+        input->setFeature("status", 1.0);
+        input->setFeature("mean_hf", 10.0 * i);
+        output = std::make_shared<PluginResultImpl>();
+        ASSERT_TRUE(plugin.process(input, output)) << plugin.getLastError();
+    }
+    for (const char* key : {"mean_stat", "median_stat"}) {
+        EXPECT_DOUBLE_EQ(output->getDoubleData(std::string(key) + "_count"), 5.0) << key;
+        EXPECT_DOUBLE_EQ(output->getDoubleData(std::string(key) + "_median"), 1.0) << key;
+        EXPECT_DOUBLE_EQ(output->getDoubleData(std::string(key) + "_long"), 5.0) << key;
+    }
+    
+    // 共用历史的统计使用不同的长期平滑参数时初始化失败
+    SharedHistoryTestPlugin conflicting("0.2");
+    EXPECT_FALSE(conflicting.initialize(std::make_shared<PluginParameterImpl>()));
+}
+
+/**
+ * @brief 状态检查点测试
+ */
+TEST_F(PluginBaseTest, StateCheckpointTest) {
+    // 编码与解码一致，越界读取进入失败状态
+    StateWriter writer;
+    writer.writeU32(7);
+    writer.writeString("state");
+    writer.writeDoubleArray({1.5, -2.0});
+    writer.writeDoubleMap({{"score", 0.5}});
+    StateReader reader(writer.data().data(), writer.size());
+    uint32_t version = 0;
+    std::string text;
+    std::vector<double> values;
+    std::map<std::string, double> scores;
+    EXPECT_TRUE(reader.readU32(version) && reader.readString(text) &&
+                reader.readDoubleArray(values) && reader.readDoubleMap(scores));
+    EXPECT_EQ(version, 7);
+    EXPECT_EQ(text, "state");
+    EXPECT_EQ(values, std::vector<double>({1.5, -2.0}));
+    EXPECT_EQ(scores["score"], 0.5);
+    EXPECT_TRUE(reader.atEnd());
+    EXPECT_FALSE(reader.readU32(version));
+    EXPECT_TRUE(reader.failed());
+    EXPECT_EQ(StateCheckpoint::crc32("123456789", 9), 0xCBF43926u);
+    
+    auto directory = std::filesystem::temp_directory_path() / "plugin_state_checkpoint_test";
+    std::filesystem::remove_all(directory);
+    
+    TestPluginOptions counting;
+    counting.counting = true;
+    registerTestPlugins({"ckpt_counter"}, counting);
+    auto config = chainConfig("ckpt_chain", {"ckpt_counter"});
+    
+    auto execute = [](PluginChainManager& manager, const std::string& device_id) {
+        auto output = runChain(manager, "ckpt_chain", device_id);
+        return output ? output->getIntData("ckpt_counter_count") : -1;
+    };
+    
+    // 首次写入全量检查点，之后只写入有变化的设备
+    PluginChainManager chain_manager;
+    EXPECT_TRUE(chain_manager.createChain(config));
+    for (int i = 0; i < 3; ++i) {
+        execute(chain_manager, "ckpt_device_a");
+    }
+    execute(chain_manager, "ckpt_device_b");
+    EXPECT_TRUE(chain_manager.writeCheckpoint(directory.string()));
+    execute(chain_manager, "ckpt_device_b");
+    EXPECT_TRUE(chain_manager.writeCheckpoint(directory.string()));
+    EXPECT_EQ(chain_manager.getCheckpointSequence(), 2);
+    EXPECT_TRUE(std::filesystem::exists(directory / "state.ckpt"));
+    
+    // 新的管理器恢复后从检查点状态继续
+    PluginChainManager restored;
+    EXPECT_TRUE(restored.createChain(config));
+    EXPECT_TRUE(restored.restoreCheckpoint(directory.string()));
+    EXPECT_EQ(restored.getCheckpointSequence(), 2);
+    EXPECT_EQ(execute(restored, "ckpt_device_a"), 4);
+    EXPECT_EQ(execute(restored, "ckpt_device_b"), 3);
+    EXPECT_EQ(execute(restored, "ckpt_device_c"), 1);
+    
+    // 全量检查点损坏时拒绝恢复
+    {
+        std::fstream file(directory / "state.ckpt", std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+    PluginChainManager corrupted;
+    EXPECT_TRUE(corrupted.createChain(config));
+    EXPECT_FALSE(corrupted.restoreCheckpoint(directory.string()));
+    EXPECT_FALSE(corrupted.getLastCheckpointError().empty());
+    
+    // 没有检查点时从空状态开始
+    std::filesystem::remove_all(directory);
+    PluginChainManager empty;
+    EXPECT_TRUE(empty.createChain(config));
+    EXPECT_TRUE(empty.restoreCheckpoint(directory.string()));
+    EXPECT_EQ(empty.getCheckpointSequence(), 0);
+}
+
 /**
  * @brief 插件配置管理器测试
  */
@@ -277,6 +1725,334 @@ TEST_F(PluginBaseTest, PluginMonitorManagerTest) {
     monitor_manager.stopMonitoring("test_plugin");
 }
 
+/**
+ * @brief 执行时间分布统计测试
+ */
+TEST_F(PluginBaseTest, PluginMonitorLatencyTest) {
+    // 桶连续覆盖取值范围，相对误差不超过1/32
+    for (uint64_t value : {0ull, 63ull, 64ull, 1000ull, 123456789ull}) {
+        size_t index = LatencyHistogram::bucketIndex(value);
+        EXPECT_LE(LatencyHistogram::bucketLowerBound(index), value);
+        EXPECT_GE(LatencyHistogram::bucketUpperBound(index), value);
+        EXPECT_EQ(LatencyHistogram::bucketLowerBound(index + 1), LatencyHistogram::bucketUpperBound(index) + 1);
+    }
+    
+    PluginMonitorManager monitor_manager;
+    monitor_manager.startMonitoring("latency_plugin");
+    
+    // 多个线程并发记录，查询时合并各线程的分片
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&monitor_manager]() {
+            for (int i = 1; i <= 1000; ++i) {
+                monitor_manager.recordExecution("latency_plugin", i % 100 != 0, i * 0.01, "慢请求");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    monitor_manager.recordExecution("unmonitored_plugin", true, 1.0);
+    
+    auto metrics = monitor_manager.getPluginMetrics("latency_plugin");
+    EXPECT_EQ(metrics.execution_count, 4000);
+    EXPECT_EQ(metrics.error_count, 40);
+    EXPECT_EQ(metrics.last_error_message, "慢请求");
+    EXPECT_NEAR(metrics.avg_execution_time_ms, 5.005, 1e-6);
+    EXPECT_NEAR(metrics.min_execution_time_ms, 0.01, 1e-9);
+    EXPECT_NEAR(metrics.max_execution_time_ms, 10.0, 1e-9);
+    EXPECT_NEAR(metrics.p50_execution_time_ms, 5.0, 5.0 / 32);
+    EXPECT_NEAR(metrics.p99_execution_time_ms, 9.9, 9.9 / 32);
+    EXPECT_LE(metrics.p999_execution_time_ms, metrics.max_execution_time_ms);
+    EXPECT_NEAR(monitor_manager.getExecutionTimePercentile("latency_plugin", 0.9), 9.0, 9.0 / 32);
+    EXPECT_EQ(monitor_manager.getLatencyHistogram("latency_plugin").getCount(), 4000);
+    EXPECT_EQ(monitor_manager.getExecutionCount("unmonitored_plugin"), 0);
+    
+    // 停止监控后不再记录
+    monitor_manager.stopMonitoring("latency_plugin");
+    monitor_manager.recordExecution("latency_plugin", true, 1.0);
+    EXPECT_EQ(monitor_manager.getExecutionCount("latency_plugin"), 4000);
+    EXPECT_TRUE(monitor_manager.getMonitoredPlugins().empty());
+}
+
+/**
+ * @brief 线程退出后其统计分片归并回收，统计值不丢失
+ */
+TEST_F(PluginBaseTest, PluginMonitorThreadChurnTest) {
+    PluginMonitorManager monitor_manager;
+    monitor_manager.startMonitoring("churn_plugin");
+    const std::string stage_key = PluginMonitorManager::stageKey("churn_chain", "churn_plugin");
+    
+    // 依次创建大量短生命周期线程，每个线程只记录少量数据
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&monitor_manager, &stage_key, round, t]() {
+                monitor_manager.recordExecution("churn_plugin", t != 0, 1.0 + round + t);
+                monitor_manager.recordExecution("churn_plugin", true, 1.0);
+                monitor_manager.recordStageExecution(stage_key, true, 2.0);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    
+    // 已退出线程的分片合并为一个
+    EXPECT_EQ(monitor_manager.getShardCount("churn_plugin"), 1);
+    auto metrics = monitor_manager.getPluginMetrics("churn_plugin");
+    EXPECT_EQ(metrics.execution_count, 400);
+    EXPECT_EQ(metrics.error_count, 50);
+    EXPECT_NEAR(metrics.min_execution_time_ms, 1.0, 1e-9);
+    EXPECT_NEAR(metrics.max_execution_time_ms, 53.0, 1e-9);
+    EXPECT_EQ(monitor_manager.getLatencyHistogram("churn_plugin").getCount(), 400);
+    EXPECT_EQ(monitor_manager.getStageMetrics("churn_chain", "churn_plugin").execution_count, 200);
+    
+    // 存活线程保留自己的分片
+    monitor_manager.recordExecution("churn_plugin", true, 1.0);
+    EXPECT_EQ(monitor_manager.getShardCount("churn_plugin"), 2);
+    EXPECT_EQ(monitor_manager.getExecutionCount("churn_plugin"), 401);
+    
+    // 管理器先于线程析构时，线程退出不再访问它
+    auto short_lived = std::make_unique<PluginMonitorManager>();
+    short_lived->startMonitoring("late_plugin");
+    std::promise<void> recorded;
+    std::promise<void> release;
+    std::thread late_thread([monitor = short_lived.get(), &recorded, released = release.get_future()]() {
+        monitor->recordExecution("late_plugin", true, 1.0);
+        recorded.set_value();
+        released.wait();
+    });
+    recorded.get_future().wait();
+    short_lived.reset();
+    release.set_value();
+    late_thread.join();
+}
+
+/**
+ * @brief OpenMetrics指标导出测试
+ */
+TEST_F(PluginBaseTest, OpenMetricsExporterTest) {
+    TestPluginOptions pure;
+    pure.pure = true;
+    registerTestPlugins({"metrics_pure"}, pure);
+    registerTestPlugins({"metrics_plain"});
+    
+    PluginMonitorManager monitor_manager;
+    monitor_manager.startMonitoring("metrics_plain");
+    monitor_manager.recordExecution("metrics_plain", true, 0.2);
+    monitor_manager.recordExecution("metrics_plain", false, 3.0, "失败");
+    
+    // 链节点耗时记录到监控管理器
+    PluginChainManager chain_manager;
+    chain_manager.setMonitor(&monitor_manager);
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("metrics_chain", {"metrics_pure", "metrics_plain"})));
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(runChain(chain_manager, "metrics_chain"));
+    }
+    EXPECT_EQ(monitor_manager.getStageMetrics("metrics_chain", "metrics_plain").execution_count, 3);
+    
+    // 一次快照取得全部插件和链节点的合并统计
+    std::vector<PluginMonitorManager::MetricsSnapshot> plugin_snapshots;
+    std::vector<PluginMonitorManager::MetricsSnapshot> stage_snapshots;
+    monitor_manager.snapshotMetrics({1000000, UINT64_MAX}, plugin_snapshots, stage_snapshots);
+    ASSERT_EQ(plugin_snapshots.size(), 1);
+    EXPECT_TRUE(plugin_snapshots[0].chain_name.empty());
+    EXPECT_EQ(plugin_snapshots[0].metrics.execution_count, 2);
+    EXPECT_EQ(plugin_snapshots[0].latency_counts, (std::vector<uint64_t>{1, 2}));
+    ASSERT_EQ(stage_snapshots.size(), 2);
+    EXPECT_EQ(stage_snapshots[0].chain_name, "metrics_chain");
+    
+    TaskScheduler scheduler(2);
+    OpenMetricsExporter exporter("test");
+    exporter.setMonitor(&monitor_manager);
+    exporter.setScheduler(&scheduler);
+    exporter.setResultCache("chain", &chain_manager.getResultCache());
+    
+    std::string text = exporter.render();
+    EXPECT_NE(text.find("# TYPE test_plugin_executions counter"), std::string::npos);
+    EXPECT_NE(text.find("test_plugin_executions_total{plugin=\"metrics_plain\",result=\"error\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("test_plugin_execution_seconds_bucket{plugin=\"metrics_plain\",le=\"0.001\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("test_plugin_execution_seconds_bucket{plugin=\"metrics_plain\",le=\"+Inf\"} 2"), std::string::npos);
+    EXPECT_NE(text.find("test_plugin_execution_seconds_count{plugin=\"metrics_plain\"} 2"), std::string::npos);
+    EXPECT_NE(text.find("test_chain_stage_execution_seconds_count{chain=\"metrics_chain\",plugin=\"metrics_pure\"} 3"),
+              std::string::npos);
+    EXPECT_NE(text.find("test_scheduler_threads 2"), std::string::npos);
+    EXPECT_NE(text.find("test_result_cache_hits_total{cache=\"chain\"} 2"), std::string::npos);
+    EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+    
+    // 写入文件
+    auto file_path = std::filesystem::temp_directory_path() / "algorithm_plugins_metrics_test.prom";
+    EXPECT_TRUE(exporter.writeToFile(file_path.string()));
+    std::ifstream file(file_path);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("# EOF"), std::string::npos);
+    std::filesystem::remove(file_path);
+    
+#if !defined(_WIN32)
+    // HTTP抓取
+    ASSERT_TRUE(exporter.startHttpServer(0));
+    EXPECT_GT(exporter.getHttpPort(), 0);
+    
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(client, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(exporter.getHttpPort());
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    ASSERT_EQ(::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    std::string request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    EXPECT_EQ(::send(client, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = ::recv(client, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(received));
+    }
+    ::close(client);
+    EXPECT_EQ(response.compare(0, 15, "HTTP/1.1 200 OK"), 0);
+    EXPECT_NE(response.find("application/openmetrics-text"), std::string::npos);
+    EXPECT_NE(response.find("test_scheduler_threads 2"), std::string::npos);
+    exporter.stop();
+    EXPECT_EQ(exporter.getHttpPort(), 0);
+#endif
+}
+
+/**
+ * @brief 插件内存统计测试
+ */
+TEST_F(PluginBaseTest, MemoryAccountingTest) {
+    if (!MemoryAccount::isAllocationTrackingEnabled()) {
+        GTEST_SKIP() << "分配钩子未编译";
+    }
+    
+    // 下级账户的记录同时计入上级，作用域结束后恢复
+    MemoryAccount request_account;
+    {
+        MemoryAccountScope scope(&request_account);
+        MemoryAccount node_account(MemoryAccount::current());
+        {
+            MemoryAccountScope node_scope(&node_account);
+            std::vector<char> buffer(100000);
+            EXPECT_EQ(MemoryAccount::current(), &node_account);
+        }
+        EXPECT_GE(node_account.getUsage().peak_live_bytes, 100000u);
+        EXPECT_EQ(node_account.getUsage().retainedBytes(), 0);
+    }
+    EXPECT_EQ(MemoryAccount::current(), nullptr);
+    EXPECT_GE(request_account.getUsage().bytes_allocated, 100000u);
+    EXPECT_EQ(request_account.getUsage().retainedBytes(), 0);
+    
+    // 链节点内存记录到监控管理器，保留的内存逐次累积
+    TestPluginOptions leaking_options;
+    leaking_options.scratch_bytes = 64 * 1024;
+    leaking_options.retained_bytes = 4096;
+    registerTestPlugins({"memory_leaking"}, leaking_options);
+    registerTestPlugins({"memory_plain"});
+    
+    PluginMonitorManager monitor_manager;
+    PluginChainManager chain_manager;
+    chain_manager.setMonitor(&monitor_manager);
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("memory_chain", {"memory_leaking", "memory_plain"})));
+    
+    MemoryAccount execution_account;
+    {
+        MemoryAccountScope scope(&execution_account);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(runChain(chain_manager, "memory_chain"));
+        }
+    }
+    
+    auto leaking = monitor_manager.getStageMetrics("memory_chain", "memory_leaking");
+    EXPECT_EQ(leaking.memory_samples, 4u);
+    EXPECT_GE(leaking.peak_memory_bytes, 64u * 1024);
+    EXPECT_GE(leaking.bytes_allocated, 4u * (64 * 1024 + 4096));
+    EXPECT_GE(leaking.retained_bytes, 4 * 4096);
+    EXPECT_GE(execution_account.getUsage().bytes_allocated, leaking.bytes_allocated);
+    
+    OpenMetricsExporter exporter("test");
+    exporter.setMonitor(&monitor_manager);
+    std::string text = exporter.render();
+    EXPECT_NE(text.find("test_chain_stage_allocated_bytes_total{chain=\"memory_chain\",plugin=\"memory_leaking\"}"),
+              std::string::npos);
+    EXPECT_NE(text.find("test_chain_stage_retained_bytes{chain=\"memory_chain\",plugin=\"memory_leaking\"}"),
+              std::string::npos);
+}
+
+#if defined(ALGORITHM_PLUGINS_TRACING)
+/**
+ * @brief 追踪区间测试
+ */
+TEST_F(PluginBaseTest, TracerTest) {
+    registerTestPlugins({"trace_left", "trace_right", "trace_join"});
+    PluginChainManager chain_manager;
+    EXPECT_TRUE(chain_manager.createChain(chainConfig("trace_chain", {"trace_left", "trace_right", "trace_join"}, {
+        {"trace_left->trace_join", "*"},
+        {"trace_right->trace_join", "*"}
+    })));
+    
+    auto& tracer = Tracer::getInstance();
+    tracer.clear();
+    
+    // 关闭时不记录
+    EXPECT_TRUE(runChain(chain_manager, "trace_chain"));
+    EXPECT_EQ(tracer.getEventCount(), 0);
+    
+    // 每2个请求采样1个，每个被采样请求记录链区间和3个节点区间，并行分支在其他线程上同样记录
+    tracer.setEnabled(true);
+    tracer.setSampleInterval(2);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(runChain(chain_manager, "trace_chain"));
+    }
+    EXPECT_EQ(tracer.getEventCount(), 8);
+    
+    std::string trace = tracer.renderChromeTrace();
+    EXPECT_EQ(trace.compare(0, 15, "{\"displayTimeUn"), 0);
+    EXPECT_NE(trace.find("\"name\":\"executeChain\",\"cat\":\"chain\""), std::string::npos);
+    EXPECT_NE(trace.find("\"label\":\"trace_chain/trace_join\""), std::string::npos);
+    EXPECT_NE(trace.find("\"depth\":1"), std::string::npos);
+    
+    // 上下文复制到其他线程后，区间归属同一请求
+    tracer.setSampleInterval(1);
+    {
+        TraceRequestScope request;
+        TraceContext context = Tracer::currentContext();
+        EXPECT_NE(context.request_id, 0);
+        std::thread worker([context] {
+            TraceContextScope scope(context);
+            TraceSpan span("worker", "test", "带\"引号\"的标签");
+        });
+        worker.join();
+    }
+    EXPECT_EQ(Tracer::currentContext().request_id, 0);
+    EXPECT_NE(tracer.renderChromeTrace().find("带\\\"引号\\\"的标签"), std::string::npos);
+    
+    // 缓冲区满时覆盖最早的事件
+    tracer.clear();
+    tracer.setBufferCapacity(4);
+    std::thread small_buffer([&tracer] {
+        TraceRequestScope request;
+        for (int i = 0; i < 10; ++i) {
+            TraceSpan span("overflow", "test");
+        }
+    });
+    small_buffer.join();
+    EXPECT_EQ(tracer.getEventCount(), 4);
+    EXPECT_EQ(tracer.getDroppedCount(), 6);
+    
+    auto trace_path = std::filesystem::temp_directory_path() / "algorithm_plugins_trace_test.json";
+    EXPECT_TRUE(tracer.exportChromeTrace(trace_path.string()));
+    EXPECT_GT(std::filesystem::file_size(trace_path), 0);
+    std::filesystem::remove(trace_path);
+    
+    tracer.setEnabled(false);
+    tracer.setBufferCapacity(16384);
+    tracer.clear();
+    EXPECT_EQ(tracer.getEventCount(), 0);
+}
+#endif
+
 /**
  * @brief 数据序列化测试
  */
@@ -311,6 +2087,54 @@ TEST_F(PluginBaseTest, DataSerializationTest) {
     EXPECT_EQ(deserialized_feature->getFeature("mean_hf"), feature_data->getFeature("mean_hf"));
 }
 
+/**
+ * @brief 录制数据流读写测试
+ */
+TEST_F(PluginBaseTest, StreamRecordingTest) {
+    std::vector<std::shared_ptr<PluginData>> records = {
+        TestDataHelper::createRealTimeData("record_a"),
+        TestDataHelper::createBatchData("record_b"),
+        TestDataHelper::createFeatureData("record_c"),
+    };
+    auto path = (std::filesystem::temp_directory_path() / "plugin_stream_recording_test").string();
+    
+    // 两种格式读回的记录与原记录一致，二进制格式按文件头识别
+    for (auto format : {RecordingFormat::BINARY, RecordingFormat::JSON_LINES}) {
+        std::string error;
+        EXPECT_TRUE(StreamRecording::write(path, records, format, error)) << error;
+        std::vector<std::shared_ptr<PluginData>> loaded;
+        ASSERT_TRUE(StreamRecording::read(path, loaded, error)) << error;
+        ASSERT_EQ(loaded.size(), records.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            EXPECT_EQ(loaded[i]->getType(), records[i]->getType());
+            EXPECT_EQ(loaded[i]->getDeviceId(), records[i]->getDeviceId());
+            EXPECT_EQ(std::chrono::duration_cast<std::chrono::milliseconds>(
+                          loaded[i]->getTimestamp() - records[i]->getTimestamp()).count(), 0);
+        }
+        auto batch = std::dynamic_pointer_cast<BatchData>(loaded[1]);
+        ASSERT_TRUE(batch);
+        EXPECT_EQ(batch->getWaveData().size(), TestDataHelper::createBatchData()->getWaveData().size());
+    }
+    
+    // 替换设备ID时保留数据内容
+    auto copy = StreamRecording::withDeviceId(*records[0], "record_a#1");
+    ASSERT_TRUE(copy);
+    EXPECT_EQ(copy->getDeviceId(), "record_a#1");
+    EXPECT_EQ(std::static_pointer_cast<RealTimeData>(copy)->getMeanHF(),
+              std::static_pointer_cast<RealTimeData>(records[0])->getMeanHF());
+    
+    // 无法解析的行报告行号
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << records[0]->serialize() << "\n\n{\"type\":\"unknown\"}\n";
+    }
+    std::vector<std::shared_ptr<PluginData>> loaded;
+    std::string error;
+    EXPECT_FALSE(StreamRecording::read(path, loaded, error));
+    EXPECT_NE(error.find("3"), std::string::npos);
+    std::filesystem::remove(path);
+}
+
 /**
  * @brief 性能测试
  */
@@ -0,0 +1,59 @@
+#include "plugin_base.h"
+
+/**
+ * @brief 动态加载测试用插件库
+ *
+ * 以add_algorithm_plugin构建，输出输入数据的设备ID和本实例的调用次数。
+ * ECHO_PLUGIN_VERSION由构建脚本指定，同一源文件构建出不同版本用于热替换测试
+ */
+
+#ifndef ECHO_PLUGIN_VERSION
+#define ECHO_PLUGIN_VERSION "1.0.0"
+#endif
+
+namespace AlgorithmPlugins {
+
+class EchoTestPlugin : public IPlugin {
+public:
+    std::string getName() const override { return "echo_test_plugin"; }
+    std::string getVersion() const override { return ECHO_PLUGIN_VERSION; }
+    std::string getDescription() const override { return "动态加载测试插件"; }
+    PluginType getType() const override { return PluginType::OTHER; }
+
+    bool initialize(std::shared_ptr<PluginParameter>) override {
+        initialized_ = true;
+        return true;
+    }
+
+    bool process(std::shared_ptr<PluginData> input, std::shared_ptr<PluginResult> output) override {
+        if (!initialized_ || !input || !output) {
+            return false;
+        }
+        output->setData("echo_device", input->getDeviceId());
+        output->setData("echo_version", std::string(ECHO_PLUGIN_VERSION));
+        output->setData("echo_calls", ++calls_);
+        return true;
+    }
+
+    void cleanup() override { initialized_ = false; }
+    bool isInitialized() const override { return initialized_; }
+    std::string getLastError() const override { return ""; }
+
+    std::vector<std::string> getRequiredParameters() const override { return {}; }
+    std::vector<std::string> getOptionalParameters() const override { return {}; }
+
+private:
+    bool initialized_ = false;
+    int calls_ = 0;
+};
+
+class EchoTestPluginFactory : public IPluginFactory {
+public:
+    std::shared_ptr<IPlugin> createPlugin() override { return std::make_shared<EchoTestPlugin>(); }
+    std::string getPluginName() const override { return "echo_test_plugin"; }
+    PluginType getPluginType() const override { return PluginType::OTHER; }
+};
+
+REGISTER_PLUGIN(EchoTestPlugin, "echo_test_plugin", PluginType::OTHER)
+
+} // namespace AlgorithmPlugins
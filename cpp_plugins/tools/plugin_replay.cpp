@@ -0,0 +1,664 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "plugin_manager.h"
+#include "data_types.h"
+#include "latency_histogram.h"
+#include "memory_accounting.h"
+#include "stream_recording.h"
+#include "vibrate31_plugin.h"
+#include "feature_plugin_base.h"
+#include "decision_plugin_base.h"
+#include "evaluation_plugin_base.h"
+#include "event_plugin_base.h"
+#include "synthetic_data.h"
+
+using namespace AlgorithmPlugins;
+
+/**
+ * 录制数据回放与压测工具
+ *
+ * 用法：
+ *   plugin_replay replay <录制文件> (--chain p1,p2,... | --plugin name) [选项]
+ *   plugin_replay convert <输入文件> <输出文件> [--format jsonl|binary]
+ *   plugin_replay generate <输出文件> [--devices N] [--readings M] [--seed S] [--format jsonl|binary]
+ *
+ * replay选项：
+ *   --chain p1,p2,...   以串行插件链执行（PluginChainManager）
+ *   --plugin name       每条记录新建插件实例执行，与CppAlgorithmExecutor单次调用的路径一致
+ *   --param key=value   插件参数，可重复；数值按整数和浮点同时设置，逗号分隔的数值为数组
+ *   --plugin-dir dir    额外加载目录中的插件库
+ *   --devices N         每条记录复制为N台模拟设备（设备ID加"#序号"后缀），默认1即保留原设备
+ *   --rate R            目标速率（条/秒），0表示尽快执行，默认0
+ *   --speed X           按录制时间戳的间隔回放，X为加速倍数，与--rate互斥
+ *   --threads T         工作线程数，同一设备的记录固定由一个线程按顺序执行，默认1
+ *   --loops L           重复回放次数，默认1
+ *   --shards S          插件链实例分片数，默认0（每设备独占实例）
+ *   --json              以JSON输出报告
+ *
+ * 限速回放时延迟从计划发送时刻开始计算，执行落后于计划时排队时间计入延迟，
+ * 避免只统计实际发出的请求而低估尾延迟
+ */
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// 内置插件注册
+// ---------------------------------------------------------------------------
+
+template <typename PluginT>
+class BuiltinPluginFactory : public IPluginFactory {
+public:
+    BuiltinPluginFactory(const std::string& name, PluginType type) : name_(name), type_(type) {}
+
+    std::shared_ptr<IPlugin> createPlugin() override { return std::make_shared<PluginT>(); }
+    std::string getPluginName() const override { return name_; }
+    PluginType getPluginType() const override { return type_; }
+
+private:
+    std::string name_;
+    PluginType type_;
+};
+
+void registerBuiltinPlugins() {
+    auto& manager = PluginManager::getInstance();
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<Vibrate31Plugin>>(
+        "vibrate31", PluginType::FEATURE));
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<CurrentFeaturePlugin>>(
+        "current_feature", PluginType::FEATURE));
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<TemperatureFeaturePlugin>>(
+        "temperature_feature", PluginType::FEATURE));
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<AudioFeaturePlugin>>(
+        "audio_feature", PluginType::FEATURE));
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<Motor97Plugin>>(
+        "motor97", PluginType::DECISION));
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<UniversalClassify1Plugin>>(
+        "universal_classify1", PluginType::DECISION));
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<CompRealtimeHealth34Plugin>>(
+        "comp_realtime_health34", PluginType::EVALUATION));
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<Error18Plugin>>(
+        "error18", PluginType::EVALUATION));
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<ScoreAlarm5Plugin>>(
+        "score_alarm5", PluginType::EVENT));
+    manager.registerPluginFactory(std::make_shared<BuiltinPluginFactory<StatusAlarm4Plugin>>(
+        "status_alarm4", PluginType::EVENT));
+}
+
+// ---------------------------------------------------------------------------
+// 命令行解析
+// ---------------------------------------------------------------------------
+
+struct ReplayOptions {
+    std::string recording_path;
+    std::vector<std::string> chain_plugins;
+    std::string plugin_name;
+    std::vector<std::string> plugin_dirs;
+    std::shared_ptr<PluginParameterImpl> params = std::make_shared<PluginParameterImpl>();
+    size_t devices = 1;
+    double rate = 0.0;
+    double speed = 0.0;
+    size_t threads = 1;
+    size_t loops = 1;
+    size_t shards = 0;
+    bool json = false;
+};
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+bool parseNumber(const std::string& text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && end == text.c_str() + text.size();
+}
+
+bool parseCount(const std::string& text, size_t& value) {
+    double number = 0.0;
+    if (!parseNumber(text, number) || number < 0 || number != static_cast<double>(static_cast<size_t>(number))) {
+        return false;
+    }
+    value = static_cast<size_t>(number);
+    return true;
+}
+
+// 参数值为数值时同时按整数和浮点设置，插件按自身需要的类型读取
+void setParameter(PluginParameterImpl& params, const std::string& assignment) {
+    size_t equals = assignment.find('=');
+    std::string key = assignment.substr(0, equals);
+    std::string value = equals == std::string::npos ? "" : assignment.substr(equals + 1);
+
+    double number = 0.0;
+    if (parseNumber(value, number)) {
+        params.setDouble(key, number);
+        params.setInt(key, static_cast<int>(number));
+        params.setBool(key, number != 0.0);
+        return;
+    }
+
+    auto items = splitList(value);
+    std::vector<double> numbers;
+    for (const auto& item : items) {
+        if (!parseNumber(item, number)) {
+            break;
+        }
+        numbers.push_back(number);
+    }
+    if (!items.empty() && numbers.size() == items.size()) {
+        params.setDoubleArray(key, numbers);
+        params.setIntArray(key, std::vector<int>(numbers.begin(), numbers.end()));
+        return;
+    }
+
+    if (value == "true" || value == "false") {
+        params.setBool(key, value == "true");
+    }
+    params.setString(key, value);
+}
+
+bool parseFormat(const std::string& value, RecordingFormat& format) {
+    if (value == "jsonl" || value == "json") {
+        format = RecordingFormat::JSON_LINES;
+        return true;
+    }
+    if (value == "binary" || value == "bin") {
+        format = RecordingFormat::BINARY;
+        return true;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// 资源统计
+// ---------------------------------------------------------------------------
+
+struct ResourceSample {
+    double user_seconds = 0.0;
+    double system_seconds = 0.0;
+    long max_rss_kb = 0;
+};
+
+ResourceSample sampleResources() {
+    ResourceSample sample;
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        sample.user_seconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+        sample.system_seconds = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+        sample.max_rss_kb = usage.ru_maxrss;
+    }
+    return sample;
+}
+
+// 当前常驻内存（字节），读取失败时返回0
+uint64_t readResidentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t total_pages = 0;
+    uint64_t resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+// ---------------------------------------------------------------------------
+// 回放
+// ---------------------------------------------------------------------------
+
+// 一轮回放中的一条待执行数据：录制记录下标和模拟设备序号
+struct ReplayItem {
+    uint32_t record;
+    uint32_t copy;
+};
+
+struct ReplayReport {
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    double wall_seconds = 0.0;
+    LatencyHistogram latency;
+    ResourceSample resources_before;
+    ResourceSample resources_after;
+    uint64_t resident_bytes_before = 0;
+    uint64_t resident_bytes_after = 0;
+    MemoryUsage memory;
+};
+
+class Replayer {
+public:
+    Replayer(const ReplayOptions& options, const std::vector<std::shared_ptr<PluginData>>& records)
+        : options_(options), records_(records) {}
+
+    bool prepare(std::string& error) {
+        if (!options_.chain_plugins.empty()) {
+            PluginChainManager::ChainConfig config;
+            config.chain_name = kChainName;
+            config.plugin_names = options_.chain_plugins;
+            config.plugin_params.assign(options_.chain_plugins.size(), options_.params);
+            config.instance_shards = options_.shards;
+            if (!chain_manager_.createChain(config)) {
+                error = "创建插件链失败，请检查插件名称和参数";
+                return false;
+            }
+        } else if (!PluginManager::getInstance().isPluginAvailable(options_.plugin_name)) {
+            error = "插件不可用: " + options_.plugin_name;
+            return false;
+        }
+
+        // 模拟设备ID及其所属线程，同一设备的记录始终由同一线程按录制顺序执行
+        device_ids_.resize(records_.size() * options_.devices);
+        for (size_t record = 0; record < records_.size(); ++record) {
+            for (size_t copy = 0; copy < options_.devices; ++copy) {
+                device_ids_[record * options_.devices + copy] = options_.devices == 1
+                    ? records_[record]->getDeviceId()
+                    : records_[record]->getDeviceId() + "#" + std::to_string(copy);
+            }
+        }
+
+        worker_items_.assign(options_.threads, {});
+        std::hash<std::string> hasher;
+        for (size_t record = 0; record < records_.size(); ++record) {
+            for (size_t copy = 0; copy < options_.devices; ++copy) {
+                size_t worker = hasher(device_ids_[record * options_.devices + copy]) % options_.threads;
+                worker_items_[worker].push_back({static_cast<uint32_t>(record), static_cast<uint32_t>(copy)});
+            }
+        }
+
+        // 按录制时间戳回放时的相对发送时刻，每轮紧接上一轮
+        if (options_.speed > 0.0 && !records_.empty()) {
+            auto first = records_.front()->getTimestamp();
+            auto last = first;
+            offsets_.reserve(records_.size());
+            for (const auto& record : records_) {
+                auto timestamp = std::max(record->getTimestamp(), first);
+                offsets_.push_back(std::chrono::duration<double>(timestamp - first).count() / options_.speed);
+                last = std::max(last, record->getTimestamp());
+            }
+            loop_span_ = std::chrono::duration<double>(last - first).count() / options_.speed;
+            if (records_.size() > 1) {
+                loop_span_ += loop_span_ / static_cast<double>(records_.size() - 1);
+            }
+        }
+        return true;
+    }
+
+    void run(ReplayReport& report) {
+        report.resources_before = sampleResources();
+        report.resident_bytes_before = readResidentBytes();
+
+        MemoryAccount memory_account;
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::thread> workers;
+            for (size_t worker = 0; worker < options_.threads; ++worker) {
+                workers.emplace_back([this, worker, start, &memory_account, &report] {
+                    MemoryAccountScope memory_scope(&memory_account);
+                    runWorker(worker, start, report);
+                });
+            }
+            for (auto& thread : workers) {
+                thread.join();
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        report.wall_seconds = std::chrono::duration<double>(end - start).count();
+        report.completed = completed_.load();
+        report.failed = failed_.load();
+        report.resources_after = sampleResources();
+        report.resident_bytes_after = readResidentBytes();
+        report.memory = memory_account.getUsage();
+    }
+
+private:
+    static constexpr const char* kChainName = "replay";
+
+    const ReplayOptions& options_;
+    const std::vector<std::shared_ptr<PluginData>>& records_;
+    PluginChainManager chain_manager_;
+    std::vector<std::string> device_ids_;
+    std::vector<std::vector<ReplayItem>> worker_items_;
+    std::vector<double> offsets_;
+    double loop_span_ = 0.0;
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> failed_{0};
+
+    void runWorker(size_t worker, std::chrono::steady_clock::time_point start, ReplayReport& report) {
+        const size_t per_loop = records_.size() * options_.devices;
+
+        for (size_t loop = 0; loop < options_.loops; ++loop) {
+            for (const auto& item : worker_items_[worker]) {
+                std::shared_ptr<PluginData> input = options_.devices == 1
+                    ? records_[item.record]
+                    : StreamRecording::withDeviceId(*records_[item.record],
+                                                    device_ids_[item.record * options_.devices + item.copy]);
+
+                // 计划发送时刻：限速时按全局序号均匀分布，按录制时间回放时按时间戳偏移
+                auto scheduled = std::chrono::steady_clock::now();
+                bool paced = false;
+                if (options_.rate > 0.0) {
+                    size_t sequence = loop * per_loop + item.record * options_.devices + item.copy;
+                    scheduled = start + toDuration(static_cast<double>(sequence) / options_.rate);
+                    paced = true;
+                } else if (options_.speed > 0.0) {
+                    scheduled = start + toDuration(loop * loop_span_ + offsets_[item.record]);
+                    paced = true;
+                }
+                if (paced) {
+                    std::this_thread::sleep_until(scheduled);
+                }
+
+                auto begin = paced ? scheduled : std::chrono::steady_clock::now();
+                bool success = execute(input);
+                auto finish = std::chrono::steady_clock::now();
+
+                report.latency.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(finish - begin).count()));
+                (success ? completed_ : failed_).fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool execute(const std::shared_ptr<PluginData>& input) {
+        auto output = std::make_shared<PluginResultImpl>();
+        if (!options_.chain_plugins.empty()) {
+            return chain_manager_.executeChain(kChainName, input, output);
+        }
+
+        // 与CppAlgorithmExecutor::execute_algorithm相同，每次调用新建并初始化插件实例
+        auto plugin = PluginManager::getInstance().createPlugin(options_.plugin_name, options_.params);
+        return plugin && plugin->process(input, output);
+    }
+
+    static std::chrono::steady_clock::duration toDuration(double seconds) {
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(seconds));
+    }
+};
+
+void printReport(const ReplayOptions& options, size_t record_count, const ReplayReport& report) {
+    const uint64_t total = report.completed + report.failed;
+    const double throughput = report.wall_seconds > 0.0 ? total / report.wall_seconds : 0.0;
+    const double cpu_seconds = (report.resources_after.user_seconds - report.resources_before.user_seconds) +
+                               (report.resources_after.system_seconds - report.resources_before.system_seconds);
+    const double cpu_percent = report.wall_seconds > 0.0 ? 100.0 * cpu_seconds / report.wall_seconds : 0.0;
+    auto percentile_ms = [&report](double quantile) {
+        return report.latency.getPercentile(quantile) / 1e6;
+    };
+    const bool tracking = MemoryAccount::isAllocationTrackingEnabled();
+
+    if (options.json) {
+        std::cout << std::fixed << std::setprecision(3)
+                  << "{\"records\":" << record_count
+                  << ",\"devices\":" << options.devices
+                  << ",\"threads\":" << options.threads
+                  << ",\"loops\":" << options.loops
+                  << ",\"target_rate\":" << options.rate
+                  << ",\"speed\":" << options.speed
+                  << ",\"completed\":" << report.completed
+                  << ",\"failed\":" << report.failed
+                  << ",\"wall_seconds\":" << report.wall_seconds
+                  << ",\"throughput\":" << throughput
+                  << ",\"latency_ms\":{\"p50\":" << percentile_ms(0.5)
+                  << ",\"p90\":" << percentile_ms(0.9)
+                  << ",\"p99\":" << percentile_ms(0.99)
+                  << ",\"p999\":" << percentile_ms(0.999)
+                  << ",\"max\":" << percentile_ms(1.0) << "}"
+                  << ",\"cpu\":{\"user_seconds\":"
+                  << report.resources_after.user_seconds - report.resources_before.user_seconds
+                  << ",\"system_seconds\":"
+                  << report.resources_after.system_seconds - report.resources_before.system_seconds
+                  << ",\"utilization_percent\":" << cpu_percent << "}"
+                  << ",\"memory\":{\"resident_bytes_before\":" << report.resident_bytes_before
+                  << ",\"resident_bytes_after\":" << report.resident_bytes_after
+                  << ",\"max_resident_bytes\":" << report.resources_after.max_rss_kb * 1024;
+        if (tracking) {
+            std::cout << ",\"allocated_bytes\":" << report.memory.bytes_allocated
+                      << ",\"allocations\":" << report.memory.allocation_count
+                      << ",\"peak_live_bytes\":" << report.memory.peak_live_bytes
+                      << ",\"retained_bytes\":" << report.memory.retainedBytes();
+        }
+        std::cout << "}}" << std::endl;
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "记录数: " << record_count << " x 设备 " << options.devices << " x 轮次 " << options.loops
+              << "，线程 " << options.threads << std::endl;
+    std::cout << "完成: " << report.completed << "，失败: " << report.failed
+              << "，耗时: " << report.wall_seconds << " 秒" << std::endl;
+    std::cout << "吞吐量: " << throughput << " 条/秒";
+    if (options.rate > 0.0) {
+        std::cout << "（目标 " << options.rate << " 条/秒）";
+    }
+    std::cout << std::endl;
+    std::cout << "延迟(ms): p50 " << percentile_ms(0.5) << "  p90 " << percentile_ms(0.9)
+              << "  p99 " << percentile_ms(0.99) << "  p99.9 " << percentile_ms(0.999)
+              << "  max " << percentile_ms(1.0) << std::endl;
+    std::cout << "CPU: " << cpu_seconds << " 秒，利用率 " << cpu_percent << "%" << std::endl;
+    std::cout << "常驻内存: " << report.resident_bytes_before / 1024 << " KB -> "
+              << report.resident_bytes_after / 1024 << " KB，峰值 "
+              << report.resources_after.max_rss_kb << " KB" << std::endl;
+    if (tracking) {
+        std::cout << "执行期间分配: " << report.memory.bytes_allocated << " 字节 / "
+                  << report.memory.allocation_count << " 次，存活峰值 " << report.memory.peak_live_bytes
+                  << " 字节，未释放 " << report.memory.retainedBytes() << " 字节" << std::endl;
+    }
+}
+
+int runReplay(int argc, char** argv) {
+    ReplayOptions options;
+    if (argc < 1) {
+        std::cerr << "缺少录制文件" << std::endl;
+        return 2;
+    }
+    options.recording_path = argv[0];
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&](std::string& value) {
+            if (i + 1 >= argc) {
+                std::cerr << "选项缺少参数: " << arg << std::endl;
+                return false;
+            }
+            value = argv[++i];
+            return true;
+        };
+
+        std::string value;
+        bool valid = true;
+        if (arg == "--json") {
+            options.json = true;
+        } else if (!next(value)) {
+            return 2;
+        } else if (arg == "--chain") {
+            options.chain_plugins = splitList(value);
+        } else if (arg == "--plugin") {
+            options.plugin_name = value;
+        } else if (arg == "--param") {
+            setParameter(*options.params, value);
+        } else if (arg == "--plugin-dir") {
+            options.plugin_dirs.push_back(value);
+        } else if (arg == "--devices") {
+            valid = parseCount(value, options.devices) && options.devices > 0;
+        } else if (arg == "--rate") {
+            valid = parseNumber(value, options.rate) && options.rate >= 0.0;
+        } else if (arg == "--speed") {
+            valid = parseNumber(value, options.speed) && options.speed > 0.0;
+        } else if (arg == "--threads") {
+            valid = parseCount(value, options.threads) && options.threads > 0;
+        } else if (arg == "--loops") {
+            valid = parseCount(value, options.loops) && options.loops > 0;
+        } else if (arg == "--shards") {
+            valid = parseCount(value, options.shards);
+        } else {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return 2;
+        }
+        if (!valid) {
+            std::cerr << "选项参数无效: " << arg << " " << value << std::endl;
+            return 2;
+        }
+    }
+
+    if (options.chain_plugins.empty() == options.plugin_name.empty()) {
+        std::cerr << "必须且只能指定--chain或--plugin之一" << std::endl;
+        return 2;
+    }
+    if (options.rate > 0.0 && options.speed > 0.0) {
+        std::cerr << "--rate与--speed不能同时使用" << std::endl;
+        return 2;
+    }
+
+    registerBuiltinPlugins();
+    for (const auto& directory : options.plugin_dirs) {
+        PluginManager::getInstance().loadPluginsFromDirectory(directory);
+    }
+
+    std::vector<std::shared_ptr<PluginData>> records;
+    std::string error;
+    if (!StreamRecording::read(options.recording_path, records, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (records.empty()) {
+        std::cerr << "录制文件中没有记录: " << options.recording_path << std::endl;
+        return 1;
+    }
+
+    Replayer replayer(options, records);
+    if (!replayer.prepare(error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    ReplayReport report;
+    replayer.run(report);
+    printReport(options, records.size(), report);
+    return report.failed == 0 ? 0 : 1;
+}
+
+int runConvert(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "用法: plugin_replay convert <输入文件> <输出文件> [--format jsonl|binary]" << std::endl;
+        return 2;
+    }
+    RecordingFormat format = RecordingFormat::BINARY;
+    if (argc == 4 && std::strcmp(argv[2], "--format") == 0) {
+        if (!parseFormat(argv[3], format)) {
+            std::cerr << "未知格式: " << argv[3] << std::endl;
+            return 2;
+        }
+    } else if (argc != 2) {
+        std::cerr << "convert参数无效" << std::endl;
+        return 2;
+    }
+
+    std::vector<std::shared_ptr<PluginData>> records;
+    std::string error;
+    if (!StreamRecording::read(argv[0], records, error) ||
+        !StreamRecording::write(argv[1], records, format, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::cout << "已转换 " << records.size() << " 条记录" << std::endl;
+    return 0;
+}
+
+// 生成合成的多设备实时数据流，供没有现场录制时使用
+int runGenerate(int argc, char** argv) {
+    if (argc < 1) {
+        std::cerr << "用法: plugin_replay generate <输出文件> [--devices N] [--readings M] [--seed S] "
+                     "[--format jsonl|binary]" << std::endl;
+        return 2;
+    }
+    size_t devices = 16;
+    size_t readings = 100;
+    size_t seed = 42;
+    RecordingFormat format = RecordingFormat::JSON_LINES;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        bool valid = true;
+        if (arg == "--devices") {
+            valid = parseCount(argv[i + 1], devices) && devices > 0;
+        } else if (arg == "--readings") {
+            valid = parseCount(argv[i + 1], readings);
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[i + 1], seed);
+        } else if (arg == "--format") {
+            valid = parseFormat(argv[i + 1], format);
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            std::cerr << "选项参数无效: " << arg << " " << argv[i + 1] << std::endl;
+            return 2;
+        }
+    }
+    if (argc % 2 == 0) {
+        std::cerr << "选项缺少参数: " << argv[argc - 1] << std::endl;
+        return 2;
+    }
+
+    SyntheticDataGenerator generator(seed);
+    auto records = generator.interleavedStream(devices, readings);
+    std::string error;
+    if (!StreamRecording::write(argv[0], records, format, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::cout << "已生成 " << records.size() << " 条记录" << std::endl;
+    return 0;
+}
+
+void printUsage() {
+    std::cerr << "用法:\n"
+              << "  plugin_replay replay <录制文件> (--chain p1,p2,... | --plugin name) [--param key=value]...\n"
+              << "      [--plugin-dir dir] [--devices N] [--rate R | --speed X] [--threads T] [--loops L]\n"
+              << "      [--shards S] [--json]\n"
+              << "  plugin_replay convert <输入文件> <输出文件> [--format jsonl|binary]\n"
+              << "  plugin_replay generate <输出文件> [--devices N] [--readings M] [--seed S] [--format jsonl|binary]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 2;
+    }
+
+    std::string command = argv[1];
+    if (command == "replay") {
+        return runReplay(argc - 2, argv + 2);
+    }
+    if (command == "convert") {
+        return runConvert(argc - 2, argv + 2);
+    }
+    if (command == "generate") {
+        return runGenerate(argc - 2, argv + 2);
+    }
+    printUsage();
+    return 2;
+}
@@ -8,6 +8,7 @@
 #include <chrono>
 #include <memory>
 #include <stdexcept>
+#include <algorithm>
 #include <boost/program_options.hpp>
 #include <json/json.h>
 
@@ -78,6 +79,31 @@ CommandLineOptions parseCommandLine(int argc, char* argv[]) {
     return options;
 }
 
+// 硬件计数器读数转为JSON，无效的计数器不输出
+Json::Value hardwareCountersToJson(const HardwareCounters& counters) {
+    Json::Value json(Json::objectValue);
+    for (size_t i = 0; i < static_cast<size_t>(HardwareCounter::COUNT); ++i) {
+        auto counter = static_cast<HardwareCounter>(i);
+        if (counters.has(counter)) {
+            json[HardwareCounters::name(counter)] = static_cast<Json::UInt64>(counters.get(counter));
+        }
+    }
+    if (counters.available()) {
+        json["ipc"] = counters.ipc();
+        json["l1d_mpki"] = counters.perKiloInstructions(HardwareCounter::L1D_MISSES);
+        json["llc_mpki"] = counters.perKiloInstructions(HardwareCounter::LLC_MISSES);
+        json["branch_mpki"] = counters.perKiloInstructions(HardwareCounter::BRANCH_MISSES);
+    }
+    if (counters.thread_count > 0) {
+        // 运行比例小于1时计数器被分时复用，读数已按启用/运行时间换算
+        json["threads"] = counters.thread_count;
+        json["time_enabled_ns"] = static_cast<Json::UInt64>(counters.time_enabled_ns);
+        json["time_running_ns"] = static_cast<Json::UInt64>(counters.time_running_ns);
+        json["running_ratio"] = counters.runningRatio();
+    }
+    return json;
+}
+
 // 主函数
 int main(int argc, char* argv[]) {
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -186,6 +212,32 @@ int main(int argc, char* argv[]) {
         output_result["performance"]["peak_memory_usage_mb"] = static_cast<Json::UInt64>(perf_metrics.peak_memory_usage / 1024 / 1024);
         output_result["performance"]["cache_efficiency"] = perf_metrics.cache_efficiency;
 
+        // 硬件计数器可用时以实测值替换估算的缓存指标
+        if (options.enable_profiling && perf_monitor) {
+            HardwareCounters counters = perf_monitor->getHardwareCounters("matrix_multiplication");
+            output_result["performance"]["hardware_counters"] = counters.available();
+            if (counters.available()) {
+                output_result["performance"]["ipc"] = counters.ipc();
+                output_result["performance"]["counter_threads"] = counters.thread_count;
+                output_result["performance"]["counter_running_ratio"] = counters.runningRatio();
+            }
+            if (counters.has(HardwareCounter::L1D_MISSES) && perf_metrics.memory_accesses > 0) {
+                // 逻辑访存中未在L1命中的比例
+                double miss_ratio = static_cast<double>(counters.get(HardwareCounter::L1D_MISSES)) /
+                                    perf_metrics.memory_accesses;
+                output_result["performance"]["cache_efficiency"] = std::max(0.0, 1.0 - std::min(1.0, miss_ratio));
+            }
+            if (counters.has(HardwareCounter::LLC_MISSES)) {
+                uint64_t llc_misses = counters.get(HardwareCounter::LLC_MISSES);
+                output_result["performance"]["cache_misses"] = static_cast<Json::UInt64>(llc_misses);
+                // 按64字节缓存行估算主存流量，得到实测算术强度（操作数/字节）
+                if (llc_misses > 0) {
+                    output_result["performance"]["arithmetic_intensity"] =
+                        static_cast<double>(perf_metrics.operations_count) / (llc_misses * 64.0);
+                }
+            }
+        }
+
         // 矩阵尺寸信息
         output_result["performance"]["input_matrix_size"] = Json::Value(Json::arrayValue);
         output_result["performance"]["input_matrix_size"].append(static_cast<Json::UInt64>(A.size()));
@@ -203,6 +255,25 @@ int main(int argc, char* argv[]) {
         output_result["performance"]["cpu_cores_used"] = MatrixMultiplication::EdgeConfig::MAX_THREADS;
         output_result["performance"]["memory_optimized"] = true;
 
+        // 性能分析结果：各分析项的耗时和硬件计数
+        if (options.enable_profiling && perf_monitor) {
+            Json::Value profile(Json::objectValue);
+            for (const auto& data : perf_monitor->getAllProfilingData()) {
+                if (data.is_running) {
+                    continue;
+                }
+                Json::Value region(Json::objectValue);
+                region["duration_ms"] = static_cast<double>(data.duration_ns) / 1e6;
+                region["counters"] = hardwareCountersToJson(data.counters);
+                profile["regions"][data.name] = region;
+            }
+            profile["hardware_counters_available"] = perf_monitor->isHardwareCountersAvailable();
+            if (!perf_monitor->isHardwareCountersAvailable()) {
+                profile["hardware_counters_error"] = perf_monitor->getHardwareCounterError();
+            }
+            output_result["profile"] = profile;
+        }
+
         // 添加元数据
         auto end_time = std::chrono::high_resolution_clock::now();
         auto total_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
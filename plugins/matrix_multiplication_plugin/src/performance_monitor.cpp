@@ -6,8 +6,295 @@
 #include <iomanip>
 #include <algorithm>
 #include <numeric>
+#include <fstream>
+#include <sstream>
+#include <cerrno>
+#include <cstring>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+double HardwareCounters::ipc() const {
+    if (!available() || get(HardwareCounter::CYCLES) == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(get(HardwareCounter::INSTRUCTIONS)) / get(HardwareCounter::CYCLES);
+}
+
+double HardwareCounters::perKiloInstructions(HardwareCounter counter) const {
+    if (!has(counter) || !has(HardwareCounter::INSTRUCTIONS) || get(HardwareCounter::INSTRUCTIONS) == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(get(counter)) * 1000.0 / get(HardwareCounter::INSTRUCTIONS);
+}
+
+double HardwareCounters::runningRatio() const {
+    if (time_enabled_ns == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(time_running_ns) / time_enabled_ns;
+}
+
+const char* HardwareCounters::name(HardwareCounter counter) {
+    switch (counter) {
+        case HardwareCounter::CYCLES: return "cycles";
+        case HardwareCounter::INSTRUCTIONS: return "instructions";
+        case HardwareCounter::L1D_MISSES: return "l1d_misses";
+        case HardwareCounter::LLC_MISSES: return "llc_misses";
+        case HardwareCounter::BRANCH_MISSES: return "branch_misses";
+        default: return "unknown";
+    }
+}
+
+#if defined(__linux__)
+namespace {
+
+// 各计数器对应的perf事件类型和配置
+void counterEvent(HardwareCounter counter, perf_event_attr& attr) {
+    const uint64_t cache_read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    switch (counter) {
+        case HardwareCounter::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case HardwareCounter::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case HardwareCounter::L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | cache_read_miss;
+            break;
+        case HardwareCounter::LLC_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL | cache_read_miss;
+            break;
+        default:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+    }
+}
+
+// 在调用线程上打开计数器，group_fd为-1时作为组长
+int openCounter(HardwareCounter counter, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    counterEvent(counter, attr);
+    attr.disabled = (group_fd < 0) ? 1 : 0;  // 成员随组长启停
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+std::string describeOpenError(int error_code, HardwareCounter counter) {
+    if (error_code == EACCES || error_code == EPERM) {
+        return "权限不足（检查/proc/sys/kernel/perf_event_paranoid）";
+    }
+    if (error_code == ENOENT || error_code == EOPNOTSUPP || error_code == ENODEV || error_code == EINVAL) {
+        return std::string("硬件不支持事件 ") + HardwareCounters::name(counter);
+    }
+    return std::string("perf_event_open失败: ") + std::strerror(error_code);
+}
+
+} // namespace
+#endif
+
+void HardwareCounterSet::openGroup(ThreadGroup& group, std::string& error) {
+    group.fds.fill(-1);
+#if defined(__linux__)
+    const size_t leader = static_cast<size_t>(HardwareCounter::CYCLES);
+    group.fds[leader] = openCounter(HardwareCounter::CYCLES, -1);
+    if (group.fds[leader] < 0) {
+        error = describeOpenError(errno, HardwareCounter::CYCLES);
+        return;
+    }
+
+    // 成员事件不受支持或超出硬件寄存器数时跳过，其余事件仍在组内计数
+    for (size_t i = 0; i < group.fds.size(); ++i) {
+        if (i == leader) {
+            continue;
+        }
+        group.fds[i] = openCounter(static_cast<HardwareCounter>(i), group.fds[leader]);
+        if (group.fds[i] < 0 && error.empty()) {
+            error = describeOpenError(errno, static_cast<HardwareCounter>(i));
+        }
+    }
+
+    for (size_t i = 0; i < group.fds.size(); ++i) {
+        if (group.fds[i] >= 0 && ioctl(group.fds[i], PERF_EVENT_IOC_ID, &group.ids[i]) != 0) {
+            close(group.fds[i]);
+            group.fds[i] = -1;
+        }
+    }
+#else
+    (void)error;
+#endif
+}
+
+HardwareCounterSet::HardwareCounterSet() {
+#if defined(__linux__)
+    // perf事件只统计打开它的线程，在并行区域内为OpenMP线程池的每个线程各打开一组。
+    // libgomp线程池线程常驻，之后不超过该线程数的并行区域复用同一批线程
+#if defined(_OPENMP)
+    const int thread_count = omp_get_max_threads();
+#else
+    const int thread_count = 1;
+#endif
+    groups_.resize(static_cast<size_t>(thread_count));
+    std::vector<std::string> errors(groups_.size());
+
+#if defined(_OPENMP)
+    #pragma omp parallel num_threads(thread_count)
+    {
+        const int thread_index = omp_get_thread_num();
+        openGroup(groups_[thread_index], errors[thread_index]);
+    }
+#else
+    openGroup(groups_[0], errors[0]);
+#endif
+
+    for (const auto& error : errors) {
+        if (!error.empty()) {
+            error_ = error;
+            break;
+        }
+    }
+#else
+    error_ = "当前平台不支持perf_event_open";
+#endif
+}
 
-PerformanceMonitor::PerformanceMonitor() : profiling_data_() {}
+HardwareCounterSet::~HardwareCounterSet() {
+#if defined(__linux__)
+    for (const auto& group : groups_) {
+        for (int fd : group.fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+#endif
+}
+
+bool HardwareCounterSet::isAvailable() const {
+    // 组长（周期）和指令计数在全部线程上打开时才可用，否则多线程读数不完整
+    if (groups_.empty()) {
+        return false;
+    }
+    for (const auto& group : groups_) {
+        if (group.fds[static_cast<size_t>(HardwareCounter::CYCLES)] < 0 ||
+            group.fds[static_cast<size_t>(HardwareCounter::INSTRUCTIONS)] < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HardwareCounterSet::start() {
+#if defined(__linux__)
+    for (const auto& group : groups_) {
+        int leader = group.fds[static_cast<size_t>(HardwareCounter::CYCLES)];
+        if (leader >= 0) {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+#endif
+}
+
+HardwareCounters HardwareCounterSet::stop() {
+    HardwareCounters counters;
+#if defined(__linux__)
+    for (const auto& group : groups_) {
+        int leader = group.fds[static_cast<size_t>(HardwareCounter::CYCLES)];
+        if (leader >= 0) {
+            ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    constexpr size_t kEventCount = static_cast<size_t>(HardwareCounter::COUNT);
+    counters.valid.fill(true);
+    for (const auto& group : groups_) {
+        int leader = group.fds[static_cast<size_t>(HardwareCounter::CYCLES)];
+        if (leader < 0) {
+            counters.valid.fill(false);
+            continue;
+        }
+
+        // nr, time_enabled, time_running, 然后每个事件为{value, id}
+        uint64_t data[3 + 2 * kEventCount] = {};
+        ssize_t bytes = read(leader, data, sizeof(data));
+        if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[2] == 0) {
+            // 组从未被调度，该线程的读数缺失
+            counters.valid.fill(false);
+            continue;
+        }
+
+        const uint64_t nr = std::min<uint64_t>(data[0], kEventCount);
+        const uint64_t time_enabled = data[1];
+        const uint64_t time_running = data[2];
+        counters.time_enabled_ns += time_enabled;
+        counters.time_running_ns += time_running;
+        counters.thread_count++;
+
+        // 同组事件同时调度，共用一个换算比例
+        const double scale = static_cast<double>(time_enabled) / time_running;
+        std::array<bool, kEventCount> read_events{};
+        for (uint64_t k = 0; k < nr; ++k) {
+            const uint64_t value = data[3 + 2 * k];
+            const uint64_t id = data[4 + 2 * k];
+            for (size_t i = 0; i < kEventCount; ++i) {
+                if (group.fds[i] >= 0 && group.ids[i] == id) {
+                    counters.values[i] += static_cast<uint64_t>(value * scale);
+                    read_events[i] = true;
+                    break;
+                }
+            }
+        }
+
+        // 任一线程缺少某个事件时，该事件的总和不完整
+        for (size_t i = 0; i < kEventCount; ++i) {
+            if (!read_events[i]) {
+                counters.valid[i] = false;
+            }
+        }
+    }
+
+    if (counters.thread_count == 0) {
+        counters.valid.fill(false);
+    }
+    for (size_t i = 0; i < kEventCount; ++i) {
+        if (!counters.valid[i]) {
+            counters.values[i] = 0;
+        }
+    }
+#endif
+    return counters;
+}
+
+PerformanceMonitor::PerformanceMonitor(bool enable_hardware_counters)
+    : profiling_data_(),
+      enable_hardware_counters_(enable_hardware_counters),
+      hardware_counters_available_(false) {
+    if (enable_hardware_counters_) {
+        // 探测一次计数器是否可用，不可用时后续分析只记录时间
+        HardwareCounterSet probe;
+        hardware_counters_available_ = probe.isAvailable();
+        hardware_counter_error_ = probe.getError();
+    }
+}
 
 void PerformanceMonitor::startProfiling(const std::string& name) {
     auto it = profiling_data_.find(name);
@@ -23,6 +310,15 @@ void PerformanceMonitor::startProfiling(const std::string& name) {
 
     it->second->start_time = std::chrono::high_resolution_clock::now();
     it->second->is_running = true;
+
+    // 计数器最后启动，尽量只覆盖被分析的代码
+    if (hardware_counters_available_) {
+        auto& counter_set = counter_sets_[name];
+        if (!counter_set) {
+            counter_set = std::make_unique<HardwareCounterSet>();
+        }
+        counter_set->start();
+    }
 }
 
 void PerformanceMonitor::endProfiling(const std::string& name) {
@@ -37,6 +333,11 @@ void PerformanceMonitor::endProfiling(const std::string& name) {
         return;
     }
 
+    auto counter_it = counter_sets_.find(name);
+    if (counter_it != counter_sets_.end()) {
+        it->second->counters = counter_it->second->stop();
+    }
+
     it->second->end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
         it->second->end_time - it->second->start_time);
@@ -56,6 +357,14 @@ double PerformanceMonitor::getDurationMs(const std::string& name) const {
     return static_cast<double>(getDurationNs(name)) / 1e6;
 }
 
+HardwareCounters PerformanceMonitor::getHardwareCounters(const std::string& name) const {
+    auto it = profiling_data_.find(name);
+    if (it == profiling_data_.end()) {
+        return HardwareCounters{};
+    }
+    return it->second->counters;
+}
+
 bool PerformanceMonitor::isProfiling(const std::string& name) const {
     auto it = profiling_data_.find(name);
     if (it == profiling_data_.end()) {
@@ -135,6 +444,37 @@ void PerformanceMonitor::printReport() const {
                   << std::endl;
     }
 
+    // 硬件计数器
+    if (enable_hardware_counters_) {
+        if (!hardware_counters_available_) {
+            std::cout << "\n硬件计数器不可用: " << hardware_counter_error_ << std::endl;
+        } else {
+            std::cout << "\n硬件计数器:" << std::endl;
+            std::cout << std::left << std::setw(30) << "分析项"
+                      << std::right << std::setw(10) << "IPC"
+                      << std::right << std::setw(12) << "L1D MPKI"
+                      << std::right << std::setw(12) << "LLC MPKI"
+                      << std::right << std::setw(12) << "分支 MPKI"
+                      << std::right << std::setw(8) << "线程"
+                      << std::right << std::setw(10) << "运行比例" << std::endl;
+            std::cout << std::string(94, '-') << std::endl;
+
+            for (const auto* data : completed_data) {
+                if (!data->counters.available()) {
+                    continue;
+                }
+                std::cout << std::left << std::setw(30) << data->name << std::fixed << std::setprecision(2)
+                          << std::right << std::setw(10) << data->counters.ipc()
+                          << std::right << std::setw(12) << data->counters.perKiloInstructions(HardwareCounter::L1D_MISSES)
+                          << std::right << std::setw(12) << data->counters.perKiloInstructions(HardwareCounter::LLC_MISSES)
+                          << std::right << std::setw(12) << data->counters.perKiloInstructions(HardwareCounter::BRANCH_MISSES)
+                          << std::right << std::setw(8) << data->counters.thread_count
+                          << std::right << std::setw(10) << data->counters.runningRatio()
+                          << std::endl;
+            }
+        }
+    }
+
     // 显示仍在运行的项目
     bool has_running = false;
     for (const auto& pair : profiling_data_) {
@@ -154,6 +494,7 @@ void PerformanceMonitor::printReport() const {
 
 void PerformanceMonitor::reset() {
     profiling_data_.clear();
+    counter_sets_.clear();
 }
 
 std::string PerformanceMonitor::formatDuration(long long ns) const {
@@ -9,6 +9,84 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <array>
+#include <cstdint>
+
+// 硬件性能计数器类型
+enum class HardwareCounter {
+    CYCLES = 0,         // CPU周期
+    INSTRUCTIONS,       // 退役指令数
+    L1D_MISSES,         // L1数据缓存读未命中
+    LLC_MISSES,         // 末级缓存读未命中
+    BRANCH_MISSES,      // 分支预测失败
+    COUNT
+};
+
+// 硬件性能计数器读数，平台或权限不支持的计数器标记为无效
+// 读数为各线程计数组按各自运行时间比例换算后的总和
+struct HardwareCounters {
+    std::array<uint64_t, static_cast<size_t>(HardwareCounter::COUNT)> values{};
+    std::array<bool, static_cast<size_t>(HardwareCounter::COUNT)> valid{};
+
+    // 各线程计数组启用时间和实际运行时间之和（纳秒），以及参与计数的线程数
+    uint64_t time_enabled_ns = 0;
+    uint64_t time_running_ns = 0;
+    uint32_t thread_count = 0;
+
+    bool has(HardwareCounter counter) const { return valid[static_cast<size_t>(counter)]; }
+    uint64_t get(HardwareCounter counter) const { return values[static_cast<size_t>(counter)]; }
+
+    // 周期和指令计数均有效时才视为可用
+    bool available() const { return has(HardwareCounter::CYCLES) && has(HardwareCounter::INSTRUCTIONS); }
+
+    // 每周期指令数
+    double ipc() const;
+
+    // 每千条指令的事件数（MPKI），计数器无效时返回0
+    double perKiloInstructions(HardwareCounter counter) const;
+
+    // 计数组实际运行时间占启用时间的比例，小于1表示计数器被分时复用，读数为换算估计值
+    double runningRatio() const;
+
+    static const char* name(HardwareCounter counter);
+};
+
+// 基于perf_event_open的硬件计数器，只统计用户态事件
+// 每个OpenMP线程打开一个计数组（周期计数为组长，其余事件为成员），组内事件同时调度，
+// 分时复用时比值（IPC、MPKI）不失真。计数组在并行区域内打开，覆盖调用线程和OpenMP线程池，
+// 线程池线程在区间内自旋等待的指令也会被计入。
+// 非Linux平台、perf_event_paranoid限制或虚拟机不支持时不可用，读数全部无效
+class HardwareCounterSet {
+public:
+    HardwareCounterSet();
+    ~HardwareCounterSet();
+
+    HardwareCounterSet(const HardwareCounterSet&) = delete;
+    HardwareCounterSet& operator=(const HardwareCounterSet&) = delete;
+
+    bool isAvailable() const;
+
+    // 清零并开始计数
+    void start();
+
+    // 停止计数并读取各线程计数组，按各组实际运行时间比例换算后求和
+    HardwareCounters stop();
+
+    // 计数器不可用的原因
+    const std::string& getError() const { return error_; }
+
+private:
+    // 单个线程的计数组，fds[CYCLES]为组长，ids为各事件的内核编号
+    struct ThreadGroup {
+        std::array<int, static_cast<size_t>(HardwareCounter::COUNT)> fds;
+        std::array<uint64_t, static_cast<size_t>(HardwareCounter::COUNT)> ids{};
+    };
+
+    std::vector<ThreadGroup> groups_;
+    std::string error_;
+
+    void openGroup(ThreadGroup& group, std::string& error);
+};
 
 class PerformanceMonitor {
 public:
@@ -18,12 +96,14 @@ public:
         std::chrono::high_resolution_clock::time_point end_time;
         long long duration_ns;
         bool is_running;
+        HardwareCounters counters;  // 分析区间内的硬件计数
 
         ProfilingData(const std::string& n)
             : name(n), duration_ns(0), is_running(false) {}
     };
 
-    PerformanceMonitor();
+    // enable_hardware_counters为true时在分析区间内采集硬件计数器
+    explicit PerformanceMonitor(bool enable_hardware_counters = true);
     ~PerformanceMonitor() = default;
 
     // 开始性能分析
@@ -38,6 +118,13 @@ public:
     // 获取执行时间（毫秒）
     double getDurationMs(const std::string& name) const;
 
+    // 获取分析区间的硬件计数
+    HardwareCounters getHardwareCounters(const std::string& name) const;
+
+    // 硬件计数器是否可用，不可用时返回原因
+    bool isHardwareCountersAvailable() const { return hardware_counters_available_; }
+    const std::string& getHardwareCounterError() const { return hardware_counter_error_; }
+
     // 检查分析是否正在运行
     bool isProfiling(const std::string& name) const;
 
@@ -59,6 +146,12 @@ public:
 private:
     std::unordered_map<std::string, std::unique_ptr<ProfilingData>> profiling_data_;
 
+    // 每个分析项的计数器，嵌套的分析区间各自计数
+    bool enable_hardware_counters_;
+    bool hardware_counters_available_;
+    std::string hardware_counter_error_;
+    std::unordered_map<std::string, std::unique_ptr<HardwareCounterSet>> counter_sets_;
+
     // 格式化时间输出
     std::string formatDuration(long long ns) const;
 
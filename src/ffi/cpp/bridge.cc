@@ -6,12 +6,22 @@
 #include "feature_plugin_base.h"
 #include "vibrate31_plugin.h"
 #include "plugin_manager.h"
+#include "async_chain_executor.h"
+#include "memory_accounting.h"
+#include "metrics_exporter.h"
+#include "trace_span.h"
 
 #include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <cmath>
 #include <chrono>
+#include <fstream>
+#include <mutex>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 // JSON序列化辅助函数（简化实现）
 std::string to_json(double value) {
@@ -55,6 +65,16 @@ public:
             // 注册所有插件
             registerAllPlugins();
 
+            // 异步请求队列满时直接拒绝，避免阻塞数据接收端
+            AlgorithmPlugins::AsyncChainExecutor::Options async_options;
+            async_options.overflow_policy = AlgorithmPlugins::AsyncChainExecutor::OverflowPolicy::REJECT;
+            async_executor_ = std::make_unique<AlgorithmPlugins::AsyncChainExecutor>(chain_manager_, async_options);
+
+            // 插件与链节点的执行统计，由get_metrics导出
+            chain_manager_.setMonitor(&monitor_);
+            metrics_exporter_.setMonitor(&monitor_);
+            metrics_exporter_.setAsyncExecutor("bridge", async_executor_.get());
+
             // 加载vibrate31插件
             if (loadVibrate31Plugin()) {
                 std::cout << "CppAlgorithmExecutor initialized successfully" << std::endl;
@@ -75,6 +95,10 @@ public:
         output.execution_time_ms = 0;
         output.memory_used_bytes = 0;
 
+        // Rust侧请求在此决定是否采样，异步请求沿用提交时安装的上下文
+        TRACE_REQUEST();
+        TRACE_SPAN_LABEL("bridgeExecute", "ffi", input.algorithm_name);
+
         auto start_time = std::chrono::high_resolution_clock::now();
 
         try {
@@ -83,18 +107,22 @@ public:
                 return output;
             }
 
-            // 创建插件参数
-            auto params = parseParameters(input.parameters_json);
-            if (!params) {
-                output.error_message = "Failed to parse parameters";
-                return output;
-            }
+            // 创建插件参数和输入数据 - 智能识别数据类型
+            std::shared_ptr<AlgorithmPlugins::PluginParameter> params;
+            std::shared_ptr<AlgorithmPlugins::PluginData> plugin_data;
+            {
+                TRACE_SPAN("bridgeDecode", "ffi");
+                params = parseParameters(input.parameters_json);
+                if (!params) {
+                    output.error_message = "Failed to parse parameters";
+                    return output;
+                }
 
-            // 创建输入数据 - 智能识别数据类型
-            auto plugin_data = createPluginData(input, params);
-            if (!plugin_data) {
-                output.error_message = "Failed to create plugin data";
-                return output;
+                plugin_data = createPluginData(input, params);
+                if (!plugin_data) {
+                    output.error_message = "Failed to create plugin data";
+                    return output;
+                }
             }
 
             // 创建输出结果
@@ -102,10 +130,9 @@ public:
 
             // 获取插件实例 - 统一处理所有插件类型
             std::shared_ptr<AlgorithmPlugins::IPlugin> plugin;
-            if (input.algorithm_name == "vibrate31" && vibrate31_plugin_) {
-                plugin = vibrate31_plugin_;
-            } else {
-                plugin = plugin_manager_->createPlugin(input.algorithm_name, params);
+            {
+                TRACE_SPAN_LABEL("bridgeLookup", "ffi", input.algorithm_name);
+                plugin = lookupPlugin(input.algorithm_name, params);
             }
 
             if (!plugin) {
@@ -113,24 +140,37 @@ public:
                 return output;
             }
 
-            // 执行算法
-            bool success = plugin->process(plugin_data, plugin_result);
+            // 执行算法，期间的分配记入本次执行的内存账户
+            AlgorithmPlugins::MemoryAccount memory_account(AlgorithmPlugins::MemoryAccount::current());
+            bool success;
+            {
+                TRACE_SPAN_LABEL("bridgeProcess", "ffi", input.algorithm_name);
+                AlgorithmPlugins::MemoryAccountScope memory_scope(&memory_account);
+                success = processWithPlugin(plugin, plugin_data, plugin_result);
+            }
 
             // 计算执行时间
             auto end_time = std::chrono::high_resolution_clock::now();
             output.execution_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                 end_time - start_time).count();
+            std::chrono::duration<double, std::milli> elapsed = end_time - start_time;
+            recordPluginExecution(input.algorithm_name, success, elapsed.count(),
+                                  success ? std::string() : plugin->getLastError());
+            recordPluginMemory(input.algorithm_name, memory_account);
 
             // 序列化结果
             if (success) {
+                TRACE_SPAN("bridgeSerialize", "ffi");
                 output.success = true;
                 output.result_json = serializeResult(plugin_result);
             } else {
                 output.error_message = plugin->getLastError();
             }
 
-            // 估算内存使用量
-            output.memory_used_bytes = estimateMemoryUsage(input, output.result_json);
+            // 实测执行期间的内存峰值，共享库未开启ENABLE_SHARED_ALLOCATION_TRACKING时退回估算
+            output.memory_used_bytes = AlgorithmPlugins::MemoryAccount::isAllocationTrackingEnabled()
+                ? memory_account.getUsage().peak_live_bytes
+                : estimateMemoryUsage(input, output.result_json);
 
         } catch (const std::exception& e) {
             output.error_message = std::string("Algorithm execution failed: ") + e.what();
@@ -139,6 +179,173 @@ public:
         return output;
     }
 
+    // 批量执行算法，相同算法和参数的输入共用一个插件实例并通过processBatch一次处理
+    std::vector<AlgorithmOutput> execute_algorithm_batch(const std::vector<AlgorithmInput>& inputs) {
+        // 整个批次作为一个请求采样，各算法分组为其中的区间
+        TRACE_REQUEST();
+        TRACE_SPAN("bridgeExecuteBatch", "ffi");
+
+        std::vector<AlgorithmOutput> outputs(inputs.size());
+        for (auto& output : outputs) {
+            output.success = false;
+            output.execution_time_ms = 0;
+            output.memory_used_bytes = 0;
+        }
+
+        if (!plugin_manager_) {
+            for (auto& output : outputs) {
+                output.error_message = "Plugin manager not initialized";
+            }
+            return outputs;
+        }
+
+        // 按算法名和参数分组，组内保持输入顺序
+        std::map<std::pair<std::string, std::string>, std::vector<size_t>> groups;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            groups[{inputs[i].algorithm_name, inputs[i].parameters_json}].push_back(i);
+        }
+
+        for (const auto& [key, indices] : groups) {
+            auto start_time = std::chrono::high_resolution_clock::now();
+            const auto& algorithm_name = key.first;
+            TRACE_SPAN_LABEL("bridgeBatchGroup", "ffi", algorithm_name);
+
+            try {
+                std::shared_ptr<AlgorithmPlugins::PluginParameter> params;
+                {
+                    TRACE_SPAN("bridgeDecode", "ffi");
+                    params = parseParameters(key.second);
+                }
+                if (!params) {
+                    for (size_t index : indices) {
+                        outputs[index].error_message = "Failed to parse parameters";
+                    }
+                    continue;
+                }
+
+                std::shared_ptr<AlgorithmPlugins::IPlugin> plugin;
+                {
+                    TRACE_SPAN_LABEL("bridgeLookup", "ffi", algorithm_name);
+                    plugin = lookupPlugin(algorithm_name, params);
+                }
+
+                if (!plugin) {
+                    for (size_t index : indices) {
+                        outputs[index].error_message = "Plugin not found: " + algorithm_name;
+                    }
+                    continue;
+                }
+
+                // 创建输入数据，创建失败的数据不参与批量处理
+                std::vector<size_t> batch_indices;
+                std::vector<std::shared_ptr<AlgorithmPlugins::PluginData>> batch_inputs;
+                std::vector<std::shared_ptr<AlgorithmPlugins::PluginResult>> batch_outputs;
+                std::vector<std::shared_ptr<AlgorithmPlugins::PluginResultImpl>> batch_results;
+                {
+                    TRACE_SPAN("bridgeDecode", "ffi");
+                    for (size_t index : indices) {
+                        auto plugin_data = createPluginData(inputs[index], params);
+                        if (!plugin_data) {
+                            outputs[index].error_message = "Failed to create plugin data";
+                            continue;
+                        }
+                        auto plugin_result = std::make_shared<AlgorithmPlugins::PluginResultImpl>();
+                        batch_indices.push_back(index);
+                        batch_inputs.push_back(plugin_data);
+                        batch_outputs.push_back(plugin_result);
+                        batch_results.push_back(plugin_result);
+                    }
+                }
+
+                std::vector<bool> succeeded;
+                AlgorithmPlugins::MemoryAccount memory_account(AlgorithmPlugins::MemoryAccount::current());
+                {
+                    TRACE_SPAN_LABEL("bridgeProcessBatch", "ffi", algorithm_name);
+                    AlgorithmPlugins::MemoryAccountScope memory_scope(&memory_account);
+                    if (plugin == vibrate31_plugin_) {
+                        std::lock_guard<std::mutex> lock(vibrate31_mutex_);
+                        plugin->processBatch(batch_inputs, batch_outputs, succeeded);
+                    } else {
+                        plugin->processBatch(batch_inputs, batch_outputs, succeeded);
+                    }
+                }
+                // 整组共用一个账户，各条输出报告整组的内存峰值
+                const bool memory_tracked = AlgorithmPlugins::MemoryAccount::isAllocationTrackingEnabled();
+                const uint64_t batch_peak_bytes = memory_account.getUsage().peak_live_bytes;
+
+                // 批量耗时按条数均摊到各条输出
+                auto end_time = std::chrono::high_resolution_clock::now();
+                uint64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    end_time - start_time).count();
+                uint64_t per_item_ms = batch_indices.empty() ? 0 : elapsed_ms / batch_indices.size();
+
+                // 监控统计同样按条数均摊耗时，内存整组记录一次
+                std::chrono::duration<double, std::milli> elapsed = end_time - start_time;
+                const double per_item_time_ms = batch_indices.empty() ? 0.0 : elapsed.count() / batch_indices.size();
+                for (size_t k = 0; k < batch_indices.size(); ++k) {
+                    const bool item_success = k < succeeded.size() && succeeded[k];
+                    recordPluginExecution(algorithm_name, item_success, per_item_time_ms,
+                                          item_success ? std::string() : plugin->getLastError());
+                }
+                recordPluginMemory(algorithm_name, memory_account);
+
+                TRACE_SPAN("bridgeSerialize", "ffi");
+                for (size_t k = 0; k < batch_indices.size(); ++k) {
+                    auto& output = outputs[batch_indices[k]];
+                    output.execution_time_ms = per_item_ms;
+                    if (k < succeeded.size() && succeeded[k]) {
+                        output.success = true;
+                        output.result_json = serializeResult(batch_results[k]);
+                    } else {
+                        output.error_message = plugin->getLastError();
+                    }
+                    output.memory_used_bytes = memory_tracked
+                        ? batch_peak_bytes
+                        : estimateMemoryUsage(inputs[batch_indices[k]], output.result_json);
+                }
+
+            } catch (const std::exception& e) {
+                for (size_t index : indices) {
+                    if (!outputs[index].success) {
+                        outputs[index].error_message = std::string("Algorithm execution failed: ") + e.what();
+                    }
+                }
+            }
+        }
+
+        return outputs;
+    }
+
+    bool execute_algorithm_async(const AlgorithmInput& input,
+                                 std::function<void(AlgorithmOutput)> callback) {
+        if (!async_executor_) {
+            return false;
+        }
+
+        // 提交时决定是否采样，执行线程安装同一上下文，排队与执行归入同一请求
+        TRACE_REQUEST();
+        TRACE_SPAN_LABEL("bridgeSubmitAsync", "ffi", input.algorithm_name);
+        const AlgorithmPlugins::TraceContext trace_context = TRACE_CURRENT_CONTEXT();
+
+        // 同一设备的请求按提交顺序执行
+        return async_executor_->submitTask(input.device_id, [this, input, trace_context, callback = std::move(callback)]() {
+            TRACE_CONTEXT_SCOPE(trace_context);
+            AlgorithmOutput output = execute_algorithm(input);
+            if (callback) {
+                TRACE_SPAN("bridgeAsyncCallback", "ffi");
+                callback(std::move(output));
+            }
+        });
+    }
+
+    size_t get_async_queue_depth() const {
+        return async_executor_ ? async_executor_->getQueueDepth() : 0;
+    }
+
+    std::string get_metrics() const {
+        return metrics_exporter_.render();
+    }
+
     // 移除专门的vibrate31方法，所有插件都通过execute_algorithm统一处理
     // vibrate31插件会在execute_algorithm中自动识别振动数据类型
 
@@ -177,7 +384,59 @@ private:
     std::shared_ptr<AlgorithmPlugins::PluginManager> plugin_manager_;
     std::shared_ptr<AlgorithmPlugins::IPlugin> vibrate31_plugin_;
 
+    // vibrate31插件为共享实例，同步与异步请求需串行调用
+    std::mutex vibrate31_mutex_;
+
+    // 执行统计，生命周期长于插件链管理器和导出器
+    AlgorithmPlugins::PluginMonitorManager monitor_;
+
+    // 异步执行，执行器先于插件链管理器析构
+    AlgorithmPlugins::PluginChainManager chain_manager_;
+    std::unique_ptr<AlgorithmPlugins::AsyncChainExecutor> async_executor_;
+
+    // 只持有上述数据源的指针，最先析构
+    AlgorithmPlugins::OpenMetricsExporter metrics_exporter_;
+
+    // 按算法名记录一次执行，插件首次执行时开始监控（startMonitoring可重复调用）
+    void recordPluginExecution(const std::string& algorithm_name, bool success,
+                               double execution_time_ms, const std::string& error_message) {
+        monitor_.startMonitoring(algorithm_name);
+        monitor_.recordExecution(algorithm_name, success, execution_time_ms, error_message);
+    }
+
+    // 未编译分配钩子时账户为空，不记录内存统计
+    void recordPluginMemory(const std::string& algorithm_name,
+                            const AlgorithmPlugins::MemoryAccount& memory_account) {
+        if (AlgorithmPlugins::MemoryAccount::isAllocationTrackingEnabled()) {
+            monitor_.recordMemoryUsage(algorithm_name, memory_account.getUsage());
+        }
+    }
+
+    // vibrate31使用常驻实例，其余插件由插件管理器按参数创建
+    std::shared_ptr<AlgorithmPlugins::IPlugin> lookupPlugin(
+        const std::string& algorithm_name,
+        const std::shared_ptr<AlgorithmPlugins::PluginParameter>& params) {
+        if (algorithm_name == "vibrate31" && vibrate31_plugin_) {
+            return vibrate31_plugin_;
+        }
+        return plugin_manager_->createPlugin(algorithm_name, params);
+    }
+
+    bool processWithPlugin(const std::shared_ptr<AlgorithmPlugins::IPlugin>& plugin,
+                           std::shared_ptr<AlgorithmPlugins::PluginData> plugin_data,
+                           std::shared_ptr<AlgorithmPlugins::PluginResult> plugin_result) {
+        if (plugin == vibrate31_plugin_) {
+            std::lock_guard<std::mutex> lock(vibrate31_mutex_);
+            return plugin->process(plugin_data, plugin_result);
+        }
+        return plugin->process(plugin_data, plugin_result);
+    }
+
     void cleanup() {
+        // 等待已入队的异步请求完成后再释放插件
+        if (async_executor_) {
+            async_executor_->shutdown();
+        }
         if (vibrate31_plugin_) {
             vibrate31_plugin_->cleanup();
             vibrate31_plugin_.reset();
@@ -471,6 +730,23 @@ AlgorithmOutput CppAlgorithmExecutor::execute_algorithm(const AlgorithmInput& in
     return pimpl_->execute_algorithm(input);
 }
 
+std::vector<AlgorithmOutput> CppAlgorithmExecutor::execute_algorithm_batch(const std::vector<AlgorithmInput>& inputs) {
+    return pimpl_->execute_algorithm_batch(inputs);
+}
+
+bool CppAlgorithmExecutor::execute_algorithm_async(const AlgorithmInput& input,
+                                                   std::function<void(AlgorithmOutput)> callback) {
+    return pimpl_->execute_algorithm_async(input, std::move(callback));
+}
+
+size_t CppAlgorithmExecutor::get_async_queue_depth() const {
+    return pimpl_->get_async_queue_depth();
+}
+
+std::string CppAlgorithmExecutor::get_metrics() const {
+    return pimpl_->get_metrics();
+}
+
 AlgorithmOutput CppAlgorithmExecutor::execute_vibrate31(const VibrationData& vibration_data,
                                                       const std::map<std::string, std::string>& parameters) {
     return pimpl_->execute_vibrate31(vibration_data, parameters);
@@ -577,6 +853,43 @@ AlgorithmOutput data_filter_positive(const std::vector<int32_t>& input) {
 // 生产级API实现
 namespace ProductionAPI {
 
+namespace {
+
+// 进程常驻内存（字节），不支持的平台返回false
+bool readResidentMemory(uint64_t& resident_bytes) {
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size_pages = 0;
+    uint64_t resident_pages = 0;
+    if (!(statm >> size_pages >> resident_pages)) {
+        return false;
+    }
+    resident_bytes = resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    return true;
+#else
+    (void)resident_bytes;
+    return false;
+#endif
+}
+
+// 物理内存总量（字节），不支持的平台返回false
+bool readPhysicalMemory(uint64_t& total_bytes) {
+#if defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || page_size <= 0) {
+        return false;
+    }
+    total_bytes = static_cast<uint64_t>(pages) * static_cast<uint64_t>(page_size);
+    return true;
+#else
+    (void)total_bytes;
+    return false;
+#endif
+}
+
+} // namespace
+
     std::vector<PluginStatus> get_plugin_status() {
         std::vector<PluginStatus> status;
         // 这里应该从实际的插件管理器获取状态
@@ -595,8 +908,10 @@ namespace ProductionAPI {
 
     SystemStatus get_system_status() {
         SystemStatus status;
-        status.total_memory_bytes = 8ULL * 1024 * 1024 * 1024; // 8GB
-        status.used_memory_bytes = 1ULL * 1024 * 1024 * 1024;  // 1GB
+        status.total_memory_bytes = 8ULL * 1024 * 1024 * 1024; // 读取失败时按8GB边缘设备
+        status.used_memory_bytes = 0;
+        readPhysicalMemory(status.total_memory_bytes);
+        readResidentMemory(status.used_memory_bytes);
         status.active_plugins = 1;
         status.total_plugins = 5;
         status.system_health = "healthy";
@@ -611,7 +926,8 @@ namespace ProductionAPI {
     PerformanceMetrics get_performance_metrics() {
         PerformanceMetrics metrics;
         metrics.cpu_usage_percent = 25.0;
-        metrics.memory_usage_bytes = 512ULL * 1024 * 1024; // 512MB
+        metrics.memory_usage_bytes = 0;
+        readResidentMemory(metrics.memory_usage_bytes);
         metrics.active_threads = 4;
         metrics.uptime_seconds = 3600; // 1小时
         return metrics;
@@ -5,6 +5,7 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <functional>
 
 // 集成cpp_plugins架构的桥接头文件
 
@@ -31,7 +32,7 @@ struct AlgorithmOutput {
     std::string result_json;
     std::string error_message;
     uint64_t execution_time_ms;
-    uint64_t memory_used_bytes;
+    uint64_t memory_used_bytes;     // 执行期间插件分配的存活内存峰值
 };
 
 // 振动数据结构（专门为vibrate31_plugin设计）
@@ -66,6 +67,20 @@ public:
     // 执行通用算法
     AlgorithmOutput execute_algorithm(const AlgorithmInput& input);
 
+    // 批量执行算法，输出与输入一一对应；相同算法和参数的输入合并为一次批量处理
+    std::vector<AlgorithmOutput> execute_algorithm_batch(const std::vector<AlgorithmInput>& inputs);
+
+    // 异步执行算法，请求进入有界队列后立即返回，完成后在工作线程中调用callback
+    // 队列已满或执行器未初始化时返回false，调用方可稍后重试
+    bool execute_algorithm_async(const AlgorithmInput& input,
+                                 std::function<void(AlgorithmOutput)> callback);
+
+    // 获取异步队列中等待执行的请求数
+    size_t get_async_queue_depth() const;
+
+    // 各插件执行次数、延迟、内存统计和异步队列的OpenMetrics文本
+    std::string get_metrics() const;
+
     // 统一插件执行接口（所有插件都通过此接口调用）
     // vibrate31等插件会自动识别输入数据类型并处理
 